@@ -7,6 +7,7 @@
 
 #include "SkBenchmark.h"
 #include "SkAAClip.h"
+#include "SkAAClipCache.h"
 #include "SkPath.h"
 #include "SkRegion.h"
 #include "SkString.h"
@@ -89,10 +90,13 @@ private:
 
 ////////////////////////////////////////////////////////////////////////////////
 // This bench tests out nested clip stacks. It is intended to simulate
-// how WebKit nests clips.
+// how WebKit nests clips. Since the same clip stack recurs on every draw, the
+// AA version also runs with the AA clip cache turned off, to measure what the
+// cache saves.
 class NestedAAClipBench : public SkBenchmark {
     SkString fName;
     bool     fDoAA;
+    bool     fUseCache;
     SkRect   fDrawRect;
     SkRandom fRandom;
 
@@ -103,11 +107,13 @@ class NestedAAClipBench : public SkBenchmark {
     SkPoint fSizes[kNestingDepth+1];
 
 public:
-    NestedAAClipBench(void* param, bool doAA)
+    NestedAAClipBench(void* param, bool doAA, bool useCache = true)
         : INHERITED(param)
-        , fDoAA(doAA) {
+        , fDoAA(doAA)
+        , fUseCache(useCache) {
 
-        fName.printf("nested_aaclip_%s", doAA ? "AA" : "BW");
+        fName.printf("nested_aaclip_%s%s", doAA ? "AA" : "BW",
+                     useCache ? "" : "_nocache");
 
         fDrawRect = SkRect::MakeLTRB(0, 0,
                                      SkIntToScalar(kImageSize),
@@ -168,11 +174,19 @@ protected:
     }
 
     virtual void onDraw(SkCanvas* canvas) {
+        int limit = 0;
+        if (!fUseCache) {
+            limit = SkAAClipCache::SetCountLimit(0);
+        }
 
         for (int i = 0; i < kNumDraws; ++i) {
             SkPoint offset = SkPoint::Make(0, 0);
             this->recurse(canvas, 0, offset);
         }
+
+        if (!fUseCache) {
+            SkAAClipCache::SetCountLimit(limit);
+        }
     }
 
 private:
@@ -286,5 +300,8 @@ static BenchRegistry gReg003(Fact003);
 static SkBenchmark* Fact004(void* p) { return SkNEW_ARGS(NestedAAClipBench, (p, false)); }
 static SkBenchmark* Fact005(void* p) { return SkNEW_ARGS(NestedAAClipBench, (p, true)); }
 
+static SkBenchmark* Fact006(void* p) { return SkNEW_ARGS(NestedAAClipBench, (p, true, false)); }
+
 static BenchRegistry gReg004(Fact004);
 static BenchRegistry gReg005(Fact005);
+static BenchRegistry gReg006(Fact006);
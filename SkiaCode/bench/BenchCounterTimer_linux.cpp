@@ -0,0 +1,92 @@
+
+/*
+ * Copyright 2012 Google Inc.
+ *
+ * Use of this source code is governed by a BSD-style license that can be
+ * found in the LICENSE file.
+ */
+#include "BenchCounterTimer_linux.h"
+
+#include <linux/perf_event.h>
+#include <string.h>
+#include <sys/ioctl.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+
+// glibc has no wrapper for perf_event_open.
+static int open_counter(unsigned long long config) {
+    perf_event_attr attr;
+    memset(&attr, 0, sizeof(attr));
+    attr.type = PERF_TYPE_HARDWARE;
+    attr.size = sizeof(attr);
+    attr.config = config;
+    attr.disabled = 1;
+    // Counting only user space is allowed without privileges by the default
+    // perf_event_paranoid setting.
+    attr.exclude_kernel = 1;
+    attr.exclude_hv = 1;
+    attr.read_format = PERF_FORMAT_TOTAL_TIME_ENABLED | PERF_FORMAT_TOTAL_TIME_RUNNING;
+    return (int) syscall(__NR_perf_event_open, &attr, 0, -1, -1, 0);
+}
+
+BenchCounterTimer::BenchCounterTimer() {
+    static const unsigned long long gConfigs[kEventCount] = {
+        PERF_COUNT_HW_CPU_CYCLES,
+        PERF_COUNT_HW_INSTRUCTIONS,
+        PERF_COUNT_HW_CACHE_MISSES,
+        PERF_COUNT_HW_BRANCH_MISSES,
+    };
+    for (int i = 0; i < kEventCount; ++i) {
+        fFD[i] = open_counter(gConfigs[i]);
+    }
+}
+
+BenchCounterTimer::~BenchCounterTimer() {
+    for (int i = 0; i < kEventCount; ++i) {
+        if (fFD[i] >= 0) {
+            close(fFD[i]);
+        }
+    }
+}
+
+bool BenchCounterTimer::isValid() const {
+    for (int i = 0; i < kEventCount; ++i) {
+        if (fFD[i] >= 0) {
+            return true;
+        }
+    }
+    return false;
+}
+
+void BenchCounterTimer::startCounters() {
+    for (int i = 0; i < kEventCount; ++i) {
+        if (fFD[i] >= 0) {
+            ioctl(fFD[i], PERF_EVENT_IOC_RESET, 0);
+            ioctl(fFD[i], PERF_EVENT_IOC_ENABLE, 0);
+        }
+    }
+}
+
+void BenchCounterTimer::endCounters(double counts[kEventCount]) {
+    for (int i = 0; i < kEventCount; ++i) {
+        if (fFD[i] >= 0) {
+            ioctl(fFD[i], PERF_EVENT_IOC_DISABLE, 0);
+        }
+    }
+    for (int i = 0; i < kEventCount; ++i) {
+        counts[i] = -1;
+        // value, time enabled, time running
+        unsigned long long values[3];
+        if (fFD[i] < 0 || read(fFD[i], values, sizeof(values)) != sizeof(values)) {
+            continue;
+        }
+        if (values[2] == 0) {
+            // never scheduled on the PMU, so nothing was counted
+            continue;
+        }
+        counts[i] = (double) values[0];
+        if (values[2] < values[1]) {
+            counts[i] *= (double) values[1] / values[2];
+        }
+    }
+}
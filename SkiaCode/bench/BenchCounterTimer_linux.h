@@ -0,0 +1,42 @@
+
+/*
+ * Copyright 2012 Google Inc.
+ *
+ * Use of this source code is governed by a BSD-style license that can be
+ * found in the LICENSE file.
+ */
+#ifndef SkBenchCounterTimer_DEFINED
+#define SkBenchCounterTimer_DEFINED
+
+/**
+ * Counts hardware events of the calling thread with perf_event_open. Each event has its own
+ * counter, so that the others still count when the CPU or the kernel doesn't support one.
+ * Counters that the kernel multiplexes are scaled to the whole interval.
+ */
+class BenchCounterTimer {
+public:
+    enum Event {
+        kCycles_Event,
+        kInstructions_Event,
+        kCacheMisses_Event,
+        kBranchMisses_Event,
+
+        kEventCount
+    };
+
+    BenchCounterTimer();
+    ~BenchCounterTimer();
+
+    /** Return true if at least one of the events can be counted. */
+    bool isValid() const;
+
+    void startCounters();
+
+    /** Store the count of each event since startCounters(), or -1 if it can't be counted. */
+    void endCounters(double counts[kEventCount]);
+
+private:
+    int fFD[kEventCount];
+};
+
+#endif
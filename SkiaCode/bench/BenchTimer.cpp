@@ -20,12 +20,24 @@
 #include "BenchGpuTimer_gl.h"
 #endif
 
+#if defined(SK_BUILD_FOR_ANDROID) || (defined(SK_BUILD_FOR_UNIX) && defined(__linux__))
+    #define BENCH_COUNTERS 1
+    #include "BenchCounterTimer_linux.h"
+#else
+    #define BENCH_COUNTERS 0
+#endif
+
 BenchTimer::BenchTimer(SkGLContext* gl)
         : fCpu(-1.0)
         , fWall(-1.0)
         , fTruncatedCpu(-1.0)
         , fTruncatedWall(-1.0)
         , fGpu(-1.0)
+        , fCycles(-1.0)
+        , fInstructions(-1.0)
+        , fCacheMisses(-1.0)
+        , fBranchMisses(-1.0)
+        , fCounterTimer(NULL)
 {
     fSysTimer = new BenchSysTimer();
     fTruncatedSysTimer = new BenchSysTimer();
@@ -41,6 +53,9 @@ BenchTimer::BenchTimer(SkGLContext* gl)
 BenchTimer::~BenchTimer() {
     delete fSysTimer;
     delete fTruncatedSysTimer;
+#if BENCH_COUNTERS
+    delete fCounterTimer;
+#endif
 #if SK_SUPPORT_GPU
     delete fGpuTimer;
 #endif
@@ -56,9 +71,24 @@ void BenchTimer::start() {
 #endif
     fSysTimer->startCpu();
     fTruncatedSysTimer->startCpu();
+#if BENCH_COUNTERS
+    if (fCounterTimer) {
+        fCounterTimer->startCounters();
+    }
+#endif
 }
 
 void BenchTimer::end() {
+#if BENCH_COUNTERS
+    if (fCounterTimer) {
+        double counts[BenchCounterTimer::kEventCount];
+        fCounterTimer->endCounters(counts);
+        fCycles = counts[BenchCounterTimer::kCycles_Event];
+        fInstructions = counts[BenchCounterTimer::kInstructions_Event];
+        fCacheMisses = counts[BenchCounterTimer::kCacheMisses_Event];
+        fBranchMisses = counts[BenchCounterTimer::kBranchMisses_Event];
+    }
+#endif
     fCpu = fSysTimer->endCpu();
 #if SK_SUPPORT_GPU
     //It is important to stop the cpu clocks first,
@@ -74,3 +104,18 @@ void BenchTimer::truncatedEnd() {
     fTruncatedCpu = fTruncatedSysTimer->endCpu();
     fTruncatedWall = fTruncatedSysTimer->endWall();
 }
+
+bool BenchTimer::enableCounters() {
+#if BENCH_COUNTERS
+    if (NULL == fCounterTimer) {
+        fCounterTimer = new BenchCounterTimer();
+        if (!fCounterTimer->isValid()) {
+            delete fCounterTimer;
+            fCounterTimer = NULL;
+        }
+    }
+    return NULL != fCounterTimer;
+#else
+    return false;
+#endif
+}
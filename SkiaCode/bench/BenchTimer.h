@@ -13,6 +13,7 @@
 
 class BenchSysTimer;
 class BenchGpuTimer;
+class BenchCounterTimer;
 
 class SkGLContext;
 
@@ -24,6 +25,11 @@ class SkGLContext;
  * its rendering. It should always be <= the un-truncated system
  * times and (for GPU configurations) can be used to roughly (very
  * roughly) gauge the GPU load/backlog.
+ *
+ * Once enableCounters() succeeds, the timer also counts the CPU cycles,
+ * instructions, cache misses and branch misses between start() and end(),
+ * which tell compute bound code from memory bound code. A count is -1 when
+ * it is not available.
  */
 class BenchTimer {
 public:
@@ -32,15 +38,27 @@ public:
     void start();
     void end();
     void truncatedEnd();
+
+    /**
+     * Count hardware events from now on. Return false if this platform, the
+     * CPU or the kernel's perf_event_paranoid setting doesn't allow it.
+     */
+    bool enableCounters();
+
     double fCpu;
     double fWall;
     double fTruncatedCpu;
     double fTruncatedWall;
     double fGpu;
+    double fCycles;
+    double fInstructions;
+    double fCacheMisses;
+    double fBranchMisses;
 
 private:
     BenchSysTimer *fSysTimer;
     BenchSysTimer *fTruncatedSysTimer;
+    BenchCounterTimer *fCounterTimer;
 #if SK_SUPPORT_GPU
     BenchGpuTimer *fGpuTimer;
 #endif
@@ -0,0 +1,75 @@
+/*
+ * Copyright 2012 Google Inc.
+ *
+ * Use of this source code is governed by a BSD-style license that can be
+ * found in the LICENSE file.
+ */
+#include "SkBenchmark.h"
+#include "SkCanvas.h"
+#include "SkData.h"
+#include "SkDOM.h"
+#include "SkStream.h"
+#include "SkString.h"
+
+// Measures parsing a layout-like document of a few hundred kilobytes with
+// SkDOM::build(SkData*), which keeps every name and value in one copy of the
+// document, against SkDOM::copy(), which allocates each of them separately.
+class DOMBench : public SkBenchmark {
+    enum {
+        ELEMENTS = 4000,
+        N = SkBENCHLOOP(10)
+    };
+    SkData* fDoc;
+    SkDOM   fSrc;
+    bool    fCopy;
+
+public:
+    DOMBench(void* param, bool copy) : INHERITED(param), fCopy(copy) {
+        // SkString is limited to 64K in debug builds, so the document is streamed
+        SkDynamicMemoryWStream doc;
+        doc.writeText("<layout>\n");
+        for (int i = 0; i < ELEMENTS; ++i) {
+            SkString view;
+            view.printf("  <view id='view%d' left='%d' top='%d' width='%d' height='%d'"
+                        " color='#%06x' visible='true'>\n", i, i % 37 * 8, i % 53 * 8,
+                        i % 7 * 16 + 16, i % 5 * 16 + 16, i * 0x1357 & 0xFFFFFF);
+            view.appendf("    <text value='Label &amp; value %d' size='%d'/>\n", i, i % 9 + 10);
+            view.append("  </view>\n");
+            doc.writeText(view.c_str());
+        }
+        doc.writeText("</layout>\n");
+        fDoc = doc.copyToData();
+        fSrc.build(fDoc);
+    }
+
+    virtual ~DOMBench() {
+        fDoc->unref();
+    }
+
+protected:
+    virtual const char* onGetName() SK_OVERRIDE {
+        return fCopy ? "dom_copy" : "dom_build";
+    }
+
+    virtual void onDraw(SkCanvas*) SK_OVERRIDE {
+        for (int i = 0; i < N; ++i) {
+            SkDOM dom;
+            if (fCopy) {
+                dom.copy(fSrc, fSrc.getRootNode());
+            } else {
+                dom.build(fDoc);
+            }
+        }
+    }
+
+private:
+    typedef SkBenchmark INHERITED;
+};
+
+///////////////////////////////////////////////////////////////////////////////
+
+static SkBenchmark* Fact0(void* p) { return SkNEW_ARGS(DOMBench, (p, false)); }
+static SkBenchmark* Fact1(void* p) { return SkNEW_ARGS(DOMBench, (p, true)); }
+
+static BenchRegistry gReg0(Fact0);
+static BenchRegistry gReg1(Fact1);
@@ -260,6 +260,145 @@ private:
     typedef SkBenchmark INHERITED;
 };
 
+/*
+ *  Draws a dashed line that is much longer than the canvas, so all but a few
+ *  of its dashes are clipped out.
+ */
+class GiantDashBench : public SkBenchmark {
+public:
+    enum LineType {
+        kHori_LineType,
+        kVert_LineType,
+        kDiag_LineType
+    };
+
+    static const char* LineTypeName(LineType lt) {
+        static const char* gNames[] = { "hori", "vert", "diag" };
+        SK_COMPILE_ASSERT(kDiag_LineType + 1 == SK_ARRAY_COUNT(gNames),
+                          names_wrong_size);
+        return gNames[lt];
+    }
+
+    GiantDashBench(void* param, LineType lt, SkScalar width)
+        : INHERITED(param) {
+        fName.printf("giantdashline_%s_%g", LineTypeName(lt),
+                     SkScalarToFloat(width));
+        fStrokeWidth = width;
+
+        // the horizontal and vertical lines are drawn as rects, while the
+        // diagonal one can only be culled
+        const SkScalar intervals[] = { SkIntToScalar(20), SkIntToScalar(10),
+                                       SkIntToScalar(10), SkIntToScalar(10) };
+        fPathEffect.reset(new SkDashPathEffect(intervals,
+                                               SK_ARRAY_COUNT(intervals), 0));
+
+        SkScalar cx = SkIntToScalar(640) / 2;  // center X
+        SkScalar cy = SkIntToScalar(480) / 2;  // center Y
+        SkMatrix matrix;
+
+        switch (lt) {
+            case kHori_LineType:
+                matrix.setIdentity();
+                break;
+            case kVert_LineType:
+                matrix.setRotate(SkIntToScalar(90), cx, cy);
+                break;
+            case kDiag_LineType:
+                matrix.setRotate(SkIntToScalar(45), cx, cy);
+                break;
+        }
+
+        const SkScalar overshoot = SkIntToScalar(100*1000);
+        const SkPoint pts[2] = {
+            { -overshoot, cy }, { SkIntToScalar(640) + overshoot, cy }
+        };
+        matrix.mapPoints(fPts, pts, 2);
+    }
+
+protected:
+    virtual const char* onGetName() SK_OVERRIDE {
+        return fName.c_str();
+    }
+
+    virtual void onDraw(SkCanvas* canvas) SK_OVERRIDE {
+        SkPaint p;
+        this->setupPaint(&p);
+        p.setStyle(SkPaint::kStroke_Style);
+        p.setStrokeWidth(fStrokeWidth);
+        p.setPathEffect(fPathEffect);
+
+        for (int i = 0; i < N; ++i) {
+            canvas->drawPoints(SkCanvas::kLines_PointMode, 2, fPts, p);
+        }
+    }
+
+private:
+    enum {
+        N = SkBENCHLOOP(4)
+    };
+
+    SkString fName;
+    SkAutoTUnref<SkPathEffect> fPathEffect;
+    SkPoint fPts[2];
+    SkScalar fStrokeWidth;
+
+    typedef SkBenchmark INHERITED;
+};
+
+/*
+ *  Draws a grid of dashed rect outlines, e.g. selection marquees or the
+ *  borders of table cells.
+ */
+class DashRectOutlineBench : public SkBenchmark {
+public:
+    DashRectOutlineBench(void* param, SkScalar width) : INHERITED(param) {
+        fName.printf("dashrect_outline_%g", SkScalarToFloat(width));
+        fStrokeWidth = width;
+
+        const SkScalar intervals[] = { SkIntToScalar(6), SkIntToScalar(4) };
+        fPathEffect.reset(new SkDashPathEffect(intervals,
+                                               SK_ARRAY_COUNT(intervals), 0));
+    }
+
+protected:
+    virtual const char* onGetName() SK_OVERRIDE {
+        return fName.c_str();
+    }
+
+    virtual void onDraw(SkCanvas* canvas) SK_OVERRIDE {
+        SkPaint p;
+        this->setupPaint(&p);
+        p.setStyle(SkPaint::kStroke_Style);
+        p.setStrokeWidth(fStrokeWidth);
+        p.setPathEffect(fPathEffect);
+
+        for (int i = 0; i < N; ++i) {
+            for (int y = 0; y < kRows; ++y) {
+                for (int x = 0; x < kColumns; ++x) {
+                    SkRect r = SkRect::MakeXYWH(SkIntToScalar(10 + 60 * x),
+                                                SkIntToScalar(10 + 45 * y),
+                                                SkIntToScalar(50),
+                                                SkIntToScalar(35));
+                    canvas->drawRect(r, p);
+                }
+            }
+        }
+    }
+
+private:
+    enum {
+        kColumns    = 10,
+        kRows       = 10,
+        N           = SkBENCHLOOP(10)
+    };
+
+    SkString fName;
+    SkAutoTUnref<SkPathEffect> fPathEffect;
+    SkScalar fStrokeWidth;
+
+    typedef SkBenchmark INHERITED;
+};
+
 ///////////////////////////////////////////////////////////////////////////////
 
 static const SkScalar gDots[] = { SK_Scalar1, SK_Scalar1 };
@@ -280,6 +419,15 @@ static SkBenchmark* gF701(void* p) { return new DashLineBench(p, 0, true); }
 static SkBenchmark* gF711(void* p) { return new DashLineBench(p, SK_Scalar1, true); }
 static SkBenchmark* gF721(void* p) { return new DashLineBench(p, 2 * SK_Scalar1, true); }
 
+static SkBenchmark* gF800(void* p) { return new GiantDashBench(p, GiantDashBench::kHori_LineType, 0); }
+static SkBenchmark* gF801(void* p) { return new GiantDashBench(p, GiantDashBench::kVert_LineType, 0); }
+static SkBenchmark* gF802(void* p) { return new GiantDashBench(p, GiantDashBench::kDiag_LineType, 0); }
+static SkBenchmark* gF810(void* p) { return new GiantDashBench(p, GiantDashBench::kHori_LineType, 2 * SK_Scalar1); }
+static SkBenchmark* gF811(void* p) { return new GiantDashBench(p, GiantDashBench::kVert_LineType, 2 * SK_Scalar1); }
+static SkBenchmark* gF812(void* p) { return new GiantDashBench(p, GiantDashBench::kDiag_LineType, 2 * SK_Scalar1); }
+static SkBenchmark* gF900(void* p) { return new DashRectOutlineBench(p, SK_Scalar1); }
+static SkBenchmark* gF901(void* p) { return new DashRectOutlineBench(p, 3 * SK_Scalar1); }
+
 static BenchRegistry gR0(gF0);
 static BenchRegistry gR1(gF1);
 static BenchRegistry gR2(gF2);
@@ -293,3 +441,11 @@ static BenchRegistry gR720(gF720);
 static BenchRegistry gR701(gF701);
 static BenchRegistry gR711(gF711);
 static BenchRegistry gR721(gF721);
+static BenchRegistry gR800(gF800);
+static BenchRegistry gR801(gF801);
+static BenchRegistry gR802(gF802);
+static BenchRegistry gR810(gF810);
+static BenchRegistry gR811(gF811);
+static BenchRegistry gR812(gF812);
+static BenchRegistry gR900(gF900);
+static BenchRegistry gR901(gF901);
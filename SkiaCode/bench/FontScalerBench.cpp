@@ -6,14 +6,32 @@
  */
 
 #include "SkBenchmark.h"
+#include "SkBitmap.h"
 #include "SkCanvas.h"
 #include "SkGraphics.h"
 #include "SkPaint.h"
 #include "SkRandom.h"
 #include "SkString.h"
+#include "SkThreadUtils.h"
 
 extern bool gSkSuppressFontCachePurgeSpew;
 
+enum {
+    kMinTextSize = 9,
+    kMaxTextSize = 24,
+};
+
+// Draws text at every other text size, starting at firstSize, so that each
+// size has to create a new strike.
+static void draw_text_sizes(SkCanvas* canvas, SkPaint* paint,
+                            const SkString& text, int firstSize, int step) {
+    for (int ps = firstSize; ps <= kMaxTextSize; ps += step) {
+        paint->setTextSize(SkIntToScalar(ps));
+        canvas->drawText(text.c_str(), text.size(),
+                         0, SkIntToScalar(20), *paint);
+    }
+}
+
 class FontScalerBench : public SkBenchmark {
     SkString fName;
     SkString fText;
@@ -39,15 +57,84 @@ protected:
         // explicitly flush our cache before each run
         SkGraphics::PurgeFontCache();
 
-        for (int ps = 9; ps <= 24; ps += 2) {
-            paint.setTextSize(SkIntToScalar(ps));
-            canvas->drawText(fText.c_str(), fText.size(),
-                             0, SkIntToScalar(20), paint);
+        draw_text_sizes(canvas, &paint, fText, kMinTextSize, 2);
+
+        gSkSuppressFontCachePurgeSpew = prev;
+    }
+private:
+    typedef SkBenchmark INHERITED;
+};
+
+/**
+ *  Same work as FontScalerBench, but the text sizes are split between
+ *  kThreads threads, each drawing into its own bitmap. This measures how well
+ *  the font host scales when glyphs for different strikes are generated
+ *  concurrently.
+ */
+class FontScalerThreadedBench : public SkBenchmark {
+    enum {
+        kThreads = 4,
+    };
+
+    struct ThreadData {
+        const FontScalerThreadedBench*  fBench;
+        SkPaint                         fPaint;
+        int                             fFirstSize;
+    };
+
+    SkString    fName;
+    SkString    fText;
+
+public:
+    FontScalerThreadedBench(void* param, bool doLCD) : INHERITED(param) {
+        fName.printf("fontscaler_%s_threads%d", doLCD ? "lcd" : "aa", kThreads);
+        fText.set("abcdefghijklmnopqrstuvwxyz01234567890");
+        fDoLCD = doLCD;
+    }
+
+protected:
+    virtual const char* onGetName() { return fName.c_str(); }
+    virtual void onDraw(SkCanvas* canvas) {
+        SkPaint paint;
+        this->setupPaint(&paint);
+        paint.setLCDRenderText(fDoLCD);
+
+        bool prev = gSkSuppressFontCachePurgeSpew;
+        gSkSuppressFontCachePurgeSpew = true;
+
+        SkGraphics::PurgeFontCache();
+
+        ThreadData data[kThreads];
+        SkThread* threads[kThreads];
+        for (int i = 0; i < kThreads; ++i) {
+            data[i].fBench = this;
+            data[i].fPaint = paint;
+            data[i].fFirstSize = kMinTextSize + 2 * i;
+            threads[i] = SkNEW_ARGS(SkThread, (DrawProc, &data[i]));
+            threads[i]->start();
+        }
+        for (int i = 0; i < kThreads; ++i) {
+            threads[i]->join();
+            SkDELETE(threads[i]);
         }
 
         gSkSuppressFontCachePurgeSpew = prev;
     }
+
 private:
+    static void DrawProc(void* context) {
+        ThreadData* data = static_cast<ThreadData*>(context);
+
+        SkBitmap bitmap;
+        bitmap.setConfig(SkBitmap::kARGB_8888_Config, 640, 32);
+        bitmap.allocPixels();
+        SkCanvas canvas(bitmap);
+        draw_text_sizes(&canvas, &data->fPaint, data->fBench->fText,
+                        data->fFirstSize, 2 * kThreads);
+    }
+
+    bool fDoLCD;
+
     typedef SkBenchmark INHERITED;
 };
 
@@ -55,6 +142,10 @@ private:
 
 static SkBenchmark* Fact0(void* p) { return SkNEW_ARGS(FontScalerBench, (p, false)); }
 static SkBenchmark* Fact1(void* p) { return SkNEW_ARGS(FontScalerBench, (p, true)); }
+static SkBenchmark* Fact2(void* p) { return SkNEW_ARGS(FontScalerThreadedBench, (p, false)); }
+static SkBenchmark* Fact3(void* p) { return SkNEW_ARGS(FontScalerThreadedBench, (p, true)); }
 
 static BenchRegistry gReg0(Fact0);
 static BenchRegistry gReg1(Fact1);
+static BenchRegistry gReg2(Fact2);
+static BenchRegistry gReg3(Fact3);
@@ -0,0 +1,167 @@
+
+/*
+ * Copyright 2012 Google Inc.
+ *
+ * Use of this source code is governed by a BSD-style license that can be
+ * found in the LICENSE file.
+ */
+
+// This tests a Gr class
+#if SK_SUPPORT_GPU
+
+#include "GrContext.h"
+#include "GrResource.h"
+#include "GrResourceCache.h"
+#include "SkBenchmark.h"
+#include "SkNullGLContext.h"
+#include "SkRandom.h"
+
+namespace {
+
+// A resource that owns no 3D API object, so it can be created against the
+// null GL interface at whatever rate the cache can absorb.
+class FakeResource : public GrResource {
+public:
+    FakeResource(GrGpu* gpu, size_t size) : INHERITED(gpu), fSize(size) {}
+    virtual ~FakeResource() { this->release(); }
+
+    virtual size_t sizeInBytes() const SK_OVERRIDE { return fSize; }
+
+private:
+    size_t fSize;
+
+    typedef GrResource INHERITED;
+};
+
+enum {
+    // plenty of resources in flight, against a budget that only holds a
+    // fraction of them, so that most creates trigger a purge
+    kResourceCount  = 16 * 1024,
+    kBudgetCount    = 4 * 1024,
+    kResourceBytes  = 64 * 64 * 4,
+};
+
+GrResourceKey make_key(uint32_t i) {
+    // mimic GrTexture::ComputeKey: an id, a size and some flags
+    return GrResourceKey(i, 0x8000 | (i & 0xFF), (i >> 8) & 0xFF, 0xF00D);
+}
+
+}
+
+/**
+ * Base class for the cache benchmarks. Owns a GrContext on top of the null
+ * GL interface for the GrGpu that the fake resources register with.
+ */
+class GrResourceCacheBench : public SkBenchmark {
+public:
+    GrResourceCacheBench(void* param) : INHERITED(param), fContext(NULL) {}
+
+protected:
+    virtual void onPreDraw() SK_OVERRIDE {
+        fGLContext.reset(SkNEW(SkNullGLContext));
+        fGLContext.get()->init(32, 32);
+        fContext = GrContext::Create(kOpenGL_Shaders_GrEngine,
+                                     (GrPlatform3DContext) fGLContext.get()->gl());
+    }
+
+    virtual void onPostDraw() SK_OVERRIDE {
+        SkSafeUnref(fContext);
+        fContext = NULL;
+        fGLContext.reset(NULL);
+    }
+
+    GrGpu* gpu() { return fContext->getGpu(); }
+
+    void populate(GrResourceCache* cache, uint32_t count, uint32_t base) {
+        for (uint32_t i = 0; i < count; ++i) {
+            SkAutoTUnref<GrResource> resource(
+                SkNEW_ARGS(FakeResource, (this->gpu(), kResourceBytes)));
+            cache->create(make_key(base + i), resource);
+            cache->purgeAsNeeded();
+        }
+    }
+
+private:
+    SkAutoTUnref<SkGLContext>   fGLContext;
+    GrContext*                  fContext;
+
+    typedef SkBenchmark INHERITED;
+};
+
+/**
+ * Creates far more resources than the budget allows: every create is
+ * followed by a purge of the LRU tail.
+ */
+class GrResourceCacheBenchChurn : public GrResourceCacheBench {
+    enum {
+        N = SkBENCHLOOP(4),
+    };
+public:
+    GrResourceCacheBenchChurn(void* param) : INHERITED(param) {}
+
+protected:
+    virtual const char* onGetName() SK_OVERRIDE {
+        return "grresourcecache_churn";
+    }
+
+    virtual void onDraw(SkCanvas*) SK_OVERRIDE {
+        for (int i = 0; i < N; ++i) {
+            GrResourceCache cache(kBudgetCount, kBudgetCount * kResourceBytes);
+            this->populate(&cache, kResourceCount, 0);
+        }
+    }
+
+private:
+    typedef GrResourceCacheBench INHERITED;
+};
+
+/**
+ * Random lookups, half of them misses, into a full cache.
+ */
+class GrResourceCacheBenchFind : public GrResourceCacheBench {
+    enum {
+        N = SkBENCHLOOP(64 * 1024),
+    };
+public:
+    GrResourceCacheBenchFind(void* param) : INHERITED(param), fCache(NULL) {}
+
+protected:
+    virtual const char* onGetName() SK_OVERRIDE {
+        return "grresourcecache_find";
+    }
+
+    virtual void onPreDraw() SK_OVERRIDE {
+        this->INHERITED::onPreDraw();
+        fCache = SkNEW_ARGS(GrResourceCache,
+                            (kResourceCount, kResourceCount * kResourceBytes));
+        this->populate(fCache, kResourceCount, 0);
+    }
+
+    virtual void onPostDraw() SK_OVERRIDE {
+        SkDELETE(fCache);
+        fCache = NULL;
+        this->INHERITED::onPostDraw();
+    }
+
+    virtual void onDraw(SkCanvas*) SK_OVERRIDE {
+        SkRandom r;
+        for (int i = 0; i < N; ++i) {
+            fCache->find(make_key(r.nextU() % (2 * kResourceCount)));
+        }
+    }
+
+private:
+    GrResourceCache* fCache;
+
+    typedef GrResourceCacheBench INHERITED;
+};
+
+///////////////////////////////////////////////////////////////////////////////
+
+static SkBenchmark* Fact1(void* p) { return new GrResourceCacheBenchChurn(p); }
+static SkBenchmark* Fact2(void* p) { return new GrResourceCacheBenchFind(p); }
+
+static BenchRegistry gReg01(Fact1);
+static BenchRegistry gReg02(Fact2);
+
+#endif
@@ -0,0 +1,137 @@
+/*
+ * Copyright 2012 Google Inc.
+ *
+ * Use of this source code is governed by a BSD-style license that can be
+ * found in the LICENSE file.
+ */
+#include "SkBenchmark.h"
+#include "SkBitmap.h"
+#include "SkCanvas.h"
+#include "SkDevice.h"
+#include "SkLightingImageFilter.h"
+#include "SkPaint.h"
+#include "SkString.h"
+
+// Runs the six lights of gm/lighting.cpp over the same 100x100 bitmap.
+
+namespace {
+
+enum LightType {
+    kPoint_LightType,
+    kDistant_LightType,
+    kSpot_LightType
+};
+
+}
+
+static const char* gLightName[] = {
+    "point",
+    "distant",
+    "spot"
+};
+
+class LightingBench : public SkBenchmark {
+    LightType   fLight;
+    bool        fSpecular;
+    SkString    fName;
+    SkBitmap    fBitmap;
+
+    enum {
+        N = SkBENCHLOOP(10)
+    };
+
+public:
+    LightingBench(void* param, LightType light, bool specular)
+        : INHERITED(param)
+        , fLight(light)
+        , fSpecular(specular) {
+        fName.printf("lighting_%s_%s", gLightName[light],
+                     specular ? "specular" : "diffuse");
+
+        fBitmap.setConfig(SkBitmap::kARGB_8888_Config, 100, 100);
+        fBitmap.allocPixels();
+        SkDevice device(fBitmap);
+        SkCanvas canvas(&device);
+        canvas.clear(0x00000000);
+        // a shape with soft, curved edges in place of the gm's glyph
+        SkPaint paint;
+        paint.setAntiAlias(true);
+        paint.setColor(0xFFFFFFFF);
+        canvas.drawCircle(SkIntToScalar(50), SkIntToScalar(50),
+                          SkIntToScalar(40), paint);
+        paint.setColor(0x80FFFFFF);
+        paint.setXfermodeMode(SkXfermode::kSrc_Mode);
+        canvas.drawCircle(SkIntToScalar(50), SkIntToScalar(50),
+                          SkIntToScalar(20), paint);
+    }
+
+protected:
+    virtual const char* onGetName() {
+        return fName.c_str();
+    }
+
+    SkImageFilter* createFilter() const {
+        SkPoint3 pointLocation(0, 0, SkIntToScalar(10));
+        SkScalar azimuthRad = SkDegreesToRadians(SkIntToScalar(225));
+        SkScalar elevationRad = SkDegreesToRadians(SkIntToScalar(5));
+        SkPoint3 distantDirection(SkScalarMul(SkScalarCos(azimuthRad), SkScalarCos(elevationRad)),
+                                  SkScalarMul(SkScalarSin(azimuthRad), SkScalarCos(elevationRad)),
+                                  SkScalarSin(elevationRad));
+        SkPoint3 spotLocation(SkIntToScalar(-10), SkIntToScalar(-10), SkIntToScalar(20));
+        SkPoint3 spotTarget(SkIntToScalar(40), SkIntToScalar(40), 0);
+        SkScalar spotExponent = SK_Scalar1;
+        SkScalar cutoffAngle = SkIntToScalar(15);
+        SkScalar kd = SkIntToScalar(2);
+        SkScalar ks = SkIntToScalar(1);
+        SkScalar shininess = SkIntToScalar(8);
+        SkScalar surfaceScale = SkIntToScalar(1);
+        SkColor white(0xFFFFFFFF);
+
+        switch (fLight) {
+            case kPoint_LightType:
+                return fSpecular ?
+                    SkLightingImageFilter::CreatePointLitSpecular(pointLocation, white, surfaceScale, ks, shininess) :
+                    SkLightingImageFilter::CreatePointLitDiffuse(pointLocation, white, surfaceScale, kd);
+            case kDistant_LightType:
+                return fSpecular ?
+                    SkLightingImageFilter::CreateDistantLitSpecular(distantDirection, white, surfaceScale, ks, shininess) :
+                    SkLightingImageFilter::CreateDistantLitDiffuse(distantDirection, white, surfaceScale, kd);
+            case kSpot_LightType:
+                return fSpecular ?
+                    SkLightingImageFilter::CreateSpotLitSpecular(spotLocation, spotTarget, spotExponent, cutoffAngle, white, surfaceScale, ks, shininess) :
+                    SkLightingImageFilter::CreateSpotLitDiffuse(spotLocation, spotTarget, spotExponent, cutoffAngle, white, surfaceScale, kd);
+        }
+        return NULL;
+    }
+
+    virtual void onDraw(SkCanvas* canvas) {
+        SkPaint paint;
+        paint.setImageFilter(this->createFilter())->unref();
+        for (int i = 0; i < N; ++i) {
+            canvas->drawSprite(fBitmap, 0, 0, &paint);
+        }
+    }
+
+private:
+    typedef SkBenchmark INHERITED;
+};
+
+static SkBenchmark* Fact00(void* p) { return new LightingBench(p, kPoint_LightType, false); }
+static SkBenchmark* Fact01(void* p) { return new LightingBench(p, kDistant_LightType, false); }
+static SkBenchmark* Fact02(void* p) { return new LightingBench(p, kSpot_LightType, false); }
+static SkBenchmark* Fact10(void* p) { return new LightingBench(p, kPoint_LightType, true); }
+static SkBenchmark* Fact11(void* p) { return new LightingBench(p, kDistant_LightType, true); }
+static SkBenchmark* Fact12(void* p) { return new LightingBench(p, kSpot_LightType, true); }
+
+// Fixed point can be much slower than float on these tests, causing
+// bench to timeout.
+#ifndef SK_SCALAR_IS_FIXED
+
+static BenchRegistry gReg00(Fact00);
+static BenchRegistry gReg01(Fact01);
+static BenchRegistry gReg02(Fact02);
+static BenchRegistry gReg10(Fact10);
+static BenchRegistry gReg11(Fact11);
+static BenchRegistry gReg12(Fact12);
+
+#endif
@@ -7,10 +7,13 @@
  */
 #include "SkBenchmark.h"
 #include "SkBitmap.h"
+#include "SkBlitter.h"
 #include "SkCanvas.h"
 #include "SkColorPriv.h"
 #include "SkPaint.h"
 #include "SkRandom.h"
+#include "SkRasterClip.h"
+#include "SkScan.h"
 #include "SkShader.h"
 #include "SkString.h"
 #include "SkTArray.h"
@@ -668,6 +671,91 @@ private:
     typedef SkBenchmark INHERITED;
 };
 
+/**
+ *  Fills paths with thousands of edges (an area chart, and a self-intersecting
+ *  scribble) with either of the scan converter's edge walkers, to compare the
+ *  linked list walker with the array walker. The walker can only be chosen by
+ *  calling SkScan directly, so this draws into its own bitmap rather than the
+ *  bench's canvas.
+ */
+class EdgeWalkerBench : public SkBenchmark {
+public:
+    enum Shape {
+        kChart_Shape,
+        kScribble_Shape
+    };
+
+    EdgeWalkerBench(void* param, Shape shape, SkScan::EdgeWalker walker)
+        : INHERITED(param)
+        , fWalker(walker) {
+        fName.printf("path_edges_%s_%s",
+                     kChart_Shape == shape ? "chart" : "scribble",
+                     SkScan::kList_EdgeWalker == walker ? "list" : "arrays");
+
+        SkRandom rand;
+        if (kChart_Shape == shape) {
+            const SkScalar bottom = SkIntToScalar(480);
+            fPath.moveTo(0, bottom);
+            for (int i = 0; i <= kPoints; ++i) {
+                fPath.lineTo(SkIntToScalar(640) * i / kPoints,
+                             SkIntToScalar(100) + rand.nextUScalar1() * 300);
+            }
+            fPath.lineTo(SkIntToScalar(640), bottom);
+            fPath.close();
+        } else {
+            fPath.moveTo(rand.nextUScalar1() * 640, rand.nextUScalar1() * 480);
+            for (int i = 1; i < kPoints; ++i) {
+                fPath.lineTo(rand.nextUScalar1() * 640, rand.nextUScalar1() * 480);
+            }
+            fPath.close();
+            fPath.setFillType(SkPath::kEvenOdd_FillType);
+        }
+    }
+
+protected:
+    enum {
+        kPoints = 2000,
+        N       = SkBENCHLOOP(2)
+    };
+
+    virtual const char* onGetName() SK_OVERRIDE {
+        return fName.c_str();
+    }
+
+    virtual void onPreDraw() SK_OVERRIDE {
+        fBitmap.setConfig(SkBitmap::kARGB_8888_Config, 640, 480);
+        fBitmap.allocPixels();
+    }
+
+    virtual void onDraw(SkCanvas*) SK_OVERRIDE {
+        SkPaint paint;
+        this->setupPaint(&paint);
+        // the antialiased scan converter walks the same edges, but its time
+        // is dominated by accumulating coverage
+        paint.setAntiAlias(false);
+
+        SkAutoLockPixels alp(fBitmap);
+        SkAutoTDelete<SkBlitter> blitter(SkBlitter::Choose(fBitmap, SkMatrix::I(),
+                                                           paint));
+        SkRasterClip clip(SkIRect::MakeWH(fBitmap.width(), fBitmap.height()));
+        for (int i = 0; i < N; ++i) {
+            SkScan::FillPath(fPath, clip, blitter.get(), fWalker);
+        }
+    }
+
+    virtual void onPostDraw() SK_OVERRIDE {
+        fBitmap.reset();
+    }
+
+private:
+    SkString            fName;
+    SkPath              fPath;
+    SkScan::EdgeWalker  fWalker;
+    SkBitmap            fBitmap;
+
+    typedef SkBenchmark INHERITED;
+};
+
 static SkBenchmark* FactT00(void* p) { return new TrianglePathBench(p, FLAGS00); }
 static SkBenchmark* FactT01(void* p) { return new TrianglePathBench(p, FLAGS01); }
 static SkBenchmark* FactT10(void* p) { return new TrianglePathBench(p, FLAGS10); }
@@ -767,3 +855,23 @@ static BenchRegistry gRegReverseTo(FactReverseTo);
 static SkBenchmark* CirclesTest(void* p) { return new CirclesBench(p); }
 static BenchRegistry gRegCirclesTest(CirclesTest);
 
+static SkBenchmark* FactEdgesChartList(void* p) {
+    return new EdgeWalkerBench(p, EdgeWalkerBench::kChart_Shape,
+                               SkScan::kList_EdgeWalker);
+}
+static SkBenchmark* FactEdgesChartArrays(void* p) {
+    return new EdgeWalkerBench(p, EdgeWalkerBench::kChart_Shape,
+                               SkScan::kArray_EdgeWalker);
+}
+static SkBenchmark* FactEdgesScribbleList(void* p) {
+    return new EdgeWalkerBench(p, EdgeWalkerBench::kScribble_Shape,
+                               SkScan::kList_EdgeWalker);
+}
+static SkBenchmark* FactEdgesScribbleArrays(void* p) {
+    return new EdgeWalkerBench(p, EdgeWalkerBench::kScribble_Shape,
+                               SkScan::kArray_EdgeWalker);
+}
+static BenchRegistry gRegEdgesChartList(FactEdgesChartList);
+static BenchRegistry gRegEdgesChartArrays(FactEdgesChartArrays);
+static BenchRegistry gRegEdgesScribbleList(FactEdgesScribbleList);
+static BenchRegistry gRegEdgesScribbleArrays(FactEdgesScribbleArrays);
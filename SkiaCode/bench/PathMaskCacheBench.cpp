@@ -0,0 +1,115 @@
+
+/*
+ * Copyright 2012 Google Inc.
+ *
+ * Use of this source code is governed by a BSD-style license that can be
+ * found in the LICENSE file.
+ */
+
+#include "SkBenchmark.h"
+#include "SkCanvas.h"
+#include "SkGraphics.h"
+#include "SkPaint.h"
+#include "SkPath.h"
+#include "SkPathMaskCache.h"
+#include "SkString.h"
+
+/**
+ *  Draws a toolbar's worth of small antialiased icons (filled and stroked
+ *  paths) at whole-pixel offsets, as a UI does every frame, with the path
+ *  mask cache either enabled or disabled.
+ */
+class PathMaskCacheBench : public SkBenchmark {
+    enum {
+        kIconCount  = 3,
+        kColumns    = 20,
+        kRows       = 12,
+        N           = SkBENCHLOOP(4),
+    };
+
+public:
+    PathMaskCacheBench(void* param, bool useCache)
+        : INHERITED(param)
+        , fUseCache(useCache) {
+        fName.printf("path_icons_%s", useCache ? "cached" : "uncached");
+
+        // star
+        fIcons[0].moveTo(SkIntToScalar(10), 0);
+        fIcons[0].lineTo(SkIntToScalar(16), SkIntToScalar(19));
+        fIcons[0].lineTo(0, SkIntToScalar(7));
+        fIcons[0].lineTo(SkIntToScalar(20), SkIntToScalar(7));
+        fIcons[0].lineTo(SkIntToScalar(4), SkIntToScalar(19));
+        fIcons[0].close();
+
+        // heart
+        fIcons[1].moveTo(SkIntToScalar(10), SkIntToScalar(18));
+        fIcons[1].cubicTo(SkIntToScalar(-6), SkIntToScalar(6),
+                          SkIntToScalar(4), SkIntToScalar(-4),
+                          SkIntToScalar(10), SkIntToScalar(4));
+        fIcons[1].cubicTo(SkIntToScalar(16), SkIntToScalar(-4),
+                          SkIntToScalar(26), SkIntToScalar(6),
+                          SkIntToScalar(10), SkIntToScalar(18));
+        fIcons[1].close();
+
+        // gear-ish ring
+        fIcons[2].addCircle(SkIntToScalar(10), SkIntToScalar(10),
+                            SkIntToScalar(9));
+        fIcons[2].addCircle(SkIntToScalar(10), SkIntToScalar(10),
+                            SkIntToScalar(4), SkPath::kCCW_Direction);
+    }
+
+protected:
+    virtual const char* onGetName() SK_OVERRIDE {
+        return fName.c_str();
+    }
+
+    virtual void onPreDraw() SK_OVERRIDE {
+        fPrevLimit = SkGraphics::SetPathMaskCacheLimit(
+                fUseCache ? SkPathMaskCache::kSuggestedByteLimit : 0);
+        SkGraphics::PurgePathMaskCache();
+    }
+
+    virtual void onDraw(SkCanvas* canvas) SK_OVERRIDE {
+        SkPaint paint;
+        this->setupPaint(&paint);
+        paint.setStrokeWidth(SkIntToScalar(2));
+        paint.setStrokeJoin(SkPaint::kRound_Join);
+
+        for (int loop = 0; loop < N; ++loop) {
+            for (int y = 0; y < kRows; ++y) {
+                for (int x = 0; x < kColumns; ++x) {
+                    int icon = (x + y) % kIconCount;
+                    paint.setStyle((x & 1) ? SkPaint::kStroke_Style :
+                                             SkPaint::kFill_Style);
+                    paint.setColor(0xFF000000 | (icon * 0x405020));
+                    canvas->save();
+                    canvas->translate(SK_ScalarHalf + SkIntToScalar(30 * x),
+                                      SkScalarHalf(SK_ScalarHalf) +
+                                      SkIntToScalar(36 * y));
+                    canvas->drawPath(fIcons[icon], paint);
+                    canvas->restore();
+                }
+            }
+        }
+    }
+
+    virtual void onPostDraw() SK_OVERRIDE {
+        SkGraphics::SetPathMaskCacheLimit(fPrevLimit);
+    }
+
+private:
+    SkString    fName;
+    SkPath      fIcons[kIconCount];
+    bool        fUseCache;
+    size_t      fPrevLimit;
+
+    typedef SkBenchmark INHERITED;
+};
+
+///////////////////////////////////////////////////////////////////////////////
+
+static SkBenchmark* Fact0(void* p) { return new PathMaskCacheBench(p, false); }
+static SkBenchmark* Fact1(void* p) { return new PathMaskCacheBench(p, true); }
+
+static BenchRegistry gReg0(Fact0);
+static BenchRegistry gReg1(Fact1);
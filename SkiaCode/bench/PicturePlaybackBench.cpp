@@ -11,15 +11,22 @@
 #include "SkPicture.h"
 #include "SkPoint.h"
 #include "SkRect.h"
+#include "SkStream.h"
 #include "SkString.h"
 
 // This is designed to emulate about 4 screens of textual content
+// The _compact variants record with SkPicture::kCompactOpStream_RecordingFlag,
+// so comparing them shows the cost of decoding the compact op stream; the
+// serialized size of each picture is reported once per bench.
 
 
 class PicturePlaybackBench : public SkBenchmark {
 public:
-    PicturePlaybackBench(void* param, const char name[]) : INHERITED(param) {
-        fName.printf("picture_playback_%s", name);
+    PicturePlaybackBench(void* param, const char name[], bool compact)
+        : INHERITED(param)
+        , fCompact(compact)
+        , fSerializedSize(0) {
+        fName.printf("picture_playback_%s%s", name, compact ? "_compact" : "");
         fPictureWidth = SkIntToScalar(PICTURE_WIDTH);
         fPictureHeight = SkIntToScalar(PICTURE_HEIGHT);
         fTextSize = SkIntToScalar(TEXT_SIZE);
@@ -36,13 +43,24 @@ protected:
         return fName.c_str();
     }
 
+    virtual void onPreDraw() {
+        // the subclass can't record in our constructor, so measure before
+        // the first timed draw instead
+        if (0 == fSerializedSize) {
+            SkPicture picture;
+            this->recordPicture(&picture);
+            SkDynamicMemoryWStream stream;
+            picture.serialize(&stream);
+            fSerializedSize = stream.getOffset();
+            SkDebugf("%s: %d bytes serialized\n", fName.c_str(),
+                     (int)fSerializedSize);
+        }
+    }
+
     virtual void onDraw(SkCanvas* canvas) {
 
         SkPicture picture;
-
-        SkCanvas* pCanvas = picture.beginRecording(PICTURE_WIDTH, PICTURE_HEIGHT);
-        recordCanvas(pCanvas);
-        picture.endRecording();
+        this->recordPicture(&picture);
 
         const SkPoint translateDelta = getTranslateDelta();
 
@@ -52,6 +70,14 @@ protected:
         }
     }
 
+    void recordPicture(SkPicture* picture) {
+        uint32_t flags = fCompact ? SkPicture::kCompactOpStream_RecordingFlag : 0;
+        SkCanvas* pCanvas = picture->beginRecording(PICTURE_WIDTH, PICTURE_HEIGHT,
+                                                    flags);
+        recordCanvas(pCanvas);
+        picture->endRecording();
+    }
+
     virtual void recordCanvas(SkCanvas* canvas) = 0;
     virtual SkPoint getTranslateDelta() {
         SkIPoint canvasSize = onGetSize();
@@ -63,6 +89,8 @@ protected:
     SkScalar fPictureWidth;
     SkScalar fPictureHeight;
     SkScalar fTextSize;
+    bool     fCompact;
+    size_t   fSerializedSize;
 private:
     typedef SkBenchmark INHERITED;
 };
@@ -70,7 +98,8 @@ private:
 
 class TextPlaybackBench : public PicturePlaybackBench {
 public:
-    TextPlaybackBench(void* param) : INHERITED(param, "drawText") { }
+    TextPlaybackBench(void* param, bool compact)
+        : INHERITED(param, "drawText", compact) { }
 protected:
     virtual void recordCanvas(SkCanvas* canvas) {
         SkPaint paint;
@@ -93,8 +122,8 @@ private:
 
 class PosTextPlaybackBench : public PicturePlaybackBench {
 public:
-    PosTextPlaybackBench(void* param, bool drawPosH)
-        : INHERITED(param, drawPosH ? "drawPosTextH" : "drawPosText")
+    PosTextPlaybackBench(void* param, bool drawPosH, bool compact)
+        : INHERITED(param, drawPosH ? "drawPosTextH" : "drawPosText", compact)
         , fDrawPosH(drawPosH) { }
 protected:
     virtual void recordCanvas(SkCanvas* canvas) {
@@ -135,13 +164,46 @@ private:
 };
 
 
+// Pixel-aligned rects with a handful of paints, like a page of UI content
+class RectPlaybackBench : public PicturePlaybackBench {
+public:
+    RectPlaybackBench(void* param, bool compact)
+        : INHERITED(param, "drawRect", compact) { }
+protected:
+    virtual void recordCanvas(SkCanvas* canvas) {
+        SkPaint paint;
+        int count = 0;
+        for (int y = 0; y < PICTURE_HEIGHT; y += 20) {
+            for (int x = 0; x < PICTURE_WIDTH; x += 50) {
+                paint.setColor(0xFF000000 | (0x302010 * (count++ & 7)));
+                canvas->drawRect(SkRect::MakeXYWH(SkIntToScalar(x),
+                                                  SkIntToScalar(y),
+                                                  SkIntToScalar(40),
+                                                  SkIntToScalar(16)), paint);
+            }
+        }
+    }
+private:
+    typedef PicturePlaybackBench INHERITED;
+};
+
 ///////////////////////////////////////////////////////////////////////////////
 
-static SkBenchmark* Fact0(void* p) { return new TextPlaybackBench(p); }
-static SkBenchmark* Fact1(void* p) { return new PosTextPlaybackBench(p, true); }
-static SkBenchmark* Fact2(void* p) { return new PosTextPlaybackBench(p, false); }
+static SkBenchmark* Fact0(void* p) { return new TextPlaybackBench(p, false); }
+static SkBenchmark* Fact1(void* p) { return new PosTextPlaybackBench(p, true, false); }
+static SkBenchmark* Fact2(void* p) { return new PosTextPlaybackBench(p, false, false); }
+static SkBenchmark* Fact3(void* p) { return new RectPlaybackBench(p, false); }
+static SkBenchmark* Fact4(void* p) { return new TextPlaybackBench(p, true); }
+static SkBenchmark* Fact5(void* p) { return new PosTextPlaybackBench(p, true, true); }
+static SkBenchmark* Fact6(void* p) { return new PosTextPlaybackBench(p, false, true); }
+static SkBenchmark* Fact7(void* p) { return new RectPlaybackBench(p, true); }
 
 static BenchRegistry gReg0(Fact0);
 static BenchRegistry gReg1(Fact1);
 static BenchRegistry gReg2(Fact2);
+static BenchRegistry gReg3(Fact3);
+static BenchRegistry gReg4(Fact4);
+static BenchRegistry gReg5(Fact5);
+static BenchRegistry gReg6(Fact6);
+static BenchRegistry gReg7(Fact7);
 
@@ -0,0 +1,103 @@
+/*
+ * Copyright 2012 Google Inc.
+ *
+ * Use of this source code is governed by a BSD-style license that can be
+ * found in the LICENSE file.
+ */
+#include "SamplePipeControllers.h"
+#include "SkBenchmark.h"
+#include "SkCanvas.h"
+#include "SkGPipe.h"
+#include "SkPaint.h"
+#include "SkPath.h"
+#include "SkString.h"
+
+/**
+ * Records frames of draw commands through an SkGPipeWriter and measures the
+ * throughput to the bench canvas. The synchronous version plays each command
+ * back as it is written; the threaded one plays back on a reader thread, with
+ * the writer recording frame N+1 while frame N is drawn.
+ */
+class PipeBench : public SkBenchmark {
+public:
+    PipeBench(void* param, bool threaded) : INHERITED(param), fThreaded(threaded) {
+        fName.printf("pipe_%s", threaded ? "threaded" : "sync");
+
+        fPath.moveTo(0, 0);
+        fPath.cubicTo(SkIntToScalar(20), SkIntToScalar(-10),
+                      SkIntToScalar(30), SkIntToScalar(40),
+                      SkIntToScalar(10), SkIntToScalar(30));
+        fPath.close();
+    }
+
+    enum {
+        N = SkBENCHLOOP(10),    // frames
+        M = SkBENCHLOOP(200),   // draws per frame
+    };
+
+protected:
+    virtual const char* onGetName() SK_OVERRIDE {
+        return fName.c_str();
+    }
+
+    virtual void onDraw(SkCanvas* canvas) SK_OVERRIDE {
+        if (fThreaded) {
+            ThreadedPipeController controller(canvas);
+            SkGPipeWriter writer;
+            SkCanvas* pipeCanvas = writer.startRecording(&controller,
+                                                         SkGPipeWriter::kCrossProcess_Flag);
+            ThreadedPipeController::Fence prevFrame = controller.insertFence();
+            for (int frame = 0; frame < N; ++frame) {
+                this->drawFrame(pipeCanvas, frame);
+                ThreadedPipeController::Fence thisFrame = controller.insertFence();
+                // keep at most one frame in flight
+                controller.waitForFence(prevFrame);
+                prevFrame = thisFrame;
+            }
+            writer.endRecording();
+            controller.drain();
+        } else {
+            PipeController controller(canvas);
+            SkGPipeWriter writer;
+            SkCanvas* pipeCanvas = writer.startRecording(&controller,
+                                                         SkGPipeWriter::kCrossProcess_Flag);
+            for (int frame = 0; frame < N; ++frame) {
+                this->drawFrame(pipeCanvas, frame);
+            }
+            writer.endRecording();
+        }
+    }
+
+private:
+    void drawFrame(SkCanvas* canvas, int frame) {
+        SkPaint paint;
+        paint.setAntiAlias(true);
+        for (int i = 0; i < M; ++i) {
+            paint.setColor(0xFF000000 | ((frame * M + i) * 0x10307));
+            canvas->save();
+            canvas->translate(SkIntToScalar((i * 17) % 600),
+                              SkIntToScalar((i * 31) % 440));
+            if (i & 1) {
+                canvas->drawPath(fPath, paint);
+            } else {
+                canvas->drawRect(SkRect::MakeWH(SkIntToScalar(24),
+                                                SkIntToScalar(16)), paint);
+            }
+            canvas->restore();
+        }
+    }
+
+    bool        fThreaded;
+    SkString    fName;
+    SkPath      fPath;
+
+    typedef SkBenchmark INHERITED;
+};
+
+///////////////////////////////////////////////////////////////////////////////
+
+static SkBenchmark* Fact0(void* p) { return new PipeBench(p, false); }
+static SkBenchmark* Fact1(void* p) { return new PipeBench(p, true); }
+
+static BenchRegistry gReg0(Fact0);
+static BenchRegistry gReg1(Fact1);
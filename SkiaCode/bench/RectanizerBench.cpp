@@ -0,0 +1,157 @@
+
+/*
+ * Copyright 2012 Google Inc.
+ *
+ * Use of this source code is governed by a BSD-style license that can be
+ * found in the LICENSE file.
+ */
+
+// This tests a Gr class, but only on the CPU
+#if SK_SUPPORT_GPU
+
+#include "GrRectanizer.h"
+#include "SkBenchmark.h"
+#include "SkRandom.h"
+#include "SkString.h"
+#include "SkTDArray.h"
+
+namespace {
+
+// same plot size GrAtlas packs glyphs into
+enum {
+    kPlotWidth  = 256 - 1,
+    kPlotHeight = 256 - 1,
+};
+
+struct GlyphSize {
+    int fWidth;
+    int fHeight;
+};
+
+/**
+ *  Generates glyph-like sizes: a handful of common text sizes, with narrow
+ *  punctuation, x-height lower case, cap height and descender glyphs mixed in.
+ */
+void make_glyph_sizes(SkTDArray<GlyphSize>* sizes, int count) {
+    static const int gTextSizes[] = { 10, 11, 12, 12, 13, 13, 14, 16, 18, 24, 32 };
+    // width and height as a fraction (in 1/16ths) of the text size
+    static const struct {
+        int fWidth16;
+        int fHeight16;
+    } gShapes[] = {
+        {  5,  5 },     // punctuation
+        {  9, 10 },     // x-height
+        {  9, 10 },
+        {  9, 10 },
+        { 10, 12 },     // caps
+        { 10, 12 },
+        {  9, 14 },     // ascender
+        {  9, 15 },     // descender
+        { 14, 12 },     // wide caps
+        { 16, 19 },     // accented / CJK
+    };
+
+    SkRandom rand;
+    sizes->setCount(count);
+    for (int i = 0; i < count; ++i) {
+        int textSize = gTextSizes[rand.nextU() % SK_ARRAY_COUNT(gTextSizes)];
+        int shape = rand.nextU() % SK_ARRAY_COUNT(gShapes);
+        // +2 for the antialiasing / filter border every glyph mask has
+        (*sizes)[i].fWidth = (gShapes[shape].fWidth16 * textSize >> 4) + 2;
+        (*sizes)[i].fHeight = (gShapes[shape].fHeight16 * textSize >> 4) + 2;
+    }
+}
+
+}
+
+/**
+ *  Packs a stream of glyph sizes into atlas plots, starting a fresh plot each
+ *  time one is full, as GrAtlasMgr does. Measures throughput; the number of
+ *  plots used and their average fill when abandoned (the packing efficiency)
+ *  are computed once per bench and reported before its first run.
+ */
+class RectanizerBench : public SkBenchmark {
+    enum {
+        kGlyphCount = 4096,
+        N = SkBENCHLOOP(50),
+    };
+public:
+    RectanizerBench(void* param, GrRectanizer::Type type, const char* name)
+        : INHERITED(param)
+        , fType(type) {
+        fName.printf("rectanizer_%s", name);
+        make_glyph_sizes(&fSizes, kGlyphCount);
+        fPlots = this->pack(&fTotalFull);
+        fReported = false;
+    }
+
+protected:
+    virtual const char* onGetName() SK_OVERRIDE {
+        return fName.c_str();
+    }
+
+    virtual void onPreDraw() SK_OVERRIDE {
+        if (!fReported) {
+            SkDebugf("%s: %d plots, %.1f%% average fill\n", fName.c_str(),
+                     fPlots, 100 * fTotalFull / fPlots);
+            fReported = true;
+        }
+    }
+
+    virtual void onDraw(SkCanvas*) SK_OVERRIDE {
+        for (int loop = 0; loop < N; ++loop) {
+            this->pack(NULL);
+        }
+    }
+
+private:
+    GrRectanizer::Type      fType;
+    SkString                fName;
+    SkTDArray<GlyphSize>    fSizes;
+    int                     fPlots;
+    float                   fTotalFull;
+    bool                    fReported;
+
+    /**
+     *  Packs every size and returns the number of plots used. If totalFull is
+     *  not NULL, it is set to the sum of each plot's percentFull().
+     */
+    int pack(float* totalFull) {
+        GrRectanizer* rects = GrRectanizer::Factory(kPlotWidth, kPlotHeight, fType);
+        int plots = 1;
+        float full = 0;
+        for (int i = 0; i < kGlyphCount; ++i) {
+            GrIPoint16 loc;
+            if (!rects->addRect(fSizes[i].fWidth, fSizes[i].fHeight, &loc)) {
+                if (totalFull) {
+                    full += rects->percentFull();
+                }
+                delete rects;
+                rects = GrRectanizer::Factory(kPlotWidth, kPlotHeight, fType);
+                rects->addRect(fSizes[i].fWidth, fSizes[i].fHeight, &loc);
+                plots += 1;
+            }
+        }
+        if (totalFull) {
+            *totalFull = full + rects->percentFull();
+        }
+        delete rects;
+        return plots;
+    }
+
+    typedef SkBenchmark INHERITED;
+};
+
+///////////////////////////////////////////////////////////////////////////////
+
+static SkBenchmark* Fact0(void* p) {
+    return new RectanizerBench(p, GrRectanizer::kPow2_Type, "pow2");
+}
+static SkBenchmark* Fact1(void* p) {
+    return new RectanizerBench(p, GrRectanizer::kSkyline_Type, "skyline");
+}
+
+static BenchRegistry gReg0(Fact0);
+static BenchRegistry gReg1(Fact1);
+
+#endif
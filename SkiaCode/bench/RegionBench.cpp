@@ -9,6 +9,7 @@
 #include "SkRandom.h"
 #include "SkRegion.h"
 #include "SkString.h"
+#include "SkTDArray.h"
 
 static bool union_proc(SkRegion& a, SkRegion& b) {
     SkRegion result;
@@ -117,6 +118,60 @@ private:
     typedef SkBenchmark INHERITED;
 };
 
+/**
+ *  Unions a frame's worth of damage rects, either by calling op() for each
+ *  one, or with a single batched op() that reuses a Scratch across frames.
+ */
+class RegionUnionRectsBench : public SkBenchmark {
+public:
+    enum {
+        W = 1024,
+        H = 768,
+        N = SkBENCHLOOP(10)
+    };
+
+    RegionUnionRectsBench(void* param, int count, bool batched)
+        : INHERITED(param)
+        , fBatched(batched) {
+        fName.printf("region_unionrects_%s_%d", batched ? "batched" : "serial",
+                     count);
+
+        SkRandom rand;
+        for (int i = 0; i < count; ++i) {
+            int x = rand.nextU() % W;
+            int y = rand.nextU() % H;
+            int w = 1 + rand.nextU() % 64;
+            int h = 1 + rand.nextU() % 32;
+            *fRects.append() = SkIRect::MakeXYWH(x, y, w, h);
+        }
+    }
+
+protected:
+    virtual const char* onGetName() { return fName.c_str(); }
+
+    virtual void onDraw(SkCanvas* canvas) {
+        for (int i = 0; i < N; ++i) {
+            SkRegion damage;
+            if (fBatched) {
+                damage.op(fRects.begin(), fRects.count(), SkRegion::kUnion_Op,
+                          &fScratch);
+            } else {
+                for (int j = 0; j < fRects.count(); ++j) {
+                    damage.op(fRects[j], SkRegion::kUnion_Op);
+                }
+            }
+        }
+    }
+
+private:
+    SkString            fName;
+    SkTDArray<SkIRect>  fRects;
+    SkRegion::Scratch   fScratch;
+    bool                fBatched;
+
+    typedef SkBenchmark INHERITED;
+};
+
 #define SMALL   16
 
 static SkBenchmark* gF0(void* p) { return SkNEW_ARGS(RegionBench, (p, SMALL, union_proc, "union")); }
@@ -128,6 +183,10 @@ static SkBenchmark* gF5(void* p) { return SkNEW_ARGS(RegionBench, (p, SMALL, con
 static SkBenchmark* gF6(void* p) { return SkNEW_ARGS(RegionBench, (p, SMALL, sectsrgn_proc, "intersectsrgn", 10)); }
 static SkBenchmark* gF7(void* p) { return SkNEW_ARGS(RegionBench, (p, SMALL, sectsrect_proc, "intersectsrect", 200)); }
 static SkBenchmark* gF8(void* p) { return SkNEW_ARGS(RegionBench, (p, SMALL, containsxy_proc, "containsxy")); }
+static SkBenchmark* gF9(void* p) { return SkNEW_ARGS(RegionUnionRectsBench, (p, 200, false)); }
+static SkBenchmark* gF10(void* p) { return SkNEW_ARGS(RegionUnionRectsBench, (p, 200, true)); }
+static SkBenchmark* gF11(void* p) { return SkNEW_ARGS(RegionUnionRectsBench, (p, 2000, false)); }
+static SkBenchmark* gF12(void* p) { return SkNEW_ARGS(RegionUnionRectsBench, (p, 2000, true)); }
 
 static BenchRegistry gR0(gF0);
 static BenchRegistry gR1(gF1);
@@ -138,3 +197,7 @@ static BenchRegistry gR5(gF5);
 static BenchRegistry gR6(gF6);
 static BenchRegistry gR7(gF7);
 static BenchRegistry gR8(gF8);
+static BenchRegistry gR9(gF9);
+static BenchRegistry gR10(gF10);
+static BenchRegistry gR11(gF11);
+static BenchRegistry gR12(gF12);
@@ -0,0 +1,95 @@
+
+/*
+ * Copyright 2012 Google Inc.
+ *
+ * Use of this source code is governed by a BSD-style license that can be
+ * found in the LICENSE file.
+ */
+
+#include "SkBenchmark.h"
+#include "SkPaint.h"
+#include "SkParallelFor.h"
+#include "SkPath.h"
+#include "SkRandom.h"
+#include "SkString.h"
+#include "SkStroke.h"
+#include "SkTemplates.h"
+
+/**
+ *  Strokes a polyline with hundreds of thousands of points, like a GIS track
+ *  or boundary, either in one pass or in chunks spread over four threads.
+ */
+class StrokePolylineBench : public SkBenchmark {
+    enum {
+        kPoints = 200 * 1000,
+        N       = SkBENCHLOOP(1)
+    };
+
+public:
+    StrokePolylineBench(void* param, SkPaint::Join join, bool threaded)
+        : INHERITED(param)
+        , fThreaded(threaded) {
+        fName.printf("stroke_polyline_%s_%s",
+                     SkPaint::kRound_Join == join ? "round" : "miter",
+                     threaded ? "threaded" : "serial");
+
+        fPaint.setStyle(SkPaint::kStroke_Style);
+        fPaint.setStrokeWidth(SkIntToScalar(3));
+        fPaint.setStrokeJoin(join);
+
+        // addPoly, since a lineTo per point validates the whole path each
+        // time in debug builds
+        SkAutoTMalloc<SkPoint> pts(kPoints);
+        SkRandom rand;
+        pts[0].set(0, 0);
+        for (int i = 1; i < kPoints; ++i) {
+            pts[i].set(pts[i - 1].fX + rand.nextSScalar1() * 10,
+                       pts[i - 1].fY + rand.nextSScalar1() * 10);
+        }
+        fPath.addPoly(pts.get(), kPoints, false);
+    }
+
+protected:
+    virtual const char* onGetName() SK_OVERRIDE {
+        return fName.c_str();
+    }
+
+    virtual void onDraw(SkCanvas*) SK_OVERRIDE {
+        SkStroke stroke(fPaint);
+        if (fThreaded) {
+            stroke.setParallelFor(SkThreadedFor);
+        }
+        for (int i = 0; i < N; ++i) {
+            SkPath dst;
+            stroke.strokePath(fPath, &dst);
+        }
+    }
+
+private:
+    SkString    fName;
+    SkPaint     fPaint;
+    SkPath      fPath;
+    bool        fThreaded;
+
+    typedef SkBenchmark INHERITED;
+};
+
+///////////////////////////////////////////////////////////////////////////////
+
+static SkBenchmark* Fact0(void* p) {
+    return new StrokePolylineBench(p, SkPaint::kMiter_Join, false);
+}
+static SkBenchmark* Fact1(void* p) {
+    return new StrokePolylineBench(p, SkPaint::kMiter_Join, true);
+}
+static SkBenchmark* Fact2(void* p) {
+    return new StrokePolylineBench(p, SkPaint::kRound_Join, false);
+}
+static SkBenchmark* Fact3(void* p) {
+    return new StrokePolylineBench(p, SkPaint::kRound_Join, true);
+}
+
+static BenchRegistry gReg0(Fact0);
+static BenchRegistry gReg1(Fact1);
+static BenchRegistry gReg2(Fact2);
+static BenchRegistry gReg3(Fact3);
@@ -9,7 +9,10 @@
 #include "TimerData.h"
 
 #include "BenchTimer.h"
+#include "SkStream.h"
+#include <algorithm>
 #include <limits>
+#include <math.h>
 
 using namespace std;
 
@@ -66,8 +69,26 @@ void TimerData::appendTimes(BenchTimer* timer, bool last) {
     fTruncatedCpuSum += timer->fTruncatedCpu;
     fGpuSum += timer->fGpu;
 
+    *fWallTimes.append() = timer->fWall;
+    *fCpuTimes.append() = timer->fCpu;
+    *fTruncatedWallTimes.append() = timer->fTruncatedWall;
+    *fTruncatedCpuTimes.append() = timer->fTruncatedCpu;
+    *fGpuTimes.append() = timer->fGpu;
+
+    const double counts[kCounterCount] = {
+        timer->fCycles, timer->fInstructions, timer->fCacheMisses, timer->fBranchMisses
+    };
+    for (int i = 0; i < kCounterCount; ++i) {
+        if (counts[i] >= 0) {
+            *fCounts[i].append() = counts[i];
+        }
+    }
 }
 
+static const char* gCounterNames[] = {
+    "cycles", "instructions", "cache_misses", "branch_misses"
+};
+
 SkString TimerData::getResult(bool logPerIter, bool printMin, int repeatDraw,
                               const char *configName, bool showWallTime, bool showTruncatedWallTime,
                               bool showCpuTime, bool showTruncatedCpuTime, bool showGpuTime) {
@@ -105,5 +126,186 @@ SkString TimerData::getResult(bool logPerIter, bool printMin, int repeatDraw,
     if (showGpuTime && fGpuSum > 0) {
         str += fGpuStr;
     }
+    for (int i = 0; i < kCounterCount; ++i) {
+        const SkTDArray<double>& counts = fCounts[i];
+        if (counts.isEmpty()) {
+            continue;
+        }
+        double result = printMin ? counts[0] : 0;
+        for (int j = 0; j < counts.count(); ++j) {
+            result = printMin ? Min(result, counts[j]) : result + counts[j] / counts.count();
+        }
+        str.appendf(" %s = %.0f", gCounterNames[i], result);
+    }
     return str;
 }
+
+// Samples further than this many scaled MADs from the median are outliers.
+static const double kOutlierMADs = 3.0;
+// Scales the MAD of normally distributed samples to their standard deviation.
+static const double kMADScale = 1.4826;
+
+static double sorted_median(const double sorted[], int count) {
+    SkASSERT(count > 0);
+    int half = count >> 1;
+    return (count & 1) ? sorted[half] : (sorted[half - 1] + sorted[half]) / 2;
+}
+
+static double scaled_mad(const double samples[], int count, double median) {
+    SkTDArray<double> deviations;
+    deviations.setCount(count);
+    for (int i = 0; i < count; ++i) {
+        deviations[i] = fabs(samples[i] - median);
+    }
+    sort(deviations.begin(), deviations.end());
+    return kMADScale * sorted_median(deviations.begin(), count);
+}
+
+void TimerData::ComputeStats(const double samples[], int count, Stats* stats) {
+    SkASSERT(stats != NULL);
+    memset(stats, 0, sizeof(Stats));
+    if (count <= 0) {
+        return;
+    }
+    SkTDArray<double> sorted;
+    sorted.append(count, samples);
+    sort(sorted.begin(), sorted.end());
+
+    // Reject the outliers, then summarize what is left. A MAD of zero means that more than half
+    // of the samples are equal, and only those are kept.
+    double median = sorted_median(sorted.begin(), count);
+    double limit = kOutlierMADs * scaled_mad(sorted.begin(), count, median);
+    int first = 0;
+    while (sorted[first] < median - limit) {
+        ++first;
+    }
+    int last = count - 1;
+    while (sorted[last] > median + limit) {
+        --last;
+    }
+    const double* kept = sorted.begin() + first;
+    int n = last - first + 1;
+    stats->fCount = n;
+    stats->fOutliers = count - n;
+    stats->fMedian = sorted_median(kept, n);
+    stats->fMAD = scaled_mad(kept, n, stats->fMedian);
+
+    // The (1-based) ranks bounding the median with 95% confidence, whatever the distribution of
+    // the samples: the number of samples below the median is binomial(n, 1/2), approximated by a
+    // normal distribution.
+    double spread = 0.98 * sqrt((double) n);
+    int low = (int) floor(n / 2.0 - spread) - 1;
+    int high = (int) ceil(n / 2.0 + 1 + spread) - 1;
+    stats->fLow = kept[SkMax32(low, 0)];
+    stats->fHigh = kept[SkMin32(high, n - 1)];
+}
+
+static void append_stats(SkString* str, const char* name, const SkTDArray<double>& samples) {
+    TimerData::Stats stats;
+    TimerData::ComputeStats(samples.begin(), samples.count(), &stats);
+    str->appendf(" %s = %.4g mad %.4g [%.4g, %.4g]", name, stats.fMedian, stats.fMAD,
+                 stats.fLow, stats.fHigh);
+    if (stats.fOutliers > 0) {
+        str->appendf(" (%d outliers)", stats.fOutliers);
+    }
+}
+
+SkString TimerData::getStatsResult(const char* configName, bool showWallTime,
+                                   bool showTruncatedWallTime, bool showCpuTime,
+                                   bool showTruncatedCpuTime, bool showGpuTime) {
+    SkString str;
+    str.printf("  %4s:", configName);
+    if (showWallTime) {
+        append_stats(&str, "msecs", fWallTimes);
+    }
+    if (showTruncatedWallTime) {
+        append_stats(&str, "Wmsecs", fTruncatedWallTimes);
+    }
+    if (showCpuTime) {
+        append_stats(&str, "cmsecs", fCpuTimes);
+    }
+    if (showTruncatedCpuTime) {
+        append_stats(&str, "Cmsecs", fTruncatedCpuTimes);
+    }
+    if (showGpuTime && fGpuSum > 0) {
+        append_stats(&str, "gmsecs", fGpuTimes);
+    }
+    for (int i = 0; i < kCounterCount; ++i) {
+        if (!fCounts[i].isEmpty()) {
+            Stats stats;
+            ComputeStats(fCounts[i].begin(), fCounts[i].count(), &stats);
+            str.appendf(" %s = %.0f", gCounterNames[i], stats.fMedian);
+        }
+    }
+    return str;
+}
+
+static void write_json_string(SkWStream* stream, const char str[]) {
+    SkString escaped("\"");
+    for (; *str; ++str) {
+        if ('"' == *str || '\\' == *str) {
+            escaped.append("\\");
+        }
+        if ((unsigned char) *str < 0x20) {
+            escaped.appendf("\\u%04x", *str);
+        } else {
+            escaped.append(str, 1);
+        }
+    }
+    escaped.append("\"");
+    stream->writeText(escaped.c_str());
+}
+
+static void write_json_timer(SkWStream* stream, bool* first, const char* name,
+                             const SkTDArray<double>& samples) {
+    TimerData::Stats stats;
+    TimerData::ComputeStats(samples.begin(), samples.count(), &stats);
+    SkString str;
+    str.printf("%s\n      \"%s\": { \"median\": %g, \"mad\": %g, \"ci_low\": %g, \"ci_high\": %g,"
+               " \"outliers\": %d,\n        \"samples\": [", *first ? "" : ",", name,
+               stats.fMedian, stats.fMAD, stats.fLow, stats.fHigh, stats.fOutliers);
+    stream->writeText(str.c_str());
+    for (int i = 0; i < samples.count(); ++i) {
+        str.printf("%s%g", i ? ", " : "", samples[i]);
+        stream->writeText(str.c_str());
+    }
+    stream->writeText("] }");
+    *first = false;
+}
+
+void TimerData::writeJSON(SkWStream* stream, const char* benchName, const char* configName,
+                          int loops, int warmups, bool showWallTime, bool showTruncatedWallTime,
+                          bool showCpuTime, bool showTruncatedCpuTime, bool showGpuTime) {
+    stream->writeText("    { \"bench\": ");
+    write_json_string(stream, benchName);
+    stream->writeText(", \"config\": ");
+    write_json_string(stream, configName);
+    SkString str;
+    str.printf(", \"loops\": %d, \"warmups\": %d,\n      \"timers\": {", loops, warmups);
+    stream->writeText(str.c_str());
+    bool first = true;
+    if (showWallTime) {
+        write_json_timer(stream, &first, "wall", fWallTimes);
+    }
+    if (showTruncatedWallTime) {
+        write_json_timer(stream, &first, "truncated_wall", fTruncatedWallTimes);
+    }
+    if (showCpuTime) {
+        write_json_timer(stream, &first, "cpu", fCpuTimes);
+    }
+    if (showTruncatedCpuTime) {
+        write_json_timer(stream, &first, "truncated_cpu", fTruncatedCpuTimes);
+    }
+    if (showGpuTime && fGpuSum > 0) {
+        write_json_timer(stream, &first, "gpu", fGpuTimes);
+    }
+    stream->writeText(" }");
+    first = true;
+    for (int i = 0; i < kCounterCount; ++i) {
+        if (!fCounts[i].isEmpty()) {
+            stream->writeText(first ? ",\n      \"counters\": {" : "");
+            write_json_timer(stream, &first, gCounterNames[i], fCounts[i]);
+        }
+    }
+    stream->writeText(first ? " }" : " } }");
+}
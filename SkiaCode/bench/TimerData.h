@@ -10,8 +10,10 @@
 #define TimerData_DEFINED
 
 #include "SkString.h"
+#include "SkTDArray.h"
 
 class BenchTimer;
+class SkWStream;
 
 class TimerData {
 public:
@@ -19,7 +21,8 @@ public:
 
     /**
      * Append the value from each timer in BenchTimer to our various strings, and update the
-     * minimum and sum times.
+     * minimum and sum times. Hardware counts are kept when the timer has them, and are printed
+     * after the times.
      * @param BenchTimer Must not be null.
      * @param last True if this is the last set of times to add.
      */
@@ -27,6 +30,38 @@ public:
     SkString getResult(bool logPerIter, bool printMin, int repeatDraw, const char* configName,
                        bool showWallTime, bool showTruncatedWallTime, bool showCpuTime,
                        bool showTruncatedCpuTime, bool showGpuTime);
+
+    /**
+     * Robust statistics of one timer's samples. Samples further than kOutlierMADs scaled median
+     * absolute deviations from the median are rejected as outliers; the median, its MAD and a
+     * distribution-free 95% confidence interval for the median describe the rest.
+     */
+    struct Stats {
+        int fCount;         // samples kept
+        int fOutliers;      // samples rejected
+        double fMedian;
+        double fMAD;        // scaled by 1.4826 to estimate the standard deviation
+        double fLow;        // confidence interval for the median
+        double fHigh;
+    };
+    static void ComputeStats(const double samples[], int count, Stats*);
+
+    /**
+     * Like getResult(), but print the median, MAD and confidence interval of each timer.
+     */
+    SkString getStatsResult(const char* configName, bool showWallTime, bool showTruncatedWallTime,
+                            bool showCpuTime, bool showTruncatedCpuTime, bool showGpuTime);
+
+    /**
+     * Write one JSON object with the statistics and samples of each shown timer, and of the
+     * hardware counts.
+     * @param loops The number of draws timed by each sample; the samples are per draw.
+     * @param warmups The number of samples discarded before the first one recorded.
+     */
+    void writeJSON(SkWStream*, const char* benchName, const char* configName, int loops,
+                   int warmups, bool showWallTime, bool showTruncatedWallTime, bool showCpuTime,
+                   bool showTruncatedCpuTime, bool showGpuTime);
+
 private:
     SkString fWallStr;
     SkString fTruncatedWallStr;
@@ -38,6 +73,21 @@ private:
     double fCpuSum, fCpuMin;
     double fTruncatedCpuSum, fTruncatedCpuMin;
     double fGpuSum, fGpuMin;
+    SkTDArray<double> fWallTimes;
+    SkTDArray<double> fTruncatedWallTimes;
+    SkTDArray<double> fCpuTimes;
+    SkTDArray<double> fTruncatedCpuTimes;
+    SkTDArray<double> fGpuTimes;
+
+    enum {
+        kCycles_Counter,
+        kInstructions_Counter,
+        kCacheMisses_Counter,
+        kBranchMisses_Counter,
+
+        kCounterCount
+    };
+    SkTDArray<double> fCounts[kCounterCount];
 
     SkString fPerIterTimeFormat;
     SkString fNormalTimeFormat;
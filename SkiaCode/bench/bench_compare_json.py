@@ -0,0 +1,158 @@
+'''
+Compares two runs of bench written with -json, and flags the benches whose
+times changed by more than chance explains.
+
+The samples of each timer and hardware counter in the old run are compared
+against the new run's with a two-sided Mann-Whitney U test, which does not
+assume the times are normally distributed. A change is reported when the test
+is significant and the medians moved by more than a threshold, so that tiny
+but consistent changes are not flagged.
+'''
+import sys
+import getopt
+import json
+import math
+
+def usage():
+    """Prints simple usage information."""
+
+    print('-o <file> the old bench -json output file.')
+    print('-n <file> the new bench -json output file.')
+    print('-a <alpha> the significance level. Default is 0.01.')
+    print('-t <fraction> the smallest change of the median reported.')
+    print('   Default is 0.02 (2%).')
+    print('-v print every bench, not only the significant changes.')
+    print('Exits with status 1 if any bench regressed.')
+
+class BenchTimes:
+    """The samples of one timer of one bench and config.
+
+    (str, str, str, {str:...})"""
+    def __init__(self, bench, config, time_type, timer):
+        self.bench = bench
+        self.config = config
+        self.time_type = time_type
+        self.median = timer['median']
+        self.samples = timer['samples']
+
+    def key(self):
+        return (self.bench, self.config, self.time_type)
+
+def parse(path):
+    """Returns {(bench, config, time_type): BenchTimes} from a -json file."""
+
+    with open(path, 'r') as f:
+        results = json.load(f)['results']
+    times = {}
+    for result in results:
+        counters = result.get('counters', {})
+        for time_type, timer in list(result['timers'].items()) + list(counters.items()):
+            bench_times = BenchTimes(result['bench'], result['config'],
+                                     time_type, timer)
+            times[bench_times.key()] = bench_times
+    return times
+
+def mann_whitney(old, new):
+    """Returns the two-sided p-value of a Mann-Whitney U test of the samples,
+    using the normal approximation with a correction for ties."""
+
+    n1 = len(old)
+    n2 = len(new)
+    if n1 == 0 or n2 == 0:
+        return 1.0
+    values = sorted([(x, 0) for x in old] + [(x, 1) for x in new])
+    n = n1 + n2
+    # rank the samples, giving tied samples the mean of their ranks
+    rank_sum = 0.0
+    tie_term = 0.0
+    i = 0
+    while i < n:
+        j = i
+        while j + 1 < n and values[j + 1][0] == values[i][0]:
+            j += 1
+        rank = (i + j) / 2.0 + 1
+        ties = j - i + 1
+        tie_term += ties ** 3 - ties
+        for k in range(i, j + 1):
+            if values[k][1] == 0:
+                rank_sum += rank
+        i = j + 1
+    u = rank_sum - n1 * (n1 + 1) / 2.0
+    mean = n1 * n2 / 2.0
+    variance = n1 * n2 / 12.0 * ((n + 1) - tie_term / (n * (n - 1.0)))
+    if variance <= 0:
+        return 1.0
+    z = (abs(u - mean) - 0.5) / math.sqrt(variance)
+    if z <= 0:
+        return 1.0
+    return math.erfc(z / math.sqrt(2))
+
+def main():
+    """Parses command line and writes output."""
+
+    try:
+        opts, _ = getopt.getopt(sys.argv[1:], "o:n:a:t:v")
+    except getopt.GetoptError as err:
+        print(str(err))
+        usage()
+        sys.exit(2)
+
+    old = None
+    new = None
+    alpha = 0.01
+    threshold = 0.02
+    verbose = False
+
+    for option, value in opts:
+        if option == "-o":
+            old = value
+        elif option == "-n":
+            new = value
+        elif option == "-a":
+            alpha = float(value)
+        elif option == "-t":
+            threshold = float(value)
+        elif option == "-v":
+            verbose = True
+        else:
+            usage()
+            assert False, "unhandled option"
+
+    if old is None or new is None:
+        usage()
+        sys.exit(2)
+
+    old_times = parse(old)
+    new_times = parse(new)
+
+    rows = []
+    for key in sorted(old_times.keys()):
+        if key not in new_times:
+            continue
+        old_bench = old_times[key]
+        new_bench = new_times[key]
+        diffp = 0
+        if old_bench.median != 0:
+            diffp = (new_bench.median - old_bench.median) / old_bench.median
+        p = mann_whitney(old_bench.samples, new_bench.samples)
+        verdict = ''
+        if p < alpha and abs(diffp) > threshold:
+            verdict = 'REGRESSION' if diffp > 0 else 'improvement'
+        if verdict or verbose:
+            rows.append((diffp, old_bench, new_bench, p, verdict))
+
+    rows.sort(key=lambda row : [-row[0], row[1].key()])
+    print('{0: >28} {1: <4} {2: <14} {3: >10} {4: >10} {5: >8} {6: >8}'.format(
+          'bench', 'conf', 'time', 'old', 'new', 'diffP', 'p'))
+    regressed = False
+    for diffp, old_bench, new_bench, p, verdict in rows:
+        print('{0: >28} {1: <4} {2: <14} {3: >10.4g} {4: >10.4g} {5: >+8.1%} {6: >8.2g} {7}'.format(
+              old_bench.bench, old_bench.config, old_bench.time_type,
+              old_bench.median, new_bench.median, diffp, p, verdict))
+        if verdict == 'REGRESSION':
+            regressed = True
+    if regressed:
+        sys.exit(1)
+
+if __name__ == "__main__":
+    main()
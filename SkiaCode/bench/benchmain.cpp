@@ -31,6 +31,7 @@
 #include "SkImageEncoder.h"
 #include "SkNWayCanvas.h"
 #include "SkPicture.h"
+#include "SkStream.h"
 #include "SkString.h"
 #include "TimerData.h"
 
@@ -347,9 +348,106 @@ static bool skip_name(const SkTDArray<const char*> array, const char name[]) {
     return true;
 }
 
+// Draw the bench loops times, timing the draws together, and scale the times to one draw.
+static void time_draws(BenchTimer* timer, SkBenchmark* bench, SkCanvas** canvas,
+                       benchModes benchMode, SkPicture* pictureRecordFrom,
+                       SkPicture* pictureRecordTo, const SkIPoint& dim, GLHelper* glHelper,
+                       int loops) {
+    bool record = benchMode == kRecord_benchModes || benchMode == kPictureRecord_benchModes;
+    if (record) {
+        // This will clear the recorded commands so that they do not
+        // acculmulate.
+        *canvas = pictureRecordTo->beginRecording(dim.fX, dim.fY);
+    }
+    timer->start();
+    for (int i = 0; i < loops; ++i) {
+        if (record && i > 0) {
+            *canvas = pictureRecordTo->beginRecording(dim.fX, dim.fY);
+        }
+        SkAutoCanvasRestore acr(*canvas, true);
+        if (benchMode == kPictureRecord_benchModes) {
+            pictureRecordFrom->draw(*canvas);
+        } else {
+            bench->draw(*canvas);
+        }
+        (*canvas)->flush();
+    }
+
+    // stop the truncated timer after the last canvas call but
+    // don't wait for all the GL calls to complete
+    timer->truncatedEnd();
+#if SK_SUPPORT_GPU
+    if (glHelper) {
+        glHelper->grContext()->flush();
+        SK_GL(*glHelper->glContext(), Finish());
+    }
+#endif
+    // stop the inclusive and gpu timers once all the GL calls
+    // have completed
+    timer->end();
+
+    if (loops > 1) {
+        timer->fWall /= loops;
+        timer->fTruncatedWall /= loops;
+        timer->fCpu /= loops;
+        timer->fTruncatedCpu /= loops;
+        timer->fGpu /= loops;
+        double* counts[] = {
+            &timer->fCycles, &timer->fInstructions, &timer->fCacheMisses, &timer->fBranchMisses
+        };
+        for (size_t i = 0; i < SK_ARRAY_COUNT(counts); ++i) {
+            if (*counts[i] > 0) {
+                *counts[i] /= loops;
+            }
+        }
+    }
+}
+
+static const int kMaxAutoTuneLoops = 1 << 20;
+static const int kMaxAutoTuneWarmups = 20;
+static const int kMinAutoTuneSamples = 10;
+// Warming up is over when a sample is within this fraction of the previous one.
+static const double kAutoTuneWarmupTolerance = 0.05;
+
+// Return the number of draws a sample needs to take at least targetMs of wall time, then keep
+// taking samples until two in a row agree, so that the caches are warm before timing starts.
+static int auto_tune(BenchTimer* timer, SkBenchmark* bench, SkCanvas** canvas,
+                     benchModes benchMode, SkPicture* pictureRecordFrom,
+                     SkPicture* pictureRecordTo, const SkIPoint& dim, GLHelper* glHelper,
+                     double targetMs, int* warmups) {
+    int loops = 1;
+    for (;;) {
+        time_draws(timer, bench, canvas, benchMode, pictureRecordFrom, pictureRecordTo, dim,
+                   glHelper, loops);
+        double sampleMs = timer->fWall * loops;
+        if (sampleMs >= targetMs || loops >= kMaxAutoTuneLoops) {
+            break;
+        }
+        // aim a little past the target, but don't trust a sample too short to measure
+        double next = loops * 100.0;
+        if (sampleMs * 100 > targetMs * 1.1) {
+            next = ceil(loops * targetMs * 1.1 / sampleMs);
+        }
+        loops = next < kMaxAutoTuneLoops ? (int) next : kMaxAutoTuneLoops;
+    }
+
+    double last = timer->fWall;
+    for (*warmups = 0; *warmups < kMaxAutoTuneWarmups; ) {
+        time_draws(timer, bench, canvas, benchMode, pictureRecordFrom, pictureRecordTo, dim,
+                   glHelper, loops);
+        ++*warmups;
+        if (fabs(timer->fWall - last) <= kAutoTuneWarmupTolerance * last) {
+            break;
+        }
+        last = timer->fWall;
+    }
+    return loops;
+}
+
 static void help() {
     SkDebugf("Usage: bench [-o outDir] [-repeat nr] [-logPerIter 1|0] "
                           "[-timers [wcgWC]*] [-rotate]\n"
+             "    [-autoTune ms] [-json filename] [-counters]\n"
              "    [-scale] [-clip] [-min] [-forceAA 1|0] [-forceFilter 1|0]\n"
              "    [-forceDither 1|0] [-forceBlend 1|0] [-strokeWidth width]\n"
              "    [-match name] [-mode normal|deferred|record|picturerecord]\n"
@@ -360,6 +458,15 @@ static void help() {
     SkDebugf("    -repeat nr : Each bench repeats for nr times.\n");
     SkDebugf("    -logPerIter 1|0 : "
              "Log each repeat timer instead of mean, default is disabled.\n");
+    SkDebugf("    -autoTune ms : Time enough draws in each repeat to take at least ms, after\n"
+             "                   warming up until the times settle. Report the median, median\n"
+             "                   absolute deviation and 95%% confidence interval of the\n"
+             "                   median, after rejecting outliers. Repeats at least %d times.\n",
+             kMinAutoTuneSamples);
+    SkDebugf("    -json filename : Write the statistics and times of each bench and config\n"
+             "                     to filename as JSON, for bench_compare_json.py.\n");
+    SkDebugf("    -counters : Also count CPU cycles, instructions, cache misses and branch\n"
+             "                misses per draw, where the system allows it.\n");
     SkDebugf("    -timers [wcgWC]* : "
              "Display wall, cpu, gpu, truncated wall or truncated cpu time for each bench.\n");
     SkDebugf("    -rotate : Rotate before each bench runs.\n");
@@ -403,6 +510,8 @@ int main (int argc, char * const argv[])
 
     SkTDict<const char*> defineDict(1024);
     int repeatDraw = 1;
+    double autoTuneMs = 0;
+    SkFILEWStream* jsonStream = NULL;
     bool logPerIter = false;
     int forceAlpha = 0xFF;
     bool forceAA = true;
@@ -412,6 +521,7 @@ int main (int argc, char * const argv[])
     bool truncatedTimerWall = false;
     bool timerCpu = true;
     bool truncatedTimerCpu = false;
+    bool counters = false;
     bool timerGpu = true;
     bool doScale = false;
     bool doRotate = false;
@@ -457,6 +567,10 @@ int main (int argc, char * const argv[])
 				{
                     repeatDraw = 1;
                 }
+                if (autoTuneMs > 0 && repeatDraw < kMinAutoTuneSamples) 
+				{
+                    repeatDraw = kMinAutoTuneSamples;
+                }
             } 
 			else 
 			{
@@ -464,6 +578,46 @@ int main (int argc, char * const argv[])
                 help();
                 return -1;
             }
+        } 
+		else if (strcmp(*argv, "-autoTune") == 0) 
+		{
+            argv++;
+            if (argv < stop && (autoTuneMs = atof(*argv)) > 0) 
+			{
+                if (repeatDraw < kMinAutoTuneSamples) 
+				{
+                    repeatDraw = kMinAutoTuneSamples;
+                }
+            } 
+			else 
+			{
+                logger.logError("-autoTune must be given a time > 0\n");
+                help();
+                return -1;
+            }
+        } 
+		else if (strcmp(*argv, "-json") == 0) 
+		{
+            argv++;
+            if (argv < stop) 
+			{
+                SkDELETE(jsonStream);
+                jsonStream = SkNEW_ARGS(SkFILEWStream, (*argv));
+                if (!jsonStream->isValid()) 
+				{
+                    SkString str;
+                    str.printf("Could not open %s for writing.", *argv);
+                    logger.logError(str);
+                    SkDELETE(jsonStream);
+                    return -1;
+                }
+            } 
+			else 
+			{
+                logger.logError("missing arg for -json\n");
+                help();
+                return -1;
+            }
         } 
 		else if (strcmp(*argv, "-logPerIter") == 0) 
 		{
@@ -502,6 +656,10 @@ int main (int argc, char * const argv[])
                 help();
                 return -1;
             }
+        } 
+		else if (!strcmp(*argv, "-counters")) 
+		{
+            counters = true;
         } 
 		else if (!strcmp(*argv, "-rotate")) 
 		{
@@ -730,6 +888,10 @@ int main (int argc, char * const argv[])
         str.appendf(" record=%d picturerecord=%d",
                     benchMode == kRecord_benchModes,
                     benchMode == kPictureRecord_benchModes);
+        if (autoTuneMs > 0) 
+		{
+            str.appendf(" autotune=%g", autoTuneMs);
+        }
         const char * ditherName;
         switch (forceDither) 
 		{
@@ -794,7 +956,17 @@ int main (int argc, char * const argv[])
 #endif // !defined(SK_SCALAR_IS_FIXED) && SK_SUPPORT_GPU
 
     BenchTimer timer = BenchTimer(timerCtx);
+    if (counters && !timer.enableCounters()) 
+	{
+        logger.logError("Hardware counters are not available, only timing.\n");
+    }
     Iter iter(&defineDict);
+    SkAutoTDelete<SkFILEWStream> jsonDelete(jsonStream);
+    bool firstJSONResult = true;
+    if (jsonStream) 
+	{
+        jsonStream->writeText("{ \"results\": [\n");
+    }
     SkBenchmark* bench;
     while ((bench = iter.next()) != NULL) 
 	{
@@ -895,8 +1067,22 @@ int main (int argc, char * const argv[])
                 performRotate(canvas, dim.fX, dim.fY);
             }
 
+            int loops = 1;
+            int warmups = 0;
+            if (autoTuneMs > 0) 
+			{
+#if SK_SUPPORT_GPU
+                if (glHelper) 
+				{
+                    // purge the GPU resources to reduce variance
+                    glHelper->grContext()->freeGpuResources();
+                }
+#endif
+                loops = auto_tune(&timer, bench, &canvas, benchMode, &pictureRecordFrom,
+                                  &pictureRecordTo, dim, glHelper, autoTuneMs, &warmups);
+            } 
             // warm up caches if needed
-            if (repeatDraw > 1) 
+            else if (repeatDraw > 1) 
 			{
 #if SK_SUPPORT_GPU
                 if (glHelper) 
@@ -928,50 +1114,36 @@ int main (int argc, char * const argv[])
             TimerData timerData(perIterTimeformat, normalTimeFormat);
             for (int i = 0; i < repeatDraw; i++) 
 			{
-                if ((benchMode == kRecord_benchModes
-                     || benchMode == kPictureRecord_benchModes)) 
-				{
-                    // This will clear the recorded commands so that they do not
-                    // acculmulate.
-                    canvas = pictureRecordTo.beginRecording(dim.fX, dim.fY);
-                }
-
-                timer.start();
-                SkAutoCanvasRestore acr(canvas, true);
-                if (benchMode == kPictureRecord_benchModes) 
-				{
-                    pictureRecordFrom.draw(canvas);
-                } 
-				else 
-				{
-                    bench->draw(canvas);
-                }
-                canvas->flush();
-
-                // stop the truncated timer after the last canvas call but
-                // don't wait for all the GL calls to complete
-                timer.truncatedEnd();
-#if SK_SUPPORT_GPU
-                if (glHelper) 
-				{
-                    glHelper->grContext()->flush();
-                    SK_GL(*glHelper->glContext(), Finish());
-                }
-#endif
-                // stop the inclusive and gpu timers once all the GL calls
-                // have completed
-                timer.end();
-
+                time_draws(&timer, bench, &canvas, benchMode, &pictureRecordFrom,
+                           &pictureRecordTo, dim, glHelper, loops);
                 timerData.appendTimes(&timer, repeatDraw - 1 == i);
-
             }
-            if (repeatDraw > 1) 
+            if (autoTuneMs > 0) 
+			{
+                SkString result = timerData.getStatsResult(configName, timerWall,
+                                                           truncatedTimerWall, timerCpu,
+                                                           truncatedTimerCpu, timerGpu && glHelper);
+                result.appendf(" loops = %d warmups = %d", loops, warmups);
+                logger.logProgress(result);
+            } 
+			else if (repeatDraw > 1) 
 			{
                 SkString result = timerData.getResult(logPerIter, printMin, repeatDraw, configName,
                                                       timerWall, truncatedTimerWall, timerCpu,
                                                       truncatedTimerCpu, timerGpu && glHelper);
                 logger.logProgress(result);
             }
+            if (jsonStream) 
+			{
+                if (!firstJSONResult) 
+				{
+                    jsonStream->writeText(",\n");
+                }
+                firstJSONResult = false;
+                timerData.writeJSON(jsonStream, bench->getName(), configName, loops, warmups,
+                                    timerWall, truncatedTimerWall, timerCpu, truncatedTimerCpu,
+                                    timerGpu && glHelper);
+            }
             if (outDir.size() > 0) 
 			{
                 saveFile(bench->getName(), configName, outDir.c_str(),
@@ -984,6 +1156,10 @@ int main (int argc, char * const argv[])
     // need to clean up here rather than post-main to allow leak detection to work
     gDebugGLHelper.cleanup();
 #endif
+    if (jsonStream) 
+	{
+        jsonStream->writeText("\n] }\n");
+    }
 	getchar();
     return 0;
 }
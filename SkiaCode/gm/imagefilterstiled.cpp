@@ -0,0 +1,139 @@
+/*
+ * Copyright 2012 Google Inc.
+ *
+ * Use of this source code is governed by a BSD-style license that can be
+ * found in the LICENSE file.
+ */
+
+#include "gm.h"
+#include "SkBlurImageFilter.h"
+#include "SkColorFilterImageFilter.h"
+#include "SkColorMatrixFilter.h"
+#include "SkLightingImageFilter.h"
+#include "SkMorphologyImageFilter.h"
+
+#define WIDTH 140
+#define HEIGHT 140
+
+static void serial_for(int count, void (*proc)(void*, int), void* context) {
+    for (int i = 0; i < count; ++i) {
+        proc(context, i);
+    }
+}
+
+namespace skiagm {
+
+// Draws each filter's result in one pass, then in tiles, then the pixels where
+// the two differ in red. The last column should always be black.
+class ImageFiltersTiledGM : public GM {
+public:
+    ImageFiltersTiledGM() {
+        this->setBGColor(0xFF000000);
+        fOnce = false;
+    }
+
+protected:
+    virtual SkString onShortName() {
+        return SkString("imagefilterstiled");
+    }
+
+    void make_bitmap() {
+        fBitmap.setConfig(SkBitmap::kARGB_8888_Config, WIDTH, HEIGHT);
+        fBitmap.allocPixels();
+        SkDevice device(fBitmap);
+        SkCanvas canvas(&device);
+        canvas.clear(0x0);
+        SkPaint paint;
+        paint.setAntiAlias(true);
+        const char* str1 = "ABC";
+        const char* str2 = "XYZ";
+        paint.setColor(0xFF40A0FF);
+        paint.setTextSize(64);
+        canvas.drawText(str1, strlen(str1), 10, 55, paint);
+        paint.setColor(0xFFFFC040);
+        canvas.drawText(str2, strlen(str2), 10, 110, paint);
+    }
+
+    void filter(SkImageFilter* filter, SkBitmap* dst) {
+        dst->setConfig(SkBitmap::kARGB_8888_Config, WIDTH, HEIGHT);
+        dst->allocPixels();
+        dst->eraseColor(0);
+        SkDevice device(*dst);
+        SkCanvas canvas(&device);
+        SkPaint paint;
+        paint.setImageFilter(filter);
+        canvas.drawSprite(fBitmap, 0, 0, &paint);
+    }
+
+    static void make_diff(const SkBitmap& a, const SkBitmap& b, SkBitmap* dst) {
+        dst->setConfig(SkBitmap::kARGB_8888_Config, WIDTH, HEIGHT);
+        dst->allocPixels();
+        SkAutoLockPixels alpA(a);
+        SkAutoLockPixels alpB(b);
+        for (int y = 0; y < HEIGHT; ++y) {
+            for (int x = 0; x < WIDTH; ++x) {
+                *dst->getAddr32(x, y) =
+                    *a.getAddr32(x, y) == *b.getAddr32(x, y) ?
+                    SkPreMultiplyColor(SK_ColorBLACK) :
+                    SkPreMultiplyColor(SK_ColorRED);
+            }
+        }
+    }
+
+    virtual SkISize onISize() {
+        return make_isize(3 * WIDTH, 5 * HEIGHT);
+    }
+
+    virtual void onDraw(SkCanvas* canvas) {
+        if (!fOnce) {
+            make_bitmap();
+            fOnce = true;
+        }
+
+        SkScalar matrix[20];
+        memset(matrix, 0, sizeof(matrix));
+        matrix[1] = matrix[7] = matrix[10] = matrix[18] = SK_Scalar1;
+        SkAutoTUnref<SkColorFilter> cf(SkNEW_ARGS(SkColorMatrixFilter, (matrix)));
+        SkPoint3 direction(SK_Scalar1, SK_Scalar1, SK_Scalar1);
+
+        SkImageFilter* filters[] = {
+            SkNEW_ARGS(SkBlurImageFilter, (SkIntToScalar(4), SkIntToScalar(4))),
+            SkNEW_ARGS(SkDilateImageFilter, (3, 3)),
+            SkNEW_ARGS(SkErodeImageFilter, (2, 2)),
+            SkNEW_ARGS(SkColorFilterImageFilter, (cf)),
+            SkLightingImageFilter::CreateDistantLitDiffuse(direction,
+                                                           SK_ColorWHITE,
+                                                           SK_Scalar1 * 2,
+                                                           SK_Scalar1),
+        };
+
+        for (size_t i = 0; i < SK_ARRAY_COUNT(filters); ++i) {
+            SkBitmap serial, tiled, diff;
+            SkImageFilter::SetParallelFor(NULL);
+            this->filter(filters[i], &serial);
+            // small tiles, so even this small image is split up
+            SkImageFilter::SetParallelFor(serial_for, 24);
+            this->filter(filters[i], &tiled);
+            SkImageFilter::SetParallelFor(NULL);
+            make_diff(serial, tiled, &diff);
+
+            SkScalar y = SkIntToScalar(i * HEIGHT);
+            canvas->drawBitmap(serial, 0, y);
+            canvas->drawBitmap(tiled, SkIntToScalar(WIDTH), y);
+            canvas->drawBitmap(diff, SkIntToScalar(2 * WIDTH), y);
+            filters[i]->unref();
+        }
+    }
+
+private:
+    typedef GM INHERITED;
+    SkBitmap fBitmap;
+    bool fOnce;
+};
+
+//////////////////////////////////////////////////////////////////////////////
+
+static GM* MyFactory(void*) { return new ImageFiltersTiledGM; }
+static GMRegistry reg(MyFactory);
+
+}
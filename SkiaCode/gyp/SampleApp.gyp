@@ -10,6 +10,7 @@
         '../gm',       # needed to pull gm.h
         '../samplecode', # To pull SampleApp.h and SampleCode.h
         '../src/pipe/utils', # For TiledPipeController
+        '../src/utils', # For SkCondVar and SkThread, used by ThreadedPipeController
       ],
       'includes': [
         'gmslides.gypi',
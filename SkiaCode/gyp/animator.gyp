@@ -161,6 +161,8 @@
         '../src/animator/SkScript2.h',
         '../src/animator/SkScriptCallBack.h',
         '../src/animator/SkScriptDecompile.cpp',
+        '../src/animator/SkScriptProgram.cpp',
+        '../src/animator/SkScriptProgram.h',
         '../src/animator/SkScriptRuntime.cpp',
         '../src/animator/SkScriptRuntime.h',
         '../src/animator/SkScriptTokenizer.cpp',
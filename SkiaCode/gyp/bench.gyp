@@ -10,16 +10,23 @@
       'type': 'executable',
       'include_dirs' : [
         '../src/core',
+        '../src/pipe/utils',
+        '../src/utils',
       ],
       'includes': [
         'bench.gypi'
       ],
+      'sources': [
+        # Needed for PipeBench.
+        '../src/pipe/utils/SamplePipeControllers.cpp',
+      ],
       'dependencies': [
         'core.gyp:core',
         'effects.gyp:effects',
         'images.gyp:images',
         'ports.gyp:ports',
         'utils.gyp:utils',
+        'xml.gyp:xml',
         'bench_timer',
       ],
       'conditions': [
@@ -48,6 +55,8 @@
         '../bench/BenchSysTimer_posix.cpp',
         '../bench/BenchSysTimer_windows.h',
         '../bench/BenchSysTimer_windows.cpp',
+        '../bench/BenchCounterTimer_linux.h',
+        '../bench/BenchCounterTimer_linux.cpp',
       ],
         'include_dirs': [
         '../src/core',
@@ -69,6 +78,12 @@
             '../bench/BenchSysTimer_posix.cpp',
           ],
         }],
+        [ 'skia_os not in ["linux", "android"]', {
+          'sources!': [
+            '../bench/BenchCounterTimer_linux.h',
+            '../bench/BenchCounterTimer_linux.cpp',
+          ],
+        }],
         [ 'skia_os in ["linux", "freebsd", "openbsd", "solaris"]', {
           'link_settings': {
             'libraries': [
@@ -26,6 +26,7 @@
         '../include/core',
         '../src/core',
         '../src/opts',
+        '../src/effects',
       ],
       'conditions': [
         [ 'skia_arch_type == "x86"', {
@@ -41,6 +42,7 @@
             '../src/opts/SkBitmapProcState_opts_SSE2.cpp',
             '../src/opts/SkBlitRow_opts_SSE2.cpp',
             '../src/opts/SkBlitRect_opts_SSE2.cpp',
+            '../src/opts/SkLightingRow_opts_SSE2.cpp',
             '../src/opts/SkUtils_opts_SSE2.cpp',
           ],
           'dependencies': [
@@ -78,6 +80,7 @@
           'sources': [
             '../src/opts/SkBitmapProcState_opts_none.cpp',
             '../src/opts/SkBlitRow_opts_none.cpp',
+            '../src/opts/SkLightingRow_opts_none.cpp',
             '../src/opts/SkUtils_opts_none.cpp',
           ],
         }],
@@ -6,6 +6,7 @@
       'include_dirs': [
         '../include/config',
         '../include/core',
+        '../include/effects',
         '../include/xml',
         '../include/utils',
         '../include/svg',
@@ -15,6 +16,7 @@
         '../include/svg/SkSVGBase.h',
         '../include/svg/SkSVGPaintState.h',
         '../include/svg/SkSVGParser.h',
+        '../include/svg/SkSVGPicture.h',
         '../include/svg/SkSVGTypes.h',
 
         '../src/svg/SkSVGCircle.cpp',
@@ -51,6 +53,7 @@
         '../src/svg/SkSVGParser.cpp',
         '../src/svg/SkSVGPath.cpp',
         '../src/svg/SkSVGPath.h',
+        '../src/svg/SkSVGPicture.cpp',
         '../src/svg/SkSVGPolygon.cpp',
         '../src/svg/SkSVGPolygon.h',
         '../src/svg/SkSVGPolyline.cpp',
@@ -33,6 +33,8 @@
         '../tests/ColorFilterTest.cpp',
         '../tests/ColorTest.cpp',
         '../tests/DataRefTest.cpp',
+        '../tests/DOMTest.cpp',
+        '../tests/DashPathEffectTest.cpp',
         '../tests/DeferredCanvasTest.cpp',
         '../tests/DequeTest.cpp',
         '../tests/DrawBitmapRectTest.cpp',
@@ -50,7 +52,12 @@
         '../tests/GpuBitmapCopyTest.cpp',
         '../tests/GrContextFactoryTest.cpp',
         '../tests/GradientTest.cpp',
+        '../tests/GrInOrderDrawBufferTest.cpp',
         '../tests/GrMemoryPoolTest.cpp',
+        '../tests/GrRectanizerTest.cpp',
+        '../tests/GrTDynamicHashTest.cpp',
+        '../tests/ImageFilterTest.cpp',
+        '../tests/ImageRefTest.cpp',
         '../tests/InfRectTest.cpp',
         '../tests/MathTest.cpp',
         '../tests/MatrixTest.cpp',
@@ -61,6 +68,7 @@
         '../tests/PaintTest.cpp',
         '../tests/ParsePathTest.cpp',
         '../tests/PathCoverageTest.cpp',
+        '../tests/PathMaskCacheTest.cpp',
         '../tests/PathMeasureTest.cpp',
         '../tests/PathTest.cpp',
         '../tests/PDFPrimitivesTest.cpp',
@@ -84,12 +92,15 @@
         '../tests/SrcOverTest.cpp',
         '../tests/StreamTest.cpp',
         '../tests/StringTest.cpp',
+        '../tests/StrokeTest.cpp',
+        '../tests/SVGPictureTest.cpp',
         '../tests/TDLinkedListTest.cpp',
         '../tests/Test.cpp',
         '../tests/Test.h',
         '../tests/TestSize.cpp',
         '../tests/TLSTest.cpp',
         '../tests/ToUnicode.cpp',
+        '../tests/TraceEventTest.cpp',
         '../tests/UnicodeTest.cpp',
         '../tests/UtilsTest.cpp',
         '../tests/WArrayTest.cpp',
@@ -107,8 +118,10 @@
         'images.gyp:images',
         'ports.gyp:ports',
         'pdf.gyp:pdf',
+        'svg.gyp:svg',
         'tools.gyp:picture_utils',
         'utils.gyp:utils',
+        'xml.gyp:xml',
       ],
       'conditions': [
         [ 'skia_gpu == 1', {
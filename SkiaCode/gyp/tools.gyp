@@ -20,6 +20,8 @@
         'skimage',
         'render_pictures',
         'bench_pictures',
+        'bench_svg',
+        'bench_animator',
         'pinspect',
       ],
     },
@@ -29,6 +31,9 @@
       'sources': [
         '../tools/skdiff_main.cpp',
       ],
+      'include_dirs': [
+        '../src/utils',
+      ],
       'dependencies': [
         'core.gyp:core',
         'effects.gyp:effects',
@@ -104,6 +109,47 @@
         'bench.gyp:bench_timer',
       ],
     },
+    {
+      'target_name': 'bench_svg',
+      'type': 'executable',
+      'sources': [
+        '../tools/bench_svg_main.cpp',
+      ],
+      'include_dirs': [
+        '../bench',
+      ],
+      'dependencies': [
+        'core.gyp:core',
+        'effects.gyp:effects',
+        'ports.gyp:ports',
+        'svg.gyp:svg',
+        'utils.gyp:utils',
+        'xml.gyp:xml',
+        'tools.gyp:picture_utils',
+        'bench.gyp:bench_timer',
+      ],
+    },
+    {
+      'target_name': 'bench_animator',
+      'type': 'executable',
+      'sources': [
+        '../tools/bench_animator_main.cpp',
+      ],
+      'include_dirs': [
+        '../bench',
+      ],
+      'dependencies': [
+        'animator.gyp:animator',
+        'core.gyp:core',
+        'effects.gyp:effects',
+        'images.gyp:images',
+        'ports.gyp:ports',
+        'utils.gyp:utils',
+        'views.gyp:views',
+        'xml.gyp:xml',
+        'bench.gyp:bench_timer',
+      ],
+    },
     {
      'target_name': 'picture_renderer',
      'type': 'static_library',
@@ -43,6 +43,8 @@
         '../src/utils/SkBitSet.h',
         '../src/utils/SkBoundaryPatch.cpp',
         '../src/utils/SkCamera.cpp',
+        '../src/utils/SkCondVar.cpp',
+        '../src/utils/SkCondVar.h',
         '../src/utils/SkCubicInterval.cpp',
         '../src/utils/SkCullPoints.cpp',
         '../src/utils/SkDeferredCanvas.cpp',
@@ -56,6 +58,8 @@
         '../src/utils/SkNWayCanvas.cpp',
         '../src/utils/SkNullCanvas.cpp',
         '../src/utils/SkOSFile.cpp',
+        '../src/utils/SkParallelFor.cpp',
+        '../src/utils/SkParallelFor.h',
         '../src/utils/SkParse.cpp',
         '../src/utils/SkParseColor.cpp',
         '../src/utils/SkParsePath.cpp',
@@ -15,6 +15,7 @@
 #include "SkEventSink.h"
 
 class SkAnimateMaker;
+class SkBitmap;
 class SkCanvas;
 class SkDisplayable;
 class SkEvent;
@@ -197,6 +198,22 @@ public:
     */
     DifferenceType draw(SkCanvas* canvas, SkMSec time);
 
+    /** Draws one frame of the animation into a bitmap kept by the animator,
+        using a new Paint each time. Only the drawing elements that intersect
+        the area that changed since the previous call are redrawn; the rest
+        of the bitmap is kept from earlier frames. Any event, or any change
+        made through the set functions, redraws the whole bitmap on the next
+        call, as does every frame if an <apply> animates an element outside
+        of its scope. Afterwards, getInvalBounds() returns the area that was
+        redrawn.
+        @param width  The width of the bitmap to draw into.
+        @param height  The height of the bitmap to draw into.
+        @param time  The offset into the current animation.
+        @return kNotDifferent if there are no active animations and nothing was redrawn;
+        otherwise kPartiallyDifferent.
+    */
+    DifferenceType drawRetained(int width, int height, SkMSec time);
+
     /** Experimental:
         Helper to choose whether to return a SkView::Click handler.
         @param x ignored
@@ -317,6 +334,9 @@ public:
     kIsPartiallyDifferent to do a mimimal inval(). */
     void getInvalBounds(SkRect* inval);
 
+    /** Returns the bitmap drawn into by drawRetained(). */
+    const SkBitmap& getRetainedBitmap() const;
+
     /** Returns the details of any error encountered while parsing the XML.
     */
     const SkXMLParserError* getParserError();
@@ -167,6 +167,13 @@
 */
 //#undef SK_USER_TRACE_INCLUDE_FILE
 
+/*  Define this to have SkTraceEvent record Skia's trace events (including
+    the SK_TRACE_SCOPE ones in the canvas, raster, glyph cache, image decoder
+    and PDF paths) for writing as Chrome trace-event JSON. Otherwise they
+    compile to nothing.
+ */
+//#define SK_ENABLE_TRACE_EVENTS
+
 /*  Change the ordering to work in X windows.
  */
 #ifdef SK_SAMPLES_FOR_X
@@ -10,7 +10,7 @@
 #ifndef SkGraphics_DEFINED
 #define SkGraphics_DEFINED
 
-#include "SkTypes.h"
+#include "SkThread.h"
 
 class SK_API SkGraphics {
 public:
@@ -61,6 +61,44 @@ public:
      */
     static void PurgeFontCache();
 
+    /**
+     *  Return the max number of bytes that should be used by the cache of
+     *  antialiased path masks. This max can be changed by calling
+     *  SetPathMaskCacheLimit().
+     */
+    static size_t GetPathMaskCacheLimit();
+
+    /**
+     *  Specify the max number of bytes that should be used by the path mask
+     *  cache. Zero, the default, disables the cache. Cached draws may differ
+     *  by one in coverage from uncached ones. Returns the previous setting.
+     */
+    static size_t SetPathMaskCacheLimit(size_t bytes);
+
+    /**
+     *  Return the number of bytes currently used by the path mask cache.
+     */
+    static size_t GetPathMaskCacheUsed();
+
+    /**
+     *  Purge all the cached path masks. This does not change the limit.
+     */
+    static void PurgePathMaskCache();
+
+    enum {
+        kDefaultStrokeSegmentsPerChunk = 4096
+    };
+
+    /**
+     *  If parallelFor is not NULL, every stroke built afterwards (including
+     *  those of canvas->drawPath()) splits runs of more than
+     *  2 * segmentsPerChunk lines into chunks of segmentsPerChunk lines, and
+     *  strokes the chunks with parallelFor. The stroked path is the same as
+     *  the one built in a single pass. This is off by default.
+     */
+    static void SetStrokeParallelFor(SkParallelForProc parallelFor,
+                                     int segmentsPerChunk = kDefaultStrokeSegmentsPerChunk);
+
     /**
      *  Applications with command line options may pass optional state, such
      *  as cache sizes, here, for instance:
@@ -9,6 +9,8 @@
 #define SkImageFilter_DEFINED
 
 #include "SkFlattenable.h"
+#include "SkSize.h"
+#include "SkThread.h"
 
 class SkBitmap;
 class SkDevice;
@@ -81,6 +83,28 @@ public:
      */
     bool filterBounds(const SkIRect& src, const SkMatrix& ctm, SkIRect* dst);
 
+    /**
+     *  Returns true if each pixel of the result depends only on the src
+     *  pixels within margin of it, and the result is the size of src with no
+     *  offset. Such filters can be run on src in tiles. See SetParallelFor().
+     */
+    bool filterMargin(const SkMatrix& ctm, SkISize* margin);
+
+    enum {
+        kDefaultTileSize = 256
+    };
+
+    /**
+     *  If parallelFor is not NULL, filterImage() splits the results of
+     *  filters that have a margin (see filterMargin()) into tiles of about
+     *  tileSize x tileSize pixels, filters each tile from the part of src
+     *  it depends on, and runs the tiles with parallelFor. The result is the
+     *  same as filtering src in one pass. This applies to every filter in
+     *  the process, and is off by default.
+     */
+    static void SetParallelFor(SkParallelForProc parallelFor,
+                               int tileSize = kDefaultTileSize);
+
     /**
      *  Returns true if the filter can be expressed a single-pass
      *  GrCustomStage, used to process this filter on the GPU, or false if
@@ -118,8 +142,16 @@ protected:
                                SkBitmap* result, SkIPoint* offset);
     // Default impl copies src into dst and returns true
     virtual bool onFilterBounds(const SkIRect&, const SkMatrix&, SkIRect*);
+    // Default impl returns false, so the filter is never run in tiles
+    virtual bool onFilterMargin(const SkMatrix&, SkISize* margin);
 
 private:
+    struct TileRec;
+
+    bool filterImageInTiles(const SkBitmap& src, const SkMatrix& ctm,
+                            SkBitmap* result);
+    static void FilterTileProc(void* context, int index);
+
     typedef SkFlattenable INHERITED;
 };
 
@@ -433,10 +433,14 @@ public:
         geometric perspective).
         @param src  input path
         @param dst  output path (may be the same as src)
+        @param cullRect if not NULL, only the part of dst inside this rect
+                    (in src's coordinates) will be drawn, so the path effect
+                    may leave out geometry that lies outside of it.
         @return     true if the path should be filled, or false if it should be
                     drawn with a hairline (width == 0)
     */
-    bool getFillPath(const SkPath& src, SkPath* dst) const;
+    bool getFillPath(const SkPath& src, SkPath* dst,
+                     const SkRect* cullRect = NULL) const;
 
     /** Get the paint's shader object.
         <p />
@@ -847,6 +847,9 @@ private:
     // called, if dirty, by getBounds()
     void computeBounds() const;
 
+    // identifies the path's points and verbs (but not its fill type)
+    int32_t getPathRefGenID() const;
+
     friend class Iter;
 
     friend class SkPathStroker;
@@ -873,6 +876,8 @@ private:
     inline bool hasOnlyMoveTos() const;
 
     friend class SkAutoPathBoundsUpdate;
+    friend class SkPathMaskCache;
+    friend class SkAAClipCache;
     friend class SkAutoDisableOvalCheck;
     friend class SkBench_AddPathTest; // perf test pathTo/reversePathTo
 };
@@ -12,6 +12,7 @@
 
 #include "SkFlattenable.h"
 #include "SkPaint.h"
+#include "SkTDArray.h"
 
 class SkPath;
 
@@ -123,6 +124,28 @@ public:
      */
     virtual bool filterPath(SkPath* dst, const SkPath& src, SkStrokeRec*) = 0;
 
+    /**
+     *  Same as filterPath(), except that the caller will only draw the part
+     *  of dst that falls inside cullRect (given in src's coordinates), so the
+     *  effect may leave out any geometry that (once stroked per the rec) lies
+     *  entirely outside of it. The default implementation ignores cullRect.
+     */
+    virtual bool filterPathInRect(SkPath* dst, const SkPath& src,
+                                  SkStrokeRec*, const SkRect& cullRect);
+
+    /**
+     *  Some effects, e.g. dashing a horizontal or vertical line, produce
+     *  geometry that, once stroked per rec, is just a list of non-overlapping
+     *  axis-aligned rectangles, which can be blitted directly. If this effect
+     *  can express src that way, append the rectangles (in src's coordinates)
+     *  to rects, append any pieces that aren't rectangles (already stroked,
+     *  to be filled) to fillPath, and return true. cullRect is as for
+     *  filterPathInRect(). The default implementation returns false.
+     */
+    virtual bool asRects(SkTDArray<SkRect>* rects, SkPath* fillPath,
+                         const SkPath& src, const SkStrokeRec& rec,
+                         const SkRect& cullRect);
+
     /**
      *  Compute a conservative bounds for its effect, given the src bounds.
      *  The baseline implementation just assigns src to dst.
@@ -70,7 +70,15 @@ public:
             clip-query calls will reflect the path's bounds, not the actual
             path.
          */
-        kUsePathBoundsForClip_RecordingFlag = 0x01
+        kUsePathBoundsForClip_RecordingFlag = 0x01,
+
+        /*  This flag records the draw calls in a compact form: indices and
+            counts are written as variable-length ints, and coordinates that
+            are whole numbers are delta-coded. The playback is identical, but
+            the picture is smaller (in memory and when serialized) at the cost
+            of decoding the values as they are played back.
+         */
+        kCompactOpStream_RecordingFlag = 0x02
     };
 
     /** Returns the canvas that records the drawing commands.
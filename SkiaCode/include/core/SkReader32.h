@@ -19,7 +19,8 @@ class SkString;
 
 class SkReader32 : SkNoncopyable {
 public:
-    SkReader32() : fCurr(NULL), fStop(NULL), fBase(NULL) {}
+    SkReader32() : fCurr(NULL), fStop(NULL), fBase(NULL),
+                   fPackedByte(NULL), fPackedStop(NULL) {}
     SkReader32(const void* data, size_t size)  {
         this->setMemory(data, size);
     }
@@ -30,6 +31,8 @@ public:
 
         fBase = fCurr = (const char*)data;
         fStop = (const char*)data + size;
+        fPackedByte = NULL;
+        fPackedStop = NULL;
     }
 
     uint32_t size() const { return SkToU32(fStop - fBase); }
@@ -41,12 +44,18 @@ public:
     uint32_t available() const { return SkToU32(fStop - fCurr); }
     bool isAvailable(uint32_t size) const { return fCurr + size <= fStop; }
 
-    void rewind() { fCurr = fBase; }
+    void rewind() {
+        fCurr = fBase;
+        fPackedByte = NULL;
+        fPackedStop = NULL;
+    }
 
     void setOffset(size_t offset) {
         SkASSERT(SkAlign4(offset) == offset);
         SkASSERT(offset <= this->size());
         fCurr = fBase + offset;
+        fPackedByte = NULL;
+        fPackedStop = NULL;
     }
 
     bool readBool() { return this->readInt() != 0; }
@@ -100,6 +109,29 @@ public:
         SkASSERT(fCurr <= fStop);
     }
 
+    /**
+     *  Read a variable-length int written by SkWriter32::writePackedUInt().
+     */
+    uint32_t readPackedUInt() {
+        uint32_t value = 0;
+        int shift = 0;
+        unsigned byte;
+        do {
+            byte = this->readPackedByte();
+            value |= (byte & 0x7F) << shift;
+            shift += 7;
+        } while (byte & 0x80);
+        return value;
+    }
+
+    /**
+     *  Read a signed value written by SkWriter32::writePackedInt().
+     */
+    int32_t readPackedInt() {
+        uint32_t value = this->readPackedUInt();
+        return (int32_t)(value >> 1) ^ -(int32_t)(value & 1);
+    }
+
     uint8_t readU8() { return (uint8_t)this->readInt(); }
     uint16_t readU16() { return (uint16_t)this->readInt(); }
     int32_t readS32() { return this->readInt(); }
@@ -142,6 +174,19 @@ private:
     const char* fStop;  // end of buffer
     const char* fBase;  // beginning of buffer
 
+    // the word of packed bytes being read (if any). It is only continued if
+    // nothing else has been read since, mirroring SkWriter32.
+    const uint8_t* fPackedByte;
+    const char*    fPackedStop;
+
+    unsigned readPackedByte() {
+        if (fCurr != fPackedStop || (const char*)fPackedByte >= fPackedStop) {
+            fPackedByte = (const uint8_t*)this->skip(sizeof(uint32_t));
+            fPackedStop = fCurr;
+        }
+        return *fPackedByte++;
+    }
+
 #ifdef SK_DEBUG
     static bool ptr_align_4(const void* ptr) {
         return (((const char*)ptr - (const char*)NULL) & 3) == 0;
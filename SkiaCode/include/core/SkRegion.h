@@ -14,6 +14,7 @@
 
 class SkPath;
 class SkRgnBuilder;
+class SkRgnSweeper;
 
 namespace android {
     class Region;
@@ -283,6 +284,44 @@ public:
      */
     bool op(const SkRegion& rgna, const SkRegion& rgnb, Op op);
 
+    /**
+     *  Working memory for the batched ops below. Passing the same Scratch to
+     *  successive calls (e.g. once per frame) lets them reuse its buffers
+     *  instead of allocating new ones each time.
+     */
+    class SK_API Scratch : SkNoncopyable {
+    public:
+        Scratch();
+        ~Scratch();
+
+    private:
+        SkRgnSweeper*   fSweeper;
+
+        SkRgnSweeper* sweeper();
+
+        friend class SkRegion;
+    };
+
+    /**
+     *  Set this region to the result of applying the Op to count regions in
+     *  turn: this = (rgns[0] op rgns[1] op ... op rgns[count-1]).
+     *  Union and intersect are computed in a single sweep over all of the
+     *  regions at once, which is much faster than calling op() in a loop.
+     *  Other ops are applied one at a time. If count is 0, this region is set
+     *  to empty. It is legal for this region to be one of the inputs.
+     *  Return true if the resulting region is non-empty.
+     */
+    bool op(const SkRegion* const rgns[], int count, Op op,
+            Scratch* scratch = NULL);
+
+    /**
+     *  Set this region to the result of applying the Op to count rectangles
+     *  in turn: this = (rects[0] op rects[1] op ... op rects[count-1]).
+     *  As above, union and intersect are computed in a single sweep.
+     *  Return true if the resulting region is non-empty.
+     */
+    bool op(const SkIRect rects[], int count, Op op, Scratch* scratch = NULL);
+
 #ifdef SK_BUILD_FOR_ANDROID
     /** Returns a new char* containing the list of rectangles in this region
      */
@@ -430,6 +469,7 @@ private:
     friend class Iterator;
     friend class Spanerator;
     friend class SkRgnBuilder;
+    friend class SkRgnSweeper;
     friend class SkFlatRegion;
 };
 
@@ -31,6 +31,14 @@ public:
 
 ****************/
 
+/** Calls proc(context, i) for each i in [0, count), in any order and possibly
+    on several threads at once, returning once all the calls have finished.
+    Core has no threads of its own, so APIs that can split their work take one
+    of these from the caller.
+*/
+typedef void (*SkParallelForProc)(int count, void (*proc)(void* context, int i),
+                                  void* context);
+
 class SkAutoMutexAcquire : SkNoncopyable {
 public:
     explicit SkAutoMutexAcquire(SkBaseMutex& mutex) : fMutex(&mutex) {
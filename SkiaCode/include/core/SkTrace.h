@@ -34,6 +34,20 @@
 
     #include SK_USER_TRACE_INCLUDE_FILE
 
+#elif defined(SK_ENABLE_TRACE_EVENTS)
+
+/* Skia's own trace events, recorded by SkTraceEvent. The arguments of
+   SK_TRACE_EVENT1 and SK_TRACE_EVENT2 are not recorded.
+*/
+    #include "SkTraceEvent.h"
+
+    #define SK_TRACE_EVENT0(event) \
+        SK_TRACE_SCOPE("skia", event)
+    #define SK_TRACE_EVENT1(event, name1, value1) \
+        SK_TRACE_SCOPE("skia", event)
+    #define SK_TRACE_EVENT2(event, name1, value1, name2, value2) \
+        SK_TRACE_SCOPE("skia", event)
+
 #else
 
     #define SK_TRACE_EVENT0(event)
@@ -42,6 +56,23 @@
 
 #endif
 
+/* SK_TRACE_SCOPE(category, name) traces the rest of the enclosing scope.
+   Both arguments are string literals; the category groups related events,
+   e.g. "skia.canvas" or "skia.raster". SK_ENABLE_TRACE_EVENTS records these
+   with SkTraceEvent, an SK_USER_TRACE_INCLUDE_FILE may define its own
+   SK_TRACE_SCOPE, and otherwise they are passed on to SK_TRACE_EVENT0.
+*/
+#ifndef SK_TRACE_SCOPE
+    #if defined(SK_ENABLE_TRACE_EVENTS) && !defined(SK_USER_TRACE_INCLUDE_FILE)
+        #define SK_TRACE_SCOPE_NAME2(line)  skAutoTraceEvent##line
+        #define SK_TRACE_SCOPE_NAME(line)   SK_TRACE_SCOPE_NAME2(line)
+        #define SK_TRACE_SCOPE(category, name) \
+            SkAutoTraceEvent SK_TRACE_SCOPE_NAME(__LINE__)(category, name)
+    #else
+        #define SK_TRACE_SCOPE(category, name) SK_TRACE_EVENT0(name)
+    #endif
+#endif
+
 #endif
 
 
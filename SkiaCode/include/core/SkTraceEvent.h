@@ -0,0 +1,86 @@
+
+/*
+ * Copyright 2012 Google Inc.
+ *
+ * Use of this source code is governed by a BSD-style license that can be
+ * found in the LICENSE file.
+ */
+
+#ifndef SkTraceEvent_DEFINED
+#define SkTraceEvent_DEFINED
+
+#include "SkThread.h"
+
+class SkWStream;
+
+/** \class SkTraceEvent
+
+    Records how long scopes marked with SK_TRACE_SCOPE (see SkTrace.h) take,
+    on every thread, and writes them in Chrome's trace-event JSON format, which
+    chrome://tracing displays as a timeline. SK_TRACE_SCOPE compiles to nothing
+    unless Skia is built with SK_ENABLE_TRACE_EVENTS; even then, a scope only
+    costs a plain read of a global until StartRecording() is called.
+
+    StartRecording(), StopRecording() and WriteJSON() must not be called while
+    other threads may be inside a traced scope.
+*/
+class SK_API SkTraceEvent {
+public:
+    enum {
+        /** Each thread records at most this many events; later ones are
+            dropped.
+        */
+        kMaxEventsPerThread = 64 * 1024
+    };
+
+    /** Discard the events recorded so far, and record new ones. Recording
+        must be stopped.
+    */
+    static void StartRecording();
+    static void StopRecording();
+
+    /** A plain load of an aligned int32_t, so it never tears; a scope that
+        races Start/StopRecording just records or skips one event.
+    */
+    static bool IsRecording() {
+        return 0 != *static_cast<volatile int32_t*>(&gRecording);
+    }
+
+    /** Write the recorded events as a JSON object with a "traceEvents" array.
+        Recording must be stopped. Return false if the stream fails.
+    */
+    static bool WriteJSON(SkWStream*);
+
+    /** Microseconds from an arbitrary origin. */
+    static double NowUSecs();
+
+    /** Record an event that started at start (from NowUSecs()) and ends now.
+        Category and name must be string literals, or otherwise live until the
+        events are written.
+    */
+    static void Add(const char category[], const char name[], double start);
+
+private:
+    static int32_t gRecording;
+};
+
+class SkAutoTraceEvent : SkNoncopyable {
+public:
+    SkAutoTraceEvent(const char category[], const char name[])
+            : fCategory(category), fName(name) {
+        fStart = SkTraceEvent::IsRecording() ? SkTraceEvent::NowUSecs() : -1;
+    }
+
+    ~SkAutoTraceEvent() {
+        if (fStart >= 0 && SkTraceEvent::IsRecording()) {
+            SkTraceEvent::Add(fCategory, fName, fStart);
+        }
+    }
+
+private:
+    const char* fCategory;
+    const char* fName;
+    double      fStart;
+};
+
+#endif
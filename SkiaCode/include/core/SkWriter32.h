@@ -39,7 +39,10 @@ public:
           fSingleBlockSize(0),
           fHead(NULL),
           fTail(NULL),
-          fHeadIsExternalStorage(false) {}
+          fHeadIsExternalStorage(false),
+          fPackedByte(NULL),
+          fPackedStop(NULL),
+          fPackedEnd(0) {}
 
     ~SkWriter32();
 
@@ -145,6 +148,28 @@ public:
 
     void writePad(const void* src, size_t size);
 
+    /**
+     *  Writes value as a variable-length int (7 bits per byte), which can be
+     *  read back with SkReader32::readPackedUInt(). Consecutive packed values
+     *  share 32-bit words; any other write starts on a fresh word, so the rest
+     *  of the stream stays 4-byte aligned.
+     */
+    void writePackedUInt(uint32_t value) {
+        do {
+            unsigned byte = value & 0x7F;
+            value >>= 7;
+            this->writePackedByte(value ? byte | 0x80 : byte);
+        } while (value);
+    }
+
+    /**
+     *  Writes a signed value (zig-zag encoded, so small negative values stay
+     *  small) that can be read back with SkReader32::readPackedInt().
+     */
+    void writePackedInt(int32_t value) {
+        this->writePackedUInt(((uint32_t)value << 1) ^ (value >> 31));
+    }
+
     /**
      *  Writes a string to the writer, which can be retrieved with
      *  SkReader32::readString().
@@ -194,6 +219,22 @@ private:
 
     bool fHeadIsExternalStorage;
 
+    // the partially filled word of packed bytes (if any), and fSize just after
+    // it was reserved, so we know if anything else has been written since
+    uint8_t*    fPackedByte;
+    uint8_t*    fPackedStop;
+    uint32_t    fPackedEnd;
+
+    void writePackedByte(unsigned byte) {
+        if (fPackedByte >= fPackedStop || fSize != fPackedEnd) {
+            fPackedByte = (uint8_t*)this->reserve(sizeof(uint32_t));
+            *(uint32_t*)fPackedByte = 0;
+            fPackedStop = fPackedByte + sizeof(uint32_t);
+            fPackedEnd = fSize;
+        }
+        *fPackedByte++ = SkToU8(byte);
+    }
+
     Block* newBlock(size_t bytes);
 
     SkDEBUGCODE(void validate() const;)
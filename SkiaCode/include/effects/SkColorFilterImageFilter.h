@@ -25,6 +25,7 @@ protected:
 
     virtual bool onFilterImage(Proxy*, const SkBitmap& src, const SkMatrix&,
                                SkBitmap* result, SkIPoint* loc) SK_OVERRIDE;
+    virtual bool onFilterMargin(const SkMatrix&, SkISize* margin) SK_OVERRIDE;
 
 private:
     SkColorFilter*  fColorFilter;
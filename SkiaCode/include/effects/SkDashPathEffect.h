@@ -42,6 +42,17 @@ public:
     virtual ~SkDashPathEffect();
 
     virtual bool filterPath(SkPath* dst, const SkPath& src, SkStrokeRec*) SK_OVERRIDE;
+    virtual bool filterPathInRect(SkPath* dst, const SkPath& src, SkStrokeRec*,
+                                  const SkRect& cullRect) SK_OVERRIDE;
+
+    /**
+     *  Dashing a horizontal or vertical line, or the outline of a rect, with
+     *  butt caps produces (mostly) rects. Dashes that turn a corner of the
+     *  rect are returned, stroked, in fillPath.
+     */
+    virtual bool asRects(SkTDArray<SkRect>* rects, SkPath* fillPath,
+                         const SkPath& src, const SkStrokeRec& rec,
+                         const SkRect& cullRect) SK_OVERRIDE;
 
     // overrides for SkFlattenable
     //  This method is not exported to java.
@@ -53,6 +64,9 @@ protected:
     virtual void flatten(SkFlattenableWriteBuffer&) const SK_OVERRIDE;
 
 private:
+    bool internalFilter(SkPath* dst, const SkPath& src, SkStrokeRec*,
+                        const SkRect* cullRect);
+
     SkScalar*   fIntervals;
     int32_t     fCount;
     // computed from phase
@@ -74,6 +74,7 @@ protected:
     SkLightingImageFilter(SkLight* light, SkScalar surfaceScale);
     explicit SkLightingImageFilter(SkFlattenableReadBuffer& buffer);
     virtual void flatten(SkFlattenableWriteBuffer&) const SK_OVERRIDE;
+    virtual bool onFilterMargin(const SkMatrix&, SkISize* margin) SK_OVERRIDE;
     const SkLight* light() const { return fLight; }
     SkScalar surfaceScale() const { return fSurfaceScale; }
 
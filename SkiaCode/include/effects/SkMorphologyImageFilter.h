@@ -22,6 +22,7 @@ protected:
 #if SK_SUPPORT_GPU
     virtual bool canFilterImageGPU() const SK_OVERRIDE { return true; }
 #endif
+    virtual bool onFilterMargin(const SkMatrix&, SkISize* margin) SK_OVERRIDE;
 
     SkISize    radius() const { return fRadius; }
 
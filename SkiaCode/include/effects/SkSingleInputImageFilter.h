@@ -29,6 +29,10 @@ protected:
     SkBitmap getInputResult(Proxy*, const SkBitmap& src, const SkMatrix&,
                             SkIPoint* offset);
 
+    // Sets margin to the margin of input (see filterMargin()), or to zero if
+    // there is no input. Returns false if input has no margin.
+    bool getInputMargin(const SkMatrix&, SkISize* margin);
+
 #if SK_SUPPORT_GPU
     // Recurses on input (if non-NULL), and returns the processed result as
     // a texture, otherwise returns src.
@@ -349,6 +349,15 @@ inline void GrCrash(const char* msg) { GrPrintf(msg); GrAlwaysAssert(false); }
     #define GR_DISABLE_DRAW_BUFFERING 0
 #endif
 
+/**
+ *  GR_DISABLE_DRAW_REORDERING prevents GrInOrderDrawBuffer from moving queued
+ *  draws past other non-overlapping draws in order to batch draws that share
+ *  the same state.
+ */
+#if !defined(GR_DISABLE_DRAW_REORDERING)
+    #define GR_DISABLE_DRAW_REORDERING 0
+#endif
+
 /**
  *  GR_AGGRESSIVE_SHADER_OPTS controls how aggressively shaders are optimized
  *  for special cases. On systems where program changes are expensive this
@@ -41,6 +41,13 @@
  */
 //#define GR_DISABLE_DRAW_BUFFERING 1
 
+/*
+ * This keeps GrInOrderDrawBuffer from reordering queued draws to batch draws
+ * with the same state. Draws are then played back in exactly the order they
+ * were made.
+ */
+//#define GR_DISABLE_DRAW_REORDERING 1
+
 /*
  * This causes more aggressive shader optimization. May hurt performance if
  * switching shaders is expensive.
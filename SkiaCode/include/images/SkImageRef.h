@@ -14,6 +14,7 @@
 #include "SkBitmap.h"
 #include "SkImageDecoder.h"
 #include "SkString.h"
+#include "SkThread.h"
 
 class SkImageRefPool;
 class SkStream;
@@ -60,6 +61,16 @@ public:
     // returns the factory parameter
     SkImageDecoderFactory* setDecoderFactory(SkImageDecoderFactory*);
 
+    /** Decode the pixels of count imagerefs ahead of drawing them. Each
+        imageref has its own mutex, so given a parallelFor, unrelated images
+        decode at the same time. If parallelFor is NULL, they are decoded one
+        after the other on this thread. Imagerefs in a pool are left unlocked,
+        so prefetching more than the pool's budget holds purges the first ones
+        again.
+    */
+    static void Prefetch(SkImageRef* const refs[], int count,
+                         SkParallelForProc parallelFor = NULL);
+
 protected:
     /** Override if you want to install a custom allocator.
         When this is called we will have already acquired the mutex!
@@ -95,9 +106,16 @@ private:
 
     friend class SkImageRefPool;
 
+    // fields below are owned by SkImageRefPool, and guarded by its mutex
     SkImageRef*  fPrev, *fNext;
+    size_t       fPoolRAM;      // bytes of our pixels the pool accounts for
+    bool         fPoolLocked;   // if true, the pool must not purge our pixels
     size_t ramUsed() const;
 
+    // each imageref gets its own mutex, so decodes of different images don't
+    // wait on each other
+    SkMutex fMutex;
+
     typedef SkPixelRef INHERITED;
 };
 
@@ -46,6 +46,7 @@ public:
     static void DumpPool();
 
 protected:
+    virtual void* onLockPixels(SkColorTable**);
     virtual bool onDecode(SkImageDecoder* codec, SkStream* stream,
                           SkBitmap* bitmap, SkBitmap::Config config,
                           SkImageDecoder::Mode mode);
@@ -36,6 +36,28 @@ public:
     */
     static SkMovie* DecodeMemory(const void* data, size_t length);
 
+    /** Movies whose frames are composited over the previous ones (e.g. GIF)
+        may keep copies of some composited frames, so that seeking backwards
+        (including every time the movie loops) starts from the nearest copy
+        rather than from the first frame. This sets the number of bytes that
+        each movie created afterwards may spend on these copies, and returns
+        the previous limit. Zero turns them off.
+    */
+    enum {
+        kDefaultKeyframeBudget = 256 * 1024
+    };
+    static size_t SetKeyframeBudget(size_t bytes);
+    static size_t GetKeyframeBudget();
+
+    /** If true, movies created afterwards keep a reference to their stream
+        and decode each frame from it when it is drawn, rather than holding
+        every decoded frame in memory. Such a stream must support rewind(),
+        and must be heap allocated, since the movie will ref() it. Returns the
+        previous setting, which starts out false.
+    */
+    static bool SetStreaming(bool);
+    static bool GetStreaming();
+
     SkMSec  duration();
     int     width();
     int     height();
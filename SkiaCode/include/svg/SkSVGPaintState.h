@@ -21,6 +21,7 @@ public:
         kClipRule,
         kEnableBackground,
         kFill,
+        kFillOpacity,
         kFillRule,
         kFilter,
         kFontFamily,
@@ -35,6 +36,7 @@ public:
         kStroke_Linecap,
         kStroke_Linejoin,
         kStroke_Miterlimit,
+        kStroke_Opacity,
         kStroke_Width,
         kStyle,
         kTransform,
@@ -54,6 +56,7 @@ public:
     SkString f_clipRule;
     SkString f_enableBackground;
     SkString f_fill;
+    SkString f_fillOpacity;
     SkString f_fillRule;
     SkString f_filter;
     SkString f_fontFamily;
@@ -68,6 +71,7 @@ public:
     SkString f_strokeLinecap;
     SkString f_strokeLinejoin;
     SkString f_strokeMiterlimit;
+    SkString f_strokeOpacity;
     SkString f_strokeWidth;
     SkString f_style; // unused, but allows array access to the rest
     SkString f_transform;
@@ -10,6 +10,7 @@
 #ifndef SkSVGParser_DEFINED
 #define SkSVGParser_DEFINED
 
+#include "SkColor.h"
 #include "SkMatrix.h"
 #include "SkTDict.h"
 #include "SkTDStack.h"
@@ -22,6 +23,7 @@
 
 class SkSVGBase;
 class SkSVGElement;
+class SkSVGPictureBuilder;
 
 class SkSVGParser : public SkXMLParser {
 public:
@@ -42,6 +44,12 @@ public:
     void translate(SkSVGElement*, bool isDef);
     void translateMatrix(SkString& , SkString* id);
     static void ConvertToArray(SkString& vals);
+    // Parse a number, which may have units (ignored) or be a percentage.
+    static SkScalar ParseScalar(const char str[]);
+    // Parse a named, #rgb, #rrggbb or rgb(...) color.
+    static bool ParseColor(const char str[], SkColor* color);
+    // Parse a list of transforms, such as "translate(10) rotate(45)".
+    static void ParseTransform(const char str[], SkMatrix* matrix);
 protected:
     virtual bool onAddAttribute(const char name[], const char value[]);
     bool onAddAttributeLen(const char name[], const char value[], size_t len);
@@ -65,10 +73,12 @@ private:
     SkDynamicMemoryWStream fStream;
     SkXMLStreamWriter fXMLWriter;
     SkSVGElement*   fCurrElement;
+    int fIgnoreDepth;   // > 0 inside elements that are skipped
     SkBool8 fInSVG;
     SkBool8 fSuppressPaint;
     friend class SkSVGPaint;
     friend class SkSVGGradient;
+    friend class SkSVGPictureBuilder;
 };
 
 #endif // SkSVGParser_DEFINED
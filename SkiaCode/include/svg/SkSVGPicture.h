@@ -0,0 +1,42 @@
+/*
+ * Copyright 2012 Google Inc.
+ *
+ * Use of this source code is governed by a BSD-style license that can be
+ * found in the LICENSE file.
+ */
+
+#ifndef SkSVGPicture_DEFINED
+#define SkSVGPicture_DEFINED
+
+#include "SkTypes.h"
+
+class SkPicture;
+class SkStream;
+class SkSVGParser;
+
+/** \class SkSVGPicture
+
+    Loads an SVG document by recording it straight into an SkPicture, instead
+    of translating it into animator XML as SkSVGParser::translate() does.
+    Shapes, paths, solid and gradient paints, strokes, transforms, opacity,
+    clip paths, <use> and plain text are drawn; filters, masks and images are
+    ignored.
+*/
+class SkSVGPicture {
+public:
+    /** Record the document into picture, at the size given by the document's
+        width and height (or its viewBox). If the document cannot be parsed,
+        return false and leave picture unchanged.
+    */
+    static bool DecodeMemory(const void* data, size_t length, SkPicture* picture);
+    static bool DecodeStream(SkStream* stream, SkPicture* picture);
+    static bool DecodeFile(const char path[], SkPicture* picture);
+
+    /** Record a document that parser has already parsed, e.g. from an SkDOM
+        or by being handed its elements one by one. Return false if it has no
+        size to record at.
+    */
+    static bool Record(SkSVGParser& parser, SkPicture* picture);
+};
+
+#endif
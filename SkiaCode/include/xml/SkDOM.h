@@ -14,6 +14,7 @@
 #include "SkScalar.h"
 #include "SkTemplates.h"
 
+class SkData;
 struct SkDOMNode;
 struct SkDOMAttr;
 
@@ -28,6 +29,14 @@ public:
     /** Returns null on failure
     */
     const Node* build(const char doc[], size_t len);
+
+    /** Builds the DOM without copying each name and value: the document is
+        copied once into the DOM's allocator, and names and values are
+        terminated in place inside that copy, next to the nodes. Only
+        elements and attributes are parsed; the document must be UTF-8.
+        Returns null on failure
+    */
+    const Node* build(SkData* doc);
     const Node* copy(const SkDOM& dom, const Node* node);
 
     const Node* getRootNode() const;
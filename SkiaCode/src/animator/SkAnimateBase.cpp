@@ -13,6 +13,7 @@
 #include "SkAnimatorScript.h"
 #include "SkDisplayApply.h"
 #include "SkDrawable.h"
+#include "SkScriptProgram.h"
 
 #if SK_USE_CONDENSED_INFO == 0
 
@@ -40,13 +41,14 @@ DEFINE_GET_MEMBER(SkAnimateBase);
 
 SkAnimateBase::SkAnimateBase() : begin(0), dur(1), repeat(SK_Scalar1),
         fApply(NULL), fFieldInfo(NULL), fFieldOffset(0), fStart((SkMSec) -1), fTarget(NULL),
-        fChanged(0), fDelayed(0), fDynamic(0), fHasEndEvent(0), fHasValues(0),
-        fMirror(0), fReset(0), fResetPending(0), fTargetIsScope(0) {
+        fFormulaProgram(NULL), fChanged(0), fDelayed(0), fDynamic(0), fHasEndEvent(0),
+        fHasValues(0), fMirror(0), fReset(0), fResetPending(0), fTargetIsScope(0) {
     blend.setCount(1);
     blend[0] = SK_Scalar1;
 }
 
 SkAnimateBase::~SkAnimateBase() {
+    delete fFormulaProgram;
     SkDisplayTypes type = fValues.getType();
     if (type == SkType_String || type == SkType_DynamicString) {
         SkASSERT(fValues.count() == 1);
@@ -70,6 +72,17 @@ void SkAnimateBase::dirty() {
     fChanged = true;
 }
 
+// formulas are evaluated every frame; most are plain arithmetic, and are
+// compiled once instead of being parsed again each time
+bool SkAnimateBase::evaluateFormula(SkAnimateMaker& maker, SkTDOperandArray* values) {
+    SkScriptProgram* program = SkScriptProgram::Compile(&fFormulaProgram, maker, NULL,
+        fFieldInfo->getType(), formula);
+    SkScriptValue value;
+    if (program && program->run(&value))
+        return fFieldInfo->setValue(maker, values, 0, 0, NULL, getValuesType(), *program, value);
+    return fFieldInfo->setValue(maker, values, 0, 0, NULL, getValuesType(), formula);
+}
+
 #ifdef SK_DUMP_ENABLED
 void SkAnimateBase::dump(SkAnimateMaker* maker) {
     dumpBase(maker);
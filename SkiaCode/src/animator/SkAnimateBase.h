@@ -17,6 +17,7 @@
 
 class SkApply;
 class SkDrawable;
+class SkScriptProgram;
 
 class SkAnimateBase : public SkDisplayable {
 public:
@@ -30,6 +31,7 @@ public:
     virtual void dump(SkAnimateMaker* );
 #endif
     int entries() { return fValues.count() / components(); }
+    bool evaluateFormula(SkAnimateMaker& , SkTDOperandArray* values);
     virtual bool hasExecute() const;
     bool isDynamic() const { return SkToBool(fDynamic); }
     virtual SkDisplayable* getParent() const;
@@ -63,6 +65,7 @@ protected:
     int fFieldOffset;
     SkMSec fStart;  // corrected time when this apply was enabled
     SkDrawable* fTarget;
+    SkScriptProgram* fFormulaProgram;   // formula, compiled the first time it's evaluated
     SkTypedArray fValues;
     unsigned fChanged : 1; // true when value referenced by script has changed
     unsigned fDelayed : 1;  // enabled, but undrawn pending delay
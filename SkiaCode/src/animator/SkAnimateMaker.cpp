@@ -31,7 +31,7 @@ SkAnimateMaker::SkAnimateMaker(SkAnimator* animator, SkCanvas* canvas, SkPaint*
     : fActiveEvent(NULL), fAdjustedStart(0), fCanvas(canvas), fEnableTime(0),
         fHostEventSinkID(0), fMinimumInterval((SkMSec) -1), fPaint(paint), fParentMaker(NULL),
         fTimeline(&gDefaultTimeline), fInInclude(false), fInMovie(false),
-        fFirstScriptError(false), fLoaded(false), fIDs(256), fAnimator(animator)
+        fFirstScriptError(false), fLoaded(false), fIDs(256), fScriptGeneration(0), fAnimator(animator)
 {
     fScreenplay.time = 0;
 #if defined SK_DEBUG && defined SK_DEBUG_ANIMATION_TIMING
@@ -68,6 +68,7 @@ void SkAnimateMaker::clearExtraPropertyCallBack(SkDisplayTypes type) {
         if (extra->definesType(type)) {
             extra->fExtraCallBack = NULL;
             extra->fExtraStorage = NULL;
+            fScriptGeneration++;
             break;
         }
     }
@@ -241,6 +242,7 @@ void SkAnimateMaker::loadMovies() {
 #endif
 
 void SkAnimateMaker::notifyInval() {
+    fDisplayList.invalRetained();
     if (fHostEventSinkID)
         fAnimator->onEventPost(new SkEvent(SK_EventType_Inval), fHostEventSinkID);
 }
@@ -264,6 +266,7 @@ void SkAnimateMaker::reset() {
     fChildren.reset();
     fHelpers.reset();
     fIDs.reset();
+    fScriptGeneration++;
     fEvents.reset();
     fDisplayList.hardReset();
 }
@@ -338,6 +341,7 @@ void SkAnimateMaker::setExtraPropertyCallBack(SkDisplayTypes type,
         if (extra->definesType(type)) {
             extra->fExtraCallBack = callBack;
             extra->fExtraStorage = userStorage;
+            fScriptGeneration++;
             break;
         }
     }
@@ -345,6 +349,7 @@ void SkAnimateMaker::setExtraPropertyCallBack(SkDisplayTypes type,
 
 void SkAnimateMaker::setID(SkDisplayable* displayable, const SkString& newID) {
     fIDs.set(newID.c_str(), displayable);
+    fScriptGeneration++;
 #ifdef SK_DEBUG
     displayable->_id.set(newID);
     displayable->id = displayable->_id.c_str();
@@ -77,11 +77,14 @@ public:
     SkXMLParserError::ErrorCode getErrorCode() const { return fError.getErrorCode(); }
     SkMSec getInTime() { return fDisplayList.getTime(); }
     int getNativeCode() const { return fError.getNativeCode(); }
+    // changes whenever ids or extras change what a name in a script refers to
+    int getScriptGeneration() const { return fScriptGeneration; }
     bool hasError() { return fError.hasError(); }
     void helperAdd(SkDisplayable* trackMe);
     void helperRemove(SkDisplayable* alreadyTracked);
     void idsSet(const char* attrValue, size_t len, SkDisplayable* displayable) {
-        fIDs.set(attrValue, len, displayable); }
+        fIDs.set(attrValue, len, displayable);
+        fScriptGeneration++; }
 //  void loadMovies();
     void notifyInval();
     void notifyInvalTime(SkMSec time);
@@ -143,6 +146,7 @@ private:
     SkBool8 fLoaded;
     SkTDDisplayableArray fMovies;
     SkTDict<SkDisplayable*> fIDs;
+    int fScriptGeneration;
     SkAnimator* fAnimator;
     friend class SkAdd;
     friend class SkAnimateBase;
@@ -155,6 +159,7 @@ private:
     friend class SkEvents;
     friend class SkGroup;
     friend struct SkMemberInfo;
+    friend class SkScriptProgram;
 };
 
 #endif // SkAnimateMaker_DEFINED
@@ -61,12 +61,14 @@ bool SkAnimator::appendStream(SkStream* stream) {
 bool SkAnimator::decodeMemory(const void* buffer, size_t size)
 {
     fMaker->fFileName.reset();
+    fMaker->fDisplayList.invalRetained();
     SkDisplayXMLParser parser(*fMaker);
     return parser.parse((const char*)buffer, size);
 }
 
 bool SkAnimator::decodeStream(SkStream* stream)
 {
+    fMaker->fDisplayList.invalRetained();
     SkDisplayXMLParser parser(*fMaker);
     bool result = parser.parse(*stream);
     fMaker->setErrorString();
@@ -76,6 +78,7 @@ bool SkAnimator::decodeStream(SkStream* stream)
 bool SkAnimator::decodeDOM(const SkDOM& dom, const SkDOMNode* node)
 {
     fMaker->fFileName.reset();
+    fMaker->fDisplayList.invalRetained();
     SkDisplayXMLParser parser(*fMaker);
     return parser.parse(dom, node);
 }
@@ -161,6 +164,17 @@ SkAnimator::DifferenceType SkAnimator::draw(SkCanvas* canvas, SkMSec time) {
     return draw(canvas, &paint, time);
 }
 
+SkAnimator::DifferenceType SkAnimator::drawRetained(int width, int height, SkMSec time) {
+    SkPaint paint;
+    fMaker->fScreenplay.time = time;
+    fMaker->fPaint = &paint;
+    bool animating = fMaker->fDisplayList.drawRetained(*fMaker, time, width, height);
+    fMaker->fDisplayList.fHasUnion = true;
+    if (animating == false && fMaker->fDisplayList.fInvalBounds.isEmpty())
+        return kNotDifferent;
+    return kPartiallyDifferent;
+}
+
 #ifdef SK_DEBUG
 void SkAnimator::eventDone(const SkEvent& ) {
 }
@@ -379,6 +393,10 @@ const char* SkAnimator::getString(const char* id, const char* fieldID) {
     return getString(element, field);
 }
 
+const SkBitmap& SkAnimator::getRetainedBitmap() const {
+    return fMaker->fDisplayList.getRetained();
+}
+
 const char* SkAnimator::getURIBase() {
     return fMaker->fPrefix.c_str();
 }
@@ -498,6 +516,7 @@ void SkAnimator::onEventPostTime(SkEvent* evt, SkEventSinkID sinkID, SkMSec time
 
 void SkAnimator::reset() {
     fMaker->fDisplayList.reset();
+    fMaker->fDisplayList.invalRetained();
 }
 
 SkEventSinkID SkAnimator::getHostEventSinkID() const {
@@ -547,6 +566,7 @@ bool SkAnimator::setArray(SkDisplayable* element, const SkMemberInfo* info, SkTy
     if (type == SkType_Array) {
         SkDisplayArray* dispArray = (SkDisplayArray*) element;
         dispArray->values = array;
+        fMaker->fDisplayList.invalRetained();
         return true;
     }
     else
@@ -576,6 +596,7 @@ bool SkAnimator::setInt(SkDisplayable* element, const SkMemberInfo* info, int32_
         scriptValue.fOperand.fS32 = s32;
         element->setProperty(info->propertyIndex(), scriptValue);
     }
+    fMaker->fDisplayList.invalRetained();
     return true;
 }
 
@@ -601,6 +622,7 @@ bool SkAnimator::setScalar(SkDisplayable* element, const SkMemberInfo* info, SkS
         scriptValue.fOperand.fScalar = scalar;
         element->setProperty(info->propertyIndex(), scriptValue);
     }
+    fMaker->fDisplayList.invalRetained();
     return true;
 }
 
@@ -618,6 +640,7 @@ bool SkAnimator::setString(SkDisplayable* element,
         const SkMemberInfo* info, const char* str) {
     // !!! until this is fixed, can't call script with global references from here
     info->setValue(*fMaker, NULL, 0, info->fCount, element, info->getType(), str, strlen(str));
+    fMaker->fDisplayList.invalRetained();
     return true;
 }
 
@@ -65,6 +65,7 @@ protected:
     SkDisplayable* fWorking;
 private:
     friend class SkDump;
+    friend class SkScriptProgram;
     friend struct SkScriptNAnswer;
 #ifdef SK_SUPPORT_UNITTEST
 public:
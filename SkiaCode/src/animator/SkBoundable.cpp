@@ -40,8 +40,10 @@ void SkBoundable::enableBounder() {
 
 
 SkBoundableAuto::SkBoundableAuto(SkBoundable* boundable,
-        SkAnimateMaker& maker) : fBoundable(boundable), fMaker(maker) {
+        SkAnimateMaker& maker) : fBoundable(boundable), fMaker(maker), fSaveBounder(NULL) {
     if (fBoundable->hasBounds()) {
+        fSaveBounder = fMaker.fCanvas->getBounder();
+        SkSafeRef(fSaveBounder);
         fMaker.fCanvas->setBounder(&maker.fDisplayList);
         fMaker.fDisplayList.fBounds.setEmpty();
     }
@@ -50,7 +52,8 @@ SkBoundableAuto::SkBoundableAuto(SkBoundable* boundable,
 SkBoundableAuto::~SkBoundableAuto() {
     if (fBoundable->hasBounds() == false)
         return;
-    fMaker.fCanvas->setBounder(NULL);
+    fMaker.fCanvas->setBounder(fSaveBounder);
+    SkSafeUnref(fSaveBounder);
     fBoundable->setBounds(fMaker.fDisplayList.fBounds);
 }
 
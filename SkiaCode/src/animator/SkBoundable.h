@@ -13,6 +13,8 @@
 #include "SkDrawable.h"
 #include "SkRect.h"
 
+class SkBounder;
+
 class SkBoundable : public SkDrawable {
 public:
     SkBoundable();
@@ -35,6 +37,7 @@ public:
 private:
     SkBoundable* fBoundable;
     SkAnimateMaker& fMaker;
+    SkBounder* fSaveBounder;
     SkBoundableAuto& operator= (const SkBoundableAuto& );
 };
 
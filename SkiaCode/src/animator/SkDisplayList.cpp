@@ -11,6 +11,7 @@
 #include "SkAnimateActive.h"
 #include "SkAnimateBase.h"
 #include "SkAnimateMaker.h"
+#include "SkCanvas.h"
 #include "SkDisplayApply.h"
 #include "SkDrawable.h"
 #include "SkDrawGroup.h"
@@ -18,7 +19,8 @@
 #include "SkInterpolator.h"
 #include "SkTime.h"
 
-SkDisplayList::SkDisplayList() : fDrawBounds(true), fUnionBounds(false), fInTime(0) {
+SkDisplayList::SkDisplayList() : fDrawBounds(true), fUnionBounds(false), fInTime(0),
+    fEntry(-1), fRetainedInval(true), fSelfContained(false) {
 }
 
 SkDisplayList::~SkDisplayList() {
@@ -34,10 +36,7 @@ bool SkDisplayList::draw(SkAnimateMaker& maker, SkMSec inTime) {
     bool result = false;
     fInvalBounds.setEmpty();
     if (fDrawList.count()) {
-        for (SkActive** activePtr = fActiveList.begin(); activePtr < fActiveList.end(); activePtr++) {
-            SkActive* active = *activePtr;
-            active->reset();
-        }
+        resetActives();
         for (int index = 0; index < fDrawList.count(); index++) {
             SkDrawable* draw = fDrawList[index];
             draw->initialize(); // allow matrices to reset themselves
@@ -50,6 +49,159 @@ bool SkDisplayList::draw(SkAnimateMaker& maker, SkMSec inTime) {
     return result;
 }
 
+// Returns true if an apply within draw may change what other entries draw:
+// either it animates an element outside of its scope, such as a paint or
+// matrix shared with other entries, or its scope can be used by id elsewhere.
+bool SkDisplayList::ChangesOtherEntries(SkAnimateMaker& maker, SkDrawable* draw) {
+    if (draw->isApply()) {
+        SkApply* apply = (SkApply*) draw;
+        SkDrawable* scope = apply->getScope();
+        const char* id;
+        if (scope != NULL && maker.findKey(scope, &id))
+            return true;
+        for (int index = 0; index < apply->fAnimators.count(); index++) {
+            SkDrawable* target = apply->getTarget(apply->fAnimators[index]);
+            if (target != NULL && target != scope && (scope == NULL ||
+                    scope->contains(target) == false))
+                return true;
+        }
+        return scope != NULL && ChangesOtherEntries(maker, scope);
+    }
+    if (draw->isGroup()) {
+        SkTDDrawableArray* children = ((SkGroup*) draw)->getChildren();
+        for (int index = 0; index < children->count(); index++) {
+            if (ChangesOtherEntries(maker, (*children)[index]))
+                return true;
+        }
+    }
+    return false;
+}
+
+// Finds the area of the retained bitmap to redraw from the entry bounds of
+// this frame and the last. Returns false if all of it must be redrawn.
+bool SkDisplayList::dirtyBounds(SkIRect* dirty) {
+    dirty->setEmpty();
+    for (int index = 0; index < fDrawList.count(); index++) {
+        const SkIRect& bounds = fEntryBounds[index];
+        const SkIRect& last = fLastEntryBounds[index];
+        uint8_t flags = fEntryFlags[index];
+        if (((flags | fLastEntryFlags[index]) & kAnimating_EntryFlag) == 0) {
+            if (bounds != last) {
+                dirty->join(last);
+                dirty->join(bounds);
+            }
+            continue;
+        }
+        // an animated entry that draws nothing we can see, or that changes
+        // the canvas or paint for later entries, may change any part of it
+        if ((flags & kStateful_EntryFlag) || (bounds.isEmpty() && last.isEmpty()))
+            return false;
+        dirty->join(last);
+        dirty->join(bounds);
+    }
+    if (dirty->intersect(0, 0, fRetained.width(), fRetained.height()) == false)
+        dirty->setEmpty();
+    return true;
+}
+
+// Draws the entries into the retained bitmap. The entries are first drawn
+// with this as the bounder to find their device bounds, and then only those
+// that intersect the area that changed since the last call are redrawn.
+// Drawing an entry twice in a frame is only safe if no later entry changes
+// what it draws, so if an apply may do that, every entry is drawn once, as
+// draw() does. Returns true if any entry is animating; fInvalBounds is set
+// to the area that was redrawn.
+//
+// Clipping changes how the edges of antialiased paths are scan converted, so
+// the entries are redrawn whole into fScratch, clipped only to their own
+// bounds, and then just the dirty area is copied into the retained bitmap.
+bool SkDisplayList::drawRetained(SkAnimateMaker& maker, SkMSec inTime,
+        int width, int height) {
+    validate();
+    if (fRetained.width() != width || fRetained.height() != height) {
+        fRetained.setConfig(SkBitmap::kARGB_8888_Config, width, height);
+        fRetained.allocPixels();
+        fScratch.setConfig(SkBitmap::kARGB_8888_Config, width, height);
+        fScratch.allocPixels();
+        fRetainedInval = true;
+    }
+    int count = fDrawList.count();
+    bool drawAll = fRetainedInval || fLastDrawList.count() != count ||
+        memcmp(fLastDrawList.begin(), fDrawList.begin(), count * sizeof(SkDrawable*));
+    if (drawAll) {
+        fSelfContained = true;
+        for (int index = 0; index < count; index++) {
+            if (ChangesOtherEntries(maker, fDrawList[index])) {
+                fSelfContained = false;
+                break;
+            }
+        }
+    }
+    fRetainedInval = false;
+    fLastDrawList = fDrawList;
+    SkCanvas* saveCanvas = maker.fCanvas;
+    SkIRect dirty;
+    dirty.set(0, 0, width, height);
+    bool result;
+    if (fSelfContained == false) {
+        fRetained.eraseColor(0);
+        SkCanvas canvas(fRetained);
+        maker.fCanvas = &canvas;
+        result = draw(maker, inTime);
+    } else {
+        fInTime = inTime;
+        SkPaint savePaint(*maker.fPaint);
+        fLastEntryBounds.swap(fEntryBounds);
+        fLastEntryFlags.swap(fEntryFlags);
+        SkCanvas measureCanvas(fScratch);
+        measureCanvas.setBounder(this);
+        result = measure(maker, &measureCanvas);
+        measureCanvas.setBounder(NULL);
+        // the measure may have started animations that invalidate everything
+        if (drawAll == false && fRetainedInval == false && dirtyBounds(&dirty) == false)
+            dirty.set(0, 0, width, height);
+        fRetainedInval = false;
+        // redraw the entries that touch the dirty area, and the ones that set
+        // up the canvas and paint for them
+        if (dirty.isEmpty() == false) {
+            SkIRect drawBounds = dirty;
+            for (int index = 0; index < count; index++) {
+                if (SkIRect::Intersects(fEntryBounds[index], dirty))
+                    drawBounds.join(fEntryBounds[index]);
+            }
+            drawBounds.intersect(0, 0, width, height);
+            SkCanvas canvas(fScratch);
+            SkRect clip;
+            clip.set(drawBounds);
+            canvas.clipRect(clip);
+            canvas.drawColor(0, SkXfermode::kClear_Mode);
+            maker.fCanvas = &canvas;
+            *maker.fPaint = savePaint;
+            resetActives();
+            for (int index = 0; index < count; index++) {
+                const SkIRect& bounds = fEntryBounds[index];
+                if ((fEntryFlags[index] & kStateful_EntryFlag) == 0 && bounds.isEmpty() == false &&
+                        SkIRect::Intersects(bounds, dirty) == false)
+                    continue;
+                SkDrawable* draw = fDrawList[index];
+                draw->initialize();
+                draw->draw(maker);
+            }
+            SkAutoLockPixels lockScratch(fScratch);
+            SkAutoLockPixels lockRetained(fRetained);
+            size_t rowBytes = dirty.width() << 2;
+            for (int y = dirty.fTop; y < dirty.fBottom; y++) {
+                memcpy(fRetained.getAddr32(dirty.fLeft, y), fScratch.getAddr32(dirty.fLeft, y),
+                    rowBytes);
+            }
+        }
+    }
+    maker.fCanvas = saveCanvas;
+    fInvalBounds = dirty;
+    validate();
+    return result;
+}
+
 int SkDisplayList::findGroup(SkDrawable* match, SkTDDrawableArray** list,
         SkGroup** parent, SkGroup** found, SkTDDrawableArray**grandList) {
     *parent = NULL;
@@ -63,8 +215,50 @@ void SkDisplayList::hardReset() {
     fActiveList.reset();
 }
 
+// Draws every entry into canvas, which has this as its bounder, to find the
+// device bounds of each and whether it changes the state later entries see.
+bool SkDisplayList::measure(SkAnimateMaker& maker, SkCanvas* canvas) {
+    int count = fDrawList.count();
+    fEntryBounds.setCount(count);
+    fEntryFlags.setCount(count);
+    maker.fCanvas = canvas;
+    resetActives();
+    bool result = false;
+    for (fEntry = 0; fEntry < count; fEntry++) {
+        SkDrawable* draw = fDrawList[fEntry];
+        int saveCount = canvas->getSaveCount();
+        SkMatrix matrix = canvas->getTotalMatrix();
+        SkIRect clip;
+        canvas->getClipDeviceBounds(&clip);
+        SkPaint paint(*maker.fPaint);
+        fEntryBounds[fEntry].setEmpty();
+        draw->initialize(); // allow matrices to reset themselves
+        SkASSERT(draw->isDrawable());
+        uint8_t flags = 0;
+        if (draw->draw(maker)) {
+            flags |= kAnimating_EntryFlag;
+            result = true;
+        }
+        // the bounder rounds antialiased fills to the nearest pixel
+        if (fEntryBounds[fEntry].isEmpty() == false)
+            fEntryBounds[fEntry].outset(1, 1);
+        SkIRect afterClip;
+        canvas->getClipDeviceBounds(&afterClip);
+        if (canvas->getSaveCount() != saveCount || canvas->getTotalMatrix() != matrix ||
+                afterClip != clip || *maker.fPaint != paint)
+            flags |= kStateful_EntryFlag;
+        fEntryFlags[fEntry] = flags;
+    }
+    fEntry = -1;
+    return result;
+}
+
 bool SkDisplayList::onIRect(const SkIRect& r) {
     fBounds = r;
+    if (fEntry >= 0) {
+        fEntryBounds[fEntry].join(r);
+        return false;
+    }
     return fDrawBounds;
 }
 
@@ -123,6 +317,13 @@ void SkDisplayList::reset() {
     }
 }
 
+void SkDisplayList::resetActives() {
+    for (SkActive** activePtr = fActiveList.begin(); activePtr < fActiveList.end(); activePtr++) {
+        SkActive* active = *activePtr;
+        active->reset();
+    }
+}
+
 void SkDisplayList::remove(SkActive* active) {
     int index = fActiveList.find(active);
     SkASSERT(index >= 0);
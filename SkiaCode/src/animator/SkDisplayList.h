@@ -12,12 +12,14 @@
 
 #include "SkOperand.h"
 #include "SkIntArray.h"
+#include "SkBitmap.h"
 #include "SkBounder.h"
 #include "SkRect.h"
 
 class SkAnimateMaker;
 class SkActive;
 class SkApply;
+class SkCanvas;
 class SkDrawable;
 class SkGroup;
 
@@ -29,6 +31,7 @@ public:
     void clear() { fDrawList.reset(); }
     int count() { return fDrawList.count(); }
     bool draw(SkAnimateMaker& , SkMSec time);
+    bool drawRetained(SkAnimateMaker& , SkMSec time, int width, int height);
 #ifdef SK_DUMP_ENABLED
     void dump(SkAnimateMaker* maker);
     void dumpInner(SkAnimateMaker* maker);
@@ -38,9 +41,11 @@ public:
     int findGroup(SkDrawable* match, SkTDDrawableArray** list,
         SkGroup** parent, SkGroup** found, SkTDDrawableArray** grandList);
     SkDrawable* get(int index) { return fDrawList[index]; }
+    const SkBitmap& getRetained() const { return fRetained; }
     SkMSec getTime() { return fInTime; }
     SkTDDrawableArray* getDrawList() { return &fDrawList; }
     void hardReset();
+    void invalRetained() { fRetainedInval = true; }
     virtual bool onIRect(const SkIRect& r);
     void reset();
     void remove(SkActive* );
@@ -61,9 +66,31 @@ public:
     bool fHasUnion;
     bool fUnionBounds;
 private:
+    enum EntryFlags {
+        kAnimating_EntryFlag = 0x01,
+        kStateful_EntryFlag  = 0x02  // changes the canvas or paint for later entries
+    };
+    static bool ChangesOtherEntries(SkAnimateMaker& , SkDrawable* );
+    bool dirtyBounds(SkIRect* dirty);
+    bool measure(SkAnimateMaker& , SkCanvas* );
+    void resetActives();
+
     SkTDDrawableArray fDrawList;
     SkTDActiveArray fActiveList;
     SkMSec fInTime;
+    // retained drawing: the bitmap drawRetained() draws into, one to measure
+    // and redraw the entries in, and the device bounds and flags of each entry
+    // of the draw list this frame and the last
+    SkBitmap fRetained;
+    SkBitmap fScratch;
+    SkTDDrawableArray fLastDrawList;
+    SkTDArray<SkIRect> fEntryBounds;
+    SkTDArray<SkIRect> fLastEntryBounds;
+    SkTDArray<uint8_t> fEntryFlags;
+    SkTDArray<uint8_t> fLastEntryFlags;
+    int fEntry;
+    bool fRetainedInval;
+    bool fSelfContained;
     friend class SkEvents;
 };
 
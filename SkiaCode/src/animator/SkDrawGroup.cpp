@@ -13,6 +13,7 @@
 #include "SkCanvas.h"
 #include "SkDisplayApply.h"
 #include "SkPaint.h"
+#include "SkScriptProgram.h"
 #ifdef SK_DEBUG
 #include "SkDisplayList.h"
 #endif
@@ -28,10 +29,13 @@ const SkMemberInfo SkGroup::fInfo[] = {
 
 DEFINE_GET_MEMBER(SkGroup);
 
-SkGroup::SkGroup() : fParentList(NULL), fOriginal(NULL) {
+SkGroup::SkGroup() : fParentList(NULL), fOriginal(NULL), fConditionProgram(NULL),
+        fEnableConditionProgram(NULL) {
 }
 
 SkGroup::~SkGroup() {
+    delete fConditionProgram;
+    delete fEnableConditionProgram;
     if (fOriginal)  // has been copied
         return;
     int index = 0;
@@ -103,7 +107,7 @@ bool SkGroup::doEvent(SkDisplayEvent::Kind kind, SkEventState* state) {
 }
 
 bool SkGroup::draw(SkAnimateMaker& maker) {
-    bool conditionTrue = ifCondition(maker, this, condition);
+    bool conditionTrue = ifCondition(maker, this, condition, &fConditionProgram);
     bool result = false;
     for (SkDrawable** ptr = fChildren.begin(); ptr < fChildren.end(); ptr++) {
         SkDrawable* drawable = *ptr;
@@ -165,7 +169,7 @@ bool SkGroup::enable(SkAnimateMaker& maker ) {
     reset();
     for (SkDrawable** ptr = fChildren.begin(); ptr < fChildren.end(); ptr++) {
         SkDrawable* drawable = *ptr;
-        if (ifCondition(maker, drawable, enableCondition) == false)
+        if (ifCondition(maker, drawable, enableCondition, &fEnableConditionProgram) == false)
             continue;
         drawable->enable(maker);
     }
@@ -197,11 +201,19 @@ bool SkGroup::hasEnable() const {
 }
 
 bool SkGroup::ifCondition(SkAnimateMaker& maker, SkDrawable* drawable,
-        SkString& conditionString) {
+        SkString& conditionString, SkScriptProgram** program) {
     if (conditionString.size() == 0)
         return true;
     int32_t result;
-    bool success = SkAnimatorScript::EvaluateInt(maker, this, conditionString.c_str(), &result);
+    bool success;
+    SkScriptProgram* compiled = SkScriptProgram::Compile(program, maker, this, SkType_Int,
+        conditionString);
+    SkScriptValue value;
+    if (compiled && compiled->run(&value) && value.fType == SkType_Int) {
+        result = value.fOperand.fS32;
+        success = true;
+    } else
+        success = SkAnimatorScript::EvaluateInt(maker, this, conditionString.c_str(), &result);
 #ifdef SK_DUMP_ENABLED
     if (maker.fDumpGConditions) {
         SkDebugf("group: ");
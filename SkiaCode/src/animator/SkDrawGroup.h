@@ -14,6 +14,8 @@
 #include "SkIntArray.h"
 #include "SkMemberInfo.h"
 
+class SkScriptProgram;
+
 class SkGroup : public SkDrawable { //interface for schema element <g>
 public:
     DECLARE_MEMBER_INFO(Group);
@@ -51,13 +53,15 @@ public:
 #endif
 protected:
     bool ifCondition(SkAnimateMaker& maker, SkDrawable* drawable,
-        SkString& conditionString);
+        SkString& conditionString, SkScriptProgram** program);
     SkString condition;
     SkString enableCondition;
     SkTDDrawableArray fChildren;
     SkTDDrawableArray* fParentList;
     SkTDIntArray fCopies;
     SkGroup* fOriginal;
+    SkScriptProgram* fConditionProgram;
+    SkScriptProgram* fEnableConditionProgram;
 private:
     typedef SkDrawable INHERITED;
 };
@@ -255,57 +255,8 @@ scriptCommon: {
                     return false;
                 }
             }
-            SkASSERT(success);
-            if (scriptValue.fType == SkType_Displayable) {
-                if (type == SkType_String) {
-                    const char* charPtr = NULL;
-                    maker.findKey(scriptValue.fOperand.fDisplayable, &charPtr);
-                    scriptValue.fOperand.fString = new SkString(charPtr);
-                    scriptValue.fType = SkType_String;
-                    engine.SkScriptEngine::track(scriptValue.fOperand.fString);
-                    break;
-                }
-                SkASSERT(SkDisplayType::IsDisplayable(&maker, type));
-                if (displayable)
-                    displayable->setReference(this, scriptValue.fOperand.fDisplayable);
-                else
-                    arrayStorage->begin()[0].fDisplayable = scriptValue.fOperand.fDisplayable;
-                return true;
-            }
-            if (type != scriptValue.fType) {
-                if (scriptValue.fType == SkType_Array) {
-                    engine.forget(scriptValue.getArray());
-                    goto writeStruct; // real structs have already been written by script
-                }
-                switch (type) {
-                    case SkType_String:
-                        success = engine.convertTo(SkType_String, &scriptValue);
-                        break;
-                    case SkType_MSec:
-                    case SkType_Float:
-                        success = engine.convertTo(SkType_Float, &scriptValue);
-                        break;
-                    case SkType_Int:
-                        success = engine.convertTo(SkType_Int, &scriptValue);
-                        break;
-                    case SkType_Array:
-                        success = engine.convertTo(arrayType(), &scriptValue);
-                        // !!! incomplete; create array of appropriate type and add scriptValue to it
-                        SkASSERT(0);
-                        break;
-                    case SkType_Displayable:
-                    case SkType_Drawable:
-                        return false;   // no way to convert other types to this
-                    default:    // to avoid warnings
-                        break;
-                }
-                if (success == false)
-                    return false;
-            }
-            if (type == SkType_MSec)
-                scriptValue.fOperand.fMSec = SkScalarMulRound(scriptValue.fOperand.fScalar, 1000);
-            scriptValue.fType = type;
-        break;
+            return setValue(maker, arrayStorage, storageOffset, maxStorage, displayable, outType,
+                engine, scriptValue);
         noScriptString:
         case SkType_DynamicString:
             if (fType == SkType_MemberProperty && displayable) {
@@ -333,7 +284,6 @@ scriptCommon: {
     }
 //  if (SkDisplayType::IsStruct(type) == false)
     {
-writeStruct:
         if (writeValue(displayable, arrayStorage, storageOffset, maxStorage,
                 untypedStorage, outType, scriptValue)) {
                     maker.setErrorCode(SkDisplayXMLParserError::kUnexpectedType);
@@ -353,6 +303,76 @@ bool SkMemberInfo::setValue(SkAnimateMaker& maker, SkTDOperandArray* arrayStorag
         raw.size());
 }
 
+bool SkMemberInfo::setValue(SkAnimateMaker& maker, SkTDOperandArray* arrayStorage,
+        int storageOffset, int maxStorage, SkDisplayable* displayable, SkDisplayTypes outType,
+        SkScriptEngine& engine, SkScriptValue& scriptValue) const {
+    if (arrayStorage)
+        displayable = NULL;
+    void* untypedStorage = NULL;
+    if (displayable && fType != SkType_MemberProperty && fType != SkType_MemberFunction)
+        untypedStorage = (SkTDOperandArray*) memberData(displayable);
+    SkDisplayTypes type = getType();
+    bool success = true;
+    if (scriptValue.fType == SkType_Displayable) {
+        if (type == SkType_String) {
+            const char* charPtr = NULL;
+            maker.findKey(scriptValue.fOperand.fDisplayable, &charPtr);
+            scriptValue.fOperand.fString = new SkString(charPtr);
+            scriptValue.fType = SkType_String;
+            engine.track(scriptValue.fOperand.fString);
+            goto writeStruct;
+        }
+        SkASSERT(SkDisplayType::IsDisplayable(&maker, type));
+        if (displayable)
+            displayable->setReference(this, scriptValue.fOperand.fDisplayable);
+        else
+            arrayStorage->begin()[0].fDisplayable = scriptValue.fOperand.fDisplayable;
+        return true;
+    }
+    if (type != scriptValue.fType) {
+        if (scriptValue.fType == SkType_Array) {
+            engine.forget(scriptValue.getArray());
+            goto writeStruct; // real structs have already been written by script
+        }
+        switch (type) {
+            case SkType_String:
+                success = engine.convertTo(SkType_String, &scriptValue);
+                break;
+            case SkType_MSec:
+            case SkType_Float:
+                success = engine.convertTo(SkType_Float, &scriptValue);
+                break;
+            case SkType_Int:
+                success = engine.convertTo(SkType_Int, &scriptValue);
+                break;
+            case SkType_Array:
+                success = engine.convertTo(arrayType(), &scriptValue);
+                // !!! incomplete; create array of appropriate type and add scriptValue to it
+                SkASSERT(0);
+                break;
+            case SkType_Displayable:
+            case SkType_Drawable:
+                return false;   // no way to convert other types to this
+            default:    // to avoid warnings
+                break;
+        }
+        if (success == false)
+            return false;
+    }
+    if (type == SkType_MSec)
+        scriptValue.fOperand.fMSec = SkScalarMulRound(scriptValue.fOperand.fScalar, 1000);
+    scriptValue.fType = type;
+writeStruct:
+    if (writeValue(displayable, arrayStorage, storageOffset, maxStorage,
+            untypedStorage, outType, scriptValue)) {
+        maker.setErrorCode(SkDisplayXMLParserError::kUnexpectedType);
+        return false;
+    }
+    if (displayable)
+        displayable->dirty();
+    return true;
+}
+
 bool SkMemberInfo::writeValue(SkDisplayable* displayable, SkTDOperandArray* arrayStorage,
     int storageOffset, int maxStorage, void* untypedStorage, SkDisplayTypes outType,
     SkScriptValue& scriptValue) const
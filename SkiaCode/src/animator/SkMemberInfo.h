@@ -89,6 +89,9 @@ struct SkMemberInfo {
     bool setValue(SkAnimateMaker& , SkTDOperandArray* storage,
         int storageOffset, int maxStorage, SkDisplayable* ,
         SkDisplayTypes outType, SkString& str) const;
+    bool setValue(SkAnimateMaker& , SkTDOperandArray* storage,
+        int storageOffset, int maxStorage, SkDisplayable* ,
+        SkDisplayTypes outType, SkScriptEngine& , SkScriptValue& ) const;
 //  void setValue(SkDisplayable* , const char value[], const char name[]) const;
     bool writeValue(SkDisplayable* displayable, SkTDOperandArray* arrayStorage,
         int storageOffset, int maxStorage, void* untypedStorage, SkDisplayTypes outType,
@@ -1292,6 +1292,18 @@ bool SkScriptEngine::processOp() {
         type2 = ToOpType(val.fType);
         operand2 = val.fOperand;
     }
+    if (applyOp(op, type1, operand1, &type2, &operand2) == false)
+        return false;
+    fTypeStack.push(type2);
+    fOperandStack.push(operand2);
+    return true;
+}
+
+bool SkScriptEngine::applyOp(SkOp op, SkOpType type1, SkOperand operand1,
+        SkOpType* type2Ptr, SkOperand* operand2Ptr) {
+    const SkOperatorAttributes* attributes = &gOpAttributes[op];
+    SkOpType type2 = *type2Ptr;
+    SkOperand operand2 = *operand2Ptr;
     if (attributes->fLeftType != kNoType) {
         if (type1 != type2) {
             if ((attributes->fLeftType & kString) && attributes->fBias & kTowardsString && ((type1 | type2) & kString)) {
@@ -1456,8 +1468,8 @@ bool SkScriptEngine::processOp() {
         default:
             SkASSERT(0);
     }
-    fTypeStack.push(type2);
-    fOperandStack.push(operand2);
+    *type2Ptr = type2;
+    *operand2Ptr = operand2;
     return true;
 }
 
@@ -188,6 +188,10 @@ protected:
     static const SkOperatorAttributes gOpAttributes[];
     static const signed char gPrecedence[];
     int arithmeticOp(char ch, char nextChar, bool lastPush);
+    // computes op on two unboxed operands (or on *operand2 alone for unary ops),
+    // leaving the result in *type2 and *operand2
+    bool applyOp(SkOp op, SkOpType type1, SkOperand operand1, SkOpType* type2,
+        SkOperand* operand2);
     void commonCallBack(CallBackType type, UserCallBack& callBack, void* userStorage);
     bool convertParams(SkTDArray<SkScriptValue>&, const SkFunctionParamType* ,
                                     int paramTypeCount);
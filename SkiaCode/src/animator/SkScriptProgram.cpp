@@ -0,0 +1,549 @@
+
+/*
+ * Copyright 2012 Google Inc.
+ *
+ * Use of this source code is governed by a BSD-style license that can be
+ * found in the LICENSE file.
+ */
+
+
+#include "SkScriptProgram.h"
+#include "SkAnimateMaker.h"
+#include "SkAnimatorScript.h"
+#include "SkDisplayType.h"
+#include "SkExtras.h"
+#include "SkMemberInfo.h"
+#include "SkParse.h"
+
+// The compiler follows SkScriptEngine::innerScript() and its helpers step by
+// step, so that a compiled script computes exactly what the engine would;
+// instead of evaluating operators as they come off the operator stack, it
+// appends them to the program. Anything the engine does that isn't mirrored
+// here makes compile() fail, leaving the script to the engine.
+
+static inline bool is_between(int c, int min, int max)
+{
+    return (unsigned)(c - min) <= (unsigned)(max - min);
+}
+
+static inline bool is_ws(int c)
+{
+    return is_between(c, 1, 32);
+}
+
+static int token_length(const char* start) {
+    char ch = start[0];
+    if (! is_between(ch, 'a' , 'z') &&  ! is_between(ch, 'A', 'Z') && ch != '_' && ch != '$')
+        return -1;
+    int length = 0;
+    do
+        ch = start[++length];
+    while (is_between(ch, 'a' , 'z') || is_between(ch, 'A', 'Z') || is_between(ch, '0', '9') ||
+        ch == '_' || ch == '$');
+    return length;
+}
+
+// the type SkAnimatorScript::EvalMemberCommon() leaves a member as, or kNoType
+// if it isn't a number
+static SkScriptEngine::SkOpType member_type(const SkMemberInfo* info) {
+    if (info->fType == SkType_Array || info->getCount() != 1)
+        return SkScriptEngine::kNoType;
+    switch (info->getType()) {
+        case SkType_ARGB:
+        case SkType_Boolean:
+        case SkType_Int:
+            return SkScriptEngine::kInt;
+        case SkType_MSec:
+        case SkType_Float:
+            return SkScriptEngine::kScalar;
+        default:
+            return SkScriptEngine::kNoType;
+    }
+}
+
+SkScriptProgram::SkScriptProgram(SkAnimateMaker& maker, SkDisplayable* working, SkDisplayTypes type)
+    : INHERITED(SkScriptEngine::ToOpType(type)), fMaker(maker), fWorking(working), fType(type),
+    fGeneration(maker.getScriptGeneration()), fValid(false), fDepth(0), fMaxDepth(0) {
+}
+
+SkScriptProgram::Instruction* SkScriptProgram::append(Opcode opcode) {
+    Instruction* instruction = fInstructions.append();
+    memset(instruction, 0, sizeof(Instruction));
+    instruction->fOpcode = opcode;
+    if (opcode != kUnaryOp && opcode != kBinaryOp && ++fDepth > fMaxDepth)
+        fMaxDepth = fDepth;
+    return instruction;
+}
+
+bool SkScriptProgram::compile(const char script[]) {
+    fSource.set(script);
+    fGeneration = fMaker.getScriptGeneration();
+    fValid = false;
+    fInstructions.reset();
+    fDepth = fMaxDepth = 0;
+    if (fType != SkType_Int && fType != SkType_Float && fType != SkType_MSec)
+        return false;
+    SkTDArray<SkExtras*>& extras = fMaker.fExtras;
+    for (SkExtras** extraPtr = extras.begin(); extraPtr < extras.end(); extraPtr++) {
+        if ((*extraPtr)->fExtraCallBack)
+            return false;   // extras may claim any name
+    }
+    if (fWorking && fWorking->isAnimate())
+        return false;   // looking up an id may add the animate as a dependent
+    if (strncmp(script, "#script:", sizeof("#script:") - 1) == 0)
+        script += sizeof("#script:") - 1;
+    fOps.reset();
+    *fOps.append() = kParen;
+    bool success = compileExpression(&script, false);
+    fOps.reset();
+    if (success == false)
+        return false;
+    while (is_ws(script[0]))
+        script++;
+    if (script[0] != '\0')
+        return false;
+    fTypes.setCount(fMaxDepth);
+    fOperands.setCount(fMaxDepth);
+    fValid = true;
+    return true;
+}
+
+bool SkScriptProgram::compileDot(const char** scriptPtr, const char* token, size_t len) {
+    SkDisplayable* displayable;
+    if (lookupID(token, len, &displayable) == false)
+        return false;   // NaN, Infinity and members of the working displayable aren't objects
+    const char* script = *scriptPtr + 1;
+    int fieldLength = token_length(script);
+    if (fieldLength <= 0)
+        return false;
+    const char* field = script;
+    script += fieldLength;
+    while (is_ws(script[0]))
+        script++;
+    int paramCount = -1;
+    if (script[0] == '(') {
+        script++;
+        *fOps.append() = kParen;
+        paramCount = 0;
+        do {
+            if (compileExpression(&script, true) == false)
+                return false;
+            paramCount++;
+        } while (script[-1] == ',');
+        fOps.pop();
+        script++;
+    }
+    *scriptPtr = script;
+    return compileMember(displayable, field, fieldLength, paramCount);
+}
+
+bool SkScriptProgram::compileExpression(const char** scriptPtr, bool param) {
+    const char* script = *scriptPtr;
+    const char* token = NULL;
+    size_t tokenLength = 0;
+    bool lastPush = false;
+    bool closed = param == false;
+    int opBalance = fOps.count();
+    int depthBalance = fDepth;
+    char ch;
+    while ((ch = script[0]) != '\0') {
+        if (is_ws(ch)) {
+            script++;
+            continue;
+        }
+        if (lastPush && tokenLength > 0) {
+            if (ch == '(' || ch == '[')
+                return false;   // global functions and arrays aren't compiled
+            if (ch != '.') {
+                if (compileProperty(token, tokenLength) == false)
+                    return false;
+                tokenLength = 0;
+                continue;
+            }
+        }
+        SkOperand operand;
+        if (ch == '0' && (script[1] & ~0x20) == 'X') {
+            if (lastPush)
+                return false;
+            script = SkParse::FindHex(script + 2, (uint32_t*) &operand.fS32);
+            if (script == NULL)
+                return false;
+            Instruction* push = append(kPushValue);
+            push->fType = kInt;
+            push->fOperand = operand;
+            lastPush = true;
+            continue;
+        }
+        if ((lastPush == false && ch == '.') || (ch >= '0' && ch <= '9')) {
+            if (lastPush)
+                return false;
+            SkOpType type = kInt;
+            const char* dotCheck = ch == '.' ? script : SkParse::FindS32(script, &operand.fS32);
+            if (dotCheck[0] != '.')
+                script = dotCheck;
+            else {
+                script = SkParse::FindScalar(script, &operand.fScalar);
+                if (script == NULL)
+                    return false;
+                type = kScalar;
+            }
+            Instruction* push = append(kPushValue);
+            push->fType = type;
+            push->fOperand = operand;
+            lastPush = true;
+            continue;
+        }
+        int length = token_length(script);
+        if (length > 0) {
+            if (lastPush)
+                return false;
+            token = script;
+            tokenLength = length;
+            script += length;
+            lastPush = true;
+            continue;
+        }
+        if (ch == '.') {
+            if (tokenLength == 0)
+                return false;   // members of computed values aren't compiled
+            if (compileDot(&script, token, tokenLength) == false)
+                return false;
+            tokenLength = 0;
+            lastPush = true;
+            continue;
+        }
+        if (param && ch == ')') {
+            closed = true;
+            break;
+        }
+        if (param && ch == ',') {
+            script++;
+            closed = true;
+            break;
+        }
+        int advance;
+        if (compileOp(ch, script[1], lastPush, &advance) == false)
+            return false;
+        script += advance;
+        lastPush = ch == ')';
+    }
+    if (closed == false)
+        return false;
+    if (tokenLength > 0 && compileProperty(token, tokenLength) == false)
+        return false;
+    while (fOps.count() > opBalance) {
+        if (emitOp() == false)
+            return false;
+    }
+    if (fDepth != depthBalance + 1)
+        return false;
+    // the engine converts an object left alone on the stack to the return type
+    Instruction& last = fInstructions.top();
+    if (last.fOpcode == kUnbox)
+        last.fConvert = true;
+    *scriptPtr = script;
+    return true;
+}
+
+bool SkScriptProgram::compileMember(SkDisplayable* displayable, const char* field, size_t len,
+        int paramCount) {
+    SkString name(field, len);
+    if (paramCount < 0 && displayable->contains(name))
+        return false;   // child displayables aren't numbers
+    const SkMemberInfo* info = displayable->getMember(name.c_str());
+    if (info == NULL || (paramCount >= 0) != (info->fType == SkType_MemberFunction))
+        return false;
+    SkOpType type = member_type(info);
+    if (type == kNoType)
+        return false;
+    fDepth -= SkMax32(paramCount, 0);
+    Instruction* push = append(paramCount >= 0 ? kCallMember : kPushMember);
+    push->fType = type;
+    push->fDisplayable = displayable;
+    push->fInfo = info;
+    push->fParamCount = paramCount;
+    return true;
+}
+
+// mirrors SkScriptEngine::logicalOp() for ')' and SkScriptEngine::arithmeticOp()
+bool SkScriptProgram::compileOp(char ch, char nextChar, bool lastPush, int* advancePtr) {
+    SkOp op = kUnassigned;
+    bool reverseOperands = false;
+    bool negateResult = false;
+    int advance = 1;
+    switch (ch) {
+        case ')':
+            while (gPrecedence[fOps.top() & ~kArtificialOp] < gPrecedence[kParen]) {
+                if (emitOp() == false)
+                    return false;
+            }
+            if (fOps.count() <= 1 || fOps.top() != kParen)
+                return false;
+            fOps.pop();
+            goto returnAdv;
+        case '+':
+            if (lastPush == false)  // unary plus, don't push an operator
+                goto returnAdv;
+            op = kAdd;
+            break;
+        case '-':
+            op = lastPush ? kSubtract : kMinus;
+            break;
+        case '*':
+            op = kMultiply;
+            break;
+        case '/':
+            op = kDivide;
+            break;
+        case '>':
+            if (nextChar == '>') {
+                op = kShiftRight;
+                goto twoChar;
+            }
+            op = kGreaterEqual;
+            if (nextChar == '=')
+                goto twoChar;
+            reverseOperands = negateResult = true;
+            break;
+        case '<':
+            if (nextChar == '<') {
+                op = kShiftLeft;
+                goto twoChar;
+            }
+            op = kGreaterEqual;
+            reverseOperands = nextChar == '=';
+            negateResult = ! reverseOperands;
+            advance += reverseOperands;
+            break;
+        case '=':
+            if (nextChar == '=') {
+                op = kEqual;
+                goto twoChar;
+            }
+            break;
+        case '!':
+            if (nextChar == '=') {
+                op = kEqual;
+                negateResult = true;
+twoChar:
+                advance++;
+                break;
+            }
+            op = kLogicalNot;
+            break;
+        case '^':
+            op = kXor;
+            break;
+        case '(':
+            *fOps.append() = kParen;
+            goto returnAdv;
+        case '&':
+            if (nextChar != '&')
+                op = kBitAnd;
+            break;
+        case '|':
+            if (nextChar != '|')
+                op = kBitOr;
+            break;
+        case '%':
+            op = kModulo;
+            break;
+        case '~':
+            op = kBitNot;
+            break;
+    }
+    // ?:, && and || suppress evaluation, and aren't compiled
+    if (op == kUnassigned)
+        return false;
+    {
+        signed char precedence = gPrecedence[op];
+        do {
+            int index = fOps.count() - 1;
+            while (fOps[index] & kArtificialOp)
+                index--;
+            signed char topPrecedence = gPrecedence[fOps[index]];
+            if (topPrecedence > precedence || (topPrecedence == precedence &&
+                    gOpAttributes[op].fLeftType == kNoType)) {
+                break;
+            }
+            if (emitOp() == false)
+                return false;
+        } while (true);
+    }
+    if (negateResult)
+        *fOps.append() = (SkOp) (kLogicalNot | kArtificialOp);
+    *fOps.append() = op;
+    if (reverseOperands)
+        *fOps.append() = (SkOp) (kFlipOps | kArtificialOp);
+returnAdv:
+    *advancePtr = advance;
+    return true;
+}
+
+// mirrors the property callbacks SkAnimatorScript installs for a numeric type
+bool SkScriptProgram::compileProperty(const char* token, size_t len) {
+    if (SK_LITERAL_STR_EQUAL("NaN", token, len) || SK_LITERAL_STR_EQUAL("Infinity", token, len)) {
+        Instruction* push = append(kPushValue);
+        push->fType = kScalar;
+        push->fOperand.fScalar = token[0] == 'N' ? SK_ScalarNaN : SK_ScalarInfinity;
+        return true;
+    }
+    SkDisplayable* displayable;
+    if (lookupID(token, len, &displayable)) {
+        SkDisplayTypes type = displayable->getType();
+        if (type != SkType_Boolean && type != SkType_Int && type != SkType_Float)
+            return false;
+        append(kUnbox)->fDisplayable = displayable;
+        return true;
+    }
+    if (fWorking == NULL || SK_LITERAL_STR_EQUAL("parent", token, len))
+        return false;
+    return compileMember(fWorking, token, len, -1);
+}
+
+// mirrors SkScriptEngine::processOp()
+bool SkScriptProgram::emitOp() {
+    SkOp op;
+    fOps.pop(&op);
+    op = (SkOp) (op & ~kArtificialOp);
+    bool flip = false;
+    if (op == kFlipOps) {
+        if (fOps.count() == 0)
+            return false;
+        fOps.pop(&op);
+        op = (SkOp) (op & ~kArtificialOp);
+        flip = true;
+    }
+    switch (op) {
+        case kAdd:
+        case kBitAnd:
+        case kBitNot:
+        case kBitOr:
+        case kDivide:
+        case kEqual:
+        case kGreaterEqual:
+        case kLogicalNot:
+        case kMinus:
+        case kModulo:
+        case kMultiply:
+        case kShiftLeft:
+        case kShiftRight:
+        case kSubtract:
+        case kXor:
+            break;
+        default:
+            return false;
+    }
+    bool binary = gOpAttributes[op].fLeftType != kNoType;
+    if (fDepth < (binary ? 2 : 1) || (flip && binary == false))
+        return false;
+    Instruction* instruction = append(binary ? kBinaryOp : kUnaryOp);
+    instruction->fOp = op;
+    instruction->fFlip = flip;
+    if (binary)
+        fDepth--;
+    return true;
+}
+
+bool SkScriptProgram::lookupID(const char* token, size_t len, SkDisplayable** displayable) {
+    return fMaker.find(token, len, displayable);
+}
+
+bool SkScriptProgram::run(SkScriptValue* result) {
+    SkASSERT(fValid);
+    SkOpType* types = fTypes.begin();
+    SkOperand* operands = fOperands.begin();
+    int top = -1;
+    for (const Instruction* instruction = fInstructions.begin();
+            instruction < fInstructions.end(); instruction++) {
+        switch (instruction->fOpcode) {
+            case kPushValue:
+                types[++top] = instruction->fType;
+                operands[top] = instruction->fOperand;
+                break;
+            case kPushMember: {
+                SkDisplayable* displayable = instruction->fDisplayable;
+                const SkMemberInfo* info = instruction->fInfo;
+                SkScriptValue value;
+                if (info->fType == SkType_MemberProperty &&
+                        displayable->getProperty(info->propertyIndex(), &value) == false)
+                    return false;
+                SkAnimatorScript::EvalMemberCommon(this, info, displayable, &value);
+                types[++top] = instruction->fType;
+                operands[top] = value.fOperand;
+                } break;
+            case kCallMember: {
+                SkDisplayable* displayable = instruction->fDisplayable;
+                const SkMemberInfo* info = instruction->fInfo;
+                int count = instruction->fParamCount;
+                top -= count;
+                fParams.setCount(count);
+                for (int index = 0; index < count; index++) {
+                    fParams[index].fType = ToDisplayType(types[top + 1 + index]);
+                    fParams[index].fOperand = operands[top + 1 + index];
+                }
+                SkScriptValue value;
+                displayable->executeFunction(displayable, info->functionIndex(), fParams,
+                    info->getType(), &value);
+                SkAnimatorScript::EvalMemberCommon(this, info, displayable, &value);
+                types[++top] = instruction->fType;
+                operands[top] = value.fOperand;
+                } break;
+            case kUnbox: {
+                SkScriptValue value;
+                value.fType = SkType_Displayable;
+                value.fOperand.fObject = instruction->fDisplayable;
+                SkAnimatorScript::Unbox(&fMaker, &value);
+                if (instruction->fConvert &&
+                        ConvertTo(this, ToDisplayType(fReturnType), &value) == false)
+                    return false;
+                types[++top] = ToOpType(value.fType);
+                operands[top] = value.fOperand;
+                } break;
+            case kUnaryOp:
+                if (applyOp(instruction->fOp, types[top], operands[top], &types[top],
+                        &operands[top]) == false)
+                    return false;
+                break;
+            case kBinaryOp: {
+                SkOpType type1 = types[top - 1];
+                SkOperand operand1 = operands[top - 1];
+                SkOpType type2 = types[top];
+                SkOperand operand2 = operands[top];
+                if (instruction->fFlip) {
+                    SkTSwap(type1, type2);
+                    SkTSwap(operand1, operand2);
+                }
+                if (applyOp(instruction->fOp, type1, operand1, &type2, &operand2) == false)
+                    return false;
+                types[--top] = type2;
+                operands[top] = operand2;
+                } break;
+            default:
+                SkASSERT(0);
+        }
+    }
+    SkASSERT(top == 0);
+    result->fType = ToDisplayType(types[0]);
+    result->fOperand = operands[0];
+    return true;
+}
+
+SkScriptProgram* SkScriptProgram::Compile(SkScriptProgram** cache, SkAnimateMaker& maker,
+        SkDisplayable* working, SkDisplayTypes type, const SkString& script) {
+    SkScriptProgram* program = *cache;
+    if (program && program->fWorking == working && program->fType == type &&
+            program->fGeneration == maker.getScriptGeneration() && program->fSource.equals(script))
+        return program->fValid ? program : NULL;
+    if (type != SkType_Int && type != SkType_Float && type != SkType_MSec)
+        return NULL;
+    if (program == NULL || &program->fMaker != &maker) {
+        delete program;
+        *cache = program = new SkScriptProgram(maker, working, type);
+    } else {
+        program->fWorking = working;
+        program->fType = type;
+        program->fReturnType = ToOpType(type);
+    }
+    return program->compile(script.c_str()) ? program : NULL;
+}
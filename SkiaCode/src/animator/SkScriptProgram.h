@@ -0,0 +1,88 @@
+
+/*
+ * Copyright 2012 Google Inc.
+ *
+ * Use of this source code is governed by a BSD-style license that can be
+ * found in the LICENSE file.
+ */
+
+
+#ifndef SkScriptProgram_DEFINED
+#define SkScriptProgram_DEFINED
+
+#include "SkScript.h"
+#include "SkString.h"
+
+class SkAnimateMaker;
+class SkDisplayable;
+struct SkMemberInfo;
+
+/** A script compiled once into a postfix program, so that scripts evaluated
+    every frame (such as animate formulas) are not parsed every frame.
+    Only numeric expressions are compiled: literals, operators, ids and their
+    members and member functions. compile() fails on anything else (strings,
+    arrays, ?:, && and ||, global functions, extra properties), and the
+    caller should evaluate the script with SkAnimatorScript instead.
+    Ids are resolved when the script is compiled; Compile() recompiles when
+    the maker's ids or extras change.
+*/
+class SkScriptProgram : public SkScriptEngine {
+public:
+    SkScriptProgram(SkAnimateMaker& , SkDisplayable* working, SkDisplayTypes type);
+    bool compile(const char script[]);
+    bool run(SkScriptValue* result);
+
+    /** Return the program cached in *cache if it was compiled from script for
+        the same working displayable and type, compiling a new one otherwise.
+        Return NULL if the script can't be compiled.
+    */
+    static SkScriptProgram* Compile(SkScriptProgram** cache, SkAnimateMaker& ,
+        SkDisplayable* working, SkDisplayTypes type, const SkString& script);
+private:
+    enum Opcode {
+        kPushValue,
+        kPushMember,
+        kCallMember,
+        kUnbox,
+        kUnaryOp,
+        kBinaryOp
+    };
+
+    struct Instruction {
+        Opcode fOpcode;
+        SkOpType fType;     // kPushValue, kPushMember, kCallMember: type pushed
+        SkOperand fOperand; // kPushValue
+        SkDisplayable* fDisplayable;    // kPushMember, kCallMember, kUnbox
+        const SkMemberInfo* fInfo;      // kPushMember, kCallMember
+        int fParamCount;    // kCallMember
+        SkOp fOp;           // kUnaryOp, kBinaryOp
+        bool fFlip;         // kBinaryOp: operands were pushed in reverse order
+        bool fConvert;      // kUnbox: convert to the return type, as a lone object would be
+    };
+
+    Instruction* append(Opcode );
+    bool compileDot(const char** scriptPtr, const char* token, size_t len);
+    bool compileExpression(const char** scriptPtr, bool param);
+    bool compileMember(SkDisplayable* , const char* field, size_t len, int paramCount);
+    bool compileOp(char ch, char nextChar, bool lastPush, int* advance);
+    bool compileProperty(const char* token, size_t len);
+    bool emitOp();
+    bool lookupID(const char* token, size_t len, SkDisplayable** );
+
+    SkAnimateMaker& fMaker;
+    SkDisplayable* fWorking;
+    SkDisplayTypes fType;
+    SkString fSource;
+    int fGeneration;
+    bool fValid;
+    SkTDArray<Instruction> fInstructions;
+    SkTDArray<SkOp> fOps;   // compile time only
+    int fDepth;             // compile time only
+    int fMaxDepth;
+    SkTDArray<SkOpType> fTypes;
+    SkTDArray<SkOperand> fOperands;
+    SkTDArray<SkScriptValue> fParams;
+    typedef SkScriptEngine INHERITED;
+};
+
+#endif // SkScriptProgram_DEFINED
@@ -169,7 +169,6 @@ void SkAAClip::Iter::next() {
     }
 }
 
-#ifdef SK_DEBUG
 // assert we're exactly width-wide, and then return the number of bytes used
 static size_t compute_row_length(const uint8_t row[], int width) {
     const uint8_t* origRow = row;
@@ -184,6 +183,7 @@ static size_t compute_row_length(const uint8_t row[], int width) {
     return row - origRow;
 }
 
+#ifdef SK_DEBUG
 void SkAAClip::validate() const {
     if (NULL == fRunHead) {
         SkASSERT(fBounds.isEmpty());
@@ -581,6 +581,14 @@ void SkAAClip::freeRuns() {
     }
 }
 
+size_t SkAAClip::computeRunsSize() const {
+    if (NULL == fRunHead) {
+        return 0;
+    }
+    return sizeof(RunHead) + fRunHead->fRowCount * sizeof(YOffset) +
+           fRunHead->fDataSize;
+}
+
 SkAAClip::SkAAClip() {
     fBounds.setEmpty();
     fRunHead = NULL;
@@ -942,6 +950,25 @@ public:
         SkASSERT(row->fWidth <= fBounds.width());
     }
 
+    /**
+     *  Append a whole row of already encoded runs, which must span our width,
+     *  as the last row y.
+     */
+    void addRowData(int y, const uint8_t data[], size_t length) {
+        SkASSERT(fBounds.contains(fBounds.fLeft, y));
+        SkASSERT(compute_row_length(data, fWidth) == length);
+
+        y -= fBounds.top();
+        SkASSERT(y > fPrevY);
+        fPrevY = y;
+
+        Row* row = this->flushRow(true);
+        row->fY = y;
+        row->fWidth = fWidth;
+        row->fData->append(length, data);
+        fCurrRow = row;
+    }
+
     void addColumn(int x, int y, U8CPU alpha, int height) {
         SkASSERT(fBounds.contains(x, y + height - 1));
 
@@ -1533,11 +1560,43 @@ static void adjust_iter(SkAAClip::Iter& iter, int& topA, int& botA, int bot) {
     }
 }
 
+/*
+ *  Returns true if every run of row (which spans rowBounds) that lies within
+ *  [bounds.fLeft, bounds.fRight) is opaque.
+ */
+static bool row_is_opaque(const uint8_t* row, const SkIRect& rowBounds,
+                          const SkIRect& bounds) {
+    SkASSERT(rowBounds.fLeft <= bounds.fLeft);
+    SkASSERT(rowBounds.fRight >= bounds.fRight);
+
+    int x = rowBounds.fLeft;
+    while (x < bounds.fRight) {
+        int n = row[0];
+        if (x + n > bounds.fLeft && 0xFF != row[1]) {
+            return false;
+        }
+        x += n;
+        row += 2;
+    }
+    return true;
+}
+
 static void operateY(SkAAClip::Builder& builder, const SkAAClip& A,
                      const SkAAClip& B, SkRegion::Op op) {
     AlphaProc proc = find_alpha_proc(op);
     const SkIRect& bounds = builder.getBounds();
 
+    // When intersecting, a row of one clip that is opaque across the result
+    // leaves the other clip's row untouched. If that other clip spans exactly
+    // our width, its encoded row can be copied instead of being rebuilt run
+    // by run. This is the common case of nesting one clip inside another.
+    const bool copyRowsA = SkRegion::kIntersect_Op == op &&
+                           A.getBounds().fLeft == bounds.fLeft &&
+                           A.getBounds().fRight == bounds.fRight;
+    const bool copyRowsB = SkRegion::kIntersect_Op == op &&
+                           B.getBounds().fLeft == bounds.fLeft &&
+                           B.getBounds().fRight == bounds.fRight;
+
     SkAAClip::Iter iterA(A);
     SkAAClip::Iter iterB(B);
 
@@ -1590,9 +1649,19 @@ static void operateY(SkAAClip::Builder& builder, const SkAAClip& A,
             builder.addRun(bounds.fLeft, bot - 1, 0, bounds.width());
         } else if (top >= bounds.fTop) {
             SkASSERT(bot <= bounds.fBottom);
-            RowIter rowIterA(rowA, rowA ? A.getBounds() : bounds);
-            RowIter rowIterB(rowB, rowB ? B.getBounds() : bounds);
-            operatorX(builder, bot - 1, rowIterA, rowIterB, proc, bounds);
+            if (copyRowsA && rowA && rowB &&
+                    row_is_opaque(rowB, B.getBounds(), bounds)) {
+                builder.addRowData(bot - 1, rowA,
+                                   compute_row_length(rowA, bounds.width()));
+            } else if (copyRowsB && rowA && rowB &&
+                       row_is_opaque(rowA, A.getBounds(), bounds)) {
+                builder.addRowData(bot - 1, rowB,
+                                   compute_row_length(rowB, bounds.width()));
+            } else {
+                RowIter rowIterA(rowA, rowA ? A.getBounds() : bounds);
+                RowIter rowIterB(rowB, rowB ? B.getBounds() : bounds);
+                operatorX(builder, bot - 1, rowIterA, rowIterB, proc, bounds);
+            }
         }
 
         adjust_iter(iterA, topA, botA, bot);
@@ -54,6 +54,12 @@ public:
      */
     void copyToMask(SkMask*) const;
 
+    /**
+     *  Returns the bytes used by the clip's run data, which is shared with
+     *  the clips it was copied from or to.
+     */
+    size_t computeRunsSize() const;
+
     // called internally
 
     bool quickContains(int left, int top, int right, int bottom) const;
@@ -85,6 +91,7 @@ private:
     bool trimLeftRight();
 
     friend class Builder;
+    friend class SkAAClipCache;
     class BuilderBlitter;
     friend class BuilderBlitter;
 };
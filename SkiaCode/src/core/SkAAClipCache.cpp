@@ -0,0 +1,264 @@
+
+/*
+ * Copyright 2012 Google Inc.
+ *
+ * Use of this source code is governed by a BSD-style license that can be
+ * found in the LICENSE file.
+ */
+
+#include "SkAAClipCache.h"
+#include "SkBuffer.h"
+#include "SkPath.h"
+#include "SkPathRef.h"
+#include "SkTLRUCache.h"
+#include "SkThread.h"
+
+struct SkAAClipCache::Key {
+    enum Kind {
+        kPath_Kind  = 1,
+        kOp_Kind    = 2
+    };
+
+    int32_t     fKind;
+    int32_t     fFlags;         // doAA for a path, the op for an op
+    uint32_t    fPathHash;
+    int32_t     fFillType;
+    int32_t     fPointCount;
+    int32_t     fVerbCount;
+    SkIRect     fBoundsA;       // the path's clip, or a's bounds
+    SkIRect     fBoundsB;
+    const void* fRunsA;
+    const void* fRunsB;
+
+    void initPath(const SkPath& path, const SkIRect& clip, bool doAA) {
+        // zero any padding, since we hash and compare the raw bytes
+        sk_bzero(this, sizeof(*this));
+        fKind = kPath_Kind;
+        fFlags = doAA;
+        fPathHash = SkAAClipCache::HashPathData(path);
+        fFillType = path.getFillType();
+        fPointCount = path.countPoints();
+        fVerbCount = path.countVerbs();
+        fBoundsA = clip;
+    }
+
+    void initOp(const SkAAClip& a, const SkAAClip& b, SkRegion::Op op) {
+        sk_bzero(this, sizeof(*this));
+        fKind = kOp_Kind;
+        fFlags = op;
+        fBoundsA = a.getBounds();
+        fBoundsB = b.getBounds();
+        fRunsA = SkAAClipCache::RunsID(a);
+        fRunsB = SkAAClipCache::RunsID(b);
+    }
+
+    uint32_t hash() const {
+        return SkTLRUCacheHash(*this);
+    }
+
+    bool operator==(const Key& other) const {
+        return 0 == memcmp(this, &other, sizeof(Key));
+    }
+};
+
+uint32_t SkAAClipCache::HashPathData(const SkPath& path) {
+    const SkPathRef& ref = *path.fPathRef.get();
+    uint32_t hash = SkChecksum::Compute(reinterpret_cast<const uint32_t*>(ref.points()),
+                                        ref.countPoints() * sizeof(SkPoint));
+    const uint8_t* verbs = ref.verbsMemBegin();
+    for (int i = 0; i < ref.countVerbs(); ++i) {
+        hash = hash * 31 + verbs[i];
+    }
+    return hash;
+}
+
+// A key, and for a path key the path, to tell apart paths whose data hash
+// the same.
+struct SkAAClipCache::Query {
+    Query(const Key& key, const SkPath* path) : fKey(key), fPath(path) {}
+
+    const Key&      fKey;
+    const SkPath*   fPath;
+};
+
+class SkAAClipCache::Entry {
+public:
+    Entry(const Key& key)
+        : fKey(key)
+        , fHash(key.hash())
+        , fHashNext(NULL)
+        , fPrev(NULL)
+        , fNext(NULL) {}
+
+    Key         fKey;
+    uint32_t    fHash;
+    SkPath      fPath;      // for a path
+    SkAAClip    fA;         // for an op, holds on to the operands' runs
+    SkAAClip    fB;
+    SkAAClip    fResult;
+    Entry*      fHashNext;
+    Entry*      fPrev;      // LRU order, most recently used first
+    Entry*      fNext;
+
+    bool matches(const Query& query) const {
+        return fKey == query.fKey && (NULL == query.fPath || fPath == *query.fPath);
+    }
+};
+
+///////////////////////////////////////////////////////////////////////////////
+
+struct SkAAClipCache_Traits {
+    typedef SkAAClipCache::Entry Entry;
+
+    // Only the result's runs are charged: the operands' are shared with the
+    // clips they came from, and the path's points with the caller's path.
+    static size_t Bytes(const Entry* entry) {
+        return sizeof(Entry) + entry->fResult.computeRunsSize();
+    }
+    static void Free(Entry* entry) {
+        SkDELETE(entry);
+    }
+};
+
+class SkAAClipCache_Globals {
+public:
+    typedef SkAAClipCache::Entry Entry;
+    typedef SkAAClipCache::Key Key;
+    typedef SkAAClipCache::Query Query;
+
+    SkAAClipCache_Globals()
+        : fCache(SkAAClipCache::kDefaultByteLimit,
+                 SkAAClipCache::kDefaultCountLimit) {}
+
+    SkMutex                 fMutex;
+
+    typedef SkTLRUCache<Entry, SkAAClipCache_Traits> Cache;
+
+    // guarded by fMutex
+    Cache                   fCache;
+
+    Entry* find(const Key& key, const SkPath* path, bool* shouldAdd) {
+        return fCache.find(key.hash(), Query(key, path), shouldAdd);
+    }
+
+    // Takes ownership of entry.
+    void add(Entry* entry, const SkPath* path) {
+        if (!fCache.add(entry, Query(entry->fKey, path))) {
+            // another thread beat us to it, or the cache is disabled
+            SkDELETE(entry);
+        }
+    }
+};
+
+static SkAAClipCache_Globals& get_globals() {
+    // we leak this, so we don't incur any shutdown cost of the destructor
+    static SkAAClipCache_Globals* gGlobals = SkNEW(SkAAClipCache_Globals);
+    return *gGlobals;
+}
+
+bool SkAAClipCache::FindPath(const SkPath& path, const SkIRect& clip, bool doAA,
+                             SkAAClip* result, bool* shouldAdd) {
+    Key key;
+    key.initPath(path, clip, doAA);
+
+    SkAAClipCache_Globals& globals = get_globals();
+    SkAutoMutexAcquire ac(globals.fMutex);
+
+    Entry* entry = globals.find(key, &path, shouldAdd);
+    if (entry) {
+        *result = entry->fResult;
+        return true;
+    }
+    return false;
+}
+
+void SkAAClipCache::AddPath(const SkPath& path, const SkIRect& clip, bool doAA,
+                            const SkAAClip& result) {
+    Key key;
+    key.initPath(path, clip, doAA);
+    Entry* entry = SkNEW_ARGS(Entry, (key));
+    entry->fPath = path;
+    entry->fResult = result;
+
+    SkAAClipCache_Globals& globals = get_globals();
+    SkAutoMutexAcquire ac(globals.fMutex);
+    globals.add(entry, &path);
+}
+
+bool SkAAClipCache::FindOp(const SkAAClip& a, const SkAAClip& b, SkRegion::Op op,
+                           SkAAClip* result, bool* shouldAdd) {
+    Key key;
+    key.initOp(a, b, op);
+
+    SkAAClipCache_Globals& globals = get_globals();
+    SkAutoMutexAcquire ac(globals.fMutex);
+
+    Entry* entry = globals.find(key, NULL, shouldAdd);
+    if (entry) {
+        *result = entry->fResult;
+        return true;
+    }
+    return false;
+}
+
+void SkAAClipCache::AddOp(const SkAAClip& a, const SkAAClip& b, SkRegion::Op op,
+                          const SkAAClip& result) {
+    Key key;
+    key.initOp(a, b, op);
+    Entry* entry = SkNEW_ARGS(Entry, (key));
+    entry->fA = a;
+    entry->fB = b;
+    entry->fResult = result;
+
+    SkAAClipCache_Globals& globals = get_globals();
+    SkAutoMutexAcquire ac(globals.fMutex);
+    globals.add(entry, NULL);
+}
+
+void SkAAClipCache::GetStats(Stats* stats) {
+    SkAAClipCache_Globals& globals = get_globals();
+    SkAutoMutexAcquire ac(globals.fMutex);
+    const SkAAClipCache_Globals::Cache::Stats& cacheStats = globals.fCache.stats();
+    stats->fHits = cacheStats.fHits;
+    stats->fMisses = cacheStats.fMisses;
+    stats->fAdds = cacheStats.fAdds;
+    stats->fEvictions = cacheStats.fEvictions;
+    stats->fBytesUsed = globals.fCache.bytesUsed();
+    stats->fCount = globals.fCache.count();
+}
+
+void SkAAClipCache::ResetStats() {
+    SkAAClipCache_Globals& globals = get_globals();
+    SkAutoMutexAcquire ac(globals.fMutex);
+    globals.fCache.resetStats();
+}
+
+int SkAAClipCache::GetCountLimit() {
+    SkAAClipCache_Globals& globals = get_globals();
+    SkAutoMutexAcquire ac(globals.fMutex);
+    return globals.fCache.countLimit();
+}
+
+int SkAAClipCache::SetCountLimit(int count) {
+    SkAAClipCache_Globals& globals = get_globals();
+    SkAutoMutexAcquire ac(globals.fMutex);
+    return globals.fCache.setCountLimit(count);
+}
+
+size_t SkAAClipCache::GetByteLimit() {
+    SkAAClipCache_Globals& globals = get_globals();
+    SkAutoMutexAcquire ac(globals.fMutex);
+    return globals.fCache.byteLimit();
+}
+
+size_t SkAAClipCache::SetByteLimit(size_t bytes) {
+    SkAAClipCache_Globals& globals = get_globals();
+    SkAutoMutexAcquire ac(globals.fMutex);
+    return globals.fCache.setByteLimit(bytes);
+}
+
+void SkAAClipCache::Purge() {
+    SkAAClipCache_Globals& globals = get_globals();
+    SkAutoMutexAcquire ac(globals.fMutex);
+    globals.fCache.purgeTo(0, 0);
+}
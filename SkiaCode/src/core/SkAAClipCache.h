@@ -0,0 +1,102 @@
+
+/*
+ * Copyright 2012 Google Inc.
+ *
+ * Use of this source code is governed by a BSD-style license that can be
+ * found in the LICENSE file.
+ */
+
+#ifndef SkAAClipCache_DEFINED
+#define SkAAClipCache_DEFINED
+
+#include "SkAAClip.h"
+
+class SkPath;
+
+/**
+ *  A process-wide cache of the antialiased clips SkRasterClip builds, so that
+ *  a clip stack that recurs each frame (the same clip paths, nested the same
+ *  way) reuses its clips instead of scan converting and combining them again.
+ *
+ *  Two kinds of result are cached:
+ *   - the clip built from a path, keyed on the path's points, verbs and fill
+ *     type, whether it is antialiased, and the rectangle it was clipped to;
+ *   - the result of combining two clips, keyed on the identity of the
+ *     operands' run data and their bounds, and the op. Entries hold refs to
+ *     their operands, so that run data can't be freed and reallocated at the
+ *     same address while it is a key.
+ *
+ *  Clip stack generation IDs can't serve as keys: every clipPath() call gets
+ *  a new one, even when it is handed the same path as last frame.
+ *
+ *  A key is only cached the second time it is seen, so clips that are built
+ *  once don't pay to be cached. Once the cache exceeds either its byte or its
+ *  count limit, the least recently used clips are evicted. The cache is
+ *  thread-safe.
+ */
+class SkAAClipCache {
+public:
+    enum {
+        kDefaultByteLimit   = 1024 * 1024,
+        kDefaultCountLimit  = 64
+    };
+
+    /**
+     *  If the clip for path (antialiased if doAA), clipped to the rect clip,
+     *  is cached, copy it into result and return true. Otherwise set
+     *  shouldAdd to whether the caller should build the clip and AddPath() it.
+     */
+    static bool FindPath(const SkPath& path, const SkIRect& clip, bool doAA,
+                         SkAAClip* result, bool* shouldAdd);
+    static void AddPath(const SkPath& path, const SkIRect& clip, bool doAA,
+                        const SkAAClip& result);
+
+    /**
+     *  If (a op b) is cached, copy it into result (which may be a or b) and
+     *  return true. Otherwise set shouldAdd as above.
+     */
+    static bool FindOp(const SkAAClip& a, const SkAAClip& b, SkRegion::Op op,
+                       SkAAClip* result, bool* shouldAdd);
+    static void AddOp(const SkAAClip& a, const SkAAClip& b, SkRegion::Op op,
+                      const SkAAClip& result);
+
+    struct Stats {
+        uint32_t    fHits;
+        uint32_t    fMisses;
+        uint32_t    fAdds;
+        uint32_t    fEvictions;
+        size_t      fBytesUsed;
+        int         fCount;
+    };
+
+    static void GetStats(Stats*);
+    static void ResetStats();
+
+    static int GetCountLimit();
+    /**
+     *  Sets the most entries the cache may hold, and returns the previous
+     *  limit. A limit of zero disables the cache.
+     */
+    static int SetCountLimit(int count);
+
+    static size_t GetByteLimit();
+    /**
+     *  Sets the most memory the cached clips' run data may use, and returns
+     *  the previous limit. A limit of zero disables the cache.
+     */
+    static size_t SetByteLimit(size_t bytes);
+    static void Purge();
+
+private:
+    struct Key;
+    struct Query;
+    class Entry;
+
+    static uint32_t HashPathData(const SkPath&);
+    static const void* RunsID(const SkAAClip& clip) { return clip.fRunHead; }
+
+    friend class SkAAClipCache_Globals;
+    friend struct SkAAClipCache_Traits;
+};
+
+#endif
@@ -20,6 +20,7 @@
 #include "SkTemplates.h"
 #include "SkTextFormatParams.h"
 #include "SkTLazy.h"
+#include "SkTrace.h"
 #include "SkUtils.h"
 
 SK_DEFINE_INST_COUNT(SkBounder)
@@ -1018,6 +1019,7 @@ void SkCanvas::internalDrawDevice(SkDevice* srcDev, int x, int y,
 
 void SkCanvas::drawSprite(const SkBitmap& bitmap, int x, int y,
                           const SkPaint* paint) {
+    SK_TRACE_SCOPE("skia.canvas", "SkCanvas::drawSprite");
     SkDEBUGCODE(bitmap.validate();)
 
     if (reject_bitmap(bitmap)) {
@@ -1463,6 +1465,7 @@ void SkCanvas::clear(SkColor color) {
 }
 
 void SkCanvas::drawPaint(const SkPaint& paint) {
+    SK_TRACE_SCOPE("skia.canvas", "SkCanvas::drawPaint");
     this->internalDrawPaint(paint);
 }
 
@@ -1478,6 +1481,7 @@ void SkCanvas::internalDrawPaint(const SkPaint& paint) {
 
 void SkCanvas::drawPoints(PointMode mode, size_t count, const SkPoint pts[],
                           const SkPaint& paint) {
+    SK_TRACE_SCOPE("skia.canvas", "SkCanvas::drawPoints");
     if ((long)count <= 0) {
         return;
     }
@@ -1508,6 +1512,7 @@ void SkCanvas::drawPoints(PointMode mode, size_t count, const SkPoint pts[],
 }
 
 void SkCanvas::drawRect(const SkRect& r, const SkPaint& paint) {
+    SK_TRACE_SCOPE("skia.canvas", "SkCanvas::drawRect");
     if (paint.canComputeFastBounds()) {
         SkRect storage;
         if (this->quickReject(paint.computeFastBounds(r, &storage))) {
@@ -1525,6 +1530,7 @@ void SkCanvas::drawRect(const SkRect& r, const SkPaint& paint) {
 }
 
 void SkCanvas::drawPath(const SkPath& path, const SkPaint& paint) {
+    SK_TRACE_SCOPE("skia.canvas", "SkCanvas::drawPath");
     if (!path.isFinite()) {
         return;
     }
@@ -1554,6 +1560,7 @@ void SkCanvas::drawPath(const SkPath& path, const SkPaint& paint) {
 
 void SkCanvas::drawBitmap(const SkBitmap& bitmap, SkScalar x, SkScalar y,
                           const SkPaint* paint) {
+    SK_TRACE_SCOPE("skia.canvas", "SkCanvas::drawBitmap");
     SkDEBUGCODE(bitmap.validate();)
 
     if (NULL == paint || paint->canComputeFastBounds()) {
@@ -1631,12 +1638,14 @@ void SkCanvas::internalDrawBitmapRect(const SkBitmap& bitmap, const SkIRect* src
 
 void SkCanvas::drawBitmapRect(const SkBitmap& bitmap, const SkIRect* src,
                               const SkRect& dst, const SkPaint* paint) {
+    SK_TRACE_SCOPE("skia.canvas", "SkCanvas::drawBitmapRect");
     SkDEBUGCODE(bitmap.validate();)
     this->internalDrawBitmapRect(bitmap, src, dst, paint);
 }
 
 void SkCanvas::drawBitmapMatrix(const SkBitmap& bitmap, const SkMatrix& matrix,
                                 const SkPaint* paint) {
+    SK_TRACE_SCOPE("skia.canvas", "SkCanvas::drawBitmapMatrix");
     SkDEBUGCODE(bitmap.validate();)
     this->internalDrawBitmap(bitmap, NULL, matrix, paint);
 }
@@ -1718,6 +1727,7 @@ void SkCanvas::internalDrawBitmapNine(const SkBitmap& bitmap,
 
 void SkCanvas::drawBitmapNine(const SkBitmap& bitmap, const SkIRect& center,
                               const SkRect& dst, const SkPaint* paint) {
+    SK_TRACE_SCOPE("skia.canvas", "SkCanvas::drawBitmapNine");
     SkDEBUGCODE(bitmap.validate();)
 
     // Need a device entry-point, so gpu can use a mesh
@@ -1819,6 +1829,7 @@ void SkCanvas::DrawTextDecorations(const SkDraw& draw, const SkPaint& paint,
 
 void SkCanvas::drawText(const void* text, size_t byteLength,
                         SkScalar x, SkScalar y, const SkPaint& paint) {
+    SK_TRACE_SCOPE("skia.canvas", "SkCanvas::drawText");
     LOOPER_BEGIN(paint, SkDrawFilter::kText_Type)
 
     while (iter.next()) {
@@ -1833,6 +1844,7 @@ void SkCanvas::drawText(const void* text, size_t byteLength,
 
 void SkCanvas::drawPosText(const void* text, size_t byteLength,
                            const SkPoint pos[], const SkPaint& paint) {
+    SK_TRACE_SCOPE("skia.canvas", "SkCanvas::drawPosText");
     LOOPER_BEGIN(paint, SkDrawFilter::kText_Type)
 
     while (iter.next()) {
@@ -1847,6 +1859,7 @@ void SkCanvas::drawPosText(const void* text, size_t byteLength,
 void SkCanvas::drawPosTextH(const void* text, size_t byteLength,
                             const SkScalar xpos[], SkScalar constY,
                             const SkPaint& paint) {
+    SK_TRACE_SCOPE("skia.canvas", "SkCanvas::drawPosTextH");
     LOOPER_BEGIN(paint, SkDrawFilter::kText_Type)
 
     while (iter.next()) {
@@ -1861,6 +1874,7 @@ void SkCanvas::drawPosTextH(const void* text, size_t byteLength,
 void SkCanvas::drawTextOnPath(const void* text, size_t byteLength,
                               const SkPath& path, const SkMatrix* matrix,
                               const SkPaint& paint) {
+    SK_TRACE_SCOPE("skia.canvas", "SkCanvas::drawTextOnPath");
     LOOPER_BEGIN(paint, SkDrawFilter::kText_Type)
 
     while (iter.next()) {
@@ -1891,6 +1905,7 @@ void SkCanvas::drawVertices(VertexMode vmode, int vertexCount,
                             const SkColor colors[], SkXfermode* xmode,
                             const uint16_t indices[], int indexCount,
                             const SkPaint& paint) {
+    SK_TRACE_SCOPE("skia.canvas", "SkCanvas::drawVertices");
     LOOPER_BEGIN(paint, SkDrawFilter::kPath_Type)
 
     while (iter.next()) {
@@ -2048,6 +2063,7 @@ void SkCanvas::drawTextOnPathHV(const void* text, size_t byteLength,
 ///////////////////////////////////////////////////////////////////////////////
 
 void SkCanvas::drawPicture(SkPicture& picture) {
+    SK_TRACE_SCOPE("skia.canvas", "SkCanvas::drawPicture");
     picture.draw(this);
 }
 
@@ -17,6 +17,7 @@
 #include "SkMaskFilter.h"
 #include "SkPaint.h"
 #include "SkPathEffect.h"
+#include "SkPathMaskCache.h"
 #include "SkRasterClip.h"
 #include "SkRasterizer.h"
 #include "SkScan.h"
@@ -894,6 +895,116 @@ bool SkDrawTreatAsHairline(const SkPaint& paint, const SkMatrix& matrix,
     return false;
 }
 
+// Only plain antialiased fills (including strokes, which become fills) are
+// cached: other features (mask filters, rasterizers, bounders) need to see the
+// path itself, and hairlines blend each segment separately, so overlapping
+// segments would look different if drawn from a mask.
+static bool is_path_mask_cacheable(const SkPaint& paint, SkBounder* bounder) {
+    if (SkPaint::kFill_Style != paint.getStyle() && 0 == paint.getStrokeWidth()) {
+        return false;
+    }
+    return paint.isAntiAlias() && NULL == paint.getMaskFilter() &&
+           NULL == paint.getRasterizer() && NULL == bounder;
+}
+
+// Renders the (unclipped) coverage of devPath into a new A8 mask, if it is
+// small enough to be cached.
+static bool render_path_mask(const SkPath& devPath, SkMask* mask) {
+    SkIRect bounds;
+    SkRect pathBounds = devPath.getBounds();
+    pathBounds.inset(-SK_ScalarHalf, -SK_ScalarHalf);
+    pathBounds.roundOut(&bounds);
+    if (bounds.isEmpty() ||
+            bounds.width() > SkPathMaskCache::kMaxMaskDimension ||
+            bounds.height() > SkPathMaskCache::kMaxMaskDimension) {
+        return false;
+    }
+
+    mask->fBounds = bounds;
+    mask->fFormat = SkMask::kA8_Format;
+    mask->fRowBytes = bounds.width();
+    mask->fImage = SkMask::AllocImage(mask->computeImageSize());
+    memset(mask->fImage, 0, mask->computeImageSize());
+
+    SkBitmap bm;
+    bm.setConfig(SkBitmap::kA8_Config, bounds.width(), bounds.height(),
+                 mask->fRowBytes);
+    bm.setPixels(mask->fImage);
+
+    // translating by whole pixels leaves the coverage unchanged
+    SkPath path;
+    devPath.offset(-SkIntToScalar(bounds.fLeft), -SkIntToScalar(bounds.fTop),
+                   &path);
+    SkRasterClip clip(SkIRect::MakeWH(bounds.width(), bounds.height()));
+    SkPaint paint;
+    SkAutoBlitterChoose blitter(bm, SkMatrix::I(), paint);
+    SkScan::AntiFillPath(path, clip, blitter.get());
+    return true;
+}
+
+// Computes the part of the path's (pre-matrix) space that can be seen through
+// the clip, so that path effects can skip geometry that won't be drawn.
+// Features that can move coverage around (mask filters, rasterizers) need to
+// see all of the geometry.
+static bool compute_cull_rect(const SkPaint& paint, const SkMatrix& matrix,
+                              const SkRasterClip& rc, SkRect* cullRect) {
+    if (NULL == paint.getPathEffect() || paint.getMaskFilter() ||
+            paint.getRasterizer() || matrix.hasPerspective()) {
+        return false;
+    }
+    SkMatrix inverse;
+    if (!matrix.invert(&inverse)) {
+        return false;
+    }
+    SkRect devClip;
+    devClip.set(rc.getBounds());
+    // leave room for antialiasing and hairlines
+    devClip.outset(SK_Scalar1, SK_Scalar1);
+    inverse.mapRect(cullRect, devClip);
+    return true;
+}
+
+// If the paint's path effect turns path into axis-aligned rects (e.g. dashing
+// a horizontal line), blit those directly rather than building, stroking and
+// scan converting a path for them.
+static bool draw_path_effect_rects(const SkPath& path, const SkPaint& paint,
+                                   const SkMatrix& matrix,
+                                   const SkRect& cullRect,
+                                   const SkBitmap& device,
+                                   const SkMatrix& shaderMatrix,
+                                   const SkRasterClip& rc) {
+    if (!matrix.rectStaysRect() || path.isInverseFillType()) {
+        return false;
+    }
+
+    SkTDArray<SkRect> rects;
+    SkPath fillPath;
+    if (!paint.getPathEffect()->asRects(&rects, &fillPath, path,
+                                        SkStrokeRec(paint), cullRect)) {
+        return false;
+    }
+
+    SkAutoBlitterChoose blitter(device, shaderMatrix, paint);
+    for (int i = 0; i < rects.count(); ++i) {
+        SkRect devRect;
+        matrix.mapRect(&devRect, rects[i]);
+        if (paint.isAntiAlias()) {
+            SkScan::AntiFillRect(devRect, rc, blitter.get());
+        } else {
+            SkScan::FillRect(devRect, rc, blitter.get());
+        }
+    }
+    if (!fillPath.isEmpty()) {
+        fillPath.transform(matrix);
+        if (paint.isAntiAlias()) {
+            SkScan::AntiFillPath(fillPath, rc, blitter.get());
+        } else {
+            SkScan::FillPath(fillPath, rc, blitter.get());
+        }
+    }
+    return true;
+}
+
 void SkDraw::drawPath(const SkPath& origSrcPath, const SkPaint& origPaint,
                       const SkMatrix* prePathMatrix, bool pathIsMutable) const {
     SkDEBUGCODE(this->validate();)
@@ -961,8 +1072,45 @@ void SkDraw::drawPath(const SkPath& origSrcPath, const SkPaint& origPaint,
         }
     }
 
+    SkRect cullRect;
+    const bool canCull = compute_cull_rect(*paint, *matrix, *fRC, &cullRect);
+
+    if (canCull && NULL == fBounder &&
+            draw_path_effect_rects(*pathPtr, *paint, *matrix, cullRect,
+                                   *fBitmap, *fMatrix, *fRC)) {
+        return;
+    }
+
+    // If we've drawn this path like this before, just blit its mask. This
+    // only works if the path hasn't been transformed by prePathMatrix.
+    SkPathMaskCache::Key cacheKey;
+    SkIPoint cacheOrigin;
+    bool addToCache = false;
+    if (pathPtr == &origSrcPath && is_path_mask_cacheable(*paint, fBounder) &&
+            cacheKey.init(origSrcPath, *matrix, *paint, &cacheOrigin)) {
+        SkAutoTUnref<SkPathMaskCache::Entry> entry(
+                SkPathMaskCache::Find(cacheKey, &addToCache));
+        if (entry.get()) {
+            SkMask mask;
+            entry->getMask(cacheOrigin, &mask);
+            this->drawDevMask(mask, *paint);
+            return;
+        }
+        if (addToCache && canCull && paint->canComputeFastBounds()) {
+            // don't give up culling for a mask that is too big to be cached
+            SkRect storage, devBounds;
+            matrix->mapRect(&devBounds,
+                            paint->computeFastBounds(origSrcPath.getBounds(),
+                                                     &storage));
+            addToCache = devBounds.width() <= SkPathMaskCache::kMaxMaskDimension &&
+                         devBounds.height() <= SkPathMaskCache::kMaxMaskDimension;
+        }
+    }
+
     if (paint->getPathEffect() || paint->getStyle() != SkPaint::kFill_Style) {
-        doFill = paint->getFillPath(*pathPtr, &tmpPath);
+        // a cached mask must hold all of the path, not just what's visible now
+        const SkRect* cull = (canCull && !addToCache) ? &cullRect : NULL;
+        doFill = paint->getFillPath(*pathPtr, &tmpPath, cull);
         pathPtr = &tmpPath;
     }
 
@@ -983,6 +1131,16 @@ void SkDraw::drawPath(const SkPath& origSrcPath, const SkPaint& origPaint,
     // transform the path into device space
     pathPtr->transform(*matrix, devPathPtr);
 
+    if (addToCache && doFill && !devPathPtr->isInverseFillType()) {
+        SkMask mask;
+        if (render_path_mask(*devPathPtr, &mask)) {
+            SkAutoTUnref<SkPathMaskCache::Entry> entry(
+                    SkPathMaskCache::Add(cacheKey, mask, cacheOrigin));
+            this->drawDevMask(mask, *paint);
+            return;
+        }
+    }
+
     SkAutoBlitterChoose blitter(*fBitmap, *fMatrix, *paint);
 
     if (paint->getMaskFilter()) {
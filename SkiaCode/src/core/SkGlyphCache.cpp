@@ -13,6 +13,7 @@
 #include "SkPath.h"
 #include "SkTemplates.h"
 #include "SkTLS.h"
+#include "SkTrace.h"
 
 //#define SPEW_PURGE_STATUS
 //#define USE_CACHE_HASH
@@ -269,6 +270,7 @@ SkGlyph* SkGlyphCache::lookupMetrics(uint32_t id, MetricsType mtype) {
     }
 
     // not found, but hi tells us where to inser the new glyph
+    SK_TRACE_SCOPE("skia.glyph", "SkGlyphCache::lookupMetrics miss");
     fMemoryUsed += sizeof(SkGlyph);
 
     glyph = (SkGlyph*)fGlyphAlloc.alloc(sizeof(SkGlyph),
@@ -291,6 +293,7 @@ SkGlyph* SkGlyphCache::lookupMetrics(uint32_t id, MetricsType mtype) {
 const void* SkGlyphCache::findImage(const SkGlyph& glyph) {
     if (glyph.fWidth > 0 && glyph.fWidth < kMaxGlyphWidth) {
         if (glyph.fImage == NULL) {
+            SK_TRACE_SCOPE("skia.glyph", "SkGlyphCache::findImage miss");
             size_t  size = glyph.computeImageSize();
             const_cast<SkGlyph&>(glyph).fImage = fImageAlloc.alloc(size,
                                         SkChunkAlloc::kReturnNil_AllocFailType);
@@ -311,6 +314,7 @@ const void* SkGlyphCache::findImage(const SkGlyph& glyph) {
 const SkPath* SkGlyphCache::findPath(const SkGlyph& glyph) {
     if (glyph.fWidth) {
         if (glyph.fPath == NULL) {
+            SK_TRACE_SCOPE("skia.glyph", "SkGlyphCache::findPath miss");
             const_cast<SkGlyph&>(glyph).fPath = SkNEW(SkPath);
             fScalerContext->getPath(glyph, glyph.fPath);
             fMemoryUsed += sizeof(SkPath) +
@@ -558,7 +562,10 @@ SkGlyphCache* SkGlyphCache::VisitCache(const SkDescriptor* desc,
     ac.release();           // release the mutex now
     insideMutex = false;    // can't use globals anymore
 
-    cache = SkNEW_ARGS(SkGlyphCache, (desc));
+    {
+        SK_TRACE_SCOPE("skia.glyph", "SkGlyphCache::VisitCache miss");
+        cache = SkNEW_ARGS(SkGlyphCache, (desc));
+    }
 
 FOUND_IT:
 
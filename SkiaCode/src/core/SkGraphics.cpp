@@ -10,6 +10,7 @@
 #include "SkGraphics.h"
 
 #include "Sk64.h"
+#include "SkAAClipCache.h"
 #include "SkBlitter.h"
 #include "SkCanvas.h"
 #include "SkFloat.h"
@@ -122,6 +123,8 @@ void SkGraphics::Init() {
 
 void SkGraphics::Term() {
     PurgeFontCache();
+    PurgePathMaskCache();
+    SkAAClipCache::Purge();
     SkPaint::Term();
 }
 
@@ -129,13 +132,16 @@ void SkGraphics::Term() {
 
 static const char kFontCacheLimitStr[] = "font-cache-limit";
 static const size_t kFontCacheLimitLen = sizeof(kFontCacheLimitStr) - 1;
+static const char kPathMaskCacheLimitStr[] = "path-mask-cache-limit";
+static const size_t kPathMaskCacheLimitLen = sizeof(kPathMaskCacheLimitStr) - 1;
 
 static const struct {
     const char* fStr;
     size_t fLen;
     size_t (*fFunc)(size_t);
 } gFlags[] = {
-    { kFontCacheLimitStr, kFontCacheLimitLen, SkGraphics::SetFontCacheLimit }
+    { kFontCacheLimitStr, kFontCacheLimitLen, SkGraphics::SetFontCacheLimit },
+    { kPathMaskCacheLimitStr, kPathMaskCacheLimitLen, SkGraphics::SetPathMaskCacheLimit }
 };
 
 /* flags are of the form param; or param=value; */
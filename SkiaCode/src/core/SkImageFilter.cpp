@@ -6,10 +6,24 @@
  */
 
 #include "SkImageFilter.h"
+#include "SkBitmap.h"
 #include "SkRect.h"
+#include "SkThread.h"
 
 SK_DEFINE_INST_COUNT(SkImageFilter)
 
+// guards gParallelFor and gTileSize, which are read as a pair
+SK_DECLARE_STATIC_MUTEX(gParallelForMutex);
+static SkParallelForProc gParallelFor;
+static int gTileSize = SkImageFilter::kDefaultTileSize;
+
+void SkImageFilter::SetParallelFor(SkParallelForProc parallelFor, int tileSize) {
+    SkASSERT(tileSize > 0);
+    SkAutoMutexAcquire ac(gParallelForMutex);
+    gParallelFor = parallelFor;
+    gTileSize = tileSize;
+}
+
 bool SkImageFilter::filterImage(Proxy* proxy, const SkBitmap& src,
                                 const SkMatrix& ctm,
                                 SkBitmap* result, SkIPoint* loc) {
@@ -17,12 +31,132 @@ bool SkImageFilter::filterImage(Proxy* proxy, const SkBitmap& src,
     SkASSERT(loc);
     /*
      *  Give the proxy first shot at the filter. If it returns false, ask
-     *  the filter to do it.
+     *  the filter to do it, in tiles if it can. The tiles are filtered
+     *  without a proxy, so only calls that came with one (i.e. from a
+     *  device, and not from another filter's tile) are split.
      */
     return (proxy && proxy->filterImage(this, src, ctm, result, loc)) ||
+           (proxy && this->filterImageInTiles(src, ctm, result)) ||
            this->onFilterImage(proxy, src, ctm, result, loc);
 }
 
+struct SkImageFilter::TileRec {
+    SkImageFilter*  fFilter;
+    const SkBitmap* fSrc;
+    const SkMatrix* fCTM;
+    SkBitmap*       fResult;
+    SkISize         fMargin;
+    int             fTileSize;
+    int             fCols;
+    int32_t         fFailed;
+};
+
+bool SkImageFilter::filterImageInTiles(const SkBitmap& src, const SkMatrix& ctm,
+                                       SkBitmap* result) {
+    SkParallelForProc parallelFor;
+    int tileSize;
+    {
+        SkAutoMutexAcquire ac(gParallelForMutex);
+        parallelFor = gParallelFor;
+        tileSize = gTileSize;
+    }
+    if (NULL == parallelFor || src.config() != SkBitmap::kARGB_8888_Config) {
+        return false;
+    }
+
+    SkISize margin;
+    if (!this->filterMargin(ctm, &margin) ||
+            margin.width() < 0 || margin.height() < 0) {
+        return false;
+    }
+
+    // keep the tiles large enough that the margins don't swamp them
+    tileSize = SkMax32(tileSize, 4 * SkMax32(margin.width(), margin.height()));
+    if (src.width() <= tileSize && src.height() <= tileSize) {
+        return false;
+    }
+
+    SkAutoLockPixels alp(src);
+    if (!src.getPixels()) {
+        return false;
+    }
+
+    SkBitmap dst;
+    dst.setConfig(src.config(), src.width(), src.height());
+    if (!dst.allocPixels()) {
+        return false;
+    }
+    SkAutoLockPixels alpDst(dst);
+
+    TileRec rec;
+    rec.fFilter = this;
+    rec.fSrc = &src;
+    rec.fCTM = &ctm;
+    rec.fResult = &dst;
+    rec.fMargin = margin;
+    rec.fTileSize = tileSize;
+    rec.fCols = (src.width() + tileSize - 1) / tileSize;
+    rec.fFailed = 0;
+
+    int rows = (src.height() + tileSize - 1) / tileSize;
+    parallelFor(rec.fCols * rows, FilterTileProc, &rec);
+
+    // if any tile failed, the caller filters src in one pass instead
+    if (rec.fFailed) {
+        return false;
+    }
+    result->swap(dst);
+    return true;
+}
+
+void SkImageFilter::FilterTileProc(void* context, int index) {
+    TileRec* rec = static_cast<TileRec*>(context);
+    const SkBitmap& src = *rec->fSrc;
+
+    SkIRect bounds = SkIRect::MakeWH(src.width(), src.height());
+    SkIRect tile = SkIRect::MakeXYWH((index % rec->fCols) * rec->fTileSize,
+                                     (index / rec->fCols) * rec->fTileSize,
+                                     rec->fTileSize, rec->fTileSize);
+    tile.intersect(bounds);
+
+    SkIRect subsetR = tile;
+    subsetR.outset(rec->fMargin.width(), rec->fMargin.height());
+    subsetR.intersect(bounds);
+
+    // Point straight at src's pixels, rather than calling extractSubset(),
+    // so the tiles don't contend for the pixel ref's lock.
+    SkBitmap subset;
+    subset.setConfig(src.config(), subsetR.width(), subsetR.height(),
+                     src.rowBytes());
+    subset.setPixels(src.getAddr(subsetR.fLeft, subsetR.fTop));
+
+    SkBitmap tileResult;
+    SkIPoint offset = SkIPoint::Make(0, 0);
+    if (!rec->fFilter->onFilterImage(NULL, subset, *rec->fCTM, &tileResult,
+                                     &offset) ||
+            offset.fX || offset.fY ||
+            tileResult.config() != src.config() ||
+            tileResult.width() != subset.width() ||
+            tileResult.height() != subset.height()) {
+        sk_atomic_inc(&rec->fFailed);
+        return;
+    }
+
+    SkAutoLockPixels alp(tileResult);
+    if (!tileResult.getPixels()) {
+        sk_atomic_inc(&rec->fFailed);
+        return;
+    }
+
+    const int dx = tile.fLeft - subsetR.fLeft;
+    const int dy = tile.fTop - subsetR.fTop;
+    const size_t bytes = tile.width() << 2;
+    for (int y = 0; y < tile.height(); ++y) {
+        memcpy(rec->fResult->getAddr32(tile.fLeft, tile.fTop + y),
+               tileResult.getAddr32(dx, dy + y), bytes);
+    }
+}
+
 bool SkImageFilter::filterBounds(const SkIRect& src, const SkMatrix& ctm,
                                  SkIRect* dst) {
     SkASSERT(&src);
@@ -30,6 +164,11 @@ bool SkImageFilter::filterBounds(const SkIRect& src, const SkMatrix& ctm,
     return this->onFilterBounds(src, ctm, dst);
 }
 
+bool SkImageFilter::filterMargin(const SkMatrix& ctm, SkISize* margin) {
+    SkASSERT(margin);
+    return this->onFilterMargin(ctm, margin);
+}
+
 bool SkImageFilter::onFilterImage(Proxy*, const SkBitmap&, const SkMatrix&,
                                   SkBitmap*, SkIPoint*) {
     return false;
@@ -49,6 +188,10 @@ bool SkImageFilter::onFilterBounds(const SkIRect& src, const SkMatrix& ctm,
     return true;
 }
 
+bool SkImageFilter::onFilterMargin(const SkMatrix&, SkISize*) {
+    return false;
+}
+
 bool SkImageFilter::asNewCustomStage(GrCustomStage**, GrTexture*) const {
     return false;
 }
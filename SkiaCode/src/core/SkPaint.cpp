@@ -2133,14 +2133,20 @@ SkMaskFilter* SkPaint::setMaskFilter(SkMaskFilter* filter) {
 
 ///////////////////////////////////////////////////////////////////////////////
 
-bool SkPaint::getFillPath(const SkPath& src, SkPath* dst) const {
+bool SkPaint::getFillPath(const SkPath& src, SkPath* dst,
+                          const SkRect* cullRect) const {
     SkStrokeRec rec(*this);
 
     const SkPath* srcPtr = &src;
     SkPath tmpPath;
 
-    if (fPathEffect && fPathEffect->filterPath(&tmpPath, src, &rec)) {
-        srcPtr = &tmpPath;
+    if (fPathEffect) {
+        bool filtered = cullRect ?
+                fPathEffect->filterPathInRect(&tmpPath, src, &rec, *cullRect) :
+                fPathEffect->filterPath(&tmpPath, src, &rec);
+        if (filtered) {
+            srcPtr = &tmpPath;
+        }
     }
 
     if (!rec.applyToPath(dst, *srcPtr)) {
@@ -227,6 +227,10 @@ void SkPath::swap(SkPath& other) {
     }
 }
 
+int32_t SkPath::getPathRefGenID() const {
+    return fPathRef->genID();
+}
+
 #ifdef SK_BUILD_FOR_ANDROID
 uint32_t SkPath::getGenerationID() const {
     return fGenerationID;
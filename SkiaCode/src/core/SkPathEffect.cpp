@@ -116,6 +116,16 @@ void SkPathEffect::computeFastBounds(SkRect* dst, const SkRect& src) {
     *dst = src;
 }
 
+bool SkPathEffect::filterPathInRect(SkPath* dst, const SkPath& src,
+                                    SkStrokeRec* rec, const SkRect&) {
+    return this->filterPath(dst, src, rec);
+}
+
+bool SkPathEffect::asRects(SkTDArray<SkRect>*, SkPath*, const SkPath&,
+                           const SkStrokeRec&, const SkRect&) {
+    return false;
+}
+
 ///////////////////////////////////////////////////////////////////////////////
 
 SkPairPathEffect::SkPairPathEffect(SkPathEffect* pe0, SkPathEffect* pe1)
@@ -0,0 +1,207 @@
+
+/*
+ * Copyright 2012 Google Inc.
+ *
+ * Use of this source code is governed by a BSD-style license that can be
+ * found in the LICENSE file.
+ */
+
+#include "SkPathMaskCache.h"
+#include "SkGraphics.h"
+#include "SkMatrix.h"
+#include "SkPaint.h"
+#include "SkPath.h"
+#include "SkPathEffect.h"
+#include "SkTLRUCache.h"
+#include "SkThread.h"
+
+int32_t SkPathMaskCache::PathGenID(const SkPath& path) {
+    return path.getPathRefGenID();
+}
+
+bool SkPathMaskCache::Key::init(const SkPath& path, const SkMatrix& matrix,
+                                const SkPaint& paint, SkIPoint* origin) {
+    if (matrix.hasPerspective() || path.isInverseFillType()) {
+        return false;
+    }
+
+    // keep the translate well within int range (and finite)
+    static const SkScalar kMaxTranslate = SkIntToScalar(1 << 24);
+    SkScalar tx = matrix.getTranslateX();
+    SkScalar ty = matrix.getTranslateY();
+    if (!(SkScalarAbs(tx) < kMaxTranslate && SkScalarAbs(ty) < kMaxTranslate)) {
+        return false;
+    }
+
+    // zero any padding, since we hash and compare the raw bytes
+    sk_bzero(this, sizeof(*this));
+
+    fPathGenID = SkPathMaskCache::PathGenID(path);
+    fFillType = path.getFillType();
+    fStyle = paint.getStyle();
+    if (SkPaint::kFill_Style != paint.getStyle()) {
+        fCap = paint.getStrokeCap();
+        fJoin = paint.getStrokeJoin();
+        fStrokeWidth = paint.getStrokeWidth();
+        fMiter = paint.getStrokeMiter();
+    }
+    fMatrix[0] = matrix.getScaleX();
+    fMatrix[1] = matrix.getSkewX();
+    fMatrix[2] = matrix.getSkewY();
+    fMatrix[3] = matrix.getScaleY();
+
+    SkScalar floorX = SkScalarFloorToScalar(tx);
+    SkScalar floorY = SkScalarFloorToScalar(ty);
+    fFracX = tx - floorX;
+    fFracY = ty - floorY;
+    fPathEffect = paint.getPathEffect();
+
+    origin->set(SkScalarRoundToInt(floorX), SkScalarRoundToInt(floorY));
+    return true;
+}
+
+uint32_t SkPathMaskCache::Key::hash() const {
+    return SkTLRUCacheHash(*this);
+}
+
+bool SkPathMaskCache::Key::operator==(const Key& other) const {
+    return 0 == memcmp(this, &other, sizeof(Key));
+}
+
+///////////////////////////////////////////////////////////////////////////////
+
+SkPathMaskCache::Entry::Entry(const Key& key, const SkMask& mask,
+                              const SkIPoint& origin)
+    : fKey(key)
+    , fHash(key.hash())
+    , fMask(mask)
+    , fOrigin(origin)
+    , fHashNext(NULL)
+    , fPrev(NULL)
+    , fNext(NULL) {
+    SkASSERT(SkMask::kA8_Format == mask.fFormat);
+    SkSafeRef(fKey.fPathEffect);
+}
+
+SkPathMaskCache::Entry::~Entry() {
+    SkSafeUnref(fKey.fPathEffect);
+    SkMask::FreeImage(fMask.fImage);
+}
+
+///////////////////////////////////////////////////////////////////////////////
+
+typedef SkPathMaskCache::Entry Entry;
+
+struct SkPathMaskCache_Traits {
+    static size_t Bytes(const Entry* entry) {
+        return entry->fMask.computeImageSize();
+    }
+    static void Free(Entry* entry) {
+        entry->unref();
+    }
+};
+
+class SkPathMaskCache_Globals {
+public:
+    SkPathMaskCache_Globals()
+        : fCache(SkPathMaskCache::kDefaultByteLimit, SK_MaxS32) {}
+
+    SkMutex                 fMutex;
+
+    typedef SkTLRUCache<Entry, SkPathMaskCache_Traits> Cache;
+
+    // guarded by fMutex
+    Cache                   fCache;
+};
+
+static SkPathMaskCache_Globals& get_globals() {
+    // we leak this, so we don't incur any shutdown cost of the destructor
+    static SkPathMaskCache_Globals* gGlobals = SkNEW(SkPathMaskCache_Globals);
+    return *gGlobals;
+}
+
+SkPathMaskCache::Entry* SkPathMaskCache::Find(const Key& key, bool* shouldAdd) {
+    SkPathMaskCache_Globals& globals = get_globals();
+    SkAutoMutexAcquire ac(globals.fMutex);
+
+    Entry* entry = globals.fCache.find(key.hash(), key, shouldAdd);
+    if (entry) {
+        entry->ref();
+    }
+    return entry;
+}
+
+SkPathMaskCache::Entry* SkPathMaskCache::Add(const Key& key, const SkMask& mask,
+                                             const SkIPoint& origin) {
+    Entry* entry = SkNEW_ARGS(Entry, (key, mask, origin));
+
+    SkPathMaskCache_Globals& globals = get_globals();
+    SkAutoMutexAcquire ac(globals.fMutex);
+
+    entry->ref();   // for the cache
+    if (!globals.fCache.add(entry, key)) {
+        // another thread beat us to it, or it can never fit; just hand it back
+        entry->unref();
+    }
+    return entry;
+}
+
+void SkPathMaskCache::GetStats(Stats* stats) {
+    SkPathMaskCache_Globals& globals = get_globals();
+    SkAutoMutexAcquire ac(globals.fMutex);
+    const SkPathMaskCache_Globals::Cache::Stats& cacheStats = globals.fCache.stats();
+    stats->fHits = cacheStats.fHits;
+    stats->fMisses = cacheStats.fMisses;
+    stats->fAdds = cacheStats.fAdds;
+    stats->fEvictions = cacheStats.fEvictions;
+    stats->fBytesUsed = globals.fCache.bytesUsed();
+    stats->fCount = globals.fCache.count();
+}
+
+void SkPathMaskCache::ResetStats() {
+    SkPathMaskCache_Globals& globals = get_globals();
+    SkAutoMutexAcquire ac(globals.fMutex);
+    globals.fCache.resetStats();
+}
+
+size_t SkPathMaskCache::GetByteLimit() {
+    SkPathMaskCache_Globals& globals = get_globals();
+    SkAutoMutexAcquire ac(globals.fMutex);
+    return globals.fCache.byteLimit();
+}
+
+size_t SkPathMaskCache::SetByteLimit(size_t bytes) {
+    SkPathMaskCache_Globals& globals = get_globals();
+    SkAutoMutexAcquire ac(globals.fMutex);
+    return globals.fCache.setByteLimit(bytes);
+}
+
+size_t SkPathMaskCache::GetBytesUsed() {
+    SkPathMaskCache_Globals& globals = get_globals();
+    SkAutoMutexAcquire ac(globals.fMutex);
+    return globals.fCache.bytesUsed();
+}
+
+void SkPathMaskCache::Purge() {
+    SkPathMaskCache_Globals& globals = get_globals();
+    SkAutoMutexAcquire ac(globals.fMutex);
+    globals.fCache.purgeTo(0, 0);
+}
+
+///////////////////////////////////////////////////////////////////////////////
+
+size_t SkGraphics::GetPathMaskCacheLimit() {
+    return SkPathMaskCache::GetByteLimit();
+}
+
+size_t SkGraphics::SetPathMaskCacheLimit(size_t bytes) {
+    return SkPathMaskCache::SetByteLimit(bytes);
+}
+
+size_t SkGraphics::GetPathMaskCacheUsed() {
+    return SkPathMaskCache::GetBytesUsed();
+}
+
+void SkGraphics::PurgePathMaskCache() {
+    SkPathMaskCache::Purge();
+}
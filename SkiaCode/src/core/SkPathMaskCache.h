@@ -0,0 +1,146 @@
+
+/*
+ * Copyright 2012 Google Inc.
+ *
+ * Use of this source code is governed by a BSD-style license that can be
+ * found in the LICENSE file.
+ */
+
+#ifndef SkPathMaskCache_DEFINED
+#define SkPathMaskCache_DEFINED
+
+#include "SkMask.h"
+#include "SkRefCnt.h"
+
+class SkMatrix;
+class SkPaint;
+class SkPath;
+class SkPathEffect;
+
+/**
+ *  A process-wide cache of the antialiased coverage masks SkDraw::drawPath
+ *  produces, so that paths drawn repeatedly (icons, glyph-like shapes) skip
+ *  the path effect, stroking and scan conversion and are just blitted.
+ *
+ *  Masks are keyed on the path's geometry (its SkPathRef's generation ID and
+ *  its fill type), the paint's stroke parameters and path effect, and the
+ *  matrix up to an integer translate, so the same mask is reused when a path
+ *  is drawn at whole-pixel offsets. A key is only cached the second time it is
+ *  seen, so paths that are drawn once don't pay to be cached.
+ *
+ *  The cache is off until SkGraphics::SetPathMaskCacheLimit() gives it a limit:
+ *  blitting a mask may round coverage differently from the scan converter, so
+ *  a cached draw can differ by one from the draw that cached it.
+ *
+ *  The cache is thread-safe: entries are refcounted, so one thread may blit a
+ *  mask while another evicts it.
+ */
+class SkPathMaskCache {
+public:
+    struct Key {
+        int32_t         fPathGenID;
+        uint8_t         fFillType;
+        uint8_t         fStyle;
+        uint8_t         fCap;
+        uint8_t         fJoin;
+        SkScalar        fStrokeWidth;
+        SkScalar        fMiter;
+        SkScalar        fMatrix[4];     // scaleX, skewX, skewY, scaleY
+        SkScalar        fFracX;         // the fractional part of the translate
+        SkScalar        fFracY;
+        SkPathEffect*   fPathEffect;    // the entry owns a ref
+
+        /**
+         *  Returns false if a draw of path with matrix and paint can't be
+         *  cached, e.g. because of perspective. Otherwise initializes the key
+         *  and returns the integer part of the translate in origin.
+         */
+        bool init(const SkPath& path, const SkMatrix& matrix,
+                  const SkPaint& paint, SkIPoint* origin);
+
+        uint32_t hash() const;
+        bool operator==(const Key& other) const;
+    };
+
+    class Entry : public SkRefCnt {
+    public:
+        /**
+         *  Returns the cached mask, positioned for a draw whose integer
+         *  translate is origin.
+         */
+        void getMask(const SkIPoint& origin, SkMask* mask) const {
+            *mask = fMask;
+            mask->fBounds.offset(origin.fX - fOrigin.fX,
+                                 origin.fY - fOrigin.fY);
+        }
+
+    private:
+        Entry(const Key&, const SkMask&, const SkIPoint& origin);
+        virtual ~Entry();
+
+        Key         fKey;
+        uint32_t    fHash;
+        SkMask      fMask;      // we own fMask.fImage
+        SkIPoint    fOrigin;
+        Entry*      fHashNext;
+        Entry*      fPrev;      // LRU order, most recently used first
+        Entry*      fNext;
+
+        bool matches(const Key& key) const { return fKey == key; }
+
+        friend class SkPathMaskCache;
+        friend struct SkPathMaskCache_Traits;
+        template <typename E, typename T> friend class SkTLRUCache;
+
+        typedef SkRefCnt INHERITED;
+    };
+
+    enum {
+        // off until given a limit, since a cached mask may blit a coverage
+        // one off from what the scan converter would have
+        kDefaultByteLimit   = 0,
+        kSuggestedByteLimit = 2 * 1024 * 1024,
+        kMaxMaskDimension   = 256,      // larger masks are never cached
+    };
+
+    /**
+     *  Returns the (ref'd) entry for key, or NULL. If NULL is returned and
+     *  shouldAdd is not NULL, it is set to whether the caller should render
+     *  the mask and add() it.
+     */
+    static Entry* Find(const Key& key, bool* shouldAdd);
+
+    /**
+     *  Adds mask (which must be A8, and whose image the cache takes ownership
+     *  of), rendered for a draw whose integer translate is origin. Returns the
+     *  ref'd entry; it may already have been evicted if it exceeds the limit.
+     */
+    static Entry* Add(const Key& key, const SkMask& mask,
+                      const SkIPoint& origin);
+
+    struct Stats {
+        uint32_t    fHits;
+        uint32_t    fMisses;
+        uint32_t    fAdds;
+        uint32_t    fEvictions;
+        size_t      fBytesUsed;
+        int         fCount;
+    };
+
+    static void GetStats(Stats*);
+    static void ResetStats();
+
+    static size_t GetByteLimit();
+    /**
+     *  Sets the most memory the cached masks may use, and returns the previous
+     *  limit. A limit of zero disables the cache.
+     */
+    static size_t SetByteLimit(size_t bytes);
+    static size_t GetBytesUsed();
+    static void Purge();
+
+private:
+    static int32_t PathGenID(const SkPath&);
+};
+
+#endif
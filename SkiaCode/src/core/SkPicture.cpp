@@ -232,7 +232,8 @@ void SkPicture::draw(SkCanvas* surface) {
 // V4 : move SkPictInfo to be the header
 // V5 : don't read/write FunctionPtr on cross-process (we can detect that)
 // V6 : added serialization of SkPath's bounds (and packed its flags tighter)
-#define PICTURE_VERSION     6
+// V7 : optional compact op stream (SkPictInfo::kCompactOpStream_Flag)
+#define PICTURE_VERSION     7
 
 SkPicture::SkPicture(SkStream* stream) : SkRefCnt() {
     fRecord = NULL;
@@ -282,6 +283,9 @@ void SkPicture::serialize(SkWStream* stream) const {
     if (8 == sizeof(void*)) {
         info.fFlags |= SkPictInfo::kPtrIs64Bit_Flag;
     }
+    if (playback && playback->hasCompactOpStream()) {
+        info.fFlags |= SkPictInfo::kCompactOpStream_Flag;
+    }
 
     stream->write(&info, sizeof(info));
     if (playback) {
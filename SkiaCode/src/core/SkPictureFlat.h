@@ -68,6 +68,14 @@ enum DrawVertexFlags {
     DRAW_VERTICES_HAS_INDICES = 0x04
 };
 
+// In a compact op stream (SkPicture::kCompactOpStream_RecordingFlag) each run
+// of coordinates is preceded by a packed int saying how it was written.
+enum PackedScalarsFormat {
+    PACKED_SCALARS_RAW,     // as SkScalars, just as in the non-compact stream
+    PACKED_SCALARS_DELTA    // whole numbers, as packed deltas from the values
+                            // 'stride' entries before them
+};
+
 ///////////////////////////////////////////////////////////////////////////////
 // clipparams are packed in 5 bits
 //  doAA:1 | regionOp:4
@@ -66,8 +66,11 @@ SkPicturePlayback::SkPicturePlayback(const SkPictureRecord& record, bool deepCop
     record.validate();
     const SkWriter32& writer = record.writeStream();
     init();
-    if (writer.size() == 0)
+    fCompactOps = record.fCompactOps;
+    if (writer.size() == 0) {
+        fOpData = SkData::NewEmpty();
         return;
+    }
 
     {
         size_t size = writer.size();
@@ -140,6 +143,7 @@ SkPicturePlayback::SkPicturePlayback(const SkPicturePlayback& src, SkPictCopyInf
     fMatrices = SkSafeRef(src.fMatrices);
     fRegions = SkSafeRef(src.fRegions);
     fOpData = SkSafeRef(src.fOpData);
+    fCompactOps = src.fCompactOps;
 
     if (deepCopyInfo) {
 
@@ -203,6 +207,7 @@ void SkPicturePlayback::init() {
     fPictureCount = 0;
     fOpData = NULL;
     fFactoryPlayback = NULL;
+    fCompactOps = false;
 }
 
 SkPicturePlayback::~SkPicturePlayback() {
@@ -509,6 +514,7 @@ bool SkPicturePlayback::parseBufferTag(SkOrderedReadBuffer& buffer,
 SkPicturePlayback::SkPicturePlayback(SkStream* stream, const SkPictInfo& info,
                                      bool* isValid) {
     this->init();
+    fCompactOps = SkToBool(info.fFlags & SkPictInfo::kCompactOpStream_Flag);
 
     *isValid = false;   // wait until we're done parsing to mark as true
     for (;;) {
@@ -560,6 +566,7 @@ void SkPicturePlayback::draw(SkCanvas& canvas) {
 
     SkReader32 reader(fOpData->bytes(), fOpData->size());
     TextContainer text;
+    ScalarStorage coords(0), texCoords(0);
 
     // Record this, so we can concat w/ it if we encounter a setMatrix()
     SkMatrix initialMatrix = canvas.getTotalMatrix();
@@ -616,14 +623,15 @@ void SkPicturePlayback::draw(SkCanvas& canvas) {
             case DRAW_BITMAP: {
                 const SkPaint* paint = getPaint(reader);
                 const SkBitmap& bitmap = getBitmap(reader);
-                const SkPoint& loc = reader.skipT<SkPoint>();
-                canvas.drawBitmap(bitmap, loc.fX, loc.fY, paint);
+                const SkScalar* loc = getScalars(reader, 2, 2, &coords);
+                canvas.drawBitmap(bitmap, loc[0], loc[1], paint);
             } break;
             case DRAW_BITMAP_RECT: {
                 const SkPaint* paint = getPaint(reader);
                 const SkBitmap& bitmap = getBitmap(reader);
                 const SkIRect* src = this->getIRectPtr(reader);   // may be null
-                const SkRect& dst = reader.skipT<SkRect>();     // required
+                const SkRect& dst = *(const SkRect*)getScalars(reader, 4, 2,
+                                                               &coords);
                 canvas.drawBitmapRect(bitmap, src, dst, paint);
             } break;
             case DRAW_BITMAP_MATRIX: {
@@ -636,7 +644,8 @@ void SkPicturePlayback::draw(SkCanvas& canvas) {
                 const SkPaint* paint = getPaint(reader);
                 const SkBitmap& bitmap = getBitmap(reader);
                 const SkIRect& src = reader.skipT<SkIRect>();
-                const SkRect& dst = reader.skipT<SkRect>();
+                const SkRect& dst = *(const SkRect*)getScalars(reader, 4, 2,
+                                                               &coords);
                 canvas.drawBitmapNine(bitmap, src, dst, paint);
             } break;
             case DRAW_CLEAR:
@@ -659,23 +668,26 @@ void SkPicturePlayback::draw(SkCanvas& canvas) {
                 break;
             case DRAW_POINTS: {
                 const SkPaint& paint = *getPaint(reader);
-                SkCanvas::PointMode mode = (SkCanvas::PointMode)reader.readInt();
-                size_t count = reader.readInt();
-                const SkPoint* pts = (const SkPoint*)reader.skip(sizeof(SkPoint) * count);
+                SkCanvas::PointMode mode = (SkCanvas::PointMode)getPackedUInt(reader);
+                size_t count = getPackedUInt(reader);
+                const SkPoint* pts = (const SkPoint*)getScalars(reader, 2 * count,
+                                                                2, &coords);
                 canvas.drawPoints(mode, count, pts, paint);
             } break;
             case DRAW_POS_TEXT: {
                 const SkPaint& paint = *getPaint(reader);
                 getText(reader, &text);
-                size_t points = reader.readInt();
-                const SkPoint* pos = (const SkPoint*)reader.skip(points * sizeof(SkPoint));
+                size_t points = getPackedUInt(reader);
+                const SkPoint* pos = (const SkPoint*)getScalars(reader, 2 * points,
+                                                                2, &coords);
                 canvas.drawPosText(text.text(), text.length(), pos, paint);
             } break;
             case DRAW_POS_TEXT_TOP_BOTTOM: {
                 const SkPaint& paint = *getPaint(reader);
                 getText(reader, &text);
-                size_t points = reader.readInt();
-                const SkPoint* pos = (const SkPoint*)reader.skip(points * sizeof(SkPoint));
+                size_t points = getPackedUInt(reader);
+                const SkPoint* pos = (const SkPoint*)getScalars(reader, 2 * points,
+                                                                2, &coords);
                 const SkScalar top = reader.readScalar();
                 const SkScalar bottom = reader.readScalar();
                 if (!canvas.quickRejectY(top, bottom)) {
@@ -685,20 +697,20 @@ void SkPicturePlayback::draw(SkCanvas& canvas) {
             case DRAW_POS_TEXT_H: {
                 const SkPaint& paint = *getPaint(reader);
                 getText(reader, &text);
-                size_t xCount = reader.readInt();
+                size_t xCount = getPackedUInt(reader);
                 const SkScalar constY = reader.readScalar();
-                const SkScalar* xpos = (const SkScalar*)reader.skip(xCount * sizeof(SkScalar));
+                const SkScalar* xpos = getScalars(reader, xCount, 1, &coords);
                 canvas.drawPosTextH(text.text(), text.length(), xpos, constY,
                                     paint);
             } break;
             case DRAW_POS_TEXT_H_TOP_BOTTOM: {
                 const SkPaint& paint = *getPaint(reader);
                 getText(reader, &text);
-                size_t xCount = reader.readInt();
-                const SkScalar* xpos = (const SkScalar*)reader.skip((3 + xCount) * sizeof(SkScalar));
-                const SkScalar top = *xpos++;
-                const SkScalar bottom = *xpos++;
-                const SkScalar constY = *xpos++;
+                size_t xCount = getPackedUInt(reader);
+                const SkScalar top = reader.readScalar();
+                const SkScalar bottom = reader.readScalar();
+                const SkScalar constY = reader.readScalar();
+                const SkScalar* xpos = getScalars(reader, xCount, 1, &coords);
                 if (!canvas.quickRejectY(top, bottom)) {
                     canvas.drawPosTextH(text.text(), text.length(), xpos,
                                         constY, paint);
@@ -706,32 +718,30 @@ void SkPicturePlayback::draw(SkCanvas& canvas) {
             } break;
             case DRAW_RECT: {
                 const SkPaint& paint = *getPaint(reader);
-                canvas.drawRect(reader.skipT<SkRect>(), paint);
+                canvas.drawRect(*(const SkRect*)getScalars(reader, 4, 2, &coords),
+                                paint);
             } break;
             case DRAW_SPRITE: {
                 const SkPaint* paint = getPaint(reader);
                 const SkBitmap& bitmap = getBitmap(reader);
-                int left = reader.readInt();
-                int top = reader.readInt();
+                int left = getPackedInt(reader);
+                int top = getPackedInt(reader);
                 canvas.drawSprite(bitmap, left, top, paint);
             } break;
             case DRAW_TEXT: {
                 const SkPaint& paint = *getPaint(reader);
                 getText(reader, &text);
-                SkScalar x = reader.readScalar();
-                SkScalar y = reader.readScalar();
-                canvas.drawText(text.text(), text.length(), x, y, paint);
+                const SkScalar* loc = getScalars(reader, 2, 2, &coords);
+                canvas.drawText(text.text(), text.length(), loc[0], loc[1], paint);
             } break;
             case DRAW_TEXT_TOP_BOTTOM: {
                 const SkPaint& paint = *getPaint(reader);
                 getText(reader, &text);
-                const SkScalar* ptr = (const SkScalar*)reader.skip(4 * sizeof(SkScalar));
-                // ptr[0] == x
-                // ptr[1] == y
-                // ptr[2] == top
-                // ptr[3] == bottom
-                if (!canvas.quickRejectY(ptr[2], ptr[3])) {
-                    canvas.drawText(text.text(), text.length(), ptr[0], ptr[1],
+                const SkScalar* loc = getScalars(reader, 2, 2, &coords);
+                const SkScalar top = reader.readScalar();
+                const SkScalar bottom = reader.readScalar();
+                if (!canvas.quickRejectY(top, bottom)) {
+                    canvas.drawText(text.text(), text.length(), loc[0], loc[1],
                                     paint);
                 }
             } break;
@@ -745,25 +755,25 @@ void SkPicturePlayback::draw(SkCanvas& canvas) {
             } break;
             case DRAW_VERTICES: {
                 const SkPaint& paint = *getPaint(reader);
-                DrawVertexFlags flags = (DrawVertexFlags)reader.readInt();
-                SkCanvas::VertexMode vmode = (SkCanvas::VertexMode)reader.readInt();
-                int vCount = reader.readInt();
-                const SkPoint* verts = (const SkPoint*)reader.skip(
-                                                    vCount * sizeof(SkPoint));
+                DrawVertexFlags flags = (DrawVertexFlags)getPackedUInt(reader);
+                SkCanvas::VertexMode vmode = (SkCanvas::VertexMode)getPackedUInt(reader);
+                int vCount = getPackedUInt(reader);
+                const SkPoint* verts = (const SkPoint*)getScalars(reader,
+                                                    2 * vCount, 2, &coords);
                 const SkPoint* texs = NULL;
                 const SkColor* colors = NULL;
                 const uint16_t* indices = NULL;
                 int iCount = 0;
                 if (flags & DRAW_VERTICES_HAS_TEXS) {
-                    texs = (const SkPoint*)reader.skip(
-                                                    vCount * sizeof(SkPoint));
+                    texs = (const SkPoint*)getScalars(reader, 2 * vCount, 2,
+                                                      &texCoords);
                 }
                 if (flags & DRAW_VERTICES_HAS_COLORS) {
                     colors = (const SkColor*)reader.skip(
                                                     vCount * sizeof(SkColor));
                 }
                 if (flags & DRAW_VERTICES_HAS_INDICES) {
-                    iCount = reader.readInt();
+                    iCount = getPackedUInt(reader);
                     indices = (const uint16_t*)reader.skip(
                                                     iCount * sizeof(uint16_t));
                 }
@@ -820,6 +830,20 @@ void SkPicturePlayback::draw(SkCanvas& canvas) {
 //    this->dumpSize();
 }
 
+const SkScalar* SkPicturePlayback::getScalars(SkReader32& reader, int count,
+                                              int stride, ScalarStorage* storage) {
+    if (fCompactOps && PACKED_SCALARS_DELTA == reader.readPackedUInt()) {
+        storage->reset(count);
+        SkScalar* values = storage->get();
+        for (int i = 0; i < count; i++) {
+            SkScalar prev = i >= stride ? values[i - stride] : 0;
+            values[i] = prev + SkIntToScalar(reader.readPackedInt());
+        }
+        return values;
+    }
+    return (const SkScalar*)reader.skip(count * sizeof(SkScalar));
+}
+
 void SkPicturePlayback::abort() {
     SkASSERT(!"not supported");
 //    fReader.skip(fReader.size() - fReader.offset());
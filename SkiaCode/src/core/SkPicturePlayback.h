@@ -34,6 +34,7 @@ struct SkPictInfo {
         kCrossProcess_Flag      = 1 << 0,
         kScalarIsFloat_Flag     = 1 << 1,
         kPtrIs64Bit_Flag        = 1 << 2,
+        kCompactOpStream_Flag   = 1 << 3,
     };
 
     uint32_t    fVersion;
@@ -69,6 +70,9 @@ public:
 
     void dumpSize() const;
 
+    // true if the ops were recorded with kCompactOpStream_RecordingFlag
+    bool hasCompactOpStream() const { return fCompactOps; }
+
     // Can be called in the middle of playback (the draw() call). WIll abort the
     // drawing and return from draw() after the "current" op code is done
     void abort();
@@ -82,13 +86,29 @@ private:
         const char* fText;
     };
 
+    // Indices and counts: variable-length in a compact op stream.
+    uint32_t getPackedUInt(SkReader32& reader) {
+        return fCompactOps ? reader.readPackedUInt() : reader.readInt();
+    }
+
+    int32_t getPackedInt(SkReader32& reader) {
+        return fCompactOps ? reader.readPackedInt() : reader.readInt();
+    }
+
+    typedef SkAutoSTMalloc<64, SkScalar> ScalarStorage;
+
+    // Returns count scalars written by SkPictureRecord::addScalars(), either
+    // in place or decoded into storage.
+    const SkScalar* getScalars(SkReader32& reader, int count, int stride,
+                               ScalarStorage* storage);
+
     const SkBitmap& getBitmap(SkReader32& reader) {
-        int index = reader.readInt();
+        int index = this->getPackedUInt(reader);
         return (*fBitmaps)[index];
     }
 
     const SkMatrix* getMatrix(SkReader32& reader) {
-        int index = reader.readInt();
+        int index = this->getPackedUInt(reader);
         if (index == 0) {
             return NULL;
         }
@@ -96,17 +116,17 @@ private:
     }
 
     const SkPath& getPath(SkReader32& reader) {
-        return (*fPathHeap)[reader.readInt() - 1];
+        return (*fPathHeap)[this->getPackedUInt(reader) - 1];
     }
 
     SkPicture& getPicture(SkReader32& reader) {
-        int index = reader.readInt();
+        int index = this->getPackedUInt(reader);
         SkASSERT(index > 0 && index <= fPictureCount);
         return *fPictureRefs[index - 1];
     }
 
     const SkPaint* getPaint(SkReader32& reader) {
-        int index = reader.readInt();
+        int index = this->getPackedUInt(reader);
         if (index == 0) {
             return NULL;
         }
@@ -130,12 +150,12 @@ private:
     }
 
     const SkRegion& getRegion(SkReader32& reader) {
-        int index = reader.readInt();
+        int index = this->getPackedUInt(reader);
         return (*fRegions)[index - 1];
     }
 
     void getText(SkReader32& reader, TextContainer* text) {
-        size_t length = text->fByteLength = reader.readInt();
+        size_t length = text->fByteLength = this->getPackedUInt(reader);
         text->fText = (const char*)reader.skip(length);
     }
 
@@ -192,6 +212,8 @@ private:
     SkPicture** fPictureRefs;
     int fPictureCount;
 
+    bool fCompactOps;
+
     SkTypefacePlayback fTFPlayback;
     SkFactoryPlayback* fFactoryPlayback;
 #ifdef SK_BUILD_FOR_ANDROID
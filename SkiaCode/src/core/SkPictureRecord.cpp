@@ -22,7 +22,8 @@ SkPictureRecord::SkPictureRecord(uint32_t flags) :
         fPaints(&fFlattenableHeap),
         fRegions(&fFlattenableHeap),
         fWriter(MIN_WRITER_SIZE),
-        fRecordFlags(flags) {
+        fRecordFlags(flags),
+        fCompactOps(SkToBool(flags & SkPicture::kCompactOpStream_RecordingFlag)) {
 #ifdef SK_DEBUG_SIZE
     fPointBytes = fRectBytes = fTextBytes = 0;
     fPointWrites = fRectWrites = fTextWrites = 0;
@@ -383,16 +384,16 @@ void SkPictureRecord::drawPoints(PointMode mode, size_t count, const SkPoint pts
                         const SkPaint& paint) {
     addDraw(DRAW_POINTS);
     addPaint(paint);
-    addInt(mode);
-    addInt(count);
-    fWriter.writeMul4(pts, count * sizeof(SkPoint));
+    addPackedUInt(mode);
+    addPackedUInt(count);
+    addPoints(pts, count);
     validate();
 }
 
 void SkPictureRecord::drawRect(const SkRect& rect, const SkPaint& paint) {
     addDraw(DRAW_RECT);
     addPaint(paint);
-    addRect(rect);
+    addScalars(&rect.fLeft, 4, 2);
     validate();
 }
 
@@ -408,8 +409,8 @@ void SkPictureRecord::drawBitmap(const SkBitmap& bitmap, SkScalar left, SkScalar
     addDraw(DRAW_BITMAP);
     addPaintPtr(paint);
     addBitmap(bitmap);
-    addScalar(left);
-    addScalar(top);
+    const SkScalar loc[] = { left, top };
+    addScalars(loc, 2, 2);
     validate();
 }
 
@@ -419,7 +420,7 @@ void SkPictureRecord::drawBitmapRect(const SkBitmap& bitmap, const SkIRect* src,
     addPaintPtr(paint);
     addBitmap(bitmap);
     addIRectPtr(src);  // may be null
-    addRect(dst);
+    addScalars(&dst.fLeft, 4, 2);
     validate();
 }
 
@@ -438,7 +439,7 @@ void SkPictureRecord::drawBitmapNine(const SkBitmap& bitmap, const SkIRect& cent
     addPaintPtr(paint);
     addBitmap(bitmap);
     addIRect(center);
-    addRect(dst);
+    addScalars(&dst.fLeft, 4, 2);
     validate();
 }
 
@@ -447,8 +448,8 @@ void SkPictureRecord::drawSprite(const SkBitmap& bitmap, int left, int top,
     addDraw(DRAW_SPRITE);
     addPaintPtr(paint);
     addBitmap(bitmap);
-    addInt(left);
-    addInt(top);
+    addPackedInt(left);
+    addPackedInt(top);
     validate();
 }
 
@@ -474,8 +475,8 @@ void SkPictureRecord::drawText(const void* text, size_t byteLength, SkScalar x,
     addDraw(fast ? DRAW_TEXT_TOP_BOTTOM : DRAW_TEXT);
     addPaint(paint);
     addText(text, byteLength);
-    addScalar(x);
-    addScalar(y);
+    const SkScalar loc[] = { x, y };
+    addScalars(loc, 2, 2);
     if (fast) {
         addFontMetricsTopBottom(paint, y, y);
     }
@@ -520,7 +521,7 @@ void SkPictureRecord::drawPosText(const void* text, size_t byteLength,
     }
     addPaint(paint);
     addText(text, byteLength);
-    addInt(points);
+    addPackedUInt(points);
 
 #ifdef SK_DEBUG_SIZE
     size_t start = fWriter.size();
@@ -530,12 +531,19 @@ void SkPictureRecord::drawPosText(const void* text, size_t byteLength,
             addFontMetricsTopBottom(paint, pos[0].fY, pos[0].fY);
         }
         addScalar(pos[0].fY);
-        SkScalar* xptr = (SkScalar*)fWriter.reserve(points * sizeof(SkScalar));
-        for (size_t index = 0; index < points; index++)
-            *xptr++ = pos[index].fX;
+        if (fCompactOps) {
+            SkAutoSTMalloc<64, SkScalar> xpos(points);
+            for (size_t index = 0; index < points; index++)
+                xpos[index] = pos[index].fX;
+            addScalars(xpos.get(), points, 1);
+        } else {
+            SkScalar* xptr = (SkScalar*)fWriter.reserve(points * sizeof(SkScalar));
+            for (size_t index = 0; index < points; index++)
+                *xptr++ = pos[index].fX;
+        }
     }
     else {
-        fWriter.writeMul4(pos, points * sizeof(SkPoint));
+        addScalars(&pos[0].fX, points * 2, 2);
         if (fastBounds) {
             addFontMetricsTopBottom(paint, minY, maxY);
         }
@@ -559,7 +567,7 @@ void SkPictureRecord::drawPosTextH(const void* text, size_t byteLength,
     addDraw(fast ? DRAW_POS_TEXT_H_TOP_BOTTOM : DRAW_POS_TEXT_H);
     addPaint(paint);
     addText(text, byteLength);
-    addInt(points);
+    addPackedUInt(points);
 
 #ifdef SK_DEBUG_SIZE
     size_t start = fWriter.size();
@@ -568,7 +576,7 @@ void SkPictureRecord::drawPosTextH(const void* text, size_t byteLength,
         addFontMetricsTopBottom(paint, constY, constY);
     }
     addScalar(constY);
-    fWriter.writeMul4(xpos, points * sizeof(SkScalar));
+    addScalars(xpos, points, 1);
 #ifdef SK_DEBUG_SIZE
     fPointBytes += fWriter.size() - start;
     fPointWrites += points;
@@ -611,9 +619,9 @@ void SkPictureRecord::drawVertices(VertexMode vmode, int vertexCount,
 
     addDraw(DRAW_VERTICES);
     addPaint(paint);
-    addInt(flags);
-    addInt(vmode);
-    addInt(vertexCount);
+    addPackedUInt(flags);
+    addPackedUInt(vmode);
+    addPackedUInt(vertexCount);
     addPoints(vertices, vertexCount);
     if (flags & DRAW_VERTICES_HAS_TEXS) {
         addPoints(texs, vertexCount);
@@ -622,7 +630,7 @@ void SkPictureRecord::drawVertices(VertexMode vmode, int vertexCount,
         fWriter.writeMul4(colors, vertexCount * sizeof(SkColor));
     }
     if (flags & DRAW_VERTICES_HAS_INDICES) {
-        addInt(indexCount);
+        addPackedUInt(indexCount);
         fWriter.writePad(indices, indexCount * sizeof(uint16_t));
     }
 }
@@ -636,7 +644,7 @@ void SkPictureRecord::drawData(const void* data, size_t length) {
 ///////////////////////////////////////////////////////////////////////////////
 
 void SkPictureRecord::addBitmap(const SkBitmap& bitmap) {
-    addInt(fBitmapHeap->insert(bitmap));
+    addPackedUInt(fBitmapHeap->insert(bitmap));
 }
 
 void SkPictureRecord::addMatrix(const SkMatrix& matrix) {
@@ -644,7 +652,7 @@ void SkPictureRecord::addMatrix(const SkMatrix& matrix) {
 }
 
 void SkPictureRecord::addMatrixPtr(const SkMatrix* matrix) {
-    this->addInt(matrix ? fMatrices.find(*matrix) : 0);
+    this->addPackedUInt(matrix ? fMatrices.find(*matrix) : 0);
 }
 
 void SkPictureRecord::addPaint(const SkPaint& paint) {
@@ -652,14 +660,14 @@ void SkPictureRecord::addPaint(const SkPaint& paint) {
 }
 
 void SkPictureRecord::addPaintPtr(const SkPaint* paint) {
-    this->addInt(paint ? fPaints.find(*paint) : 0);
+    this->addPackedUInt(paint ? fPaints.find(*paint) : 0);
 }
 
 void SkPictureRecord::addPath(const SkPath& path) {
     if (NULL == fPathHeap) {
         fPathHeap = SkNEW(SkPathHeap);
     }
-    addInt(fPathHeap->append(path));
+    addPackedUInt(fPathHeap->append(path));
 }
 
 void SkPictureRecord::addPicture(SkPicture& picture) {
@@ -670,7 +678,7 @@ void SkPictureRecord::addPicture(SkPicture& picture) {
         picture.ref();
     }
     // follow the convention of recording a 1-based index
-    addInt(index + 1);
+    addPackedUInt(index + 1);
 }
 
 void SkPictureRecord::addPoint(const SkPoint& point) {
@@ -685,7 +693,7 @@ void SkPictureRecord::addPoint(const SkPoint& point) {
 }
 
 void SkPictureRecord::addPoints(const SkPoint pts[], int count) {
-    fWriter.writeMul4(pts, count * sizeof(SkPoint));
+    addScalars(&pts[0].fX, count * 2, 2);
 #ifdef SK_DEBUG_SIZE
     fPointBytes += count * sizeof(SkPoint);
     fPointWrites++;
@@ -720,14 +728,14 @@ void SkPictureRecord::addIRectPtr(const SkIRect* rect) {
 }
 
 void SkPictureRecord::addRegion(const SkRegion& region) {
-    addInt(fRegions.find(region));
+    addPackedUInt(fRegions.find(region));
 }
 
 void SkPictureRecord::addText(const void* text, size_t byteLength) {
 #ifdef SK_DEBUG_SIZE
     size_t start = fWriter.size();
 #endif
-    addInt(byteLength);
+    addPackedUInt(byteLength);
     fWriter.writePad(text, byteLength);
 #ifdef SK_DEBUG_SIZE
     fTextBytes += fWriter.size() - start;
@@ -735,6 +743,37 @@ void SkPictureRecord::addText(const void* text, size_t byteLength) {
 #endif
 }
 
+// Whole numbers in this range are delta-coded in a compact op stream. It keeps
+// the values (and their differences) exact both as floats and as fixed point.
+// The bits are compared rather than the values, so -0 is not packed as +0.
+static bool is_packable_scalar(SkScalar x) {
+    if (!(SkScalarAbs(x) <= SkIntToScalar(SK_MaxS16))) {
+        return false;
+    }
+    SkScalar packed = SkIntToScalar(SkScalarRoundToInt(x));
+    return 0 == memcmp(&packed, &x, sizeof(SkScalar));
+}
+
+void SkPictureRecord::addScalars(const SkScalar values[], int count,
+                                 int stride) {
+    if (fCompactOps) {
+        int i = 0;
+        while (i < count && is_packable_scalar(values[i])) {
+            i++;
+        }
+        if (i == count) {
+            fWriter.writePackedUInt(PACKED_SCALARS_DELTA);
+            for (i = 0; i < count; i++) {
+                int prev = i >= stride ? SkScalarRoundToInt(values[i - stride]) : 0;
+                fWriter.writePackedInt(SkScalarRoundToInt(values[i]) - prev);
+            }
+            return;
+        }
+        fWriter.writePackedUInt(PACKED_SCALARS_RAW);
+    }
+    fWriter.writeMul4(values, count * sizeof(SkScalar));
+}
+
 ///////////////////////////////////////////////////////////////////////////////
 
 #ifdef SK_DEBUG_SIZE
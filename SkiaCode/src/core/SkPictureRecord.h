@@ -109,6 +109,22 @@ private:
     void addScalar(SkScalar scalar) {
         fWriter.writeScalar(scalar);
     }
+    // Indices and counts: variable-length in a compact op stream.
+    void addPackedUInt(uint32_t value) {
+        if (fCompactOps) {
+            fWriter.writePackedUInt(value);
+        } else {
+            fWriter.writeInt(value);
+        }
+    }
+    void addPackedInt(int32_t value) {
+        if (fCompactOps) {
+            fWriter.writePackedInt(value);
+        } else {
+            fWriter.writeInt(value);
+        }
+    }
+    void addScalars(const SkScalar values[], int count, int stride);
 
     void addBitmap(const SkBitmap& bitmap);
     void addMatrix(const SkMatrix& matrix);
@@ -177,6 +193,8 @@ private:
     SkTDArray<SkPicture*> fPictureRefs;
 
     uint32_t fRecordFlags;
+    // fixed when we're created, since the stream can't change format midway
+    bool fCompactOps;
     int fInitialSaveCount;
 
     friend class SkPicturePlayback;
@@ -6,6 +6,7 @@
  */
 
 #include "SkRasterClip.h"
+#include "SkAAClipCache.h"
 
 
 SkRasterClip::SkRasterClip() {
@@ -81,7 +82,17 @@ bool SkRasterClip::setPath(const SkPath& path, const SkRegion& clip, bool doAA)
         if (this->isBW()) {
             this->convertToAA();
         }
-        (void)fAA.setPath(path, &clip, doAA);
+        // only clips built against a rect are cached, since that is all the
+        // key records of the clip
+        bool shouldAdd = false;
+        if (!clip.isRect() ||
+                !SkAAClipCache::FindPath(path, clip.getBounds(), doAA, &fAA,
+                                         &shouldAdd)) {
+            (void)fAA.setPath(path, &clip, doAA);
+            if (shouldAdd) {
+                SkAAClipCache::AddPath(path, clip.getBounds(), doAA, fAA);
+            }
+        }
     }
     return this->updateCacheAndReturnNonEmpty();
 }
@@ -136,6 +147,11 @@ bool SkRasterClip::op(const SkRasterClip& clip, SkRegion::Op op) {
         SkAAClip tmp;
         const SkAAClip* other;
 
+        // Only ops between clips that were already AA are cached. A clip we
+        // convert here is new every time, so its key could never recur.
+        bool cacheable = this->isAA() && clip.isAA() &&
+                         !fAA.isEmpty() && !clip.aaRgn().isEmpty();
+
         if (this->isBW()) {
             this->convertToAA();
         }
@@ -145,7 +161,18 @@ bool SkRasterClip::op(const SkRasterClip& clip, SkRegion::Op op) {
         } else {
             other = &clip.aaRgn();
         }
-        (void)fAA.op(*other, op);
+
+        bool shouldAdd = false;
+        if (!cacheable ||
+                !SkAAClipCache::FindOp(fAA, *other, op, &fAA, &shouldAdd)) {
+            if (shouldAdd) {
+                SkAAClip orig(fAA);
+                (void)fAA.op(*other, op);
+                SkAAClipCache::AddOp(orig, *other, op, fAA);
+            } else {
+                (void)fAA.op(*other, op);
+            }
+        }
     }
     return this->updateCacheAndReturnNonEmpty();
 }
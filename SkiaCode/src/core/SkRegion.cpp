@@ -8,6 +8,9 @@
 
 
 #include "SkRegionPriv.h"
+#include "SkTDArray.h"
+#include "SkTSearch.h"
+#include "SkTSort.h"
 #include "SkTemplates.h"
 #include "SkThread.h"
 #include "SkUtils.h"
@@ -572,15 +575,7 @@ void SkRegion::translate(int dx, int dy, SkRegion* dst) const {
 ///////////////////////////////////////////////////////////////////////////////
 
 bool SkRegion::setRects(const SkIRect rects[], int count) {
-    if (0 == count) {
-        this->setEmpty();
-    } else {
-        this->setRect(rects[0]);
-        for (int i = 1; i < count; i++) {
-            this->op(rects[i], kUnion_Op);
-        }
-    }
-    return !this->isEmpty();
+    return this->op(rects, count, kUnion_Op);
 }
 
 ///////////////////////////////////////////////////////////////////////////////
@@ -1074,6 +1069,392 @@ bool SkRegion::op(const SkRegion& rgna, const SkRegion& rgnb, Op op) {
 
 ///////////////////////////////////////////////////////////////////////////////
 
+/*  Computes the union or intersection of many regions in a single pass from
+    top to bottom. The intervals of every input that covers the current band
+    are kept as two sorted arrays of left and right edges, which only change
+    when an input starts, ends or steps to its next scanline. A band's result
+    is then one linear walk over those edges, counting how many inputs cover
+    each x.
+
+    The arrays are kept between calls, so a sweeper owned by a
+    SkRegion::Scratch stops allocating once they have grown to fit.
+ */
+class SkRgnSweeper {
+public:
+    void reset(int maxInputs) {
+        fInputs.rewind();
+        fRectRuns.setCount(maxInputs * SkRegion::kRectRegionRuns);
+        fRectCount = 0;
+    }
+
+    void addRect(const SkIRect& rect) {
+        SkASSERT(!rect.isEmpty());
+        SkRegion::RunType* runs = &fRectRuns[fRectCount * SkRegion::kRectRegionRuns];
+        fRectCount += 1;
+        SkRegion::BuildRectRuns(rect, runs);
+        this->addRuns(runs);
+    }
+
+    void addRegion(const SkRegion& rgn) {
+        SkASSERT(!rgn.isEmpty());
+        if (rgn.isRect()) {
+            this->addRect(rgn.getBounds());
+        } else {
+            this->addRuns(rgn.fRunHead->readonly_runs());
+        }
+    }
+
+    /**
+     *  Set dst to the area covered by at least threshold of the inputs. Pass
+     *  1 for their union, or the number of inputs for their intersection.
+     */
+    bool sweep(int threshold, SkRegion* dst);
+
+private:
+    struct Input {
+        const SkRegion::RunType*    fRuns;  // current scanline, at its bottom
+        int32_t                     fTop;
+
+        bool operator<(const Input& other) const {
+            return fTop < other.fTop;
+        }
+    };
+
+    SkTDArray<Input>                fInputs;
+    SkTDArray<Input*>               fActive;
+    SkTDArray<SkRegion::RunType>    fRectRuns;
+    int                             fRectCount;
+
+    SkTDArray<int32_t>              fLefts;
+    SkTDArray<int32_t>              fRights;
+    SkTDArray<SkRegion::RunType>    fSpans;
+
+    SkTDArray<SkRegion::RunType>    fRuns;
+    int                             fPrevStart; // first interval of the last scanline
+    int                             fPrevLen;   // its intervals + x-sentinel
+
+    void addRuns(const SkRegion::RunType runs[]) {
+        Input* input = fInputs.append();
+        input->fTop = runs[0];
+        input->fRuns = runs + 1;
+    }
+
+    static void InsertEdge(SkTDArray<int32_t>* edges, int32_t x) {
+        int index = SkTSearch<int32_t>(edges->begin(), edges->count(), x,
+                                       sizeof(int32_t));
+        if (index < 0) {
+            index = ~index;
+        }
+        *edges->insert(index) = x;
+    }
+
+    static void RemoveEdge(SkTDArray<int32_t>* edges, int32_t x) {
+        int index = SkTSearch<int32_t>(edges->begin(), edges->count(), x,
+                                       sizeof(int32_t));
+        SkASSERT(index >= 0);
+        edges->remove(index);
+    }
+
+    void addEdges(const SkRegion::RunType runs[]) {
+        const int intervals = runs[1];
+        runs += 2;
+        for (int i = 0; i < intervals; ++i) {
+            InsertEdge(&fLefts, runs[0]);
+            InsertEdge(&fRights, runs[1]);
+            runs += 2;
+        }
+    }
+
+    void removeEdges(const SkRegion::RunType runs[]) {
+        const int intervals = runs[1];
+        runs += 2;
+        for (int i = 0; i < intervals; ++i) {
+            RemoveEdge(&fLefts, runs[0]);
+            RemoveEdge(&fRights, runs[1]);
+            runs += 2;
+        }
+    }
+
+    void computeSpans(int threshold);
+    void addScanline(int bottom);
+    int finishRuns();
+};
+
+void SkRgnSweeper::computeSpans(int threshold) {
+    SkASSERT(fLefts.count() == fRights.count());
+
+    const int32_t* lefts = fLefts.begin();
+    const int32_t* rights = fRights.begin();
+    const int count = fRights.count();
+    int i = 0;
+    int j = 0;
+    int depth = 0;
+    int left SK_INIT_TO_AVOID_WARNING;
+
+    fSpans.rewind();
+    // Every interval ends after it starts, so the right edges run out last.
+    while (j < count) {
+        int x = (i < count && lefts[i] < rights[j]) ? lefts[i] : rights[j];
+        bool wasInside = depth >= threshold;
+        while (i < count && lefts[i] == x) {
+            depth += 1;
+            i += 1;
+        }
+        while (j < count && rights[j] == x) {
+            depth -= 1;
+            j += 1;
+        }
+        bool inside = depth >= threshold;
+        if (inside != wasInside) {
+            if (inside) {
+                left = x;
+            } else {
+                SkRegion::RunType* span = fSpans.append(2);
+                span[0] = left;
+                span[1] = x;
+            }
+        }
+    }
+    SkASSERT(0 == depth);
+}
+
+// Same as RgnOper::addSpan: extend the previous scanline if this one is
+// identical, and drop leading empty scanlines by moving the top down.
+void SkRgnSweeper::addScanline(int bottom) {
+    const int count = fSpans.count();
+
+    if (fPrevLen == count + 1 &&
+            !memcmp(&fRuns[fPrevStart], fSpans.begin(),
+                    count * sizeof(SkRegion::RunType))) {
+        fRuns[fPrevStart - 2] = bottom;
+        return;
+    }
+    if (0 == count && 0 == fPrevLen) {
+        fRuns[0] = bottom;
+        return;
+    }
+
+    SkRegion::RunType* runs = fRuns.append(count + 3);
+    runs[0] = bottom;
+    runs[1] = count >> 1;
+    memcpy(runs + 2, fSpans.begin(), count * sizeof(SkRegion::RunType));
+    runs[count + 2] = SkRegion::kRunTypeSentinel;
+    fPrevStart = fRuns.count() - count - 1;
+    fPrevLen = count + 1;
+}
+
+int SkRgnSweeper::finishRuns() {
+    if (1 == fPrevLen) {
+        // drop the trailing empty scanline
+        fRuns.setCount(fPrevStart - 2);
+    }
+    *fRuns.append() = SkRegion::kRunTypeSentinel;
+    return fRuns.count();
+}
+
+bool SkRgnSweeper::sweep(int threshold, SkRegion* dst) {
+    const int count = fInputs.count();
+    SkASSERT(count > 0);
+    SkASSERT(threshold >= 1 && threshold <= count);
+
+    SkTHeapSort<Input>(fInputs.begin(), count);
+
+    fActive.rewind();
+    fLefts.rewind();
+    fRights.rewind();
+    fRuns.setCount(1);
+    fRuns[0] = fInputs[0].fTop;
+    fPrevStart = 0;
+    fPrevLen = 0;
+
+    int pending = 0;
+    int y = fInputs[0].fTop;
+    bool dirty = true;
+    for (;;) {
+        while (pending < count && fInputs[pending].fTop == y) {
+            Input* input = &fInputs[pending++];
+            this->addEdges(input->fRuns);
+            *fActive.append() = input;
+            dirty = true;
+        }
+
+        int bottom = pending < count ? fInputs[pending].fTop :
+                                       SkRegion::kRunTypeSentinel;
+        for (int i = 0; i < fActive.count(); ++i) {
+            bottom = SkMin32(bottom, fActive[i]->fRuns[0]);
+        }
+        if (SkRegion::kRunTypeSentinel == bottom) {
+            break;
+        }
+
+        // While no input starts, ends or steps, each band repeats the last.
+        if (dirty) {
+            this->computeSpans(threshold);
+            dirty = false;
+        }
+        this->addScanline(bottom);
+
+        for (int i = fActive.count() - 1; i >= 0; --i) {
+            Input* input = fActive[i];
+            if (input->fRuns[0] == bottom) {
+                this->removeEdges(input->fRuns);
+                input->fRuns = SkRegion::RunHead::SkipEntireScanline(input->fRuns);
+                if (SkRegion::kRunTypeSentinel == input->fRuns[0]) {
+                    fActive.removeShuffle(i);
+                } else {
+                    this->addEdges(input->fRuns);
+                }
+                dirty = true;
+            }
+        }
+        y = bottom;
+    }
+    SkASSERT(0 == fLefts.count() && 0 == fRights.count());
+
+    return dst->setRuns(fRuns.begin(), this->finishRuns());
+}
+
+SkRegion::Scratch::Scratch() : fSweeper(NULL) {}
+
+SkRegion::Scratch::~Scratch() {
+    SkDELETE(fSweeper);
+}
+
+SkRgnSweeper* SkRegion::Scratch::sweeper() {
+    if (NULL == fSweeper) {
+        fSweeper = SkNEW(SkRgnSweeper);
+    }
+    return fSweeper;
+}
+
+bool SkRegion::op(const SkRegion* const rgns[], int count, Op op,
+                  Scratch* scratch) {
+    SkDEBUGCODE(this->validate();)
+    SkASSERT((unsigned)op < kOpCount);
+
+    if (0 == count) {
+        return this->setEmpty();
+    }
+
+    if (kUnion_Op != op && kIntersect_Op != op) {
+        SkRegion result(*rgns[0]);
+        for (int i = 1; i < count; ++i) {
+            result.op(*rgns[i], op);
+        }
+        this->swap(result);
+        return !this->isEmpty();
+    }
+
+    SkIRect bounds;
+    int threshold;
+    if (kUnion_Op == op) {
+        const SkRegion* nonEmpty = NULL;
+        int nonEmptyCount = 0;
+        bounds.setEmpty();
+        for (int i = 0; i < count; ++i) {
+            if (!rgns[i]->isEmpty()) {
+                nonEmpty = rgns[i];
+                nonEmptyCount += 1;
+                bounds.join(rgns[i]->fBounds);
+            }
+        }
+        if (nonEmptyCount <= 1) {
+            return nonEmpty ? this->setRegion(*nonEmpty) : this->setEmpty();
+        }
+        for (int i = 0; i < count; ++i) {
+            if (rgns[i]->isRect() && rgns[i]->fBounds == bounds) {
+                return this->setRect(bounds);
+            }
+        }
+        threshold = 1;
+    } else {
+        bool allRects = true;
+        bounds = rgns[0]->fBounds;
+        for (int i = 0; i < count; ++i) {
+            if (rgns[i]->isEmpty() || !bounds.intersect(rgns[i]->fBounds)) {
+                return this->setEmpty();
+            }
+            allRects &= rgns[i]->isRect();
+        }
+        if (allRects) {
+            return this->setRect(bounds);
+        }
+        if (1 == count) {
+            return this->setRegion(*rgns[0]);
+        }
+        threshold = count;
+    }
+
+    Scratch localScratch;
+    SkRgnSweeper* sweeper = (scratch ? scratch : &localScratch)->sweeper();
+    sweeper->reset(count);
+    for (int i = 0; i < count; ++i) {
+        if (!rgns[i]->isEmpty()) {
+            sweeper->addRegion(*rgns[i]);
+        }
+    }
+    return sweeper->sweep(threshold, this);
+}
+
+bool SkRegion::op(const SkIRect rects[], int count, Op op, Scratch* scratch) {
+    SkDEBUGCODE(this->validate();)
+    SkASSERT((unsigned)op < kOpCount);
+
+    if (0 == count) {
+        return this->setEmpty();
+    }
+
+    if (kIntersect_Op == op) {
+        SkIRect bounds = rects[0];
+        for (int i = 1; i < count; ++i) {
+            if (!bounds.intersect(rects[i])) {
+                return this->setEmpty();
+            }
+        }
+        return this->setRect(bounds);
+    }
+
+    if (kUnion_Op != op) {
+        SkRegion result(rects[0]);
+        for (int i = 1; i < count; ++i) {
+            result.op(rects[i], op);
+        }
+        this->swap(result);
+        return !this->isEmpty();
+    }
+
+    SkIRect bounds;
+    int nonEmptyCount = 0;
+    bounds.setEmpty();
+    for (int i = 0; i < count; ++i) {
+        if (!rects[i].isEmpty()) {
+            nonEmptyCount += 1;
+            bounds.join(rects[i]);
+        }
+    }
+    for (int i = 0; i < count; ++i) {
+        if (rects[i] == bounds) {
+            // one rect covers all the others, including when there is just one
+            return this->setRect(bounds);
+        }
+    }
+    if (0 == nonEmptyCount) {
+        return this->setEmpty();
+    }
+
+    Scratch localScratch;
+    SkRgnSweeper* sweeper = (scratch ? scratch : &localScratch)->sweeper();
+    sweeper->reset(count);
+    for (int i = 0; i < count; ++i) {
+        if (!rects[i].isEmpty()) {
+            sweeper->addRect(rects[i]);
+        }
+    }
+    return sweeper->sweep(1, this);
+}
+
+///////////////////////////////////////////////////////////////////////////////
+
 #include "SkBuffer.h"
 
 uint32_t SkRegion::writeToMemory(void* storage) const {
@@ -24,6 +24,19 @@ typedef SkIRect SkXRect;
 
 class SkScan {
 public:
+    /**
+     *  Paths that are not convex (or are inverse filled) are scan converted by
+     *  walking their edges, kept either in a sorted linked list, or in parallel
+     *  arrays that suit paths with many edges. By default the arrays are used
+     *  once a path has enough edges to make them worthwhile; tests and
+     *  benchmarks may pass a specific walker to FillPath and AntiFillPath.
+     */
+    enum EdgeWalker {
+        kDefault_EdgeWalker,
+        kList_EdgeWalker,
+        kArray_EdgeWalker
+    };
+
     static void FillPath(const SkPath&, const SkIRect&, SkBlitter*);
 
     ///////////////////////////////////////////////////////////////////////////
@@ -45,8 +58,18 @@ public:
     static void AntiFillRect(const SkRect&, const SkRasterClip&, SkBlitter*);
 #endif
     static void AntiFillXRect(const SkXRect&, const SkRasterClip&, SkBlitter*);
-    static void FillPath(const SkPath&, const SkRasterClip&, SkBlitter*);
-    static void AntiFillPath(const SkPath&, const SkRasterClip&, SkBlitter*);
+    static void FillPath(const SkPath& path, const SkRasterClip& clip,
+                         SkBlitter* blitter) {
+        SkScan::FillPath(path, clip, blitter, kDefault_EdgeWalker);
+    }
+    static void AntiFillPath(const SkPath& path, const SkRasterClip& clip,
+                             SkBlitter* blitter) {
+        SkScan::AntiFillPath(path, clip, blitter, kDefault_EdgeWalker);
+    }
+    static void FillPath(const SkPath&, const SkRasterClip&, SkBlitter*,
+                         EdgeWalker);
+    static void AntiFillPath(const SkPath&, const SkRasterClip&, SkBlitter*,
+                             EdgeWalker);
     static void FrameRect(const SkRect&, const SkPoint& strokeSize,
                           const SkRasterClip&, SkBlitter*);
     static void AntiFrameRect(const SkRect&, const SkPoint& strokeSize,
@@ -81,9 +104,11 @@ private:
     static void AntiFillRect(const SkRect&, const SkRegion* clip, SkBlitter*);
 #endif
     static void AntiFillXRect(const SkXRect&, const SkRegion*, SkBlitter*);
-    static void FillPath(const SkPath&, const SkRegion& clip, SkBlitter*);
+    static void FillPath(const SkPath&, const SkRegion& clip, SkBlitter*,
+                         EdgeWalker = kDefault_EdgeWalker);
     static void AntiFillPath(const SkPath&, const SkRegion& clip, SkBlitter*,
-                             bool forceRLE = false);
+                             bool forceRLE = false,
+                             EdgeWalker = kDefault_EdgeWalker);
     static void FillTriangle(const SkPoint pts[], const SkRegion*, SkBlitter*);
 
     static void AntiFrameRect(const SkRect&, const SkPoint& strokeSize,
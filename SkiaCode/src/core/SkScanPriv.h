@@ -31,7 +31,7 @@ private:
 // clipRect == null means path is entirely inside the clip
 void sk_fill_path(const SkPath& path, const SkIRect* clipRect,
                   SkBlitter* blitter, int start_y, int stop_y, int shiftEdgesUp,
-                  const SkRegion& clipRgn);
+                  const SkRegion& clipRgn, SkScan::EdgeWalker walker);
 
 // blit the rects above and below avoid, clipped to clip
 void sk_blit_above(SkBlitter*, const SkIRect& avoid, const SkRegion& clip);
@@ -13,6 +13,7 @@
 #include "SkBlitter.h"
 #include "SkRegion.h"
 #include "SkAntiRun.h"
+#include "SkTrace.h"
 
 #define SHIFT   2
 #define SCALE   (1 << SHIFT)
@@ -604,7 +605,8 @@ static bool safeRoundOut(const SkRect& src, SkIRect* dst, int32_t maxInt) {
 }
 
 void SkScan::AntiFillPath(const SkPath& path, const SkRegion& origClip,
-                          SkBlitter* blitter, bool forceRLE) {
+                          SkBlitter* blitter, bool forceRLE,
+                          EdgeWalker walker) {
     if (origClip.isEmpty()) {
         return;
     }
@@ -639,7 +641,7 @@ void SkScan::AntiFillPath(const SkPath& path, const SkRegion& origClip,
        }
     }
     if (rect_overflows_short_shift(clippedIR, SHIFT)) {
-        SkScan::FillPath(path, origClip, blitter);
+        SkScan::FillPath(path, origClip, blitter, walker);
         return;
     }
 
@@ -694,10 +696,12 @@ void SkScan::AntiFillPath(const SkPath& path, const SkRegion& origClip,
     if (!path.isInverseFillType() && MaskSuperBlitter::CanHandleRect(ir) && !forceRLE) {
         MaskSuperBlitter    superBlit(blitter, ir, *clipRgn);
         SkASSERT(SkIntToScalar(ir.fTop) <= path.getBounds().fTop);
-        sk_fill_path(path, superClipRect, &superBlit, ir.fTop, ir.fBottom, SHIFT, *clipRgn);
+        sk_fill_path(path, superClipRect, &superBlit, ir.fTop, ir.fBottom, SHIFT, *clipRgn,
+                     walker);
     } else {
         SuperBlitter    superBlit(blitter, ir, *clipRgn);
-        sk_fill_path(path, superClipRect, &superBlit, ir.fTop, ir.fBottom, SHIFT, *clipRgn);
+        sk_fill_path(path, superClipRect, &superBlit, ir.fTop, ir.fBottom, SHIFT, *clipRgn,
+                     walker);
     }
 
     if (path.isInverseFillType()) {
@@ -710,38 +714,40 @@ void SkScan::AntiFillPath(const SkPath& path, const SkRegion& origClip,
 #include "SkRasterClip.h"
 
 void SkScan::FillPath(const SkPath& path, const SkRasterClip& clip,
-                          SkBlitter* blitter) {
+                          SkBlitter* blitter, EdgeWalker walker) {
+    SK_TRACE_SCOPE("skia.raster", "SkScan::FillPath");
     if (clip.isEmpty()) {
         return;
     }
 
     if (clip.isBW()) {
-        FillPath(path, clip.bwRgn(), blitter);
+        FillPath(path, clip.bwRgn(), blitter, walker);
     } else {
         SkRegion        tmp;
         SkAAClipBlitter aaBlitter;
 
         tmp.setRect(clip.getBounds());
         aaBlitter.init(blitter, &clip.aaRgn());
-        SkScan::FillPath(path, tmp, &aaBlitter);
+        SkScan::FillPath(path, tmp, &aaBlitter, walker);
     }
 }
 
 void SkScan::AntiFillPath(const SkPath& path, const SkRasterClip& clip,
-                          SkBlitter* blitter) {
+                          SkBlitter* blitter, EdgeWalker walker) {
+    SK_TRACE_SCOPE("skia.raster", "SkScan::AntiFillPath");
     if (clip.isEmpty()) {
         return;
     }
 
     if (clip.isBW()) {
-        AntiFillPath(path, clip.bwRgn(), blitter);
+        AntiFillPath(path, clip.bwRgn(), blitter, false, walker);
     } else {
         SkRegion        tmp;
         SkAAClipBlitter aaBlitter;
 
         tmp.setRect(clip.getBounds());
         aaBlitter.init(blitter, &clip.aaRgn());
-        SkScan::AntiFillPath(path, tmp, &aaBlitter, true);
+        SkScan::AntiFillPath(path, tmp, &aaBlitter, true, walker);
     }
 }
 
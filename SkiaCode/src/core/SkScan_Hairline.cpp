@@ -12,6 +12,7 @@
 #include "SkRasterClip.h"
 #include "SkFDot6.h"
 #include "SkLineClipper.h"
+#include "SkTrace.h"
 
 static void horiline(int x, int stopx, SkFixed fy, SkFixed dy,
                      SkBlitter* blitter) {
@@ -335,11 +336,13 @@ static void hair_path(const SkPath& path, const SkRasterClip& rclip, SkBlitter*
 
 void SkScan::HairPath(const SkPath& path, const SkRasterClip& clip,
                       SkBlitter* blitter) {
+    SK_TRACE_SCOPE("skia.raster", "SkScan::HairPath");
     hair_path(path, clip, blitter, SkScan::HairLineRgn);
 }
 
 void SkScan::AntiHairPath(const SkPath& path, const SkRasterClip& clip,
                           SkBlitter* blitter) {
+    SK_TRACE_SCOPE("skia.raster", "SkScan::AntiHairPath");
     hair_path(path, clip, blitter, SkScan::AntiHairLineRgn);
 }
 
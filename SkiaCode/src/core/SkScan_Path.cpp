@@ -314,6 +314,225 @@ static void walk_convex_edges(SkEdge* prevHead, SkPath::FillType,
 
 ///////////////////////////////////////////////////////////////////////////////
 
+// With fewer edges than this, walk_edges is as fast, and needs no setup
+#define MIN_EDGES_FOR_EDGE_ARRAYS   64
+
+static bool use_edge_arrays(SkScan::EdgeWalker walker, int count) {
+    switch (walker) {
+        case SkScan::kList_EdgeWalker:
+            return false;
+        case SkScan::kArray_EdgeWalker:
+            return true;
+        default:
+            return count >= MIN_EDGES_FOR_EDGE_ARRAYS;
+    }
+}
+
+/*
+ *  The active edges of walk_edge_arrays, sorted by fX. Each edge's fields live
+ *  in parallel arrays, so stepping to the next scanline is a tight loop over
+ *  contiguous memory (which the compiler can vectorize), and re-sorting moves
+ *  a few ints instead of relinking list nodes. fEdge is only needed to fetch
+ *  the next segment of a curve.
+ */
+class ActiveEdgeArrays {
+public:
+    ActiveEdgeArrays(int maxCount)
+        : fStorage(maxCount * 4)
+        , fEdgeStorage(maxCount) {
+        fX = fStorage.get();
+        fDX = fX + maxCount;
+        fLastY = fDX + maxCount;
+        fWinding = fLastY + maxCount;
+        fEdge = fEdgeStorage.get();
+        fCount = 0;
+        fMinLastY = SK_MaxS32;
+    }
+
+    void add(const SkEdge* edge) {
+        int i = fCount++;
+        this->set(i, edge);
+        fMinLastY = SkMin32(fMinLastY, edge->fLastY);
+    }
+
+    // insertion sort, since the edges are nearly always still in x order
+    void sortByX() {
+        SkFixed* SK_RESTRICT xs = fX;
+        for (int i = 1; i < fCount; ++i) {
+            SkFixed x = xs[i];
+            if (xs[i - 1] <= x) {
+                continue;
+            }
+            SkFixed dx = fDX[i];
+            int32_t lastY = fLastY[i];
+            int32_t winding = fWinding[i];
+            SkEdge* edge = fEdge[i];
+            int j = i;
+            do {
+                xs[j] = xs[j - 1];
+                fDX[j] = fDX[j - 1];
+                fLastY[j] = fLastY[j - 1];
+                fWinding[j] = fWinding[j - 1];
+                fEdge[j] = fEdge[j - 1];
+            } while (--j > 0 && xs[j - 1] > x);
+            xs[j] = x;
+            fDX[j] = dx;
+            fLastY[j] = lastY;
+            fWinding[j] = winding;
+            fEdge[j] = edge;
+        }
+    }
+
+    void blitSpans(SkBlitter* blitter, int curr_y, int windingMask) const {
+        const SkFixed* SK_RESTRICT xs = fX;
+        const int32_t* SK_RESTRICT windings = fWinding;
+        int     w = 0;
+        int     left SK_INIT_TO_AVOID_WARNING;
+        bool    in_interval = false;
+
+        for (int i = 0; i < fCount; ++i) {
+            int x = SkFixedRoundToInt(xs[i]);
+            w += windings[i];
+            if ((w & windingMask) == 0) { // we finished an interval
+                SkASSERT(in_interval);
+                int width = x - left;
+                SkASSERT(width >= 0);
+                if (width)
+                    blitter->blitH(left, curr_y, width);
+                in_interval = false;
+            } else if (!in_interval) {
+                left = x;
+                in_interval = true;
+            }
+        }
+    }
+
+    // advance every edge to curr_y + 1, dropping the ones that are done
+    void step(int curr_y) {
+        if (curr_y < fMinLastY) {
+            SkFixed* SK_RESTRICT xs = fX;
+            const SkFixed* SK_RESTRICT dxs = fDX;
+            const int count = fCount;
+            for (int i = 0; i < count; ++i) {
+                xs[i] += dxs[i];
+            }
+            return;
+        }
+
+        int live = 0;
+        fMinLastY = SK_MaxS32;
+        for (int i = 0; i < fCount; ++i) {
+            if (fLastY[i] <= curr_y) {
+                SkEdge* edge = fEdge[i];
+                if (update_edge(edge, fLastY[i])) {
+                    continue;
+                }
+                this->set(live, edge);
+            } else {
+                fX[live] = fX[i] + fDX[i];
+                fDX[live] = fDX[i];
+                fLastY[live] = fLastY[i];
+                fWinding[live] = fWinding[i];
+                fEdge[live] = fEdge[i];
+            }
+            fMinLastY = SkMin32(fMinLastY, fLastY[live]);
+            live += 1;
+        }
+        fCount = live;
+    }
+
+private:
+    SkAutoSTMalloc<4 * 32, int32_t> fStorage;
+    SkAutoSTMalloc<32, SkEdge*>     fEdgeStorage;
+
+    SkFixed*    fX;
+    SkFixed*    fDX;
+    int32_t*    fLastY;
+    int32_t*    fWinding;
+    SkEdge**    fEdge;
+    int         fCount;
+    int         fMinLastY;
+
+    void set(int i, const SkEdge* edge) {
+        fX[i] = edge->fX;
+        fDX[i] = edge->fDX;
+        fLastY[i] = edge->fLastY;
+        fWinding[i] = edge->fWinding;
+        fEdge[i] = const_cast<SkEdge*>(edge);
+    }
+};
+
+/*
+ *  Draws the same spans as walk_edges, from the unsorted edges in list. Rather
+ *  than sorting them all up front, the edges are bucketed by their first
+ *  scanline, and each scanline's new edges are sorted into the active ones.
+ */
+static void walk_edge_arrays(SkEdge* list[], int count, SkPath::FillType fillType,
+                             SkBlitter* blitter, int start_y, int stop_y,
+                             PrePostProc proc) {
+    // Edges that begin above start_y are activated on it, as walk_edges does;
+    // edges that begin on or below stop_y are never needed.
+    int minY = SK_MaxS32;
+    int maxY = SK_MinS32;
+    for (int i = 0; i < count; ++i) {
+        int y = SkMax32(list[i]->fFirstY, start_y);
+        if (y < stop_y) {
+            minY = SkMin32(minY, y);
+            maxY = SkMax32(maxY, y);
+        }
+    }
+
+    // counting sort into pending, leaving bucketEnd[y - minY] as the index
+    // after the last edge that begins on scanline y
+    const int bucketCount = minY <= maxY ? maxY - minY + 1 : 0;
+    SkAutoSTMalloc<128, int> bucketEnd(bucketCount + 1);
+    SkAutoSTMalloc<32, SkEdge*> pending(count);
+    int* buckets = bucketEnd.get();
+    sk_bzero(buckets, (bucketCount + 1) * sizeof(int));
+    for (int i = 0; i < count; ++i) {
+        int y = SkMax32(list[i]->fFirstY, start_y);
+        if (y < stop_y) {
+            buckets[y - minY + 1] += 1;
+        }
+    }
+    for (int b = 1; b <= bucketCount; ++b) {
+        buckets[b] += buckets[b - 1];
+    }
+    for (int i = 0; i < count; ++i) {
+        int y = SkMax32(list[i]->fFirstY, start_y);
+        if (y < stop_y) {
+            pending[buckets[y - minY]++] = list[i];
+        }
+    }
+
+    ActiveEdgeArrays active(count);
+    int nextPending = 0;
+    // returns 1 for evenodd, -1 for winding, regardless of inverse-ness
+    int windingMask = (fillType & 1) ? 1 : -1;
+
+    for (int curr_y = start_y; curr_y < stop_y; ++curr_y) {
+        if (curr_y >= minY && curr_y <= maxY) {
+            int end = buckets[curr_y - minY];
+            for (; nextPending < end; ++nextPending) {
+                active.add(pending[nextPending]);
+            }
+        }
+        active.sortByX();
+
+        if (proc) {
+            proc(blitter, curr_y, PREPOST_START);    // pre-proc
+        }
+        active.blitSpans(blitter, curr_y, windingMask);
+        if (proc) {
+            proc(blitter, curr_y, PREPOST_END);    // post-proc
+        }
+
+        active.step(curr_y);
+    }
+}
+
+///////////////////////////////////////////////////////////////////////////////
+
 // this guy overrides blitH, and will call its proxy blitter with the inverse
 // of the spans it is given (clipped to the left/right of the cliprect)
 //
@@ -437,7 +656,7 @@ static SkEdge* sort_edges(SkEdge* list[], int count, SkEdge** last) {
 //
 void sk_fill_path(const SkPath& path, const SkIRect* clipRect, SkBlitter* blitter,
                   int start_y, int stop_y, int shiftEdgesUp,
-                  const SkRegion& clipRgn) {
+                  const SkRegion& clipRgn, SkScan::EdgeWalker walker) {
     SkASSERT(&path && blitter);
 
     SkEdgeBuilder   builder;
@@ -471,23 +690,6 @@ void sk_fill_path(const SkPath& path, const SkIRect* clipRect, SkBlitter* blitte
         return;
     }
 
-    SkEdge headEdge, tailEdge, *last;
-    // this returns the first and last edge after they're sorted into a dlink list
-    SkEdge* edge = sort_edges(list, count, &last);
-
-    headEdge.fPrev = NULL;
-    headEdge.fNext = edge;
-    headEdge.fFirstY = kEDGE_HEAD_Y;
-    headEdge.fX = SK_MinS32;
-    edge->fPrev = &headEdge;
-
-    tailEdge.fPrev = last;
-    tailEdge.fNext = NULL;
-    tailEdge.fFirstY = kEDGE_TAIL_Y;
-    last->fNext = &tailEdge;
-
-    // now edge is the head of the sorted linklist
-
     start_y <<= shiftEdgesUp;
     stop_y <<= shiftEdgesUp;
     if (clipRect && start_y < clipRect->fTop) {
@@ -506,7 +708,31 @@ void sk_fill_path(const SkPath& path, const SkIRect* clipRect, SkBlitter* blitte
         proc = PrePostInverseBlitterProc;
     }
 
-    if (path.isConvex() && (NULL == proc)) {
+    const bool isConvex = path.isConvex() && (NULL == proc);
+    if (!isConvex && use_edge_arrays(walker, count)) {
+        walk_edge_arrays(list, count, path.getFillType(), blitter, start_y,
+                         stop_y, proc);
+        return;
+    }
+
+    SkEdge headEdge, tailEdge, *last;
+    // this returns the first and last edge after they're sorted into a dlink list
+    SkEdge* edge = sort_edges(list, count, &last);
+
+    headEdge.fPrev = NULL;
+    headEdge.fNext = edge;
+    headEdge.fFirstY = kEDGE_HEAD_Y;
+    headEdge.fX = SK_MinS32;
+    edge->fPrev = &headEdge;
+
+    tailEdge.fPrev = last;
+    tailEdge.fNext = NULL;
+    tailEdge.fFirstY = kEDGE_TAIL_Y;
+    last->fNext = &tailEdge;
+
+    // now edge is the head of the sorted linklist
+
+    if (isConvex) {
         walk_convex_edges(&headEdge, path.getFillType(), blitter, start_y, stop_y, NULL);
     } else {
         walk_edges(&headEdge, path.getFillType(), blitter, start_y, stop_y, proc);
@@ -590,7 +816,7 @@ static bool clip_to_limit(const SkRegion& orig, SkRegion* reduced) {
 }
 
 void SkScan::FillPath(const SkPath& path, const SkRegion& origClip,
-                      SkBlitter* blitter) {
+                      SkBlitter* blitter, EdgeWalker walker) {
     if (origClip.isEmpty()) {
         return;
     }
@@ -626,7 +852,7 @@ void SkScan::FillPath(const SkPath& path, const SkRegion& origClip,
             sk_blit_above(blitter, ir, *clipPtr);
         }
         sk_fill_path(path, clipper.getClipRect(), blitter, ir.fTop, ir.fBottom,
-                     0, *clipPtr);
+                     0, *clipPtr, walker);
         if (path.isInverseFillType()) {
             sk_blit_below(blitter, ir, *clipPtr);
         }
@@ -10,6 +10,7 @@
 #include "SkStrokerPriv.h"
 #include "SkGeometry.h"
 #include "SkPath.h"
+#include "SkTDArray.h"
 
 #define kMaxQuadSubdivide   5
 #define kMaxCubicSubdivide  4
@@ -67,12 +68,26 @@ public:
                   SkScalar radius, SkScalar miterLimit, SkPaint::Cap cap,
                   SkPaint::Join join);
 
+    // Picks up the contour parent is stroking partway through, as if parent
+    // had just drawn the line from before to pt (which must not be
+    // degenerate). The result can then be appended to parent's with
+    // appendContinuation().
+    SkPathStroker(const SkPathStroker& parent, const SkPoint& before,
+                  const SkPoint& pt, int segmentCount);
+
     void moveTo(const SkPoint&);
     void lineTo(const SkPoint&);
+    // lineTo each of pts[1..count-1], where pts[0] is the current point,
+    // stroking runs of segmentsPerChunk segments with parallelFor
+    void linesTo(const SkPoint pts[], int count,
+                 SkParallelForProc parallelFor, int segmentsPerChunk);
     void quadTo(const SkPoint&, const SkPoint&);
     void cubicTo(const SkPoint&, const SkPoint&, const SkPoint&);
     void close(bool isLine) { this->finishContour(true, isLine); }
 
+    // the last point of the source path that has been stroked
+    const SkPoint& currentPoint() const { return fPrevPt; }
+
     void done(SkPath* dst, bool isLine) {
         this->finishContour(false, isLine);
         fOuter.addPath(fExtra);
@@ -82,6 +97,7 @@ public:
 private:
     SkScalar    fRadius;
     SkScalar    fInvMiterLimit;
+    SkPaint::Join fJoin;
 
     SkVector    fFirstNormal, fPrevNormal, fFirstUnitNormal, fPrevUnitNormal;
     SkPoint     fFirstPt, fPrevPt;  // on original path
@@ -95,6 +111,8 @@ private:
     SkPath  fInner, fOuter; // outer is our working answer, inner is temp
     SkPath  fExtra;         // added as extra complete contours
 
+    void    reserve(int pointCount);
+    void    appendContinuation(const SkPathStroker&);
     void    finishContour(bool close, bool isLine);
     void    preJoinTo(const SkPoint&, SkVector* normal, SkVector* unitNormal,
                       bool isLine);
@@ -197,19 +215,67 @@ SkPathStroker::SkPathStroker(const SkPath& src,
             fInvMiterLimit = SkScalarInvert(miterLimit);
         }
     }
+    fJoin = join;
     fCapper = SkStrokerPriv::CapFactory(cap);
     fJoiner = SkStrokerPriv::JoinFactory(join);
     fSegmentCount = -1;
     fPrevIsLine = false;
 
-    // Need some estimate of how large our final result (fOuter)
-    // and our per-contour temp (fInner) will be, so we don't spend
-    // extra time repeatedly growing these arrays.
-    //
-    // 3x for result == inner + outer + join (swag)
-    // 1x for inner == 'wag' (worst contour length would be better guess)
-    fOuter.incReserve(src.countPoints() * 3);
-    fInner.incReserve(src.countPoints());
+    this->reserve(src.countPoints());
+}
+
+SkPathStroker::SkPathStroker(const SkPathStroker& parent, const SkPoint& before,
+                             const SkPoint& pt, int segmentCount)
+        : fRadius(parent.fRadius)
+        , fInvMiterLimit(parent.fInvMiterLimit)
+        , fJoin(parent.fJoin)
+        , fCapper(parent.fCapper)
+        , fJoiner(parent.fJoiner) {
+    SkAssertResult(set_normal_unitnormal(before, pt, fRadius, &fPrevNormal,
+                                         &fPrevUnitNormal));
+    fFirstNormal = fPrevNormal;
+    fFirstUnitNormal = fPrevUnitNormal;
+    fFirstPt = fPrevPt = pt;
+    fFirstOuterPt.set(pt.fX + fPrevNormal.fX, pt.fY + fPrevNormal.fY);
+    fSegmentCount = 1;
+    fPrevIsLine = true;
+
+    this->reserve(segmentCount + 1);
+    fOuter.moveTo(fFirstOuterPt);
+    fInner.moveTo(pt.fX - fPrevNormal.fX, pt.fY - fPrevNormal.fY);
+}
+
+// Need some estimate of how large our final result (fOuter) and our
+// per-contour temp (fInner) will be, so we don't spend extra time repeatedly
+// growing these arrays. Each point of a polyline adds a line to both sides,
+// plus its join: one or two points for miters and bevels (and two on the
+// inside), and a couple of quads for round joins. fOuter ends up with fInner
+// appended to it.
+void SkPathStroker::reserve(int pointCount) {
+    const int innerPerPoint = 3;
+    const int outerPerPoint = SkPaint::kRound_Join == fJoin ? 6 : 2;
+    fOuter.incReserve(pointCount * (outerPerPoint + innerPerPoint));
+    // worst contour length would be a better guess
+    fInner.incReserve(pointCount * innerPerPoint);
+}
+
+// Appends the stroke of other, which continues this one's contour, and takes
+// on its state, as if this stroker had drawn other's lines itself.
+void SkPathStroker::appendContinuation(const SkPathStroker& other) {
+    SkASSERT(fSegmentCount > 0 && other.fSegmentCount > 0);
+    SkASSERT(other.fExtra.isEmpty());
+
+    // a miter join moves the point the join starts from (on either side),
+    // which for other's first join is its initial moveTo
+    fOuter.setLastPt(other.fOuter.getPoint(0));
+    fInner.setLastPt(other.fInner.getPoint(0));
+    fOuter.pathTo(other.fOuter);
+    fInner.pathTo(other.fInner);
+    fPrevPt = other.fPrevPt;
+    fPrevNormal = other.fPrevNormal;
+    fPrevUnitNormal = other.fPrevUnitNormal;
+    fPrevIsLine = other.fPrevIsLine;
+    fSegmentCount += other.fSegmentCount - 1;
 }
 
 void SkPathStroker::moveTo(const SkPoint& pt) {
@@ -236,6 +302,72 @@ void SkPathStroker::lineTo(const SkPoint& currPt) {
     this->postJoinTo(currPt, normal, unitNormal);
 }
 
+namespace {
+struct LineChunk {
+    SkPathStroker*  fStroker;
+    int             fStart;     // index of the chunk's first point
+    int             fStop;      // index of the chunk's last point
+};
+
+struct LineChunks {
+    const SkPoint*          fPts;
+    SkTDArray<LineChunk>    fChunks;
+};
+}
+
+static void stroke_line_chunk(void* context, int index) {
+    const LineChunks* chunks = static_cast<const LineChunks*>(context);
+    const LineChunk& chunk = chunks->fChunks[index];
+    for (int i = chunk.fStart + 1; i <= chunk.fStop; ++i) {
+        chunk.fStroker->lineTo(chunks->fPts[i]);
+    }
+}
+
+void SkPathStroker::linesTo(const SkPoint pts[], int count,
+                            SkParallelForProc parallelFor,
+                            int segmentsPerChunk) {
+    SkASSERT(fSegmentCount >= 0 && fPrevPt == pts[0]);
+
+    LineChunks chunks;
+    chunks.fPts = pts;
+
+    // Split after every segmentsPerChunk lines that lineTo would draw (i.e.
+    // that are not degenerate), so each new chunk starts from a point that
+    // its predecessor actually reached, with the same normal.
+    LineChunk* chunk = chunks.fChunks.append();
+    chunk->fStroker = this;
+    chunk->fStart = 0;
+    SkPoint prev = pts[0];
+    int segments = 0;
+    for (int i = 1; i < count - 1; ++i) {
+        if (SkPath::IsLineDegenerate(prev, pts[i])) {
+            continue;
+        }
+        if (++segments == segmentsPerChunk) {
+            chunk->fStop = i;
+            chunk = chunks.fChunks.append();
+            chunk->fStroker = SkNEW_ARGS(SkPathStroker,
+                                         (*this, prev, pts[i], segmentsPerChunk));
+            chunk->fStart = i;
+            segments = 0;
+        }
+        prev = pts[i];
+    }
+    chunk->fStop = count - 1;
+
+    if (chunks.fChunks.count() > 1) {
+        parallelFor(chunks.fChunks.count(), stroke_line_chunk, &chunks);
+    } else {
+        stroke_line_chunk(&chunks, 0);
+    }
+
+    for (int i = 1; i < chunks.fChunks.count(); ++i) {
+        SkPathStroker* stroker = chunks.fChunks[i].fStroker;
+        this->appendContinuation(*stroker);
+        SkDELETE(stroker);
+    }
+}
+
 void SkPathStroker::quad_to(const SkPoint pts[3],
                       const SkVector& normalAB, const SkVector& unitNormalAB,
                       SkVector* normalBC, SkVector* unitNormalBC,
@@ -496,12 +628,32 @@ void SkPathStroker::cubicTo(const SkPoint& pt1, const SkPoint& pt2,
 
 #include "SkPaintDefaults.h"
 
+// guards gParallelFor and gSegmentsPerChunk, which are read as a pair
+SK_DECLARE_STATIC_MUTEX(gParallelForMutex);
+static SkParallelForProc gParallelFor;
+static int gSegmentsPerChunk = SkStroke::kDefaultSegmentsPerChunk;
+
+void SkGraphics::SetStrokeParallelFor(SkParallelForProc parallelFor,
+                                      int segmentsPerChunk) {
+    SkASSERT(segmentsPerChunk > 0);
+    SkAutoMutexAcquire ac(gParallelForMutex);
+    gParallelFor = parallelFor;
+    gSegmentsPerChunk = segmentsPerChunk;
+}
+
+void SkStroke::initParallelFor() {
+    SkAutoMutexAcquire ac(gParallelForMutex);
+    fParallelFor = gParallelFor;
+    fSegmentsPerChunk = gSegmentsPerChunk;
+}
+
 SkStroke::SkStroke() {
     fWidth      = SK_Scalar1;
     fMiterLimit = SkPaintDefaults_MiterLimit;
     fCap        = SkPaint::kDefault_Cap;
     fJoin       = SkPaint::kDefault_Join;
     fDoFill     = false;
+    this->initParallelFor();
 }
 
 SkStroke::SkStroke(const SkPaint& p) {
@@ -510,6 +662,7 @@ SkStroke::SkStroke(const SkPaint& p) {
     fCap        = (uint8_t)p.getStrokeCap();
     fJoin       = (uint8_t)p.getStrokeJoin();
     fDoFill     = SkToU8(p.getStyle() == SkPaint::kStrokeAndFill_Style);
+    this->initParallelFor();
 }
 
 SkStroke::SkStroke(const SkPaint& p, SkScalar width) {
@@ -518,6 +671,7 @@ SkStroke::SkStroke(const SkPaint& p, SkScalar width) {
     fCap        = (uint8_t)p.getStrokeCap();
     fJoin       = (uint8_t)p.getStrokeJoin();
     fDoFill     = SkToU8(p.getStyle() == SkPaint::kStrokeAndFill_Style);
+    this->initParallelFor();
 }
 
 void SkStroke::setWidth(SkScalar width) {
@@ -540,6 +694,12 @@ void SkStroke::setJoin(SkPaint::Join join) {
     fJoin = SkToU8(join);
 }
 
+void SkStroke::setParallelFor(SkParallelForProc parallelFor, int segmentsPerChunk) {
+    SkASSERT(segmentsPerChunk > 0);
+    fParallelFor = parallelFor;
+    fSegmentsPerChunk = segmentsPerChunk;
+}
+
 ///////////////////////////////////////////////////////////////////////////////
 
 #ifdef SK_SCALAR_IS_FIXED
@@ -598,6 +758,21 @@ private:
     bool            fSwapWithSrc;
 };
 
+// Strokes the lines of a contour that have been collected in polyline, in
+// chunks if there are enough of them.
+static void flush_polyline(SkPathStroker* stroker, const SkTDArray<SkPoint>& polyline,
+                           SkParallelForProc parallelFor,
+                           int segmentsPerChunk) {
+    if (polyline.count() > 2 * segmentsPerChunk) {
+        stroker->linesTo(polyline.begin(), polyline.count(), parallelFor,
+                         segmentsPerChunk);
+    } else {
+        for (int i = 1; i < polyline.count(); ++i) {
+            stroker->lineTo(polyline[i]);
+        }
+    }
+}
+
 void SkStroke::strokePath(const SkPath& src, SkPath* dst) const {
     SkASSERT(&src != NULL && dst != NULL);
 
@@ -627,7 +802,16 @@ void SkStroke::strokePath(const SkPath& src, SkPath* dst) const {
     SkPoint         pts[4];
     SkPath::Verb    verb, lastSegment = SkPath::kMove_Verb;
 
+    // With fParallelFor, runs of lines are collected in polyline, so that
+    // long ones can be stroked in chunks.
+    SkTDArray<SkPoint> polyline;
+    bool inPolyline = false;
+
     while ((verb = iter.next(pts, false)) != SkPath::kDone_Verb) {
+        if (inPolyline && (SkPath::kLine_Verb != verb)) {
+            flush_polyline(&stroker, polyline, fParallelFor, fSegmentsPerChunk);
+            inPolyline = false;
+        }
         switch (verb) {
             case SkPath::kMove_Verb:
                 APPLY_PROC(proc, &pts[0], 1);
@@ -635,7 +819,16 @@ void SkStroke::strokePath(const SkPath& src, SkPath* dst) const {
                 break;
             case SkPath::kLine_Verb:
                 APPLY_PROC(proc, &pts[1], 1);
-                stroker.lineTo(pts[1]);
+                if (fParallelFor) {
+                    if (!inPolyline) {
+                        polyline.rewind();
+                        *polyline.append() = stroker.currentPoint();
+                        inPolyline = true;
+                    }
+                    *polyline.append() = pts[1];
+                } else {
+                    stroker.lineTo(pts[1]);
+                }
                 lastSegment = verb;
                 break;
             case SkPath::kQuad_Verb:
@@ -655,6 +848,9 @@ void SkStroke::strokePath(const SkPath& src, SkPath* dst) const {
                 break;
         }
     }
+    if (inPolyline) {
+        flush_polyline(&stroker, polyline, fParallelFor, fSegmentsPerChunk);
+    }
     stroker.done(dst, lastSegment == SkPath::kLine_Verb);
 
 #ifdef SK_SCALAR_IS_FIXED
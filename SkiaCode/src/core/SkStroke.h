@@ -10,8 +10,10 @@
 #ifndef SkStroke_DEFINED
 #define SkStroke_DEFINED
 
+#include "SkGraphics.h"
 #include "SkPoint.h"
 #include "SkPaint.h"
+#include "SkThread.h"
 
 struct SkRect;
 class SkPath;
@@ -40,6 +42,20 @@ public:
     bool    getDoFill() const { return SkToBool(fDoFill); }
     void    setDoFill(bool doFill) { fDoFill = SkToU8(doFill); }
 
+    enum {
+        kDefaultSegmentsPerChunk = SkGraphics::kDefaultStrokeSegmentsPerChunk
+    };
+
+    /** If parallelFor is not NULL, strokePath splits runs of more than
+        2 * segmentsPerChunk consecutive lines into chunks of segmentsPerChunk
+        lines, strokes the chunks with parallelFor, and joins the results.
+        The stroked path is the same as the one built in a single pass.
+        Curves are always stroked in a single pass. A new SkStroke starts out
+        with what was given to SkGraphics::SetStrokeParallelFor().
+    */
+    void    setParallelFor(SkParallelForProc parallelFor,
+                           int segmentsPerChunk = kDefaultSegmentsPerChunk);
+
     void    strokePath(const SkPath& path, SkPath*) const;
 
     ////////////////////////////////////////////////////////////////
@@ -49,6 +65,11 @@ private:
     uint8_t     fCap, fJoin;
     SkBool8     fDoFill;
 
+    SkParallelForProc   fParallelFor;
+    int                 fSegmentsPerChunk;
+
+    void initParallelFor();
+
     friend class SkPaint;
 };
 
@@ -0,0 +1,255 @@
+
+/*
+ * Copyright 2012 Google Inc.
+ *
+ * Use of this source code is governed by a BSD-style license that can be
+ * found in the LICENSE file.
+ */
+
+#ifndef SkTLRUCache_DEFINED
+#define SkTLRUCache_DEFINED
+
+#include "SkChecksum.h"
+#include "SkTDArray.h"
+
+/**
+ *  Hashes the raw bytes of key, which must be zeroed (padding included)
+ *  before its fields are set.
+ */
+template <typename Key> uint32_t SkTLRUCacheHash(const Key& key) {
+    SK_COMPILE_ASSERT(0 == (sizeof(Key) & 3), key_size_must_be_multiple_of_4);
+    uint32_t hash = SkChecksum::Compute(reinterpret_cast<const uint32_t*>(&key),
+                                        sizeof(Key));
+    // SkChecksum barely mixes its low bits, and we index with them, so
+    // finish with murmur3's avalanche
+    hash ^= hash >> 16;
+    hash *= 0x85EBCA6B;
+    hash ^= hash >> 13;
+    hash *= 0xC2B2AE35;
+    hash ^= hash >> 16;
+    return hash;
+}
+
+/**
+ *  The bookkeeping of a cache whose entries are evicted least recently used
+ *  first, once they exceed a byte or count limit. A limit of zero disables
+ *  the cache. A key is only worth adding the second time it is missed, so
+ *  find() remembers the hashes of recent misses.
+ *
+ *  The cache does no locking, and owns the entries that have been added:
+ *  Traits::Free(entry) is called when one is evicted, and Traits::Bytes(entry)
+ *  is what it counts against the byte limit. Entry must have the fields
+ *      uint32_t    fHash;
+ *      Entry*      fHashNext;
+ *      Entry*      fPrev;
+ *      Entry*      fNext;
+ *  and a matches(query) method for each type of query passed to find().
+ */
+template <typename Entry, typename Traits> class SkTLRUCache : SkNoncopyable {
+public:
+    struct Stats {
+        uint32_t    fHits;
+        uint32_t    fMisses;
+        uint32_t    fAdds;
+        uint32_t    fEvictions;
+    };
+
+    SkTLRUCache(size_t byteLimit, int countLimit)
+        : fHead(NULL)
+        , fTail(NULL)
+        , fCount(0)
+        , fBytesUsed(0)
+        , fByteLimit(byteLimit)
+        , fCountLimit(countLimit) {
+        fBuckets.setCount(kInitialBucketCount);
+        sk_bzero(fBuckets.begin(), fBuckets.count() * sizeof(Entry*));
+        sk_bzero(&fStats, sizeof(fStats));
+        sk_bzero(fSeen, sizeof(fSeen));
+    }
+
+    ~SkTLRUCache() {
+        this->purgeTo(0, 0);
+    }
+
+    bool isEnabled() const { return fByteLimit > 0 && fCountLimit > 0; }
+
+    int count() const { return fCount; }
+    size_t bytesUsed() const { return fBytesUsed; }
+    const Stats& stats() const { return fStats; }
+    void resetStats() { sk_bzero(&fStats, sizeof(fStats)); }
+
+    size_t byteLimit() const { return fByteLimit; }
+    int countLimit() const { return fCountLimit; }
+
+    /** Sets the limit, evicting entries to meet it, and returns the old one. */
+    size_t setByteLimit(size_t bytes) {
+        size_t prevLimit = fByteLimit;
+        fByteLimit = bytes;
+        this->purgeTo(fByteLimit, fCountLimit);
+        return prevLimit;
+    }
+    int setCountLimit(int count) {
+        SkASSERT(count >= 0);
+        int prevLimit = fCountLimit;
+        fCountLimit = count;
+        this->purgeTo(fByteLimit, fCountLimit);
+        return prevLimit;
+    }
+
+    /**
+     *  Returns the entry that matches query, moved to the front of the LRU
+     *  list, or NULL. On a miss, if shouldAdd is not NULL it is set to whether
+     *  the key was missed recently too.
+     */
+    template <typename Query>
+    Entry* find(uint32_t hash, const Query& query, bool* shouldAdd) {
+        if (shouldAdd) {
+            *shouldAdd = false;
+        }
+        if (!this->isEnabled()) {
+            return NULL;
+        }
+
+        Entry* entry = this->lookup(hash, query);
+        if (entry) {
+            fStats.fHits += 1;
+            this->detach(entry);
+            this->attachToHead(entry);
+            return entry;
+        }
+
+        fStats.fMisses += 1;
+        if (shouldAdd) {
+            uint32_t* seen = &fSeen[hash & (kSeenCount - 1)];
+            *shouldAdd = *seen == hash;
+            *seen = hash;
+        }
+        return NULL;
+    }
+
+    /**
+     *  Adds entry, whose fHash must be set, and returns true. Returns false,
+     *  leaving entry to the caller, if an entry matching query is already
+     *  cached, if entry alone exceeds the byte limit, or if the cache is
+     *  disabled.
+     */
+    template <typename Query>
+    bool add(Entry* entry, const Query& query) {
+        const size_t bytes = Traits::Bytes(entry);
+        if (!this->isEnabled() || bytes > fByteLimit ||
+                NULL != this->lookup(entry->fHash, query)) {
+            return false;
+        }
+
+        if (fCount >= fBuckets.count()) {
+            this->growBuckets();
+        }
+        Entry** bucket = this->bucket(entry->fHash);
+        entry->fHashNext = *bucket;
+        *bucket = entry;
+        this->attachToHead(entry);
+        fCount += 1;
+        fBytesUsed += bytes;
+        fStats.fAdds += 1;
+        this->purgeTo(fByteLimit, fCountLimit);
+        return true;
+    }
+
+    /** Evicts entries, least recently used first, until both limits are met. */
+    void purgeTo(size_t bytes, int count) {
+        while (fBytesUsed > bytes || fCount > count) {
+            SkASSERT(fTail);
+            this->remove(fTail);
+            fStats.fEvictions += 1;
+        }
+    }
+
+private:
+    enum {
+        kInitialBucketCount = 64,
+        kSeenCount          = 256,
+    };
+
+    SkTDArray<Entry*>   fBuckets;   // count is a power of 2
+    Entry*              fHead;      // most recently used
+    Entry*              fTail;
+    int                 fCount;
+    size_t              fBytesUsed;
+    size_t              fByteLimit;
+    int                 fCountLimit;
+    Stats               fStats;
+
+    // hashes of recently missed keys, indexed by their low bits
+    uint32_t            fSeen[kSeenCount];
+
+    Entry** bucket(uint32_t hash) {
+        return &fBuckets[hash & (fBuckets.count() - 1)];
+    }
+
+    template <typename Query>
+    Entry* lookup(uint32_t hash, const Query& query) {
+        for (Entry* entry = *this->bucket(hash); entry; entry = entry->fHashNext) {
+            if (entry->fHash == hash && entry->matches(query)) {
+                return entry;
+            }
+        }
+        return NULL;
+    }
+
+    void detach(Entry* entry) {
+        if (entry->fPrev) {
+            entry->fPrev->fNext = entry->fNext;
+        } else {
+            fHead = entry->fNext;
+        }
+        if (entry->fNext) {
+            entry->fNext->fPrev = entry->fPrev;
+        } else {
+            fTail = entry->fPrev;
+        }
+        entry->fPrev = entry->fNext = NULL;
+    }
+
+    void attachToHead(Entry* entry) {
+        entry->fPrev = NULL;
+        entry->fNext = fHead;
+        if (fHead) {
+            fHead->fPrev = entry;
+        } else {
+            fTail = entry;
+        }
+        fHead = entry;
+    }
+
+    void remove(Entry* entry) {
+        Entry** prev = this->bucket(entry->fHash);
+        while (*prev != entry) {
+            prev = &(*prev)->fHashNext;
+        }
+        *prev = entry->fHashNext;
+        this->detach(entry);
+        fCount -= 1;
+        fBytesUsed -= Traits::Bytes(entry);
+        Traits::Free(entry);
+    }
+
+    void growBuckets() {
+        SkTDArray<Entry*> buckets;
+        buckets.setCount(fBuckets.count() * 2);
+        sk_bzero(buckets.begin(), buckets.count() * sizeof(Entry*));
+        const int mask = buckets.count() - 1;
+        for (int i = 0; i < fBuckets.count(); ++i) {
+            Entry* entry = fBuckets[i];
+            while (entry) {
+                Entry* next = entry->fHashNext;
+                Entry** bucket = &buckets[entry->fHash & mask];
+                entry->fHashNext = *bucket;
+                *bucket = entry;
+                entry = next;
+            }
+        }
+        fBuckets.swap(buckets);
+    }
+};
+
+#endif
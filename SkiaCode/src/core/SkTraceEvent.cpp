@@ -0,0 +1,142 @@
+
+/*
+ * Copyright 2012 Google Inc.
+ *
+ * Use of this source code is governed by a BSD-style license that can be
+ * found in the LICENSE file.
+ */
+
+#include "SkTraceEvent.h"
+#include "SkStream.h"
+#include "SkString.h"
+#include "SkTDArray.h"
+#include "SkThread.h"
+#include "SkTLS.h"
+
+#if !defined(SK_BUILD_FOR_WIN32)
+    #include <sys/time.h>
+#endif
+
+int32_t SkTraceEvent::gRecording;
+
+namespace {
+
+struct Event {
+    const char* fCategory;
+    const char* fName;
+    double      fStart;
+    double      fDuration;
+};
+
+// Each thread records into its own buffer, so that recording takes no lock.
+// The buffers are chained together to be written. A thread's buffer outlives
+// it, since its events are still written, until the next recording starts.
+struct ThreadEvents {
+    ThreadEvents*       fNext;
+    int32_t             fThreadID;
+    bool                fExited;
+    SkTDArray<Event>    fEvents;
+};
+
+}
+
+SK_DECLARE_STATIC_MUTEX(gThreadEventsMutex);
+static ThreadEvents* gThreadEventsHead;
+static int32_t gThreadCount;
+static double gRecordingStart;
+
+static void* create_thread_events() {
+    ThreadEvents* events = SkNEW(ThreadEvents);
+    events->fThreadID = sk_atomic_inc(&gThreadCount) + 1;
+    events->fExited = false;
+
+    SkAutoMutexAcquire ac(gThreadEventsMutex);
+    events->fNext = gThreadEventsHead;
+    gThreadEventsHead = events;
+    return events;
+}
+
+static void delete_thread_events(void* ptr) {
+    // StartRecording() frees it, once its events have been written
+    SkAutoMutexAcquire ac(gThreadEventsMutex);
+    ((ThreadEvents*)ptr)->fExited = true;
+}
+
+double SkTraceEvent::NowUSecs() {
+#if defined(SK_BUILD_FOR_WIN32)
+    static double gUSecsPerTick;
+    if (0 == gUSecsPerTick) {
+        LARGE_INTEGER frequency;
+        QueryPerformanceFrequency(&frequency);
+        gUSecsPerTick = 1e6 / frequency.QuadPart;
+    }
+    LARGE_INTEGER now;
+    QueryPerformanceCounter(&now);
+    return now.QuadPart * gUSecsPerTick;
+#else
+    struct timeval tv;
+    gettimeofday(&tv, NULL);
+    return tv.tv_sec * 1e6 + tv.tv_usec;
+#endif
+}
+
+void SkTraceEvent::StartRecording() {
+    SkASSERT(!IsRecording());
+    SkAutoMutexAcquire ac(gThreadEventsMutex);
+    ThreadEvents** prev = &gThreadEventsHead;
+    while (ThreadEvents* events = *prev) {
+        if (events->fExited) {
+            *prev = events->fNext;
+            SkDELETE(events);
+        } else {
+            events->fEvents.reset();
+            prev = &events->fNext;
+        }
+    }
+    gRecordingStart = NowUSecs();
+    sk_atomic_inc(&gRecording);
+}
+
+void SkTraceEvent::StopRecording() {
+    SkAutoMutexAcquire ac(gThreadEventsMutex);
+    if (IsRecording()) {
+        sk_atomic_dec(&gRecording);
+    }
+}
+
+void SkTraceEvent::Add(const char category[], const char name[], double start) {
+    ThreadEvents* events = (ThreadEvents*)SkTLS::Get(create_thread_events,
+                                                     delete_thread_events);
+    if (events->fEvents.count() >= kMaxEventsPerThread) {
+        return;
+    }
+    Event* event = events->fEvents.append();
+    event->fCategory = category;
+    event->fName = name;
+    event->fStart = start;
+    event->fDuration = NowUSecs() - start;
+}
+
+bool SkTraceEvent::WriteJSON(SkWStream* stream) {
+    SkASSERT(!IsRecording());
+    SkAutoMutexAcquire ac(gThreadEventsMutex);
+    if (!stream->writeText("{\"traceEvents\":[")) {
+        return false;
+    }
+    const char* separator = "\n";
+    SkString str;
+    for (ThreadEvents* events = gThreadEventsHead; events; events = events->fNext) {
+        for (int i = 0; i < events->fEvents.count(); ++i) {
+            const Event& event = events->fEvents[i];
+            // categories and names are literals, which need no escaping
+            str.printf("%s{\"cat\":\"%s\",\"name\":\"%s\",\"ph\":\"X\",\"pid\":1,\"tid\":%d,"
+                       "\"ts\":%.1f,\"dur\":%.1f}", separator, event.fCategory, event.fName,
+                       events->fThreadID, event.fStart - gRecordingStart, event.fDuration);
+            if (!stream->writeText(str.c_str())) {
+                return false;
+            }
+            separator = ",\n";
+        }
+    }
+    return stream->writeText("\n],\"displayTimeUnit\":\"ms\"}\n");
+}
@@ -75,6 +75,8 @@ SkWriter32::SkWriter32(size_t minSize, void* storage, size_t storageSize) {
         fHead = fTail = NULL;
         fHeadIsExternalStorage = false;
     }
+    fPackedByte = fPackedStop = NULL;
+    fPackedEnd = 0;
 }
 
 SkWriter32::~SkWriter32() {
@@ -97,6 +99,7 @@ void SkWriter32::reset() {
 
     fSize = 0;
     fSingleBlock = NULL;
+    fPackedByte = fPackedStop = NULL;
     if (fHeadIsExternalStorage) {
         SkASSERT(fHead);
         fHead->rewind();
@@ -174,6 +177,7 @@ void SkWriter32::rewindToOffset(size_t offset) {
     SkASSERT(SkAlign4(offset) == offset);
     SkASSERT(offset <= fSize);
     fSize = offset;
+    fPackedByte = fPackedStop = NULL;
 
     if (fSingleBlock) {
         return;
@@ -187,6 +187,27 @@ bool SkBlurImageFilter::onFilterImage(Proxy* proxy,
     return true;
 }
 
+bool SkBlurImageFilter::onFilterMargin(const SkMatrix& ctm, SkISize* margin) {
+    if (!this->getInputMargin(ctm, margin)) {
+        return false;
+    }
+    int kernelSizeX, kernelSizeX3, lowOffsetX, highOffsetX;
+    int kernelSizeY, kernelSizeY3, lowOffsetY, highOffsetY;
+    getBox3Params(fSigma.width(), &kernelSizeX, &kernelSizeX3, &lowOffsetX, &highOffsetX);
+    getBox3Params(fSigma.height(), &kernelSizeY, &kernelSizeY3, &lowOffsetY, &highOffsetY);
+    if (kernelSizeX < 0 || kernelSizeY < 0) {
+        return false;
+    }
+    // the three box passes reach this far, all told
+    if (kernelSizeX > 0) {
+        margin->fWidth += 2 * highOffsetX + lowOffsetX;
+    }
+    if (kernelSizeY > 0) {
+        margin->fHeight += 2 * highOffsetY + lowOffsetY;
+    }
+    return true;
+}
+
 GrTexture* SkBlurImageFilter::onFilterImageGPU(GrTexture* src, const SkRect& rect) {
 #if SK_SUPPORT_GPU
     SkAutoTUnref<GrTexture> input(this->getInputResultAsTexture(src, rect));
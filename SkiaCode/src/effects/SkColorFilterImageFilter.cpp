@@ -41,7 +41,11 @@ bool SkColorFilterImageFilter::onFilterImage(Proxy* proxy, const SkBitmap& sourc
         return true;
     }
 
-    SkAutoTUnref<SkDevice> device(proxy->createDevice(src.width(), src.height()));
+    // tiles (see SkImageFilter::SetParallelFor()) are filtered without a proxy
+    SkAutoTUnref<SkDevice> device(proxy ?
+        proxy->createDevice(src.width(), src.height()) :
+        SkNEW_ARGS(SkDevice, (SkBitmap::kARGB_8888_Config, src.width(),
+                              src.height())));
     SkCanvas canvas(device.get());
     SkPaint paint;
 
@@ -53,5 +57,11 @@ bool SkColorFilterImageFilter::onFilterImage(Proxy* proxy, const SkBitmap& sourc
     return true;
 }
 
+bool SkColorFilterImageFilter::onFilterMargin(const SkMatrix& ctm,
+                                              SkISize* margin) {
+    // each pixel is filtered on its own
+    return this->getInputMargin(ctm, margin);
+}
+
 SK_DEFINE_FLATTENABLE_REGISTRAR(SkColorFilterImageFilter)
 
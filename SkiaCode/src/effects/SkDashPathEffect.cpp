@@ -91,7 +91,7 @@ SkDashPathEffect::~SkDashPathEffect() {
 class SpecialLineRec {
 public:
     bool init(const SkPath& src, SkPath* dst, SkStrokeRec* rec,
-              SkScalar pathLength,
+              SkScalar pathLength, SkScalar dashedLength,
               int intervalCount, SkScalar intervalLength) {
         if (rec->isHairlineStyle() || !src.isLine(fPts)) {
             return false;
@@ -113,10 +113,10 @@ public:
         fNormal.scale(SkScalarHalf(rec->getWidth()));
 
         // now estimate how many quads will be added to the path
-        //     resulting segments = pathLen * intervalCount / intervalLen
+        //     resulting segments = dashedLen * intervalCount / intervalLen
         //     resulting points = 4 * segments
 
-        SkScalar ptCount = SkScalarMulDiv(pathLength,
+        SkScalar ptCount = SkScalarMulDiv(dashedLength,
                                           SkIntToScalar(intervalCount),
                                           intervalLength);
         int n = SkScalarCeilToInt(ptCount) << 2;
@@ -155,18 +155,110 @@ private:
     SkScalar fPathLength;
 };
 
+// Returns how far from the path the stroke described by rec can reach.
+static SkScalar stroke_outset(const SkStrokeRec& rec) {
+    SkScalar multiplier = SK_Scalar1;
+    if (SkPaint::kMiter_Join == rec.getJoin()) {
+        multiplier = SkMaxScalar(multiplier, rec.getMiter());
+    }
+    if (SkPaint::kSquare_Cap == rec.getCap()) {
+        multiplier = SkMaxScalar(multiplier, SK_ScalarSqrt2);
+    }
+    return SkScalarMul(SkScalarHalf(rec.getWidth()), multiplier);
+}
+
+static bool bounds_intersect(const SkRect& bounds, const SkRect& rect) {
+    // unlike SkRect::Intersects, allow bounds to be empty (e.g. a hline)
+    return bounds.fLeft <= rect.fRight && rect.fLeft <= bounds.fRight &&
+           bounds.fTop <= rect.fBottom && rect.fTop <= bounds.fBottom;
+}
+
+// Clips the line pts[0]..pts[1] (whose length is length) to rect, returning
+// the visible part as distances along the line. Returns false if the line
+// misses rect entirely.
+static bool clip_line(const SkPoint pts[2], SkScalar length, const SkRect& rect,
+                      SkScalar* start, SkScalar* stop) {
+    SkASSERT(length > 0);
+    SkScalar t0 = 0;
+    SkScalar t1 = length;
+
+    const SkScalar p[2] = { pts[0].fX, pts[0].fY };
+    const SkScalar u[2] = { SkScalarDiv(pts[1].fX - pts[0].fX, length),
+                            SkScalarDiv(pts[1].fY - pts[0].fY, length) };
+    const SkScalar lo[2] = { rect.fLeft, rect.fTop };
+    const SkScalar hi[2] = { rect.fRight, rect.fBottom };
+
+    for (int i = 0; i < 2; ++i) {
+        if (0 == u[i]) {
+            if (p[i] < lo[i] || p[i] > hi[i]) {
+                return false;
+            }
+            continue;
+        }
+        SkScalar ta = SkScalarDiv(lo[i] - p[i], u[i]);
+        SkScalar tb = SkScalarDiv(hi[i] - p[i], u[i]);
+        if (ta > tb) {
+            SkTSwap(ta, tb);
+        }
+        t0 = SkMaxScalar(t0, ta);
+        t1 = SkMinScalar(t1, tb);
+        if (t0 > t1) {
+            return false;
+        }
+    }
+    *start = t0;
+    *stop = t1;
+    return true;
+}
+
 bool SkDashPathEffect::filterPath(SkPath* dst, const SkPath& src,
                                   SkStrokeRec* rec) {
+    return this->internalFilter(dst, src, rec, NULL);
+}
+
+bool SkDashPathEffect::filterPathInRect(SkPath* dst, const SkPath& src,
+                                        SkStrokeRec* rec,
+                                        const SkRect& cullRect) {
+    return this->internalFilter(dst, src, rec, &cullRect);
+}
+
+bool SkDashPathEffect::internalFilter(SkPath* dst, const SkPath& src,
+                                      SkStrokeRec* rec,
+                                      const SkRect* cullRect) {
     // we do nothing if the src wants to be filled, or if our dashlength is 0
     if (rec->isFillStyle() || fInitialDashLength < 0) {
         return false;
     }
 
+    SkRect cull;
+    if (cullRect) {
+        cull = *cullRect;
+        SkScalar outset = stroke_outset(*rec);
+        cull.outset(outset, outset);
+        if (!bounds_intersect(src.getBounds(), cull)) {
+            return true;    // none of our dashes would be visible
+        }
+    }
+
     SkPathMeasure   meas(src, false);
     const SkScalar* intervals = fIntervals;
 
+    // For a single line we can tell which part of it is visible, and only
+    // dash that part. This is what keeps a dashed line that spans a huge
+    // canvas from producing millions of invisible segments.
+    SkPoint linePts[2];
+    SkScalar visibleStart = 0;
+    SkScalar visibleStop = meas.getLength();
+    const bool cullLine = cullRect && meas.getLength() > 0 &&
+                          src.isLine(linePts);
+    if (cullLine && !clip_line(linePts, meas.getLength(), cull,
+                               &visibleStart, &visibleStop)) {
+        return true;
+    }
+
     SpecialLineRec lineRec;
     const bool specialLine = lineRec.init(src, dst, rec, meas.getLength(),
+                                          visibleStop - visibleStart,
                                           fCount >> 1, fIntervalLength);
 
     do {
@@ -188,8 +280,21 @@ bool SkDashPathEffect::filterPath(SkPath* dst, const SkPath& src,
 
         SkScalar    distance = 0;
         SkScalar    dlen = SkScalarMul(fInitialDashLength, scale);
+        SkScalar    stop = length;
+
+        if (cullLine) {
+            // The pattern repeats exactly every period, so skipping whole
+            // periods leaves index and dlen as they are.
+            SkScalar period = SkScalarMul(fIntervalLength, scale);
+            if (period > 0 && visibleStart > period) {
+                distance = SkScalarMul(
+                        SkScalarFloorToScalar(SkScalarDiv(visibleStart, period)),
+                        period);
+            }
+            stop = visibleStop;
+        }
 
-        while (distance < length) {
+        while (distance < stop) {
             SkASSERT(dlen >= 0);
             addedSegment = false;
             if (is_even(index) && dlen > 0 && !skipFirstSegment) {
@@ -227,6 +332,335 @@ bool SkDashPathEffect::filterPath(SkPath* dst, const SkPath& src,
     return true;
 }
 
+///////////////////////////////////////////////////////////////////////////////
+
+// Tracks our position in the dash pattern along a contour: the current
+// interval is [fStart, fStart + fLength), and it is "on" if fIndex is even.
+// The phase may put us part way into the first interval, so it (and its
+// repeats, every period) starts before 0.
+class DashCursor {
+public:
+    DashCursor(const SkScalar intervals[], int count, int initialIndex,
+               SkScalar initialLength, SkScalar period)
+        : fIntervals(intervals)
+        , fCount(count)
+        , fInitialIndex(initialIndex)
+        , fOrigin(initialLength - intervals[initialIndex])
+        , fPeriod(period) {
+        SkASSERT(period > 0);
+        this->seek(0);
+    }
+
+    SkScalar    fStart;
+    SkScalar    fLength;
+    int         fIndex;
+
+    // where the current interval starts on the contour
+    SkScalar start() const { return SkMaxScalar(fStart, 0); }
+    SkScalar stop() const { return fStart + fLength; }
+    bool isOn() const { return is_even(fIndex) && this->stop() > this->start(); }
+
+    void next() {
+        fStart += fLength;
+        fIndex += 1;
+        if (fIndex == fCount) {
+            fIndex = 0;
+        }
+        fLength = fIntervals[fIndex];
+    }
+
+    // Moves to the interval that reaches distance, i.e. the one for which
+    // fStart < distance <= stop() (or the first one, if distance is 0). Since
+    // the pattern repeats every period, we can jump straight to the last
+    // period before distance.
+    void seek(SkScalar distance) {
+        SkScalar periods = SkScalarFloorToScalar(
+                SkScalarDiv(distance - fOrigin, fPeriod));
+        fStart = fOrigin + SkScalarMul(periods, fPeriod);
+        if (fStart >= distance && fStart > fOrigin) {
+            fStart -= fPeriod;
+        }
+        fIndex = fInitialIndex;
+        fLength = fIntervals[fInitialIndex];
+        while (this->stop() < distance) {
+            this->next();
+        }
+    }
+
+private:
+    const SkScalar* fIntervals;
+    int             fCount;
+    int             fInitialIndex;
+    SkScalar        fOrigin;
+    SkScalar        fPeriod;
+};
+
+// The sides of an open line, or of a closed rect, along with the distance
+// along the contour at which each side starts.
+struct AxisAlignedPolyline {
+    SkPoint     fPts[5];
+    SkScalar    fDists[5];
+    int         fSideCount;
+
+    bool isHorizontal(int side) const {
+        return fPts[side].fY == fPts[side + 1].fY;
+    }
+
+    SkScalar length() const { return fDists[fSideCount]; }
+
+    SkPoint pointOnSide(int side, SkScalar distance) const {
+        // step along the side's axis, rather than interpolating, so that
+        // whole and half-pixel positions stay exact
+        SkScalar offset = distance - fDists[side];
+        SkPoint pt = fPts[side];
+        if (this->isHorizontal(side)) {
+            pt.fX += fPts[side + 1].fX > pt.fX ? offset : -offset;
+        } else {
+            pt.fY += fPts[side + 1].fY > pt.fY ? offset : -offset;
+        }
+        return pt;
+    }
+
+    int findSide(SkScalar distance) const {
+        int side = 0;
+        while (side < fSideCount - 1 && distance >= fDists[side + 1]) {
+            side += 1;
+        }
+        return side;
+    }
+
+    // Adds the part of the polyline from start to stop to path, starting a
+    // new contour if moveTo is true.
+    void addSpan(SkScalar start, SkScalar stop, bool moveTo,
+                 SkPath* path) const {
+        int side = this->findSide(start);
+        if (moveTo) {
+            path->moveTo(this->pointOnSide(side, start));
+        }
+        while (side < fSideCount - 1 && fDists[side + 1] < stop) {
+            side += 1;
+            path->lineTo(fPts[side]);
+        }
+        path->lineTo(this->pointOnSide(side, stop));
+    }
+
+    bool setLine(const SkPath& path) {
+        if (!path.isLine(fPts)) {
+            return false;
+        }
+        fSideCount = 1;
+        return this->computeDists();
+    }
+
+    bool setRect(const SkPath& path) {
+        SkPath::Iter iter(path, false);
+        SkPoint pts[4];
+        int count = 0;
+        SkPath::Verb verb;
+        bool closed = false;
+        while ((verb = iter.next(pts)) != SkPath::kDone_Verb) {
+            switch (verb) {
+                case SkPath::kMove_Verb:
+                    if (0 != count) {
+                        return false;
+                    }
+                    fPts[count++] = pts[0];
+                    break;
+                case SkPath::kLine_Verb:
+                    if (closed || count >= 5) {
+                        return false;
+                    }
+                    fPts[count++] = pts[1];
+                    break;
+                case SkPath::kClose_Verb:
+                    closed = true;
+                    break;
+                default:
+                    return false;
+            }
+        }
+        if (!closed || 5 != count || fPts[4] != fPts[0]) {
+            return false;
+        }
+        fSideCount = 4;
+        if (!this->computeDists()) {
+            return false;
+        }
+        // the sides must alternate between horizontal and vertical
+        return this->isHorizontal(0) != this->isHorizontal(1) &&
+               this->isHorizontal(0) == this->isHorizontal(2) &&
+               this->isHorizontal(1) == this->isHorizontal(3);
+    }
+
+private:
+    bool computeDists() {
+        fDists[0] = 0;
+        for (int i = 0; i < fSideCount; ++i) {
+            const SkPoint& p0 = fPts[i];
+            const SkPoint& p1 = fPts[i + 1];
+            if (p0.fX != p1.fX && p0.fY != p1.fY) {
+                return false;   // not axis-aligned
+            }
+            SkScalar len = SkPoint::Distance(p0, p1);
+            if (!(len > 0)) {
+                return false;
+            }
+            fDists[i + 1] = fDists[i] + len;
+        }
+        return SkScalarIsFinite(fDists[fSideCount]);
+    }
+};
+
+bool SkDashPathEffect::asRects(SkTDArray<SkRect>* rects, SkPath* fillPath,
+                               const SkPath& src, const SkStrokeRec& rec,
+                               const SkRect& cullRect) {
+    if (fInitialDashLength < 0 || fScaleToFit ||
+            SkStrokeRec::kStroke_Style != rec.getStyle() ||
+            SkPaint::kButt_Cap != rec.getCap()) {
+        return false;
+    }
+
+    const SkScalar width = rec.getWidth();
+    // Our rects are drawn one at a time, so they mustn't overlap (or even
+    // abut, since the shared antialiased edge would be blended twice). This
+    // holds as long as every gap is at least as long as the stroke is wide.
+    for (int i = 1; i < fCount; i += 2) {
+        if (fIntervals[i] < width) {
+            return false;
+        }
+    }
+
+    AxisAlignedPolyline poly;
+    bool closed = false;
+    if (!poly.setLine(src)) {
+        if (!poly.setRect(src)) {
+            return false;
+        }
+        closed = true;
+        // opposite sides of a thin rect would overlap
+        for (int i = 0; i < poly.fSideCount; ++i) {
+            if (poly.fDists[i + 1] - poly.fDists[i] < width) {
+                return false;
+            }
+        }
+    }
+
+    const SkScalar length = poly.length();
+    if (closed && fInitialDashLength >= length) {
+        return false;   // the first dash wraps all the way around
+    }
+
+    DashCursor cursor(fIntervals, fCount, fInitialDashIndex,
+                      fInitialDashLength, fIntervalLength);
+
+    // Dashes that turn a corner aren't rects; we stroke them as a path.
+    SkPath corners;
+
+    // On a closed contour the pattern doesn't line up where the contour
+    // starts and ends, so the first (head) and last (tail) dashes need care.
+    // If we start with a dash, it continues the dash that runs into the end
+    // of the contour (if there is one), turning the first corner (see
+    // filterPath). Otherwise the two dashes may still come close enough to
+    // overlap, in which case we also leave them to the path.
+    SkScalar headStop = 0;
+    SkScalar tailStart = length;
+    if (closed) {
+        SkScalar firstStart = 0;
+        SkScalar firstStop = 0;
+        for (cursor.seek(0); cursor.start() < length; cursor.next()) {
+            if (cursor.isOn()) {
+                firstStart = cursor.start();
+                firstStop = SkMinScalar(cursor.stop(), length);
+                break;
+            }
+        }
+        SkScalar lastStart = -SK_Scalar1;
+        SkScalar lastStop = 0;
+        for (cursor.seek(SkMaxScalar(length - fIntervalLength, 0));
+                cursor.start() < length; cursor.next()) {
+            if (cursor.isOn()) {
+                lastStart = cursor.start();
+                lastStop = SkMinScalar(cursor.stop(), length);
+            }
+        }
+
+        if (lastStart > firstStop) {
+            if (is_even(fInitialDashIndex) && fInitialDashLength > 0 &&
+                    lastStop >= length) {
+                headStop = firstStop;
+                tailStart = lastStart;
+                poly.addSpan(tailStart, length, true, &corners);
+                poly.addSpan(0, headStop, false, &corners);
+            } else if (length - lastStop + firstStart < width) {
+                headStop = firstStop;
+                tailStart = lastStart;
+                poly.addSpan(firstStart, firstStop, true, &corners);
+                poly.addSpan(lastStart, lastStop, true, &corners);
+            }
+        }
+    }
+
+    SkScalar covered = headStop;
+    for (int i = 1; i < poly.fSideCount; ++i) {
+        SkScalar corner = poly.fDists[i];
+        if (corner <= covered || corner >= tailStart) {
+            continue;
+        }
+        cursor.seek(corner);
+        if (cursor.isOn() && cursor.stop() > corner) {
+            SkScalar stop = SkMinScalar(cursor.stop(), length);
+            poly.addSpan(cursor.start(), stop, true, &corners);
+            covered = stop;
+        }
+    }
+    if (!corners.isEmpty()) {
+        SkPath stroked;
+        rec.applyToPath(&stroked, corners);
+        fillPath->addPath(stroked);
+    }
+
+    // Everything else lies along a single side, and is just a rect.
+    const SkScalar radius = SkScalarHalf(width);
+    SkRect cull = cullRect;
+    cull.outset(radius, radius);
+
+    for (int side = 0; side < poly.fSideCount; ++side) {
+        const SkScalar sideStart = poly.fDists[side];
+        const SkScalar sideStop = poly.fDists[side + 1];
+        SkScalar visibleStart, visibleStop;
+        if (!clip_line(&poly.fPts[side], sideStop - sideStart, cull,
+                       &visibleStart, &visibleStop)) {
+            continue;
+        }
+        visibleStart += sideStart;
+        visibleStop += sideStart;
+
+        for (cursor.seek(visibleStart); cursor.start() < visibleStop;
+                cursor.next()) {
+            if (!cursor.isOn()) {
+                continue;
+            }
+            SkScalar start = cursor.start();
+            SkScalar stop = SkMinScalar(cursor.stop(), length);
+            if (start < sideStart || stop > sideStop ||
+                    stop <= headStop || start >= tailStart) {
+                continue;   // turns a corner, or is the head or tail
+            }
+
+            SkPoint p0 = poly.pointOnSide(side, start);
+            SkPoint p1 = poly.pointOnSide(side, stop);
+            SkRect* r = rects->append();
+            r->set(p0, p1);
+            if (poly.isHorizontal(side)) {
+                r->outset(0, radius);
+            } else {
+                r->outset(radius, 0);
+            }
+        }
+    }
+    return true;
+}
+
 SkFlattenable::Factory SkDashPathEffect::getFactory() {
     return fInitialDashLength < 0 ? NULL : CreateProc;
 }
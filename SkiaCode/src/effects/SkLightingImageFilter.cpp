@@ -9,8 +9,10 @@
 #include "SkBitmap.h"
 #include "SkColorPriv.h"
 #include "SkFlattenableBuffers.h"
+#include "SkLightingRow.h"
 #include "SkOrderedReadBuffer.h"
 #include "SkOrderedWriteBuffer.h"
+#include "SkTemplates.h"
 #include "SkTypes.h"
 
 #if SK_SUPPORT_GPU
@@ -31,8 +33,6 @@ static const UniformHandle kInvalidUniformHandle = GrGLUniformManager::kInvalidU
 namespace {
 
 const SkScalar gOneThird = SkScalarInvert(SkIntToScalar(3));
-const SkScalar gTwoThirds = SkScalarDiv(SkIntToScalar(2), SkIntToScalar(3));
-const SkScalar gOneHalf = SkFloatToScalar(0.5f);
 const SkScalar gOneQuarter = SkFloatToScalar(0.25f);
 
 #if SK_SUPPORT_GPU
@@ -53,201 +53,117 @@ void setUniformPoint3FlipY(const GrGLUniformManager& uman,
 }
 #endif
 
-// Shift matrix components to the left, as we advance pixels to the right.
-inline void shiftMatrixLeft(int m[9]) {
-    m[0] = m[1];
-    m[3] = m[4];
-    m[6] = m[7];
-    m[1] = m[2];
-    m[4] = m[5];
-    m[7] = m[8];
-}
-
-class DiffuseLightingType {
-public:
-    DiffuseLightingType(SkScalar kd)
-        : fKD(kd) {}
-    SkPMColor light(const SkPoint3& normal, const SkPoint3& surfaceTolight, const SkPoint3& lightColor) const {
-        SkScalar colorScale = SkScalarMul(fKD, normal.dot(surfaceTolight));
-        colorScale = SkScalarClampMax(colorScale, SK_Scalar1);
-        SkPoint3 color(lightColor * colorScale);
-        return SkPackARGB32(255,
-                            SkScalarFloorToInt(color.fX),
-                            SkScalarFloorToInt(color.fY),
-                            SkScalarFloorToInt(color.fZ));
+// Pins x to [0, 1], sending NaN to 0.
+inline float clamp_unit(float x) {
+    return x > 0 ? (x < 1 ? x : 1) : 0;
+}
+
+// pow(x, exponent) for x in [0, 1], read from a table built by buildPowTable.
+inline float pow_lookup(const float table[], float x) {
+    float f = clamp_unit(x) * SkLightingRow::kPowTableSize;
+    int i = (int)f;
+    float t = f - (float)i;
+    return table[i] + (table[i + 1] - table[i]) * t;
+}
+
+inline void setNormal(float gx, float gy, SkScalar surfaceScale,
+                      float* nx, float* ny, float* nz) {
+    float a = -gx * surfaceScale;
+    float b = -gy * surfaceScale;
+    float scale = SkScalarInvert(SkScalarSqrt((a * a + b * b) + 1));
+    *nx = a * scale;
+    *ny = b * scale;
+    *nz = scale;
+}
+
+// The first and last pixels of a row leave out the column outside the
+// bitmap, so they take the larger scales edgeScaleX and edgeScaleY.
+void edgeNormal(const SkLightingRow::NormalsRec& rec, SkScalar edgeScaleX,
+                SkScalar edgeScaleY, const float prev[], const float curr[],
+                const float next[], int x, int width,
+                float nx[], float ny[], float nz[]) {
+    int xl = x > 0 ? x - 1 : x;
+    int xr = x < width - 1 ? x + 1 : x;
+    float wl = SkIntToScalar(x > 0);
+    float wr = SkIntToScalar(x < width - 1);
+    float gx = ((prev[xr] - prev[xl]) * rec.fPrevWeight +
+                (curr[xr] - curr[xl]) * 2) +
+               (next[xr] - next[xl]) * rec.fNextWeight;
+    float gy = ((next[xl] - prev[xl]) * wl + (next[x] - prev[x]) * 2) +
+               (next[xr] - prev[xr]) * wr;
+    setNormal(gx * edgeScaleX, gy * edgeScaleY, rec.fSurfaceScale,
+              &nx[x], &ny[x], &nz[x]);
+}
+
+void normals_portable(const SkLightingRow::NormalsRec& rec,
+                      const float prev[], const float curr[],
+                      const float next[], int width,
+                      float nx[], float ny[], float nz[]) {
+    for (int x = 1; x < width - 1; ++x) {
+        float gx = ((prev[x + 1] - prev[x - 1]) * rec.fPrevWeight +
+                    (curr[x + 1] - curr[x - 1]) * 2) +
+                   (next[x + 1] - next[x - 1]) * rec.fNextWeight;
+        float gy = ((next[x - 1] - prev[x - 1]) + (next[x] - prev[x]) * 2) +
+                   (next[x + 1] - prev[x + 1]);
+        setNormal(gx * rec.fScaleX, gy * rec.fScaleY, rec.fSurfaceScale,
+                  &nx[x], &ny[x], &nz[x]);
     }
-private:
-    SkScalar fKD;
-};
-
-class SpecularLightingType {
-public:
-    SpecularLightingType(SkScalar ks, SkScalar shininess)
-        : fKS(ks), fShininess(shininess) {}
-    SkPMColor light(const SkPoint3& normal, const SkPoint3& surfaceTolight, const SkPoint3& lightColor) const {
-        SkPoint3 halfDir(surfaceTolight);
-        halfDir.fZ += SK_Scalar1;        // eye position is always (0, 0, 1)
-        halfDir.normalize();
-        SkScalar colorScale = SkScalarMul(fKS,
-            SkScalarPow(normal.dot(halfDir), fShininess));
-        colorScale = SkScalarClampMax(colorScale, SK_Scalar1);
-        SkPoint3 color(lightColor * colorScale);
-        return SkPackARGB32(SkScalarFloorToInt(color.maxComponent()),
-                            SkScalarFloorToInt(color.fX),
-                            SkScalarFloorToInt(color.fY),
-                            SkScalarFloorToInt(color.fZ));
-    }
-private:
-    SkScalar fKS;
-    SkScalar fShininess;
-};
-
-inline SkScalar sobel(int a, int b, int c, int d, int e, int f, SkScalar scale) {
-    return SkScalarMul(SkIntToScalar(-a + b - 2 * c + 2 * d -e + f), scale);
-}
-
-inline SkPoint3 pointToNormal(SkScalar x, SkScalar y, SkScalar surfaceScale) {
-    SkPoint3 vector(SkScalarMul(-x, surfaceScale),
-                    SkScalarMul(-y, surfaceScale),
-                    SK_Scalar1);
-    vector.normalize();
-    return vector;
-}
-
-inline SkPoint3 topLeftNormal(int m[9], SkScalar surfaceScale) {
-    return pointToNormal(sobel(0, 0, m[4], m[5], m[7], m[8], gTwoThirds),
-                         sobel(0, 0, m[4], m[7], m[5], m[8], gTwoThirds),
-                         surfaceScale);
-}
-
-inline SkPoint3 topNormal(int m[9], SkScalar surfaceScale) {
-    return pointToNormal(sobel(   0,    0, m[3], m[5], m[6], m[8], gOneThird),
-                         sobel(m[3], m[6], m[4], m[7], m[5], m[8], gOneHalf),
-                         surfaceScale);
-}
-
-inline SkPoint3 topRightNormal(int m[9], SkScalar surfaceScale) {
-    return pointToNormal(sobel(   0,    0, m[3], m[4], m[6], m[7], gTwoThirds),
-                         sobel(m[3], m[6], m[4], m[7],    0,    0, gTwoThirds),
-                         surfaceScale);
 }
 
-inline SkPoint3 leftNormal(int m[9], SkScalar surfaceScale) {
-    return pointToNormal(sobel(m[1], m[2], m[4], m[5], m[7], m[8], gOneHalf),
-                         sobel(   0,    0, m[1], m[7], m[2], m[8], gOneThird),
-                         surfaceScale);
-}
-
-
-inline SkPoint3 interiorNormal(int m[9], SkScalar surfaceScale) {
-    return pointToNormal(sobel(m[0], m[2], m[3], m[5], m[6], m[8], gOneQuarter),
-                         sobel(m[0], m[6], m[1], m[7], m[2], m[8], gOneQuarter),
-                         surfaceScale);
-}
-
-inline SkPoint3 rightNormal(int m[9], SkScalar surfaceScale) {
-    return pointToNormal(sobel(m[0], m[1], m[3], m[4], m[6], m[7], gOneHalf),
-                         sobel(m[0], m[6], m[1], m[7],    0,    0, gOneThird),
-                         surfaceScale);
-}
-
-inline SkPoint3 bottomLeftNormal(int m[9], SkScalar surfaceScale) {
-    return pointToNormal(sobel(m[1], m[2], m[4], m[5],    0,    0, gTwoThirds),
-                         sobel(   0,    0, m[1], m[4], m[2], m[5], gTwoThirds),
-                         surfaceScale);
-}
-
-inline SkPoint3 bottomNormal(int m[9], SkScalar surfaceScale) {
-    return pointToNormal(sobel(m[0], m[2], m[3], m[5],    0,    0, gOneThird),
-                         sobel(m[0], m[3], m[1], m[4], m[2], m[5], gOneHalf),
-                         surfaceScale);
-}
-
-inline SkPoint3 bottomRightNormal(int m[9], SkScalar surfaceScale) {
-    return pointToNormal(sobel(m[0], m[1], m[3], m[4], 0,  0, gTwoThirds),
-                         sobel(m[0], m[3], m[1], m[4], 0,  0, gTwoThirds),
-                         surfaceScale);
-}
-
-template <class LightingType, class LightType> void lightBitmap(const LightingType& lightingType, const SkLight* light, const SkBitmap& src, SkBitmap* dst, SkScalar surfaceScale) {
-    const LightType* l = static_cast<const LightType*>(light);
-    int y = 0;
-    {
-        const SkPMColor* row1 = src.getAddr32(0, 0);
-        const SkPMColor* row2 = src.getAddr32(0, 1);
-        SkPMColor* dptr = dst->getAddr32(0, 0);
-        int m[9];
-        int x = 0;
-        m[4] = SkGetPackedA32(*row1++);
-        m[5] = SkGetPackedA32(*row1++);
-        m[7] = SkGetPackedA32(*row2++);
-        m[8] = SkGetPackedA32(*row2++);
-        SkPoint3 surfaceToLight = l->surfaceToLight(x, y, m[4], surfaceScale);
-        *dptr++ = lightingType.light(topLeftNormal(m, surfaceScale), surfaceToLight, l->lightColor(surfaceToLight));
-        for (x = 1; x < src.width() - 1; ++x)
-        {
-            shiftMatrixLeft(m);
-            m[5] = SkGetPackedA32(*row1++);
-            m[8] = SkGetPackedA32(*row2++);
-            surfaceToLight = l->surfaceToLight(x, 0, m[4], surfaceScale);
-            *dptr++ = lightingType.light(topNormal(m, surfaceScale), surfaceToLight, l->lightColor(surfaceToLight));
-        }
-        shiftMatrixLeft(m);
-        surfaceToLight = l->surfaceToLight(x, y, m[4], surfaceScale);
-        *dptr++ = lightingType.light(topRightNormal(m, surfaceScale), surfaceToLight, l->lightColor(surfaceToLight));
-    }
-
-    for (++y; y < src.height() - 1; ++y) {
-        const SkPMColor* row0 = src.getAddr32(0, y - 1);
-        const SkPMColor* row1 = src.getAddr32(0, y);
-        const SkPMColor* row2 = src.getAddr32(0, y + 1);
-        SkPMColor* dptr = dst->getAddr32(0, y);
-        int m[9];
-        int x = 0;
-        m[1] = SkGetPackedA32(*row0++);
-        m[2] = SkGetPackedA32(*row0++);
-        m[4] = SkGetPackedA32(*row1++);
-        m[5] = SkGetPackedA32(*row1++);
-        m[7] = SkGetPackedA32(*row2++);
-        m[8] = SkGetPackedA32(*row2++);
-        SkPoint3 surfaceToLight = l->surfaceToLight(x, y, m[4], surfaceScale);
-        *dptr++ = lightingType.light(leftNormal(m, surfaceScale), surfaceToLight, l->lightColor(surfaceToLight));
-        for (x = 1; x < src.width() - 1; ++x) {
-            shiftMatrixLeft(m);
-            m[2] = SkGetPackedA32(*row0++);
-            m[5] = SkGetPackedA32(*row1++);
-            m[8] = SkGetPackedA32(*row2++);
-            surfaceToLight = l->surfaceToLight(x, y, m[4], surfaceScale);
-            *dptr++ = lightingType.light(interiorNormal(m, surfaceScale), surfaceToLight, l->lightColor(surfaceToLight));
+void shade_portable(const SkLightingRow::ShadeRec& rec, int x, int y,
+                    const float alpha[], const float nx[], const float ny[],
+                    const float nz[], SkPMColor dst[], int count) {
+    for (int i = 0; i < count; ++i) {
+        float lx = rec.fLight[0];
+        float ly = rec.fLight[1];
+        float lz = rec.fLight[2];
+        float r = rec.fColor[0];
+        float g = rec.fColor[1];
+        float b = rec.fColor[2];
+        if (SkLightingRow::kDistant_LightType != rec.fLightType) {
+            lx -= SkIntToScalar(x + i);
+            ly -= SkIntToScalar(y);
+            lz -= alpha[i] * rec.fSurfaceScale;
+            float scale = SkScalarInvert(SkScalarSqrt((lx * lx + ly * ly) + lz * lz));
+            lx *= scale;
+            ly *= scale;
+            lz *= scale;
+            if (SkLightingRow::kSpot_LightType == rec.fLightType) {
+                float cosAngle = -((lx * rec.fS[0] + ly * rec.fS[1]) + lz * rec.fS[2]);
+                float spot = 0;
+                if (cosAngle >= rec.fCosOuterConeAngle) {
+                    spot = pow_lookup(rec.fSpotTable, cosAngle);
+                    if (cosAngle < rec.fCosInnerConeAngle) {
+                        spot = (spot * (cosAngle - rec.fCosOuterConeAngle)) * rec.fConeScale;
+                    }
+                }
+                r *= spot;
+                g *= spot;
+                b *= spot;
+            }
         }
-        shiftMatrixLeft(m);
-        surfaceToLight = l->surfaceToLight(x, y, m[4], surfaceScale);
-        *dptr++ = lightingType.light(rightNormal(m, surfaceScale), surfaceToLight, l->lightColor(surfaceToLight));
-    }
 
-    {
-        const SkPMColor* row0 = src.getAddr32(0, src.height() - 2);
-        const SkPMColor* row1 = src.getAddr32(0, src.height() - 1);
-        int x = 0;
-        SkPMColor* dptr = dst->getAddr32(0, src.height() - 1);
-        int m[9];
-        m[1] = SkGetPackedA32(*row0++);
-        m[2] = SkGetPackedA32(*row0++);
-        m[4] = SkGetPackedA32(*row1++);
-        m[5] = SkGetPackedA32(*row1++);
-        SkPoint3 surfaceToLight = l->surfaceToLight(x, y, m[4], surfaceScale);
-        *dptr++ = lightingType.light(bottomLeftNormal(m, surfaceScale), surfaceToLight, l->lightColor(surfaceToLight));
-        for (x = 1; x < src.width() - 1; ++x)
-        {
-            shiftMatrixLeft(m);
-            m[2] = SkGetPackedA32(*row0++);
-            m[5] = SkGetPackedA32(*row1++);
-            surfaceToLight = l->surfaceToLight(x, y, m[4], surfaceScale);
-            *dptr++ = lightingType.light(bottomNormal(m, surfaceScale), surfaceToLight, l->lightColor(surfaceToLight));
+        float colorScale;
+        if (rec.fSpecular) {
+            if (SkLightingRow::kDistant_LightType != rec.fLightType) {
+                // eye position is always (0, 0, 1)
+                lz += 1;
+                float scale = SkScalarInvert(SkScalarSqrt((lx * lx + ly * ly) + lz * lz));
+                lx *= scale;
+                ly *= scale;
+                lz *= scale;
+            }
+            float dot = (nx[i] * lx + ny[i] * ly) + nz[i] * lz;
+            colorScale = clamp_unit(rec.fK * pow_lookup(rec.fShininessTable, dot));
+        } else {
+            float dot = (nx[i] * lx + ny[i] * ly) + nz[i] * lz;
+            colorScale = clamp_unit(rec.fK * dot);
         }
-        shiftMatrixLeft(m);
-        surfaceToLight = l->surfaceToLight(x, y, m[4], surfaceScale);
-        *dptr++ = lightingType.light(bottomRightNormal(m, surfaceScale), surfaceToLight, l->lightColor(surfaceToLight));
+        int ir = (int)(r * colorScale);
+        int ig = (int)(g * colorScale);
+        int ib = (int)(b * colorScale);
+        int ia = rec.fSpecular ? SkMax32(ir, SkMax32(ig, ib)) : 255;
+        dst[i] = SkPackARGB32(ia, ir, ig, ib);
     }
 }
 
@@ -695,6 +611,144 @@ private:
 
 ///////////////////////////////////////////////////////////////////////////////
 
+namespace {
+
+void buildPowTable(float table[], SkScalar exponent) {
+    for (int i = 0; i <= SkLightingRow::kPowTableSize; ++i) {
+        table[i] = SkScalarPow(SkIntToScalar(i) / SkLightingRow::kPowTableSize,
+                               exponent);
+    }
+    // so pow_lookup(1) can always read the entry past i
+    table[SkLightingRow::kPowTableSize + 1] = table[SkLightingRow::kPowTableSize];
+}
+
+void setPoint3(float dst[3], const SkPoint3& point) {
+    dst[0] = point.fX;
+    dst[1] = point.fY;
+    dst[2] = point.fZ;
+}
+
+void loadAlphaRow(const SkBitmap& src, int y, float alpha[]) {
+    const SkPMColor* row = src.getAddr32(0, y);
+    for (int x = 0; x < src.width(); ++x) {
+        alpha[x] = SkIntToScalar(SkGetPackedA32(row[x]));
+    }
+}
+
+// Lights src a row at a time: the normals of a row are found from the alpha
+// of it and its neighbours, then the light is evaluated from those normals.
+// k is kd for a diffuse filter, or ks for a specular one.
+void lightBitmap(const SkLight* light, bool specular, SkScalar k,
+                 SkScalar shininess, SkScalar surfaceScale,
+                 const SkBitmap& src, SkBitmap* dst) {
+    SkLightingRow::NormalsProc normalsProc = SkLightingRow::PlatformNormalsProc();
+    if (NULL == normalsProc) {
+        normalsProc = normals_portable;
+    }
+    SkLightingRow::ShadeProc shadeProc = SkLightingRow::PlatformShadeProc();
+    if (NULL == shadeProc) {
+        shadeProc = shade_portable;
+    }
+
+    float shininessTable[SkLightingRow::kPowTableSize + 2];
+    float spotTable[SkLightingRow::kPowTableSize + 2];
+
+    SkLightingRow::ShadeRec rec;
+    memset(&rec, 0, sizeof(rec));
+    rec.fSpecular = specular;
+    rec.fK = k;
+    rec.fSurfaceScale = surfaceScale;
+    setPoint3(rec.fColor, light->color());
+    if (specular) {
+        buildPowTable(shininessTable, shininess);
+        rec.fShininessTable = shininessTable;
+    }
+    switch (light->type()) {
+        case SkLight::kDistant_LightType: {
+            SkPoint3 direction =
+                static_cast<const SkDistantLight*>(light)->direction();
+            if (specular) {
+                // the half vector is the same at every pixel
+                direction.fZ += SK_Scalar1;
+                direction.normalize();
+            }
+            rec.fLightType = SkLightingRow::kDistant_LightType;
+            setPoint3(rec.fLight, direction);
+            break;
+        }
+        case SkLight::kPoint_LightType:
+            rec.fLightType = SkLightingRow::kPoint_LightType;
+            setPoint3(rec.fLight,
+                      static_cast<const SkPointLight*>(light)->location());
+            break;
+        case SkLight::kSpot_LightType: {
+            const SkSpotLight* spot = static_cast<const SkSpotLight*>(light);
+            rec.fLightType = SkLightingRow::kSpot_LightType;
+            setPoint3(rec.fLight, spot->location());
+            setPoint3(rec.fS, spot->s());
+            rec.fCosOuterConeAngle = spot->cosOuterConeAngle();
+            rec.fCosInnerConeAngle = spot->cosInnerConeAngle();
+            rec.fConeScale = spot->coneScale();
+            buildPowTable(spotTable, spot->specularExponent());
+            rec.fSpotTable = spotTable;
+            break;
+        }
+    }
+
+    const int width = src.width();
+    const int height = src.height();
+    // three rows of alpha, then the normals of one row
+    SkAutoTMalloc<float> storage(6 * width);
+    float* rows[3] = { storage.get(), storage.get() + width,
+                       storage.get() + 2 * width };
+    float* nx = storage.get() + 3 * width;
+    float* ny = nx + width;
+    float* nz = ny + width;
+
+    loadAlphaRow(src, 0, rows[1]);
+    for (int y = 0; y < height; ++y) {
+        const bool hasPrev = y > 0;
+        const bool hasNext = y < height - 1;
+        if (hasNext) {
+            loadAlphaRow(src, y + 1, rows[2]);
+        }
+        const float* prev = hasPrev ? rows[0] : rows[1];
+        const float* curr = rows[1];
+        const float* next = hasNext ? rows[2] : rows[1];
+
+        // Rows missing a neighbour weigh the one they have more heavily.
+        SkScalar rowScale = hasPrev && hasNext ? gOneQuarter : gOneThird;
+        SkScalar rowFactor = SkIntToScalar(hasPrev && hasNext ? 1 : 2);
+
+        SkLightingRow::NormalsRec normals;
+        normals.fPrevWeight = SkIntToScalar(hasPrev);
+        normals.fNextWeight = SkIntToScalar(hasNext);
+        normals.fScaleX = rowScale;
+        normals.fScaleY = gOneQuarter * rowFactor;
+        normals.fSurfaceScale = surfaceScale;
+        normalsProc(normals, prev, curr, next, width, nx, ny, nz);
+
+        SkScalar edgeScaleX = rowScale * 2;
+        SkScalar edgeScaleY = gOneThird * rowFactor;
+        edgeNormal(normals, edgeScaleX, edgeScaleY, prev, curr, next, 0,
+                   width, nx, ny, nz);
+        edgeNormal(normals, edgeScaleX, edgeScaleY, prev, curr, next,
+                   width - 1, width, nx, ny, nz);
+
+        shadeProc(rec, 0, y, curr, nx, ny, nz, dst->getAddr32(0, y), width);
+
+        // rotate the rows, so the next row's neighbours are in place
+        float* tmp = rows[0];
+        rows[0] = rows[1];
+        rows[1] = rows[2];
+        rows[2] = tmp;
+    }
+}
+
+}
+
+///////////////////////////////////////////////////////////////////////////////
+
 SkLightingImageFilter::SkLightingImageFilter(SkLight* light, SkScalar surfaceScale)
   : fLight(light),
     fSurfaceScale(SkScalarDiv(surfaceScale, SkIntToScalar(255)))
@@ -768,6 +822,17 @@ void SkLightingImageFilter::flatten(SkFlattenableWriteBuffer& buffer) const {
     buffer.writeScalar(fSurfaceScale);
 }
 
+bool SkLightingImageFilter::onFilterMargin(const SkMatrix&, SkISize* margin) {
+    // Point and spot lights depend on where each pixel is in src, so they
+    // would come out differently in each tile.
+    if (fLight->type() != SkLight::kDistant_LightType) {
+        return false;
+    }
+    // the normals are found from each pixel's 3x3 neighbourhood
+    margin->set(1, 1);
+    return true;
+}
+
 ///////////////////////////////////////////////////////////////////////////////
 
 SkDiffuseLightingImageFilter::SkDiffuseLightingImageFilter(SkLight* light, SkScalar surfaceScale, SkScalar kd)
@@ -805,18 +870,7 @@ bool SkDiffuseLightingImageFilter::onFilterImage(Proxy*,
     dst->setConfig(src.config(), src.width(), src.height());
     dst->allocPixels();
 
-    DiffuseLightingType lightingType(fKD);
-    switch (light()->type()) {
-        case SkLight::kDistant_LightType:
-            lightBitmap<DiffuseLightingType, SkDistantLight>(lightingType, light(), src, dst, surfaceScale());
-            break;
-        case SkLight::kPoint_LightType:
-            lightBitmap<DiffuseLightingType, SkPointLight>(lightingType, light(), src, dst, surfaceScale());
-            break;
-        case SkLight::kSpot_LightType:
-            lightBitmap<DiffuseLightingType, SkSpotLight>(lightingType, light(), src, dst, surfaceScale());
-            break;
-    }
+    lightBitmap(light(), false, fKD, 0, surfaceScale(), src, dst);
     return true;
 }
 
@@ -874,18 +928,7 @@ bool SkSpecularLightingImageFilter::onFilterImage(Proxy*,
     dst->setConfig(src.config(), src.width(), src.height());
     dst->allocPixels();
 
-    SpecularLightingType lightingType(fKS, fShininess);
-    switch (light()->type()) {
-        case SkLight::kDistant_LightType:
-            lightBitmap<SpecularLightingType, SkDistantLight>(lightingType, light(), src, dst, surfaceScale());
-            break;
-        case SkLight::kPoint_LightType:
-            lightBitmap<SpecularLightingType, SkPointLight>(lightingType, light(), src, dst, surfaceScale());
-            break;
-        case SkLight::kSpot_LightType:
-            lightBitmap<SpecularLightingType, SkSpotLight>(lightingType, light(), src, dst, surfaceScale());
-            break;
-    }
+    lightBitmap(light(), true, fKS, fShininess, surfaceScale(), src, dst);
     return true;
 }
 
@@ -0,0 +1,89 @@
+/*
+ * Copyright 2012 Google Inc.
+ *
+ * Use of this source code is governed by a BSD-style license that can be
+ * found in the LICENSE file.
+ */
+
+#ifndef SkLightingRow_DEFINED
+#define SkLightingRow_DEFINED
+
+#include "SkColor.h"
+
+/**
+ *  Row procs for the CPU lighting image filters. Each row is lit in two
+ *  steps: the surface normals are found from three rows of alpha, and then
+ *  the light is evaluated at each pixel from its normal. Both steps work on
+ *  plain float arrays, so platform versions can do four pixels at a time.
+ */
+class SkLightingRow {
+public:
+    struct NormalsRec {
+        // weights of the rows above and below (0 at the top and bottom)
+        float   fPrevWeight;
+        float   fNextWeight;
+        // scale for the horizontal and vertical sobel sums
+        float   fScaleX;
+        float   fScaleY;
+        float   fSurfaceScale;
+    };
+
+    /**
+     *  Sets the unit surface normals of pixels [1, width - 1) of the row curr,
+     *  given the alpha (0..255) of it and of the rows above (prev) and below
+     *  (next). At the top and bottom, prev or next is curr itself. The first
+     *  and last pixels of the row have their own kernels, so are left alone.
+     */
+    typedef void (*NormalsProc)(const NormalsRec&, const float prev[],
+                                const float curr[], const float next[],
+                                int width, float nx[], float ny[], float nz[]);
+
+    enum LightType {
+        kDistant_LightType,
+        kPoint_LightType,
+        kSpot_LightType
+    };
+
+    enum {
+        kPowTableSize = 1024
+    };
+
+    struct ShadeRec {
+        LightType       fLightType;
+        bool            fSpecular;
+        // direction of a distant light (for specular lights, the normalized
+        // half vector) or the location of a point or spot light
+        float           fLight[3];
+        float           fColor[3];
+        // kd for diffuse lights, ks for specular ones
+        float           fK;
+        float           fSurfaceScale;
+        // pow(i / kPowTableSize, shininess) for i in [0, kPowTableSize + 1]
+        const float*    fShininessTable;
+
+        // spot lights only
+        float           fS[3];
+        float           fCosOuterConeAngle;
+        float           fCosInnerConeAngle;
+        float           fConeScale;
+        // as fShininessTable, for the spot light's specular exponent
+        const float*    fSpotTable;
+    };
+
+    /**
+     *  Lights count pixels starting at (x, y), given their alpha (0..255)
+     *  and unit normals, and writes their colors to dst.
+     */
+    typedef void (*ShadeProc)(const ShadeRec&, int x, int y,
+                              const float alpha[], const float nx[],
+                              const float ny[], const float nz[],
+                              SkPMColor dst[], int count);
+
+    /** Return platform specific procs, or NULL if there are none. Defined in
+        src/opts.
+    */
+    static NormalsProc PlatformNormalsProc();
+    static ShadeProc PlatformShadeProc();
+};
+
+#endif
@@ -35,6 +35,16 @@ void SkMorphologyImageFilter::flatten(SkFlattenableWriteBuffer& buffer) const {
     buffer.writeInt(fRadius.fHeight);
 }
 
+bool SkMorphologyImageFilter::onFilterMargin(const SkMatrix& ctm, SkISize* margin) {
+    if (fRadius.width() < 0 || fRadius.height() < 0 ||
+            !this->getInputMargin(ctm, margin)) {
+        return false;
+    }
+    margin->fWidth += fRadius.width();
+    margin->fHeight += fRadius.height();
+    return true;
+}
+
 static void erode(const SkPMColor* src, SkPMColor* dst,
                   int radius, int width, int height,
                   int srcStrideX, int srcStrideY,
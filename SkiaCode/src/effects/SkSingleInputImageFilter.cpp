@@ -50,6 +50,15 @@ SkBitmap SkSingleInputImageFilter::getInputResult(Proxy* proxy,
     }
 }
 
+bool SkSingleInputImageFilter::getInputMargin(const SkMatrix& ctm,
+                                              SkISize* margin) {
+    if (fInput) {
+        return fInput->filterMargin(ctm, margin);
+    }
+    margin->set(0, 0);
+    return true;
+}
+
 #if SK_SUPPORT_GPU
 GrTexture* SkSingleInputImageFilter::getInputResultAsTexture(GrTexture* src,
                                                              const SkRect& rect) {
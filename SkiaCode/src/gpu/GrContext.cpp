@@ -368,6 +368,11 @@ GrTexture* GrContext::createTexture(
 
     GrResourceKey resourceKey = GrTexture::ComputeKey(fGpu, params, desc, cacheData, false);
 
+    // make room for the new texture before allocating it so that the cache
+    // does not transiently exceed its byte budget
+    fTextureCache->purgeAsNeeded(1, (size_t) desc.fWidth * desc.fHeight *
+                                    GrBytesPerPixel(desc.fConfig));
+
     SkAutoTUnref<GrTexture> texture;
     if (GrTexture::NeedsResizing(resourceKey)) {
         texture.reset(this->createResizedTexture(desc, cacheData,
@@ -26,7 +26,8 @@ GrInOrderDrawBuffer::GrInOrderDrawBuffer(const GrGpu* gpu,
     , fLastRectVertexLayout(0)
     , fQuadIndexBuffer(NULL)
     , fMaxQuads(0)
-    , fFlushing(false) {
+    , fFlushing(false)
+    , fReorderDraws(!GR_DISABLE_DRAW_REORDERING) {
 
     fCaps = gpu->getCaps();
 
@@ -36,6 +37,7 @@ GrInOrderDrawBuffer::GrInOrderDrawBuffer(const GrGpu* gpu,
     GeometryPoolState& poolState = fGeoPoolStateStack.push_back();
     poolState.fUsedPoolVertexBytes = 0;
     poolState.fUsedPoolIndexBytes = 0;
+    poolState.fVertexData = NULL;
 #if GR_DEBUG
     poolState.fPoolVertexBuffer = (GrVertexBuffer*)~0;
     poolState.fPoolStartVertex = ~0;
@@ -43,6 +45,7 @@ GrInOrderDrawBuffer::GrInOrderDrawBuffer(const GrGpu* gpu,
     poolState.fPoolStartIndex = ~0;
 #endif
     this->reset();
+    this->resetDrawStats();
 }
 
 GrInOrderDrawBuffer::~GrInOrderDrawBuffer() {
@@ -74,6 +77,41 @@ void GrInOrderDrawBuffer::resetDrawTracking() {
     fInstancedDrawTracker.reset();
 }
 
+void GrInOrderDrawBuffer::resetDrawStats() {
+    fDrawStats.fRecordedDraws = 0;
+    fDrawStats.fIssuedDraws = 0;
+    fDrawStats.fReorderedDraws = 0;
+}
+
+void GrInOrderDrawBuffer::addToDevBounds(Draw* draw,
+                                         int startVertex,
+                                         int vertexCount) const {
+    if (!draw->fHasDevBounds) {
+        return;
+    }
+    const void* vertices = fGeoPoolStateStack.back().fVertexData;
+    const GrMatrix& viewMatrix = this->getDrawState().getViewMatrix();
+    if (kBuffer_GeometrySrcType == this->getGeomSrc().fVertexSrc ||
+        NULL == vertices || viewMatrix.hasPerspective()) {
+        draw->fHasDevBounds = false;
+        return;
+    }
+
+    int stride = VertexSize(this->getVertexLayout());
+    const GrPoint* p = GetVertexPoint(vertices, startVertex, stride);
+    GrRect bounds;
+    bounds.setLTRB(p->fX, p->fY, p->fX, p->fY);
+    for (int v = 1; v < vertexCount; ++v) {
+        p = GetVertexPoint(vertices, startVertex + v, stride);
+        bounds.growToInclude(p->fX, p->fY);
+    }
+    viewMatrix.mapRect(&bounds);
+    // outset to cover antialiased edges, lines and points that are
+    // rasterized outside their vertices.
+    bounds.outset(GR_Scalar1, GR_Scalar1);
+    draw->fDevBounds.join(bounds);
+}
+
 void GrInOrderDrawBuffer::drawRect(const GrRect& rect,
                                    const GrMatrix* matrix,
                                    const GrRect* srcRects[],
@@ -190,7 +228,7 @@ void GrInOrderDrawBuffer::drawRect(const GrRect& rect,
             GeometryPoolState& poolState = fGeoPoolStateStack.back();
 
             appendToPreviousDraw =
-                kDraw_Cmd != fCmds.back() &&
+                kDraw_Cmd == fCmds.back() &&
                 lastDraw.fVertexBuffer == poolState.fPoolVertexBuffer &&
                 (fCurrQuad * 4 + lastDraw.fStartVertex) == poolState.fPoolStartVertex;
 
@@ -202,6 +240,8 @@ void GrInOrderDrawBuffer::drawRect(const GrRect& rect,
                 // use of this vertex reservation.
                 GrAssert(0 == poolState.fUsedPoolVertexBytes);
                 poolState.fUsedPoolVertexBytes = 4 * vsize;
+                this->addToDevBounds(&lastDraw, 0, 4);
+                ++fDrawStats.fRecordedDraws;
             }
         }
         if (!appendToPreviousDraw) {
@@ -300,7 +340,9 @@ void GrInOrderDrawBuffer::drawIndexedInstances(GrPrimitiveType type,
                              VertexSize(draw->fVertexLayout);
         poolState.fUsedPoolVertexBytes =
                             GrMax(poolState.fUsedPoolVertexBytes, vertexBytes);
+        ++fDrawStats.fRecordedDraws;
 
+        int srcVertex = 0;
         while (instanceCount) {
             if (!instancesToConcat) {
                 int startVertex = draw->fStartVertex + draw->fVertexCount;
@@ -316,7 +358,10 @@ void GrInOrderDrawBuffer::drawIndexedInstances(GrPrimitiveType type,
                 draw->fVertexLayout = geomSrc.fVertexLayout;
                 instancesToConcat = maxInstancesPerDraw;
             }
-            draw->fVertexCount += instancesToConcat * verticesPerInstance;
+            int vertexCount = instancesToConcat * verticesPerInstance;
+            this->addToDevBounds(draw, srcVertex, vertexCount);
+            srcVertex += vertexCount;
+            draw->fVertexCount += vertexCount;
             draw->fIndexCount += instancesToConcat * indicesPerInstance;
             instanceCount -= instancesToConcat;
             instancesToConcat = 0;
@@ -363,6 +408,8 @@ void GrInOrderDrawBuffer::onDrawIndexed(GrPrimitiveType primitiveType,
     draw->fStartIndex    = startIndex;
     draw->fVertexCount   = vertexCount;
     draw->fIndexCount    = indexCount;
+    this->addToDevBounds(draw, startVertex, vertexCount);
+    ++fDrawStats.fRecordedDraws;
 
     draw->fVertexLayout = this->getVertexLayout();
     switch (this->getGeomSrc().fVertexSrc) {
@@ -426,6 +473,8 @@ void GrInOrderDrawBuffer::onDrawNonIndexed(GrPrimitiveType primitiveType,
     draw->fStartIndex    = 0;
     draw->fVertexCount   = vertexCount;
     draw->fIndexCount    = 0;
+    this->addToDevBounds(draw, startVertex, vertexCount);
+    ++fDrawStats.fRecordedDraws;
 
     draw->fVertexLayout = this->getVertexLayout();
     switch (this->getGeomSrc().fVertexSrc) {
@@ -547,46 +596,50 @@ bool GrInOrderDrawBuffer::playback(GrDrawTarget* target) {
     int currDraw        = 0;
     int currStencilPath = 0;
 
+    // the state and clip currently set on the target
+    int issuedState     = -1;
+    int issuedClip      = -1;
+
+    // Draws are collected into groups that share a state and clip. The
+    // groups are issued when we reach a command that draws can't be moved
+    // past (or the end of the buffer). The draws in a group are linked through
+    // nextDraw.
+    SkTDArray<DrawGroup> groups;
+    SkAutoSTMalloc<kDrawPreallocCnt, int> nextDraw(fDraws.count());
+
     for (int c = 0; c < numCmds; ++c) {
         switch (fCmds[c]) {
-            case kDraw_Cmd: {
-                const Draw& draw = fDraws[currDraw];
-                target->setVertexSourceToBuffer(draw.fVertexLayout, draw.fVertexBuffer);
-                if (draw.fIndexCount) {
-                    target->setIndexSourceToBuffer(draw.fIndexBuffer);
-                }
-
-                if (draw.fIndexCount) {
-                    target->drawIndexed(draw.fPrimitiveType,
-                                        draw.fStartVertex,
-                                        draw.fStartIndex,
-                                        draw.fVertexCount,
-                                        draw.fIndexCount);
-                } else {
-                    target->drawNonIndexed(draw.fPrimitiveType,
-                                           draw.fStartVertex,
-                                           draw.fVertexCount);
-                }
+            case kDraw_Cmd:
+                GrAssert(currState > 0 && currClip > 0);
+                this->addToGroups(&groups, nextDraw.get(), currDraw,
+                                  currState - 1, currClip - 1);
                 ++currDraw;
                 break;
-            }
             case kStencilPath_Cmd: {
+                this->issueGroups(target, &clipData, groups, nextDraw.get(),
+                                  &issuedState, &issuedClip);
+                groups.rewind();
+                this->setPlaybackStateAndClip(target, &clipData,
+                                              currState - 1, currClip - 1,
+                                              &issuedState, &issuedClip);
                 const StencilPath& sp = fStencilPaths[currStencilPath];
                 target->stencilPath(sp.fPath.get(), sp.fFill);
                 ++currStencilPath;
                 break;
             }
             case kSetState_Cmd:
-                target->setDrawState(&fStates[currState]);
                 ++currState;
                 break;
             case kSetClip_Cmd:
-                clipData.fClipStack = &fClips[currClip];
-                clipData.fOrigin = fClipOrigins[currClip];
-                target->setClip(&clipData);
                 ++currClip;
                 break;
             case kClear_Cmd:
+                this->issueGroups(target, &clipData, groups, nextDraw.get(),
+                                  &issuedState, &issuedClip);
+                groups.rewind();
+                this->setPlaybackStateAndClip(target, &clipData,
+                                              currState - 1, currClip - 1,
+                                              &issuedState, &issuedClip);
                 target->clear(&fClears[currClear].fRect,
                               fClears[currClear].fColor,
                               fClears[currClear].fRenderTarget);
@@ -594,6 +647,9 @@ bool GrInOrderDrawBuffer::playback(GrDrawTarget* target) {
                 break;
         }
     }
+    this->issueGroups(target, &clipData, groups, nextDraw.get(),
+                      &issuedState, &issuedClip);
+
     // we should have consumed all the states, clips, etc.
     GrAssert(fStates.count() == currState);
     GrAssert(fClips.count() == currClip);
@@ -606,6 +662,258 @@ bool GrInOrderDrawBuffer::playback(GrDrawTarget* target) {
     return true;
 }
 
+struct GrInOrderDrawBuffer::DrawGroup {
+    int     fState;
+    int     fClip;
+    int     fFirstDraw;
+    int     fLastDraw;
+    // union of the device bounds of the group's draws
+    GrRect  fDevBounds;
+    bool    fHasDevBounds;
+};
+
+bool GrInOrderDrawBuffer::sameState(int stateA, int stateB) const {
+    return stateA == stateB || fStates[stateA] == fStates[stateB];
+}
+
+bool GrInOrderDrawBuffer::sameClip(int clipA, int clipB) const {
+    return clipA == clipB ||
+           (fClips[clipA] == fClips[clipB] &&
+            fClipOrigins[clipA] == fClipOrigins[clipB]);
+}
+
+bool GrInOrderDrawBuffer::canMoveAhead(const Draw& draw,
+                                       int state,
+                                       const DrawGroup& group) const {
+    if (!draw.fHasDevBounds || !group.fHasDevBounds) {
+        return false;
+    }
+    const GrDrawState& drawState = fStates[state];
+    const GrDrawState& groupState = fStates[group.fState];
+    // Draws to another render target may be producing a texture this draw
+    // reads (or vice versa). Stenciled draws depend on the stencil values
+    // left by earlier draws anywhere in the target.
+    if (drawState.getRenderTarget() != groupState.getRenderTarget() ||
+        !drawState.getStencil().isDisabled() ||
+        !groupState.getStencil().isDisabled()) {
+        return false;
+    }
+    const GrRect& r = draw.fDevBounds;
+    return !group.fDevBounds.intersects(r.fLeft, r.fTop, r.fRight, r.fBottom);
+}
+
+void GrInOrderDrawBuffer::addToGroups(SkTDArray<DrawGroup>* groups,
+                                      int* nextDraw,
+                                      int drawIdx,
+                                      int state,
+                                      int clip) {
+    const Draw& draw = fDraws[drawIdx];
+    nextDraw[drawIdx] = -1;
+
+    // Look back for a group with the same state and clip. The draw may join
+    // it only if it can be moved ahead of every group after it. Without
+    // reordering it can only join the last group.
+    int last = groups->count() - 1;
+    int stop = GrMax(0, last - (fReorderDraws ? (int)kMaxReorderLookback : 0));
+    for (int g = last; g >= stop; --g) {
+        DrawGroup& group = (*groups)[g];
+        if (this->sameState(group.fState, state) &&
+            this->sameClip(group.fClip, clip)) {
+            nextDraw[group.fLastDraw] = drawIdx;
+            group.fLastDraw = drawIdx;
+            if (group.fHasDevBounds && draw.fHasDevBounds) {
+                group.fDevBounds.join(draw.fDevBounds);
+            } else {
+                group.fHasDevBounds = false;
+            }
+            if (g != last) {
+                ++fDrawStats.fReorderedDraws;
+            }
+            return;
+        }
+        if (!this->canMoveAhead(draw, state, group)) {
+            break;
+        }
+    }
+
+    DrawGroup* group = groups->append();
+    group->fState = state;
+    group->fClip = clip;
+    group->fFirstDraw = drawIdx;
+    group->fLastDraw = drawIdx;
+    group->fDevBounds = draw.fDevBounds;
+    group->fHasDevBounds = draw.fHasDevBounds;
+}
+
+bool GrInOrderDrawBuffer::canConcatDraws(const Draw& first,
+                                         const Draw& second) const {
+    if (first.fVertexBuffer != second.fVertexBuffer ||
+        first.fVertexLayout != second.fVertexLayout ||
+        kTriangles_GrPrimitiveType != first.fPrimitiveType ||
+        kTriangles_GrPrimitiveType != second.fPrimitiveType ||
+        first.fStartVertex + first.fVertexCount != second.fStartVertex) {
+        return false;
+    }
+    if (0 == first.fIndexCount && 0 == second.fIndexCount) {
+        return true;
+    }
+    // Indexed draws can only be joined when both are runs of quads that
+    // index the quad buffer from its start.
+    return NULL != fQuadIndexBuffer &&
+           fQuadIndexBuffer == first.fIndexBuffer &&
+           fQuadIndexBuffer == second.fIndexBuffer &&
+           0 == first.fStartIndex && 0 == second.fStartIndex &&
+           0 == first.fVertexCount % 4 && 0 == second.fVertexCount % 4 &&
+           6 * first.fVertexCount == 4 * first.fIndexCount &&
+           6 * second.fVertexCount == 4 * second.fIndexCount &&
+           (first.fVertexCount + second.fVertexCount) / 4 <= fMaxQuads;
+}
+
+void GrInOrderDrawBuffer::setPlaybackStateAndClip(GrDrawTarget* target,
+                                                  GrClipData* clipData,
+                                                  int state,
+                                                  int clip,
+                                                  int* issuedState,
+                                                  int* issuedClip) {
+    if (clip != *issuedClip) {
+        clipData->fClipStack = &fClips[clip];
+        clipData->fOrigin = fClipOrigins[clip];
+        target->setClip(clipData);
+        *issuedClip = clip;
+    }
+    if (state != *issuedState) {
+        target->setDrawState(&fStates[state]);
+        *issuedState = state;
+    }
+}
+
+void GrInOrderDrawBuffer::issueDraw(GrDrawTarget* target, const Draw& draw) {
+    target->setVertexSourceToBuffer(draw.fVertexLayout, draw.fVertexBuffer);
+    if (draw.fIndexCount) {
+        target->setIndexSourceToBuffer(draw.fIndexBuffer);
+        target->drawIndexed(draw.fPrimitiveType,
+                            draw.fStartVertex,
+                            draw.fStartIndex,
+                            draw.fVertexCount,
+                            draw.fIndexCount);
+    } else {
+        target->drawNonIndexed(draw.fPrimitiveType,
+                               draw.fStartVertex,
+                               draw.fVertexCount);
+    }
+    ++fDrawStats.fIssuedDraws;
+}
+
+bool GrInOrderDrawBuffer::isQuadDraw(const Draw& draw) const {
+    return NULL != fQuadIndexBuffer &&
+           fQuadIndexBuffer == draw.fIndexBuffer &&
+           kTriangles_GrPrimitiveType == draw.fPrimitiveType &&
+           0 == draw.fStartIndex &&
+           0 == draw.fVertexCount % 4 &&
+           6 * draw.fVertexCount == 4 * draw.fIndexCount;
+}
+
+void GrInOrderDrawBuffer::issueBatch(GrDrawTarget* target,
+                                     const SkTDArray<Draw>& batch) {
+    GrAssert(batch.count() > 0);
+    if (1 == batch.count()) {
+        this->issueDraw(target, batch[0]);
+        return;
+    }
+
+    // The batch is runs of quads that reordering brought together but that
+    // aren't adjacent in the vertex buffer. They are drawn with a single
+    // index array that picks out each run's vertices.
+    int minVertex = batch[0].fStartVertex;
+    int quadCount = 0;
+    for (int i = 0; i < batch.count(); ++i) {
+        GrAssert(this->isQuadDraw(batch[i]));
+        minVertex = GrMin(minVertex, batch[i].fStartVertex);
+        quadCount += batch[i].fVertexCount / 4;
+    }
+    int maxVertex = minVertex;
+    SkAutoSTMalloc<6 * kDrawPreallocCnt, uint16_t> indices(6 * quadCount);
+    uint16_t* idx = indices.get();
+    for (int i = 0; i < batch.count(); ++i) {
+        const Draw& draw = batch[i];
+        maxVertex = GrMax(maxVertex, draw.fStartVertex + draw.fVertexCount);
+        for (int v = draw.fStartVertex - minVertex;
+             v < draw.fStartVertex - minVertex + draw.fVertexCount;
+             v += 4) {
+            // same winding as the quad index buffer
+            *idx++ = v + 0;
+            *idx++ = v + 1;
+            *idx++ = v + 2;
+            *idx++ = v + 0;
+            *idx++ = v + 2;
+            *idx++ = v + 3;
+        }
+    }
+    GrAssert(maxVertex - minVertex <= kMaxBatchVertexRange);
+
+    target->setVertexSourceToBuffer(batch[0].fVertexLayout,
+                                    batch[0].fVertexBuffer);
+    target->setIndexSourceToArray(indices.get(), 6 * quadCount);
+    target->drawIndexed(kTriangles_GrPrimitiveType,
+                        minVertex,
+                        0,
+                        maxVertex - minVertex,
+                        6 * quadCount);
+    target->resetIndexSource();
+    ++fDrawStats.fIssuedDraws;
+}
+
+void GrInOrderDrawBuffer::issueGroups(GrDrawTarget* target,
+                                      GrClipData* clipData,
+                                      const SkTDArray<DrawGroup>& groups,
+                                      const int* nextDraw,
+                                      int* issuedState,
+                                      int* issuedClip) {
+    SkTDArray<Draw> batch;
+    int batchMinVertex = 0;
+    int batchMaxVertex = 0;
+    for (int g = 0; g < groups.count(); ++g) {
+        const DrawGroup& group = groups[g];
+        this->setPlaybackStateAndClip(target, clipData,
+                                      group.fState, group.fClip,
+                                      issuedState, issuedClip);
+        for (int d = group.fFirstDraw; d >= 0; d = nextDraw[d]) {
+            const Draw& draw = fDraws[d];
+            int drawEnd = draw.fStartVertex + draw.fVertexCount;
+            if (batch.count()) {
+                // draws that are adjacent in the vertex buffer are joined
+                Draw& last = batch.top();
+                if (this->canConcatDraws(last, draw)) {
+                    last.fVertexCount += draw.fVertexCount;
+                    last.fIndexCount += draw.fIndexCount;
+                    batchMaxVertex = GrMax(batchMaxVertex, drawEnd);
+                    continue;
+                }
+                // other quads from the same vertex buffer are batched as
+                // long as they can be reached with 16 bit indices
+                int minVertex = GrMin(batchMinVertex, draw.fStartVertex);
+                int maxVertex = GrMax(batchMaxVertex, drawEnd);
+                if (this->isQuadDraw(batch[0]) && this->isQuadDraw(draw) &&
+                    batch[0].fVertexBuffer == draw.fVertexBuffer &&
+                    batch[0].fVertexLayout == draw.fVertexLayout &&
+                    maxVertex - minVertex <= kMaxBatchVertexRange) {
+                    *batch.append() = draw;
+                    batchMinVertex = minVertex;
+                    batchMaxVertex = maxVertex;
+                    continue;
+                }
+                this->issueBatch(target, batch);
+                batch.rewind();
+            }
+            *batch.append() = draw;
+            batchMinVertex = draw.fStartVertex;
+            batchMaxVertex = drawEnd;
+        }
+        this->issueBatch(target, batch);
+        batch.rewind();
+    }
+}
+
 void GrInOrderDrawBuffer::setAutoFlushTarget(GrDrawTarget* target) {
     GrSafeAssign(fAutoFlushTarget, target);
 }
@@ -692,6 +1000,7 @@ bool GrInOrderDrawBuffer::onReserveVertexSpace(GrVertexLayout vertexLayout,
                                       vertexCount,
                                       &poolState.fPoolVertexBuffer,
                                       &poolState.fPoolStartVertex);
+    poolState.fVertexData = *vertices;
     return NULL != *vertices;
 }
 
@@ -727,6 +1036,7 @@ void GrInOrderDrawBuffer::releaseReservedVertexSpace() {
     poolState.fUsedPoolVertexBytes = 0;
     poolState.fPoolVertexBuffer = NULL;
     poolState.fPoolStartVertex = 0;
+    poolState.fVertexData = NULL;
 }
 
 void GrInOrderDrawBuffer::releaseReservedIndexSpace() {
@@ -761,6 +1071,7 @@ void GrInOrderDrawBuffer::onSetVertexSourceToArray(const void* vertexArray,
                                &poolState.fPoolVertexBuffer,
                                &poolState.fPoolStartVertex);
     GR_DEBUGASSERT(success);
+    poolState.fVertexData = vertexArray;
 }
 
 void GrInOrderDrawBuffer::onSetIndexSourceToArray(const void* indexArray,
@@ -793,6 +1104,7 @@ void GrInOrderDrawBuffer::geometrySourceWillPush() {
     GeometryPoolState& poolState = fGeoPoolStateStack.push_back();
     poolState.fUsedPoolVertexBytes = 0;
     poolState.fUsedPoolIndexBytes = 0;
+    poolState.fVertexData = NULL;
     this->resetDrawTracking();
 #if GR_DEBUG
     poolState.fPoolVertexBuffer = (GrVertexBuffer*)~0;
@@ -866,7 +1178,10 @@ void GrInOrderDrawBuffer::recordDefaultState() {
 
 GrInOrderDrawBuffer::Draw* GrInOrderDrawBuffer::recordDraw() {
     fCmds.push_back(kDraw_Cmd);
-    return &fDraws.push_back();
+    Draw* draw = &fDraws.push_back();
+    draw->fDevBounds.setEmpty();
+    draw->fHasDevBounds = true;
+    return draw;
 }
 
 GrInOrderDrawBuffer::StencilPath* GrInOrderDrawBuffer::recordStencilPath() {
@@ -17,6 +17,7 @@
 #include "GrPath.h"
 
 #include "SkClipStack.h"
+#include "SkTDArray.h"
 #include "SkTemplates.h"
 
 class GrGpu;
@@ -112,6 +113,30 @@ public:
      */
     void setAutoFlushTarget(GrDrawTarget* target);
 
+    /**
+     * When reordering is enabled playback() may move a draw ahead of earlier
+     * draws in order to batch it with other draws that use the same state and
+     * clip. A draw is only moved past draws to the same render target whose
+     * device bounds it doesn't overlap, so the rendered result is unchanged.
+     * Clears and path stencils are never reordered. Initially enabled unless
+     * GR_DISABLE_DRAW_REORDERING is set.
+     */
+    void setDrawReordering(bool enable) { fReorderDraws = enable; }
+
+    /**
+     * Counts of the draws recorded into the buffer and the draws it issued to
+     * targets during playback. Recorded draws that were batched together are
+     * issued as a single draw. The counts accumulate until resetDrawStats().
+     */
+    struct DrawStats {
+        int fRecordedDraws;
+        int fIssuedDraws;
+        // draws that were moved ahead of other draws to join a batch
+        int fReorderedDraws;
+    };
+    const DrawStats& getDrawStats() const { return fDrawStats; }
+    void resetDrawStats();
+
     // overrides from GrDrawTarget
     virtual void drawRect(const GrRect& rect,
                           const GrMatrix* matrix = NULL,
@@ -154,8 +179,16 @@ private:
         GrVertexLayout          fVertexLayout;
         const GrVertexBuffer*   fVertexBuffer;
         const GrIndexBuffer*    fIndexBuffer;
+        // conservative device space bounds of the draw. Draws whose vertices
+        // are in a buffer (or that use perspective) don't have bounds and so
+        // are never reordered.
+        GrRect                  fDevBounds;
+        bool                    fHasDevBounds;
     };
 
+    // a run of draws that will be issued with the same state and clip
+    struct DrawGroup;
+
     struct StencilPath {
         SkAutoTUnref<const GrPath>  fPath;
         GrPathFill                  fFill;
@@ -216,7 +249,34 @@ private:
     // multiple draws into a single draw.
     void resetDrawTracking();
 
+    // grows the draw's device bounds to include vertices of the current
+    // vertex source.
+    void addToDevBounds(Draw* draw, int startVertex, int vertexCount) const;
+
+    // playback helpers: adds a draw to a group (reordering it if allowed)
+    // and issues the grouped draws to the target.
+    void addToGroups(SkTDArray<DrawGroup>* groups, int* nextDraw,
+                     int draw, int state, int clip);
+    void issueGroups(GrDrawTarget* target, GrClipData* clipData,
+                     const SkTDArray<DrawGroup>& groups, const int* nextDraw,
+                     int* issuedState, int* issuedClip);
+    void setPlaybackStateAndClip(GrDrawTarget* target, GrClipData* clipData,
+                                 int state, int clip,
+                                 int* issuedState, int* issuedClip);
+    void issueDraw(GrDrawTarget* target, const Draw& draw);
+    void issueBatch(GrDrawTarget* target, const SkTDArray<Draw>& batch);
+    bool isQuadDraw(const Draw& draw) const;
+    bool sameState(int stateA, int stateB) const;
+    bool sameClip(int clipA, int clipB) const;
+    bool canMoveAhead(const Draw& draw, int state,
+                      const DrawGroup& group) const;
+    bool canConcatDraws(const Draw& first, const Draw& second) const;
+
     enum {
+        // how many groups back playback will look for a group a draw can join
+        kMaxReorderLookback      = 8,
+        // largest span of vertices that batched quads may index
+        kMaxBatchVertexRange     = 1 << 16,
         kCmdPreallocCnt          = 32,
         kDrawPreallocCnt         = 8,
         kStencilPathPreallocCnt  = 8,
@@ -269,11 +329,17 @@ private:
         // can only do this if there isn't an intervening pushGeometrySource()
         size_t                          fUsedPoolVertexBytes;
         size_t                          fUsedPoolIndexBytes;
+        // CPU copy of the vertex data (reserved or array sources only), used
+        // to compute draw bounds
+        const void*                     fVertexData;
     };
     SkSTArray<kGeoPoolStatePreAllocCnt, GeometryPoolState> fGeoPoolStateStack;
 
     bool                            fFlushing;
 
+    bool                            fReorderDraws;
+    DrawStats                       fDrawStats;
+
     typedef GrDrawTarget INHERITED;
 };
 
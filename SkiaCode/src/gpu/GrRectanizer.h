@@ -42,10 +42,20 @@ public:
     virtual int stripToPurge(int height) const = 0;
     virtual void purgeStripAtY(int yCoord) = 0;
 
+    enum Type {
+        // packs into rows whose height is the next pow2 of the rect height
+        kPow2_Type,
+        // bottom-left skyline packer, see GrRectanizer_skyline.cpp
+        kSkyline_Type,
+
+        kDefault_Type = kSkyline_Type
+    };
+
     /**
      *  Our factory, which returns the subclass du jour
      */
-    static GrRectanizer* Factory(int width, int height);
+    static GrRectanizer* Factory(int width, int height,
+                                 Type type = kDefault_Type);
 
 private:
     int fWidth;
@@ -0,0 +1,132 @@
+
+/*
+ * Copyright 2012 Google Inc.
+ *
+ * Use of this source code is governed by a BSD-style license that can be
+ * found in the LICENSE file.
+ */
+
+
+
+#include "GrRectanizer_skyline.h"
+
+GrRectanizerSkyline::GrRectanizerSkyline(int w, int h) : GrRectanizer(w, h) {
+    fAreaSoFar = 0;
+
+    // the whole area starts out as a single empty segment at y == 0
+    SkylineSegment* seg = fSkyline.append();
+    seg->fX = 0;
+    seg->fY = 0;
+    seg->fWidth = w;
+}
+
+bool GrRectanizerSkyline::rectangleFits(int index, int width, int height,
+                                        int* y) const {
+    int x = fSkyline[index].fX;
+    if (x + width > this->width()) {
+        return false;
+    }
+
+    // the rect rests on the highest of the segments it spans
+    int widthLeft = width;
+    int top = fSkyline[index].fY;
+    while (widthLeft > 0) {
+        GrAssert(index < fSkyline.count());
+        top = GrMax(top, fSkyline[index].fY);
+        if (top + height > this->height()) {
+            return false;
+        }
+        widthLeft -= fSkyline[index].fWidth;
+        ++index;
+    }
+
+    *y = top;
+    return true;
+}
+
+void GrRectanizerSkyline::addSkylineLevel(int index, int x, int y,
+                                          int width, int height) {
+    SkylineSegment* seg = fSkyline.insert(index);
+    seg->fX = x;
+    seg->fY = y + height;
+    seg->fWidth = width;
+
+    GrAssert(seg->fX + seg->fWidth <= this->width());
+    GrAssert(seg->fY <= this->height());
+
+    // trim (or remove) the segments now covered by the new one
+    int right = x + width;
+    int i = index + 1;
+    while (i < fSkyline.count() && fSkyline[i].fX < right) {
+        int shrink = right - fSkyline[i].fX;
+        if (shrink >= fSkyline[i].fWidth) {
+            fSkyline.remove(i);
+        } else {
+            fSkyline[i].fX += shrink;
+            fSkyline[i].fWidth -= shrink;
+            break;
+        }
+    }
+
+    // only the neighbours of the new segment can have changed, so they are
+    // the only candidates for merging segments of equal height
+    if (index + 1 < fSkyline.count() &&
+        fSkyline[index].fY == fSkyline[index + 1].fY) {
+        fSkyline[index].fWidth += fSkyline[index + 1].fWidth;
+        fSkyline.remove(index + 1);
+    }
+    if (index > 0 && fSkyline[index - 1].fY == fSkyline[index].fY) {
+        fSkyline[index - 1].fWidth += fSkyline[index].fWidth;
+        fSkyline.remove(index);
+    }
+}
+
+bool GrRectanizerSkyline::addRect(int width, int height, GrIPoint16* loc) {
+    if ((unsigned)width > (unsigned)this->width() ||
+        (unsigned)height > (unsigned)this->height()) {
+        return false;
+    }
+
+    // find the position where the rect sits lowest, preferring the
+    // narrowest segment on ties so wide segments stay available
+    int bestIndex = -1;
+    int bestX = 0;
+    int bestY = this->height() + 1;
+    int bestWidth = this->width() + 1;
+    for (int i = 0; i < fSkyline.count(); ++i) {
+        int y;
+        if (this->rectangleFits(i, width, height, &y)) {
+            if (y < bestY || (y == bestY && fSkyline[i].fWidth < bestWidth)) {
+                bestIndex = i;
+                bestX = fSkyline[i].fX;
+                bestY = y;
+                bestWidth = fSkyline[i].fWidth;
+            }
+        }
+    }
+
+    if (-1 == bestIndex) {
+        return false;
+    }
+
+    this->addSkylineLevel(bestIndex, bestX, bestY, width, height);
+    loc->set(bestX, bestY);
+    fAreaSoFar += width * height;
+
+    this->validate();
+    return true;
+}
+
+#if GR_DEBUG
+void GrRectanizerSkyline::validate() const {
+    int x = 0;
+    for (int i = 0; i < fSkyline.count(); ++i) {
+        GrAssert(fSkyline[i].fX == x);
+        GrAssert(fSkyline[i].fWidth > 0);
+        GrAssert(fSkyline[i].fY <= this->height());
+        GrAssert(0 == i || fSkyline[i - 1].fY != fSkyline[i].fY);
+        x += fSkyline[i].fWidth;
+    }
+    GrAssert(x == this->width());
+}
+#endif
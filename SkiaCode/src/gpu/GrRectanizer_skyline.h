@@ -0,0 +1,67 @@
+
+/*
+ * Copyright 2012 Google Inc.
+ *
+ * Use of this source code is governed by a BSD-style license that can be
+ * found in the LICENSE file.
+ */
+
+
+
+#ifndef GrRectanizer_skyline_DEFINED
+#define GrRectanizer_skyline_DEFINED
+
+#include "GrRectanizer.h"
+
+/**
+ *  Bottom-left skyline packer.
+ *
+ *  The packed area is described by its "skyline": a list of horizontal
+ *  segments, sorted by x, each giving the lowest free y over its span. A new
+ *  rect is placed at the segment where it would sit lowest (ties going to the
+ *  narrowest segment), and then becomes a new segment of the skyline.
+ *
+ *  Unlike GrRectanizerPow2 it does not round heights up, so mixed glyph
+ *  heights do not waste the space between a glyph and its row's pow2 height.
+ */
+class GrRectanizerSkyline : public GrRectanizer {
+public:
+    GrRectanizerSkyline(int w, int h);
+
+    virtual ~GrRectanizerSkyline() {}
+
+    virtual bool addRect(int w, int h, GrIPoint16* loc) SK_OVERRIDE;
+
+    virtual float percentFull() const SK_OVERRIDE {
+        return fAreaSoFar / ((float)this->width() * this->height());
+    }
+
+    virtual int stripToPurge(int height) const SK_OVERRIDE { return -1; }
+    virtual void purgeStripAtY(int yCoord) SK_OVERRIDE { }
+
+private:
+    struct SkylineSegment {
+        int fX;
+        int fY;
+        int fWidth;
+    };
+
+    // if the rect fits starting at segment 'index', returns true and sets
+    // *y to the lowest y at which it can be placed
+    bool rectangleFits(int index, int width, int height, int* y) const;
+
+    // adds the rect as a new segment at 'index', trims the segments it
+    // covers and merges neighbours at the same height
+    void addSkylineLevel(int index, int x, int y, int width, int height);
+
+#if GR_DEBUG
+    void validate() const;
+#else
+    void validate() const {}
+#endif
+
+    GrTDArray<SkylineSegment>   fSkyline;
+    int32_t                     fAreaSoFar;
+};
+
+#endif
@@ -40,25 +40,14 @@ class GrResourceCache::Key {
 public:
     Key(const GrResourceKey& key) : fKey(key) {}
 
-    uint32_t getHash() const { return fKey.hashIndex(); }
+    uint32_t getHash() const { return fKey.getHash(); }
 
-    static bool LT(const T& entry, const Key& key) {
-        return entry.key() < key.fKey;
-    }
     static bool EQ(const T& entry, const Key& key) {
         return entry.key() == key.fKey;
     }
-#if GR_DEBUG
     static uint32_t GetHash(const T& entry) {
-        return entry.key().hashIndex();
-    }
-    static bool LT(const T& a, const T& b) {
-        return a.key() < b.key();
-    }
-    static bool EQ(const T& a, const T& b) {
-        return a.key() == b.key();
+        return entry.key().getHash();
     }
-#endif
 };
 
 ///////////////////////////////////////////////////////////////////////////////
@@ -175,8 +164,10 @@ GrResource* GrResourceCache::find(const GrResourceKey& key) {
         return NULL;
     }
 
-    this->internalDetach(entry, false);
-    this->attachToHead(entry, false);
+    // relink at the head of the LRU; the entry stays in the cache so our
+    // count and byte stats are unchanged
+    fList.remove(entry);
+    fList.addToHead(entry);
 
     return entry->fResource;
 }
@@ -255,57 +246,59 @@ void GrResourceCache::makeNonExclusive(GrResourceEntry* entry) {
  * new resources were unlocked before purgeAsNeeded completed it could
  * potentially make purgeAsNeeded loop infinitely.
  */
-void GrResourceCache::purgeAsNeeded() {
-    if (!fPurging) {
-        fPurging = true;
-        bool withinBudget = false;
-        bool changed = false;
-
-        // The purging process is repeated several times since one pass
-        // may free up other resources
-        do {
-            EntryList::Iter iter;
-
-            changed = false;
-
-            // Note: the following code relies on the fact that the
-            // doubly linked list doesn't invalidate its data/pointers
-            // outside of the specific area where a deletion occurs (e.g.,
-            // in internalDetach)
-            GrResourceEntry* entry = iter.init(fList, EntryList::Iter::kTail_IterStart);
-
-            while (NULL != entry) {
-                GrAutoResourceCacheValidate atcv(this);
-
-                if (fEntryCount <= fMaxCount && fEntryBytes <= fMaxBytes) {
-                    withinBudget = true;
-                    break;
-                }
-
-                GrResourceEntry* prev = iter.prev();
-                if (1 == entry->fResource->getRefCnt()) {
-                    changed = true;
-
-                    // remove from our cache
-                    fCache.remove(entry->key(), entry);
-
-                    // remove from our llist
-                    this->internalDetach(entry, false);
-
-        #if GR_DUMP_TEXTURE_UPLOAD
-                    GrPrintf("--- ~resource from cache %p [%d %d]\n",
-                             entry->resource(),
-                             entry->resource()->width(),
-                             entry->resource()->height());
-        #endif
-
-                    delete entry;
-                }
-                entry = prev;
-            }
-        } while (!withinBudget && changed);
-        fPurging = false;
+void GrResourceCache::purgeAsNeeded(int extraCount, size_t extraBytes) {
+    if (fPurging || !this->overBudget(extraCount, extraBytes)) {
+        return;
     }
+
+    fPurging = true;
+    GrAutoResourceCacheValidate atcv(this);
+
+    bool withinBudget = false;
+    bool changed = false;
+
+    // The purging process is repeated several times since one pass
+    // may free up other resources
+    do {
+        EntryList::Iter iter;
+
+        changed = false;
+
+        // Note: the following code relies on the fact that the
+        // doubly linked list doesn't invalidate its data/pointers
+        // outside of the specific area where a deletion occurs (e.g.,
+        // in internalDetach)
+        GrResourceEntry* entry = iter.init(fList, EntryList::Iter::kTail_IterStart);
+
+        while (NULL != entry) {
+            if (!this->overBudget(extraCount, extraBytes)) {
+                withinBudget = true;
+                break;
+            }
+
+            GrResourceEntry* prev = iter.prev();
+            if (1 == entry->fResource->getRefCnt()) {
+                changed = true;
+
+                // remove from our cache
+                fCache.remove(entry->key(), entry);
+
+                // remove from our llist
+                this->internalDetach(entry, false);
+
+    #if GR_DUMP_TEXTURE_UPLOAD
+                GrPrintf("--- ~resource from cache %p [%d %d]\n",
+                         entry->resource(),
+                         entry->resource()->width(),
+                         entry->resource()->height());
+    #endif
+
+                delete entry;
+            }
+            entry = prev;
+        }
+    } while (!withinBudget && changed);
+    fPurging = false;
 }
 
 void GrResourceCache::purgeAllUnlocked() {
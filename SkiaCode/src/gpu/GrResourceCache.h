@@ -13,7 +13,7 @@
 
 #include "GrConfig.h"
 #include "GrTypes.h"
-#include "GrTHashCache.h"
+#include "GrTDynamicHash.h"
 #include "SkTDLinkedList.h"
 
 class GrResource;
@@ -37,44 +37,37 @@ class GrResource;
  */
 class GrResourceKey {
 public:
-    enum {
-        kHashBits   = 7,
-        kHashCount  = 1 << kHashBits,
-        kHashMask   = kHashCount - 1
-    };
-
     GrResourceKey(uint32_t p0, uint32_t p1, uint32_t p2, uint32_t p3) {
         fP[0] = p0;
         fP[1] = p1;
         fP[2] = p2;
         fP[3] = p3;
-        this->computeHashIndex();
+        this->computeHash();
     }
 
     GrResourceKey(uint32_t v[4]) {
         memcpy(fP, v, 4 * sizeof(uint32_t));
-        this->computeHashIndex();
+        this->computeHash();
     }
 
     GrResourceKey(const GrResourceKey& src) {
         memcpy(fP, src.fP, 4 * sizeof(uint32_t));
 #if GR_DEBUG
-        this->computeHashIndex();
-        GrAssert(fHashIndex == src.fHashIndex);
+        this->computeHash();
+        GrAssert(fHash == src.fHash);
 #endif
-        fHashIndex = src.fHashIndex;
+        fHash = src.fHash;
     }
 
-    //!< returns hash value [0..kHashMask] for the key
-    int hashIndex() const { return fHashIndex; }
+    //!< returns the full 32bit hash for the key, mixed so that any subset of
+    //!< its low bits can be used as a table index
+    uint32_t getHash() const { return fHash; }
 
     friend bool operator==(const GrResourceKey& a, const GrResourceKey& b) {
-        GR_DEBUGASSERT(-1 != a.fHashIndex && -1 != b.fHashIndex);
         return 0 == memcmp(a.fP, b.fP, 4 * sizeof(uint32_t));
     }
 
     friend bool operator!=(const GrResourceKey& a, const GrResourceKey& b) {
-        GR_DEBUGASSERT(-1 != a.fHashIndex && -1 != b.fHashIndex);
         return !(a == b);
     }
 
@@ -101,19 +94,22 @@ private:
         return (x >> 16) | (x << 16);
     }
 
-    void computeHashIndex() {
+    void computeHash() {
         uint32_t hash = fP[0] ^ rol(fP[1]) ^ ror(fP[2]) ^ rohalf(fP[3]);
-        // this way to mix and reduce hash to its index may have to change
-        // depending on how many bits we allocate to the index
+        // finalizer from MurmurHash3, so that the low bits used by
+        // GrTDynamicHash depend on every bit of the key
+        hash ^= hash >> 16;
+        hash *= 0x85ebca6b;
+        hash ^= hash >> 13;
+        hash *= 0xc2b2ae35;
         hash ^= hash >> 16;
-        hash ^= hash >> 8;
-        fHashIndex = hash & kHashMask;
+        fHash = hash;
     }
 
     uint32_t    fP[4];
 
     // this is computed from the fP... fields
-    int         fHashIndex;
+    uint32_t    fHash;
 
     friend class GrContext;
 };
@@ -168,8 +164,6 @@ private:
 
 ///////////////////////////////////////////////////////////////////////////////
 
-#include "GrTHashCache.h"
-
 /**
  *  Cache of GrResource objects.
  *
@@ -177,17 +171,15 @@ private:
  *  resource.
  *
  *  The cache stores the entries in a double-linked list, which is its LRU.
- *  When an entry is "locked" (i.e. given to the caller), it is moved to the
- *  head of the list. If/when we must purge some of the entries, we walk the
- *  list backwards from the tail, since those are the least recently used.
- *
- *  For fast searches, we maintain a sorted array (based on the GrResourceKey)
- *  which we can bsearch. When a new entry is added, it is inserted into this
- *  array.
+ *  When an entry is "locked" (i.e. given to the caller), it is relinked at the
+ *  head of the list in constant time. If/when we must purge some of the
+ *  entries, we walk the list backwards from the tail, since those are the
+ *  least recently used, and stop as soon as we are back within budget.
  *
- *  For even faster searches, a hash is computed from the Key. If there is
- *  a collision between two keys with the same hash, we fall back on the
- *  bsearch, and update the hash to reflect the most recent Key requested.
+ *  Searches go through an open-addressing hash (GrTDynamicHash) keyed on the
+ *  full 32bit hash of the GrResourceKey. It grows with the number of entries,
+ *  so find, create and purge stay O(1) per entry even with tens of thousands
+ *  of cached resources.
  */
 class GrResourceCache {
 public:
@@ -264,8 +256,14 @@ public:
      * Allow cache to purge unused resources to obey resource limitations
      * Note: this entry point will be hidden (again) once totally ref-driven
      * cache maintenance is implemented
+     *
+     * @param extraCount  number of resources the caller is about to add
+     * @param extraBytes  number of bytes the caller is about to add
+     *
+     * If non-zero, the extra amounts are counted against the budget so that
+     * room is made before a new resource is allocated rather than after.
      */
-    void purgeAsNeeded();
+    void purgeAsNeeded(int extraCount = 0, size_t extraBytes = 0);
 
 #if GR_DEBUG
     void validate() const;
@@ -283,8 +281,13 @@ private:
 
     void removeInvalidResource(GrResourceEntry* entry);
 
+    bool overBudget(int extraCount, size_t extraBytes) const {
+        return fEntryCount + extraCount > fMaxCount ||
+               fEntryBytes + extraBytes > fMaxBytes;
+    }
+
     class Key;
-    GrTHashTable<GrResourceEntry, Key, 8> fCache;
+    GrTDynamicHash<GrResourceEntry, Key> fCache;
 
     // manage the dlink list
     typedef SkTDLinkedList<GrResourceEntry> EntryList;
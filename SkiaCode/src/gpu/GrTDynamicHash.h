@@ -0,0 +1,227 @@
+
+/*
+ * Copyright 2012 Google Inc.
+ *
+ * Use of this source code is governed by a BSD-style license that can be
+ * found in the LICENSE file.
+ */
+
+
+
+#ifndef GrTDynamicHash_DEFINED
+#define GrTDynamicHash_DEFINED
+
+#include "GrTypes.h"
+
+/**
+ *  Growable open-addressing (linear probing) hash table of T pointers.
+ *  Unlike GrTHashTable it does not keep a sorted array of its elements, so
+ *  insert and remove are O(1) on average regardless of the element count.
+ *
+ *  Key needs
+ *      static bool EQ(const Entry&, const HashKey&);
+ *      static uint32_t GetHash(const Entry&);
+ *      uint32_t getHash() const;
+ *
+ *  The hash must be well distributed in its low bits since the slot index is
+ *  taken directly from them. Duplicate key entries are allowed; find() may
+ *  return any of them.
+ */
+template <typename T, typename Key> class GrTDynamicHash {
+public:
+    GrTDynamicHash() : fArray(NULL), fCapacity(0), fCount(0), fDeleted(0) {}
+    ~GrTDynamicHash() { GrFree(fArray); }
+
+    int count() const { return fCount; }
+    int capacity() const { return fCapacity; }
+
+    T* find(const Key&) const;
+    void insert(const Key&, T*);
+    void remove(const Key&, const T*);
+    void removeAll();
+
+#if GR_DEBUG
+    void validate() const;
+    bool contains(const T*) const;
+#endif
+
+private:
+    enum {
+        kMinCapacity = 16,
+        // grow (or rehash in place) once live + deleted slots exceed 3/4
+        kMaxLoadNumerator = 3,
+        kMaxLoadShift = 2,
+    };
+
+    static T* Deleted() { return reinterpret_cast<T*>(1); }
+    static bool IsEmpty(const T* slot) { return NULL == slot; }
+    static bool IsDeleted(const T* slot) { return Deleted() == slot; }
+    static bool IsLive(const T* slot) {
+        return !IsEmpty(slot) && !IsDeleted(slot);
+    }
+
+    int firstIndex(uint32_t hash) const { return hash & (fCapacity - 1); }
+    int nextIndex(int index) const { return (index + 1) & (fCapacity - 1); }
+
+    void maybeGrow();
+    void resize(int newCapacity);
+    void innerInsert(uint32_t hash, T* elem);
+
+    T**     fArray;
+    int     fCapacity;  // always 0 or a power of 2
+    int     fCount;     // live entries
+    int     fDeleted;   // tombstones
+};
+
+///////////////////////////////////////////////////////////////////////////////
+
+template <typename T, typename Key>
+T* GrTDynamicHash<T, Key>::find(const Key& key) const {
+    if (0 == fCapacity) {
+        return NULL;
+    }
+    int index = this->firstIndex(key.getHash());
+    for (int round = 0; round < fCapacity; ++round) {
+        T* candidate = fArray[index];
+        if (IsEmpty(candidate)) {
+            return NULL;
+        }
+        if (!IsDeleted(candidate) && Key::EQ(*candidate, key)) {
+            return candidate;
+        }
+        index = this->nextIndex(index);
+    }
+    return NULL;
+}
+
+template <typename T, typename Key>
+void GrTDynamicHash<T, Key>::insert(const Key& key, T* elem) {
+    GrAssert(NULL != elem && Key::EQ(*elem, key));
+    this->maybeGrow();
+    this->innerInsert(key.getHash(), elem);
+    fCount += 1;
+}
+
+template <typename T, typename Key>
+void GrTDynamicHash<T, Key>::innerInsert(uint32_t hash, T* elem) {
+    int index = this->firstIndex(hash);
+    for (;;) {
+        T* candidate = fArray[index];
+        if (IsEmpty(candidate)) {
+            break;
+        }
+        if (IsDeleted(candidate)) {
+            fDeleted -= 1;
+            break;
+        }
+        index = this->nextIndex(index);
+    }
+    fArray[index] = elem;
+}
+
+template <typename T, typename Key>
+void GrTDynamicHash<T, Key>::remove(const Key& key, const T* elem) {
+    GrAssert(fCapacity > 0);
+    int index = this->firstIndex(key.getHash());
+    for (int round = 0; round < fCapacity; ++round) {
+        T* candidate = fArray[index];
+        GrAssert(!IsEmpty(candidate));
+        if (candidate == elem) {
+            // if the next slot is empty no probe sequence runs through this
+            // one, so it can be emptied rather than tombstoned
+            if (IsEmpty(fArray[this->nextIndex(index)])) {
+                fArray[index] = NULL;
+            } else {
+                fArray[index] = Deleted();
+                fDeleted += 1;
+            }
+            fCount -= 1;
+            return;
+        }
+        index = this->nextIndex(index);
+    }
+    GrAssert(!"GrTDynamicHash::remove: element not found");
+}
+
+template <typename T, typename Key>
+void GrTDynamicHash<T, Key>::removeAll() {
+    GrFree(fArray);
+    fArray = NULL;
+    fCapacity = fCount = fDeleted = 0;
+}
+
+template <typename T, typename Key>
+void GrTDynamicHash<T, Key>::maybeGrow() {
+    int used = fCount + fDeleted + 1;
+    if (used <= ((fCapacity * kMaxLoadNumerator) >> kMaxLoadShift)) {
+        return;
+    }
+    int newCapacity = fCapacity ? fCapacity : kMinCapacity;
+    // only double if the live entries alone would keep us over half full,
+    // otherwise just rehash at the same size to flush the tombstones.
+    while (2 * (fCount + 1) > newCapacity) {
+        newCapacity <<= 1;
+    }
+    this->resize(newCapacity);
+}
+
+template <typename T, typename Key>
+void GrTDynamicHash<T, Key>::resize(int newCapacity) {
+    GrAssert(newCapacity > 0 && 0 == (newCapacity & (newCapacity - 1)));
+
+    T** oldArray = fArray;
+    int oldCapacity = fCapacity;
+
+    fArray = (T**)GrMalloc(newCapacity * sizeof(T*));
+    Gr_bzero(fArray, newCapacity * sizeof(T*));
+    fCapacity = newCapacity;
+    fDeleted = 0;
+
+    for (int i = 0; i < oldCapacity; ++i) {
+        T* elem = oldArray[i];
+        if (IsLive(elem)) {
+            this->innerInsert(Key::GetHash(*elem), elem);
+        }
+    }
+    GrFree(oldArray);
+}
+
+#if GR_DEBUG
+template <typename T, typename Key>
+void GrTDynamicHash<T, Key>::validate() const {
+    GrAssert(0 == (fCapacity & (fCapacity - 1)));
+    GrAssert(fCount + fDeleted <= fCapacity);
+
+    int live = 0;
+    int deleted = 0;
+    for (int i = 0; i < fCapacity; ++i) {
+        T* elem = fArray[i];
+        if (IsDeleted(elem)) {
+            ++deleted;
+        } else if (!IsEmpty(elem)) {
+            ++live;
+            // every slot between the element's home and its actual position
+            // must be occupied, otherwise find() would stop short of it
+            int index = this->firstIndex(Key::GetHash(*elem));
+            while (index != i) {
+                GrAssert(!IsEmpty(fArray[index]));
+                index = this->nextIndex(index);
+            }
+        }
+    }
+    GrAssert(live == fCount);
+    GrAssert(deleted == fDeleted);
+}
+
+template <typename T, typename Key>
+bool GrTDynamicHash<T, Key>::contains(const T* elem) const {
+    for (int i = 0; i < fCapacity; ++i) {
+        if (fArray[i] == elem) {
+            return true;
+        }
+    }
+    return false;
+}
+#endif
+
+#endif
@@ -15,14 +15,11 @@
 
 //#define DUMP_IMAGEREF_LIFECYCLE
 
-// can't be static, as SkImageRef_Pool needs to see it
-SK_DECLARE_GLOBAL_MUTEX(gImageRefMutex);
-
 ///////////////////////////////////////////////////////////////////////////////
 
 SkImageRef::SkImageRef(SkStream* stream, SkBitmap::Config config,
                        int sampleSize)
-        : SkPixelRef(&gImageRefMutex), fErrorInDecoding(false) {
+        : SkPixelRef(&fMutex), fErrorInDecoding(false) {
     SkASSERT(stream);
     stream->ref();
     fStream = stream;
@@ -30,6 +27,8 @@ SkImageRef::SkImageRef(SkStream* stream, SkBitmap::Config config,
     fSampleSize = sampleSize;
     fDoDither = true;
     fPrev = fNext = NULL;
+    fPoolRAM = 0;
+    fPoolLocked = false;
     fFactory = NULL;
 
 #ifdef DUMP_IMAGEREF_LIFECYCLE
@@ -39,8 +38,6 @@ SkImageRef::SkImageRef(SkStream* stream, SkBitmap::Config config,
 }
 
 SkImageRef::~SkImageRef() {
-    SkASSERT(&gImageRefMutex == this->mutex());
-
 #ifdef DUMP_IMAGEREF_LIFECYCLE
     SkDebugf("delete ImageRef %p [%d] data=%d\n",
               this, fConfig, (int)fStream->getLength());
@@ -51,7 +48,7 @@ SkImageRef::~SkImageRef() {
 }
 
 bool SkImageRef::getInfo(SkBitmap* bitmap) {
-    SkAutoMutexAcquire ac(gImageRefMutex);
+    SkAutoMutexAcquire ac(this->mutex());
 
     if (!this->prepareBitmap(SkImageDecoder::kDecodeBounds_Mode)) {
         return false;
@@ -80,6 +77,26 @@ SkImageDecoderFactory* SkImageRef::setDecoderFactory(
     return fact;
 }
 
+static void prefetch_proc(void* context, int i) {
+    SkImageRef* ref = static_cast<SkImageRef* const*>(context)[i];
+    // locking decodes the pixels, and they stay around after the unlock
+    // unless a pool needs the memory back
+    ref->lockPixels();
+    ref->unlockPixels();
+}
+
+void SkImageRef::Prefetch(SkImageRef* const refs[], int count,
+                          SkParallelForProc parallelFor) {
+    void* context = const_cast<SkImageRef**>(refs);
+    if (parallelFor) {
+        parallelFor(count, prefetch_proc, context);
+    } else {
+        for (int i = 0; i < count; ++i) {
+            prefetch_proc(context, i);
+        }
+    }
+}
+
 ///////////////////////////////////////////////////////////////////////////////
 
 bool SkImageRef::onDecode(SkImageDecoder* codec, SkStream* stream,
@@ -89,8 +106,6 @@ bool SkImageRef::onDecode(SkImageDecoder* codec, SkStream* stream,
 }
 
 bool SkImageRef::prepareBitmap(SkImageDecoder::Mode mode) {
-    SkASSERT(&gImageRefMutex == this->mutex());
-
     if (fErrorInDecoding) {
         return false;
     }
@@ -103,9 +118,11 @@ bool SkImageRef::prepareBitmap(SkImageDecoder::Mode mode) {
         fConfig = fBitmap.config();
     }
 
-    if (NULL != fBitmap.getPixels() ||
-            (SkBitmap::kNo_Config != fBitmap.config() &&
-             SkImageDecoder::kDecodeBounds_Mode == mode)) {
+    // Check the config first: a pool may purge our pixels from another
+    // thread while we are unlocked, but never changes the config.
+    if ((SkBitmap::kNo_Config != fBitmap.config() &&
+         SkImageDecoder::kDecodeBounds_Mode == mode) ||
+            NULL != fBitmap.getPixels()) {
         return true;
     }
 
@@ -144,8 +161,6 @@ bool SkImageRef::prepareBitmap(SkImageDecoder::Mode mode) {
 }
 
 void* SkImageRef::onLockPixels(SkColorTable** ct) {
-    SkASSERT(&gImageRefMutex == this->mutex());
-
     if (NULL == fBitmap.getPixels()) {
         (void)this->prepareBitmap(SkImageDecoder::kDecodePixels_Mode);
     }
@@ -158,7 +173,6 @@ void* SkImageRef::onLockPixels(SkColorTable** ct) {
 
 void SkImageRef::onUnlockPixels() {
     // we're already have the mutex locked
-    SkASSERT(&gImageRefMutex == this->mutex());
 }
 
 size_t SkImageRef::ramUsed() const {
@@ -176,7 +190,7 @@ size_t SkImageRef::ramUsed() const {
 ///////////////////////////////////////////////////////////////////////////////
 
 SkImageRef::SkImageRef(SkFlattenableReadBuffer& buffer)
-        : INHERITED(buffer, &gImageRefMutex), fErrorInDecoding(false) {
+        : INHERITED(buffer, &fMutex), fErrorInDecoding(false) {
     fConfig = (SkBitmap::Config)buffer.readUInt();
     fSampleSize = buffer.readInt();
     fDoDither = buffer.readBool();
@@ -186,6 +200,8 @@ SkImageRef::SkImageRef(SkFlattenableReadBuffer& buffer)
     buffer.readByteArray((void*)fStream->getMemoryBase());
 
     fPrev = fNext = NULL;
+    fPoolRAM = 0;
+    fPoolLocked = false;
     fFactory = NULL;
 }
 
@@ -20,14 +20,37 @@ SkImageRefPool::~SkImageRefPool() {
     //    SkASSERT(NULL == fHead);
 }
 
+size_t SkImageRefPool::getRAMBudget() const {
+    SkAutoMutexAcquire ac(fMutex);
+    return fRAMBudget;
+}
+
 void SkImageRefPool::setRAMBudget(size_t size) {
+    SkAutoMutexAcquire ac(fMutex);
     if (fRAMBudget != size) {
         fRAMBudget = size;
         this->purgeIfNeeded();
     }
 }
 
+size_t SkImageRefPool::getRAMUsed() const {
+    SkAutoMutexAcquire ac(fMutex);
+    return fRAMUsed;
+}
+
+void SkImageRefPool::setRAMUsed(size_t limit) {
+    SkAutoMutexAcquire ac(fMutex);
+    this->lockedSetRAMUsed(limit);
+}
+
+void SkImageRefPool::justLockedPixels(SkImageRef* ref) {
+    SkAutoMutexAcquire ac(fMutex);
+    SkASSERT(!ref->fPoolLocked);
+    ref->fPoolLocked = true;
+}
+
 void SkImageRefPool::justAddedPixels(SkImageRef* ref) {
+    SkAutoMutexAcquire ac(fMutex);
 #ifdef DUMP_IMAGEREF_LIFECYCLE
     SkDebugf("=== ImagePool: add pixels %s [%d %d %d] bytes=%d heap=%d\n",
              ref->getURI(),
@@ -35,34 +58,44 @@ void SkImageRefPool::justAddedPixels(SkImageRef* ref) {
              ref->fBitmap.bytesPerPixel(),
              ref->fBitmap.getSize(), (int)fRAMUsed);
 #endif
-    fRAMUsed += ref->ramUsed();
+    // the ref is locked, so nothing else touches its bitmap
+    SkASSERT(ref->fPoolLocked);
+    fRAMUsed -= ref->fPoolRAM;
+    ref->fPoolRAM = ref->ramUsed();
+    fRAMUsed += ref->fPoolRAM;
     this->purgeIfNeeded();
 }
 
 void SkImageRefPool::canLosePixels(SkImageRef* ref) {
+    SkAutoMutexAcquire ac(fMutex);
+    SkASSERT(ref->fPoolLocked);
+    ref->fPoolLocked = false;
     // the refs near fHead have recently been released (used)
     // if we purge, we purge from the tail
-    this->detach(ref);
-    this->addToHead(ref);
+    this->lockedDetach(ref);
+    this->lockedAddToHead(ref);
     this->purgeIfNeeded();
 }
 
 void SkImageRefPool::purgeIfNeeded() {
     // do nothing if we have a zero-budget (i.e. unlimited)
     if (fRAMBudget != 0) {
-        this->setRAMUsed(fRAMBudget);
+        this->lockedSetRAMUsed(fRAMBudget);
     }
 }
 
-void SkImageRefPool::setRAMUsed(size_t limit) {
+void SkImageRefPool::lockedSetRAMUsed(size_t limit) {
     SkImageRef* ref = fTail;
 
     while (NULL != ref && fRAMUsed > limit) {
-        // only purge it if its pixels are unlocked
-        if (!ref->isLocked() && ref->fBitmap.getPixels()) {
-            size_t size = ref->ramUsed();
+        // Only purge it if its pixels are unlocked. Since an unlocked ref only
+        // reads its bitmap's config, which we leave alone, we can clear the
+        // pixels without taking its mutex.
+        if (!ref->fPoolLocked && ref->fPoolRAM) {
+            size_t size = ref->fPoolRAM;
             SkASSERT(size <= fRAMUsed);
             fRAMUsed -= size;
+            ref->fPoolRAM = 0;
 
 #ifdef DUMP_IMAGEREF_LIFECYCLE
             SkDebugf("=== ImagePool: purge %s [%d %d %d] bytes=%d heap=%d\n",
@@ -84,6 +117,11 @@ void SkImageRefPool::setRAMUsed(size_t limit) {
 ///////////////////////////////////////////////////////////////////////////////
 
 void SkImageRefPool::addToHead(SkImageRef* ref) {
+    SkAutoMutexAcquire ac(fMutex);
+    this->lockedAddToHead(ref);
+}
+
+void SkImageRefPool::lockedAddToHead(SkImageRef* ref) {
     ref->fNext = fHead;
     ref->fPrev = NULL;
 
@@ -99,10 +137,12 @@ void SkImageRefPool::addToHead(SkImageRef* ref) {
     fCount += 1;
     SkASSERT(computeCount() == fCount);
 
-    fRAMUsed += ref->ramUsed();
+    fRAMUsed += ref->fPoolRAM;
 }
 
 void SkImageRefPool::addToTail(SkImageRef* ref) {
+    SkAutoMutexAcquire ac(fMutex);
+
     ref->fNext = NULL;
     ref->fPrev = fTail;
 
@@ -118,10 +158,15 @@ void SkImageRefPool::addToTail(SkImageRef* ref) {
     fCount += 1;
     SkASSERT(computeCount() == fCount);
 
-    fRAMUsed += ref->ramUsed();
+    fRAMUsed += ref->fPoolRAM;
 }
 
 void SkImageRefPool::detach(SkImageRef* ref) {
+    SkAutoMutexAcquire ac(fMutex);
+    this->lockedDetach(ref);
+}
+
+void SkImageRefPool::lockedDetach(SkImageRef* ref) {
     SkASSERT(fCount > 0);
 
     if (fHead == ref) {
@@ -142,8 +187,8 @@ void SkImageRefPool::detach(SkImageRef* ref) {
     fCount -= 1;
     SkASSERT(computeCount() == fCount);
 
-    SkASSERT(fRAMUsed >= ref->ramUsed());
-    fRAMUsed -= ref->ramUsed();
+    SkASSERT(fRAMUsed >= ref->fPoolRAM);
+    fRAMUsed -= ref->fPoolRAM;
 }
 
 int SkImageRefPool::computeCount() const {
@@ -175,6 +220,8 @@ int SkImageRefPool::computeCount() const {
 
 void SkImageRefPool::dump() const {
 #if defined(SK_DEBUG) || defined(DUMP_IMAGEREF_LIFECYCLE)
+    SkAutoMutexAcquire ac(fMutex);
+
     SkDebugf("ImagePool dump: bugdet: %d used: %d count: %d\n",
              (int)fRAMBudget, (int)fRAMUsed, fCount);
 
@@ -183,8 +230,8 @@ void SkImageRefPool::dump() const {
     while (ref != NULL) {
         SkDebugf("  [%3d %3d %d] ram=%d data=%d locked=%d %s\n", ref->fBitmap.width(),
                  ref->fBitmap.height(), ref->fBitmap.config(),
-                 ref->ramUsed(), (int)ref->fStream->getLength(),
-                 ref->isLocked(), ref->getURI());
+                 (int)ref->fPoolRAM, (int)ref->fStream->getLength(),
+                 ref->fPoolLocked, ref->getURI());
 
         ref = ref->fNext;
     }
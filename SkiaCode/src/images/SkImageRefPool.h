@@ -9,19 +9,26 @@
 #define SkImageRefPool_DEFINED
 
 #include "SkTypes.h"
+#include "SkThread.h"
 
 class SkImageRef;
 class SkImageRef_GlobalPool;
 
+/*  All of a pool's methods lock its own mutex, so they may be called from any
+    thread. The pool never takes an imageref's mutex: an imageref tells the
+    pool when it locks and unlocks its pixels, and the pool only purges the
+    pixels of refs that are unlocked. So decodes of unrelated images in the
+    same pool never wait on each other, only on the brief bookkeeping here.
+ */
 class SkImageRefPool {
 public:
     SkImageRefPool();
     ~SkImageRefPool();
 
-    size_t  getRAMBudget() const { return fRAMBudget; }
+    size_t  getRAMBudget() const;
     void    setRAMBudget(size_t);
 
-    size_t  getRAMUsed() const { return fRAMUsed; }
+    size_t  getRAMUsed() const;
     void    setRAMUsed(size_t limit);
 
     void addToHead(SkImageRef*);
@@ -31,6 +38,8 @@ public:
     void dump() const;
 
 private:
+    mutable SkMutex fMutex;
+
     size_t fRAMBudget;
     size_t fRAMUsed;
 
@@ -41,8 +50,15 @@ private:
 
     friend class SkImageRef_GlobalPool;
 
+    // called by the ref with its own mutex held
+    void justLockedPixels(SkImageRef*);
     void justAddedPixels(SkImageRef*);
     void canLosePixels(SkImageRef*);
+
+    // these expect fMutex to already be held
+    void lockedAddToHead(SkImageRef*);
+    void lockedDetach(SkImageRef*);
+    void lockedSetRAMUsed(size_t limit);
     void purgeIfNeeded();
 };
 
@@ -9,13 +9,14 @@
 #include "SkImageRefPool.h"
 #include "SkThread.h"
 
-extern SkBaseMutex gImageRefMutex;
+SK_DECLARE_STATIC_MUTEX(gGlobalPoolMutex);
 
 /*
- *  This returns the lazily-allocated global pool. It must be called
- *  from inside the guard mutex, so we safely only ever allocate 1.
+ *  This returns the lazily-allocated global pool. The pool guards itself with
+ *  its own mutex, so this one only makes sure we ever allocate 1.
  */
 static SkImageRefPool* GetGlobalPool() {
+    SkAutoMutexAcquire ac(gGlobalPoolMutex);
     static SkImageRefPool* gPool;
     if (NULL == gPool) {
         gPool = SkNEW(SkImageRefPool);
@@ -28,22 +29,23 @@ SkImageRef_GlobalPool::SkImageRef_GlobalPool(SkStream* stream,
                                              SkBitmap::Config config,
                                              int sampleSize)
         : SkImageRef(stream, config, sampleSize) {
-    this->mutex()->acquire();
     GetGlobalPool()->addToHead(this);
-    this->mutex()->release();
 }
 
 SkImageRef_GlobalPool::~SkImageRef_GlobalPool() {
-    this->mutex()->acquire();
     GetGlobalPool()->detach(this);
-    this->mutex()->release();
 }
 
-/*  By design, onUnlockPixels() already is inside the mutex-lock,
- *  and it is the (indirect) caller of onDecode(), therefore we can assume
- *  that we also are already inside the mutex. Hence, we can reference
- *  the global-pool directly.
+/*  onLockPixels() is called inside our own mutex, before it touches the
+ *  bitmap, so the pool stops treating our pixels as purgeable first. The
+ *  decode that may follow only holds our mutex, so other images can decode
+ *  at the same time.
  */
+void* SkImageRef_GlobalPool::onLockPixels(SkColorTable** ct) {
+    GetGlobalPool()->justLockedPixels(this);
+    return this->INHERITED::onLockPixels(ct);
+}
+
 bool SkImageRef_GlobalPool::onDecode(SkImageDecoder* codec, SkStream* stream,
                                      SkBitmap* bitmap, SkBitmap::Config config,
                                      SkImageDecoder::Mode mode) {
@@ -51,7 +53,6 @@ bool SkImageRef_GlobalPool::onDecode(SkImageDecoder* codec, SkStream* stream,
         return false;
     }
     if (mode == SkImageDecoder::kDecodePixels_Mode) {
-        // no need to grab the mutex here, it has already been acquired.
         GetGlobalPool()->justAddedPixels(this);
     }
     return true;
@@ -60,15 +61,12 @@ bool SkImageRef_GlobalPool::onDecode(SkImageDecoder* codec, SkStream* stream,
 void SkImageRef_GlobalPool::onUnlockPixels() {
     this->INHERITED::onUnlockPixels();
 
-    // by design, onUnlockPixels() already is inside the mutex-lock
     GetGlobalPool()->canLosePixels(this);
 }
 
 SkImageRef_GlobalPool::SkImageRef_GlobalPool(SkFlattenableReadBuffer& buffer)
         : INHERITED(buffer) {
-    this->mutex()->acquire();
     GetGlobalPool()->addToHead(this);
-    this->mutex()->release();
 }
 
 SK_DEFINE_FLATTENABLE_REGISTRAR(SkImageRef_GlobalPool)
@@ -77,26 +75,21 @@ SK_DEFINE_FLATTENABLE_REGISTRAR(SkImageRef_GlobalPool)
 // global imagerefpool wrappers
 
 size_t SkImageRef_GlobalPool::GetRAMBudget() {
-    SkAutoMutexAcquire ac(gImageRefMutex);
     return GetGlobalPool()->getRAMBudget();
 }
 
 void SkImageRef_GlobalPool::SetRAMBudget(size_t size) {
-    SkAutoMutexAcquire ac(gImageRefMutex);
     GetGlobalPool()->setRAMBudget(size);
 }
 
 size_t SkImageRef_GlobalPool::GetRAMUsed() {
-    SkAutoMutexAcquire ac(gImageRefMutex);
     return GetGlobalPool()->getRAMUsed();
 }
 
 void SkImageRef_GlobalPool::SetRAMUsed(size_t usage) {
-    SkAutoMutexAcquire ac(gImageRefMutex);
     GetGlobalPool()->setRAMUsed(usage);
 }
 
 void SkImageRef_GlobalPool::DumpPool() {
-    SkAutoMutexAcquire ac(gImageRefMutex);
     GetGlobalPool()->dump();
 }
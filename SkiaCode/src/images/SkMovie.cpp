@@ -85,25 +85,65 @@ const SkBitmap& SkMovie::bitmap()
 ////////////////////////////////////////////////////////////////////
 
 #include "SkStream.h"
+#include "SkThread.h"
+
+SK_DECLARE_STATIC_MUTEX(gMovieSettingsMutex);
+static size_t gKeyframeBudget = SkMovie::kDefaultKeyframeBudget;
+static bool gStreaming;
+
+size_t SkMovie::SetKeyframeBudget(size_t bytes) {
+    SkAutoMutexAcquire ac(gMovieSettingsMutex);
+    size_t prev = gKeyframeBudget;
+    gKeyframeBudget = bytes;
+    return prev;
+}
+
+size_t SkMovie::GetKeyframeBudget() {
+    SkAutoMutexAcquire ac(gMovieSettingsMutex);
+    return gKeyframeBudget;
+}
+
+bool SkMovie::SetStreaming(bool streaming) {
+    SkAutoMutexAcquire ac(gMovieSettingsMutex);
+    bool prev = gStreaming;
+    gStreaming = streaming;
+    return prev;
+}
+
+bool SkMovie::GetStreaming() {
+    SkAutoMutexAcquire ac(gMovieSettingsMutex);
+    return gStreaming;
+}
 
 SkMovie* SkMovie::DecodeMemory(const void* data, size_t length) {
-    SkMemoryStream stream(data, length, false);
-    return SkMovie::DecodeStream(&stream);
+    // On the heap, since a streaming movie refs it. Only the decoder reads
+    // the streaming setting, so rather than guess, we check whether it kept
+    // the stream.
+    SkMemoryStream* stream = SkNEW_ARGS(SkMemoryStream, (data, length, false));
+    SkMovie* movie = SkMovie::DecodeStream(stream);
+    if (stream->getRefCnt() > 1) {
+        // the movie may outlive the caller's data, so it gets its own copy
+        stream->setMemory(data, length, true);
+    }
+    stream->unref();
+    return movie;
 }
 
 SkMovie* SkMovie::DecodeFile(const char path[])
 {
     SkMovie* movie = NULL;
 
-    SkFILEStream stream(path);
-    if (stream.isValid()) {
-        movie = SkMovie::DecodeStream(&stream);
+    // on the heap, since the movie may ref it
+    SkFILEStream* stream = SkNEW_ARGS(SkFILEStream, (path));
+    if (stream->isValid()) {
+        movie = SkMovie::DecodeStream(stream);
     }
 #ifdef SK_DEBUG
     else {
         SkDebugf("Movie file not found <%s>\n", path);
     }
 #endif
+    stream->unref();
 
     return movie;
 }
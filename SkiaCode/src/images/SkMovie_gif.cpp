@@ -27,10 +27,39 @@ protected:
     virtual bool onGetBitmap(SkBitmap*);
 
 private:
+    // A copy of the composited movie as of frame fIndex, which does not need
+    // fBackup to carry on to the next frame.
+    struct Keyframe {
+        Keyframe() : fIndex(-1) {}
+
+        int         fIndex;     // -1 until a frame has been copied
+        SkBitmap    fBitmap;
+    };
+
     GifFileType* fGIF;
     int fCurrIndex;
     int fLastDrawIndex;
     SkBitmap fBackup;
+    SkColor fPaintingColor;
+
+    // Keyframe i holds the first frame at or after (i + 1) * fKeyframeInterval
+    // that has been drawn and can be resumed from.
+    size_t fKeyframeBudget;
+    SkAutoTArray<Keyframe> fKeyframes;
+    int fKeyframeCount;
+    int fKeyframeInterval;
+
+    // When streaming, fGIF only holds the frames' descriptions, and their
+    // pixels are read from fStream by fFrameGIF as they are drawn.
+    SkStream* fStream;
+    GifFileType* fFrameGIF;
+    int fFrameGIFIndex;     // index of the next frame fFrameGIF will read
+    SkAutoMalloc fRaster;
+
+    const unsigned char* frameRaster(int index);
+    void setupKeyframes();
+    void saveKeyframe(int index, const SkBitmap&);
+    const Keyframe* findKeyframe(int index) const;
 };
 
 static int Decode(GifFileType* fileType, GifByteType* out, int size) {
@@ -38,25 +67,124 @@ static int Decode(GifFileType* fileType, GifByteType* out, int size) {
     return (int) stream->read(out, size);
 }
 
+// not static, since it is a template argument
+void FreeSavedExtensions(SavedImage* image) {
+    if (image->ExtensionBlocks) {
+        FreeExtension(image);
+    }
+}
+
+static int skip_extension(GifFileType* gif, GifByteType* extData) {
+    while (extData != NULL) {
+        if (DGifGetExtensionNext(gif, &extData) == GIF_ERROR) {
+            return GIF_ERROR;
+        }
+    }
+    return GIF_OK;
+}
+
+// Reads past the (compressed) pixels of the image whose description was just
+// read, without decoding them.
+static int skip_pixels(GifFileType* gif) {
+    int codeSize;
+    GifByteType* codeBlock;
+    if (DGifGetCode(gif, &codeSize, &codeBlock) == GIF_ERROR) {
+        return GIF_ERROR;
+    }
+    while (codeBlock != NULL) {
+        if (DGifGetCodeNext(gif, &codeBlock) == GIF_ERROR) {
+            return GIF_ERROR;
+        }
+    }
+    return GIF_OK;
+}
+
+// Like DGifSlurp, but skips the pixels of each frame, so only their
+// descriptions and extension blocks are kept (RasterBits is left NULL).
+static int scan_frames(GifFileType* gif) {
+    SavedImage temp;
+    temp.ExtensionBlocks = NULL;
+    temp.ExtensionBlockCount = 0;
+    SkAutoTCallVProc<SavedImage, FreeSavedExtensions> afe(&temp);
+
+    GifRecordType recType;
+    GifByteType* extData;
+    do {
+        if (DGifGetRecordType(gif, &recType) == GIF_ERROR) {
+            return GIF_ERROR;
+        }
+
+        switch (recType) {
+        case IMAGE_DESC_RECORD_TYPE: {
+            if (DGifGetImageDesc(gif) == GIF_ERROR || skip_pixels(gif) == GIF_ERROR) {
+                return GIF_ERROR;
+            }
+            SavedImage* image = &gif->SavedImages[gif->ImageCount - 1];
+            if (temp.ExtensionBlocks) {
+                image->ExtensionBlocks = temp.ExtensionBlocks;
+                image->ExtensionBlockCount = temp.ExtensionBlockCount;
+                temp.ExtensionBlocks = NULL;
+                temp.ExtensionBlockCount = 0;
+            }
+            } break;
+
+        case EXTENSION_RECORD_TYPE:
+            if (DGifGetExtension(gif, &temp.Function, &extData) == GIF_ERROR) {
+                return GIF_ERROR;
+            }
+            while (extData != NULL) {
+                if (AddExtensionBlock(&temp, extData[0], &extData[1]) == GIF_ERROR ||
+                    DGifGetExtensionNext(gif, &extData) == GIF_ERROR) {
+                    return GIF_ERROR;
+                }
+                temp.Function = 0;
+            }
+            break;
+
+        default:
+            break;
+        }
+    } while (recType != TERMINATE_RECORD_TYPE);
+
+    return GIF_OK;
+}
+
 SkGIFMovie::SkGIFMovie(SkStream* stream)
 {
+    fCurrIndex = -1;
+    fLastDrawIndex = -1;
+    fPaintingColor = SkColorSetARGB(0, 0, 0, 0);
+    fKeyframeBudget = SkMovie::GetKeyframeBudget();
+    fKeyframeCount = 0;
+    fKeyframeInterval = 0;
+    fStream = NULL;
+    fFrameGIF = NULL;
+    fFrameGIFIndex = 0;
+
     fGIF = DGifOpen( stream, Decode );
     if (NULL == fGIF)
         return;
 
-    if (DGifSlurp(fGIF) != GIF_OK)
+    bool streaming = SkMovie::GetStreaming();
+    if ((streaming ? scan_frames(fGIF) : DGifSlurp(fGIF)) != GIF_OK)
     {
         DGifCloseFile(fGIF);
         fGIF = NULL;
+        return;
+    }
+    if (streaming) {
+        fStream = stream;
+        fStream->ref();
     }
-    fCurrIndex = -1;
-    fLastDrawIndex = -1;
 }
 
 SkGIFMovie::~SkGIFMovie()
 {
+    if (fFrameGIF)
+        DGifCloseFile(fFrameGIF);
     if (fGIF)
         DGifCloseFile(fGIF);
+    SkSafeUnref(fStream);
 }
 
 static SkMSec savedimage_duration(const SavedImage* image)
@@ -137,8 +265,8 @@ static void copyInterlaceGroup(SkBitmap* bm, const unsigned char*& src,
     src += imageDesc.Width * ((imageDesc.Height - row + rowStep - 1) / rowStep);
 }
 
-static void blitInterlace(SkBitmap* bm, const SavedImage* frame, const ColorMapObject* cmap,
-                          int transparent)
+static void blitInterlace(SkBitmap* bm, const SavedImage* frame, const unsigned char* raster,
+                          const ColorMapObject* cmap, int transparent)
 {
     int width = bm->width();
     int height = bm->height();
@@ -153,7 +281,7 @@ static void blitInterlace(SkBitmap* bm, const SavedImage* frame, const ColorMapO
     }
 
     // deinterlace
-    const unsigned char* src = (unsigned char*)frame->RasterBits;
+    const unsigned char* src = raster;
 
     // group 1 - every 8th row, starting with row 0
     copyInterlaceGroup(bm, src, cmap, transparent, copyWidth, copyHeight, frame->ImageDesc, 8, 0);
@@ -167,12 +295,12 @@ static void blitInterlace(SkBitmap* bm, const SavedImage* frame, const ColorMapO
     copyInterlaceGroup(bm, src, cmap, transparent, copyWidth, copyHeight, frame->ImageDesc, 2, 1);
 }
 
-static void blitNormal(SkBitmap* bm, const SavedImage* frame, const ColorMapObject* cmap,
-                       int transparent)
+static void blitNormal(SkBitmap* bm, const SavedImage* frame, const unsigned char* raster,
+                       const ColorMapObject* cmap, int transparent)
 {
     int width = bm->width();
     int height = bm->height();
-    const unsigned char* src = (unsigned char*)frame->RasterBits;
+    const unsigned char* src = raster;
     uint32_t* dst = bm->getAddr32(frame->ImageDesc.Left, frame->ImageDesc.Top);
     GifWord copyWidth = frame->ImageDesc.Width;
     if (frame->ImageDesc.Left + copyWidth > width) {
@@ -216,7 +344,8 @@ static void fillRect(SkBitmap* bm, GifWord left, GifWord top, GifWord width, Gif
     }
 }
 
-static void drawFrame(SkBitmap* bm, const SavedImage* frame, const ColorMapObject* cmap)
+static void drawFrame(SkBitmap* bm, const SavedImage* frame, const unsigned char* raster,
+                      const ColorMapObject* cmap)
 {
     int transparent = -1;
 
@@ -242,9 +371,9 @@ static void drawFrame(SkBitmap* bm, const SavedImage* frame, const ColorMapObjec
     }
 
     if (frame->ImageDesc.Interlace) {
-        blitInterlace(bm, frame, cmap, transparent);
+        blitInterlace(bm, frame, raster, cmap, transparent);
     } else {
-        blitNormal(bm, frame, cmap, transparent);
+        blitNormal(bm, frame, raster, cmap, transparent);
     }
 }
 
@@ -296,7 +425,8 @@ static void disposeFrameIfNeeded(SkBitmap* bm, const SavedImage* cur, const Save
                                  SkBitmap* backup, SkColor color)
 {
     // We can skip disposal process if next frame is not transparent
-    // and completely covers current area
+    // and completely covers current area, unless the next frame wants a
+    // backup, which must not include the current one
     bool curTrans;
     int curDisposal;
     getTransparencyAndDisposalMethod(cur, &curTrans, &curDisposal);
@@ -304,7 +434,7 @@ static void disposeFrameIfNeeded(SkBitmap* bm, const SavedImage* cur, const Save
     int nextDisposal;
     getTransparencyAndDisposalMethod(next, &nextTrans, &nextDisposal);
     if ((curDisposal == 2 || curDisposal == 3)
-        && (nextTrans || !checkIfCover(next, cur))) {
+        && (nextTrans || !checkIfCover(next, cur) || nextDisposal == 3)) {
         switch (curDisposal) {
         // restore to background color
         // -> 'background' means background under this image.
@@ -330,6 +460,117 @@ static void disposeFrameIfNeeded(SkBitmap* bm, const SavedImage* cur, const Save
     }
 }
 
+// Returns the pixels of frame index, reading them from the stream if the
+// frames were not slurped, or NULL if they could not be read.
+const unsigned char* SkGIFMovie::frameRaster(int index)
+{
+    const SavedImage* frame = &fGIF->SavedImages[index];
+    if (NULL == fStream) {
+        return (const unsigned char*)frame->RasterBits;
+    }
+
+    // the frames can only be read in order, so going back means starting over
+    if (fFrameGIF && fFrameGIFIndex > index) {
+        DGifCloseFile(fFrameGIF);
+        fFrameGIF = NULL;
+    }
+    if (NULL == fFrameGIF) {
+        if (!fStream->rewind()) {
+            return NULL;
+        }
+        fFrameGIF = DGifOpen(fStream, Decode);
+        if (NULL == fFrameGIF) {
+            return NULL;
+        }
+        fFrameGIFIndex = 0;
+    }
+
+    GifRecordType recType;
+    GifByteType* extData;
+    int function;
+    for (;;) {
+        if (DGifGetRecordType(fFrameGIF, &recType) == GIF_ERROR) {
+            break;
+        }
+        if (IMAGE_DESC_RECORD_TYPE == recType) {
+            if (DGifGetImageDesc(fFrameGIF) == GIF_ERROR) {
+                break;
+            }
+            if (fFrameGIFIndex++ < index) {
+                if (skip_pixels(fFrameGIF) == GIF_ERROR) {
+                    break;
+                }
+                continue;
+            }
+            // same layout as DGifSlurp's RasterBits
+            int size = frame->ImageDesc.Width * frame->ImageDesc.Height;
+            GifPixelType* raster = (GifPixelType*)fRaster.reset(size,
+                                                    SkAutoMalloc::kReuse_OnShrink);
+            if (NULL == raster || DGifGetLine(fFrameGIF, raster, size) == GIF_ERROR) {
+                break;
+            }
+            return raster;
+        } else if (EXTENSION_RECORD_TYPE == recType) {
+            if (DGifGetExtension(fFrameGIF, &function, &extData) == GIF_ERROR ||
+                skip_extension(fFrameGIF, extData) == GIF_ERROR) {
+                break;
+            }
+        } else {
+            // the stream ended before frame index
+            break;
+        }
+    }
+
+    // we don't know where fFrameGIF stopped, so start over next time
+    DGifCloseFile(fFrameGIF);
+    fFrameGIF = NULL;
+    return NULL;
+}
+
+void SkGIFMovie::setupKeyframes()
+{
+    // Spread as many keyframes as fit in the budget evenly over the movie.
+    // Frame 0 is never needed, since starting there costs no more than it.
+    const int frameCount = fGIF->ImageCount;
+    const size_t frameSize = (size_t)fGIF->SWidth * fGIF->SHeight * sizeof(SkPMColor);
+    size_t count = fKeyframeBudget / frameSize;
+    if (count > (size_t)(frameCount - 1)) {
+        count = frameCount - 1;
+    }
+    if (0 == count) {
+        return;
+    }
+    fKeyframeInterval = (frameCount + (int)count) / ((int)count + 1);
+    fKeyframeCount = (frameCount - 1) / fKeyframeInterval;
+    fKeyframes.reset(fKeyframeCount);
+}
+
+void SkGIFMovie::saveKeyframe(int index, const SkBitmap& bm)
+{
+    if (0 == fKeyframeCount || index < fKeyframeInterval) {
+        return;
+    }
+    Keyframe& keyframe = fKeyframes[SkMin32(index / fKeyframeInterval, fKeyframeCount) - 1];
+    if (keyframe.fIndex < 0 && bm.copyTo(&keyframe.fBitmap, SkBitmap::kARGB_8888_Config)) {
+        keyframe.fIndex = index;
+    }
+}
+
+// Returns the latest keyframe at or before index, or NULL if there is none.
+const SkGIFMovie::Keyframe* SkGIFMovie::findKeyframe(int index) const
+{
+    if (0 == fKeyframeCount) {
+        return NULL;
+    }
+    for (int i = SkMin32(index / fKeyframeInterval, fKeyframeCount); i > 0; --i) {
+        const Keyframe& keyframe = fKeyframes[i - 1];
+        if (keyframe.fIndex >= 0 && keyframe.fIndex <= index) {
+            return &keyframe;
+        }
+    }
+    return NULL;
+}
+
 bool SkGIFMovie::onGetBitmap(SkBitmap* bm)
 {
     const GifFileType* gif = fGIF;
@@ -346,16 +587,24 @@ bool SkGIFMovie::onGetBitmap(SkBitmap* bm)
         return false;
     }
 
+    int lastIndex = fCurrIndex;
+    if (lastIndex < 0) {
+        // first time
+        lastIndex = 0;
+    } else if (lastIndex > fGIF->ImageCount - 1) {
+        // this block must not be reached.
+        lastIndex = fGIF->ImageCount - 1;
+    }
+
     // no need to draw
-    if (fLastDrawIndex >= 0 && fLastDrawIndex == fCurrIndex) {
+    if (fLastDrawIndex >= 0 && fLastDrawIndex == lastIndex && bm->readyToDraw()) {
         return true;
     }
 
-    int startIndex = fLastDrawIndex + 1;
     if (fLastDrawIndex < 0 || !bm->readyToDraw()) {
         // first time
 
-        startIndex = 0;
+        fLastDrawIndex = -1;
 
         // create bitmap
         bm->setConfig(SkBitmap::kARGB_8888_Config, width, height, 0);
@@ -367,53 +616,62 @@ bool SkGIFMovie::onGetBitmap(SkBitmap* bm)
         if (!fBackup.allocPixels(NULL)) {
             return false;
         }
-    } else if (startIndex > fCurrIndex) {
-        // rewind to 1st frame for repeat
-        startIndex = 0;
-    }
 
-    int lastIndex = fCurrIndex;
-    if (lastIndex < 0) {
-        // first time
-        lastIndex = 0;
-    } else if (lastIndex > fGIF->ImageCount - 1) {
-        // this block must not be reached.
-        lastIndex = fGIF->ImageCount - 1;
+        bool trans;
+        int disposal;
+        getTransparencyAndDisposalMethod(&fGIF->SavedImages[0], &trans, &disposal);
+        if (!trans && gif->SColorMap != NULL) {
+            const GifColorType& col = gif->SColorMap->Colors[fGIF->SBackGroundColor];
+            fPaintingColor = SkColorSetARGB(0xFF, col.Red, col.Green, col.Blue);
+        } else {
+            fPaintingColor = SkColorSetARGB(0, 0, 0, 0);
+        }
+
+        if (0 == fKeyframeInterval) {
+            this->setupKeyframes();
+        }
     }
 
-    SkColor bgColor = SkPackARGB32(0, 0, 0, 0);
-    if (gif->SColorMap != NULL) {
-        const GifColorType& col = gif->SColorMap->Colors[fGIF->SBackGroundColor];
-        bgColor = SkColorSetARGB(0xFF, col.Red, col.Green, col.Blue);
+    // Carry on from the frame last drawn, unless we have to go back (e.g. to
+    // repeat), in which case start from the nearest keyframe, or the 1st frame.
+    int startIndex = 0;
+    if (fLastDrawIndex >= 0 && fLastDrawIndex < lastIndex) {
+        startIndex = fLastDrawIndex + 1;
+    }
+    const Keyframe* keyframe = this->findKeyframe(lastIndex);
+    if (keyframe && keyframe->fIndex >= startIndex) {
+        memcpy(bm->getPixels(), keyframe->fBitmap.getPixels(), bm->getSize());
+        startIndex = keyframe->fIndex + 1;
     }
 
-    static SkColor paintingColor = SkPackARGB32(0, 0, 0, 0);
     // draw each frames - not intelligent way
     for (int i = startIndex; i <= lastIndex; i++) {
         const SavedImage* cur = &fGIF->SavedImages[i];
         if (i == 0) {
-            bool trans;
-            int disposal;
-            getTransparencyAndDisposalMethod(cur, &trans, &disposal);
-            if (!trans && gif->SColorMap != NULL) {
-                paintingColor = bgColor;
-            } else {
-                paintingColor = SkColorSetARGB(0, 0, 0, 0);
-            }
-
-            bm->eraseColor(paintingColor);
-            fBackup.eraseColor(paintingColor);
+            bm->eraseColor(fPaintingColor);
+            fBackup.eraseColor(fPaintingColor);
         } else {
             // Dispose previous frame before move to next frame.
             const SavedImage* prev = &fGIF->SavedImages[i-1];
-            disposeFrameIfNeeded(bm, prev, cur, &fBackup, paintingColor);
+            disposeFrameIfNeeded(bm, prev, cur, &fBackup, fPaintingColor);
         }
 
         // Draw frame
         // We can skip this process if this index is not last and disposal
         // method == 2 or method == 3
-        if (i == lastIndex || !checkIfWillBeCleared(cur)) {
-            drawFrame(bm, cur, gif->SColorMap);
+        bool willBeCleared = checkIfWillBeCleared(cur);
+        if (i == lastIndex || !willBeCleared) {
+            const unsigned char* raster = this->frameRaster(i);
+            if (NULL == raster) {
+                // bm is only part way there, so start over next time
+                fLastDrawIndex = -1;
+                return false;
+            }
+            drawFrame(bm, cur, raster, gif->SColorMap);
+        }
+        // A frame that stays put is all that's needed to carry on from it.
+        if (!willBeCleared) {
+            this->saveKeyframe(i, *bm);
         }
     }
 
@@ -0,0 +1,204 @@
+/*
+ * Copyright 2012 Google Inc.
+ *
+ * Use of this source code is governed by a BSD-style license that can be
+ * found in the LICENSE file.
+ */
+
+#include "SkLightingRow_opts_SSE2.h"
+#include "SkColorPriv.h"
+
+#include <emmintrin.h>
+
+// These do the same float operations in the same order as the portable procs
+// in SkLightingImageFilter.cpp, so both give exactly the same pixels.
+
+static inline __m128 negate_SSE2(__m128 x) {
+    return _mm_xor_ps(x, _mm_castsi128_ps(_mm_set1_epi32(0x80000000)));
+}
+
+// Pins to [0, 1], sending NaN to 0 as the portable clamp does.
+static inline __m128 clamp_unit_SSE2(__m128 x) {
+    return _mm_min_ps(_mm_max_ps(x, _mm_setzero_ps()), _mm_set1_ps(1));
+}
+
+static inline __m128 invert_length_SSE2(__m128 x, __m128 y, __m128 z) {
+    __m128 dot = _mm_add_ps(_mm_add_ps(_mm_mul_ps(x, x), _mm_mul_ps(y, y)),
+                            _mm_mul_ps(z, z));
+    return _mm_div_ps(_mm_set1_ps(1), _mm_sqrt_ps(dot));
+}
+
+static inline __m128 pow_lookup_SSE2(const float table[], __m128 x) {
+    __m128 f = _mm_mul_ps(clamp_unit_SSE2(x),
+                          _mm_set1_ps(SkLightingRow::kPowTableSize));
+    __m128i i = _mm_cvttps_epi32(f);
+    __m128 t = _mm_sub_ps(f, _mm_cvtepi32_ps(i));
+
+    // SSE2 has no gather, so the table is read a lane at a time
+    int32_t index[4];
+    _mm_storeu_si128((__m128i*)index, i);
+    __m128 lo = _mm_setr_ps(table[index[0]], table[index[1]],
+                            table[index[2]], table[index[3]]);
+    __m128 hi = _mm_setr_ps(table[index[0] + 1], table[index[1] + 1],
+                            table[index[2] + 1], table[index[3] + 1]);
+    return _mm_add_ps(lo, _mm_mul_ps(_mm_sub_ps(hi, lo), t));
+}
+
+static inline __m128 diff_SSE2(const float a[], const float b[]) {
+    return _mm_sub_ps(_mm_loadu_ps(a), _mm_loadu_ps(b));
+}
+
+// Normals of the four pixels starting at curr[0].
+static inline void normals4_SSE2(const SkLightingRow::NormalsRec& rec,
+                                 const float prev[], const float curr[],
+                                 const float next[],
+                                 float nx[], float ny[], float nz[]) {
+    const __m128 two = _mm_set1_ps(2);
+
+    __m128 gx = _mm_add_ps(
+        _mm_add_ps(_mm_mul_ps(diff_SSE2(prev + 1, prev - 1),
+                              _mm_set1_ps(rec.fPrevWeight)),
+                   _mm_mul_ps(diff_SSE2(curr + 1, curr - 1), two)),
+        _mm_mul_ps(diff_SSE2(next + 1, next - 1),
+                   _mm_set1_ps(rec.fNextWeight)));
+    __m128 gy = _mm_add_ps(
+        _mm_add_ps(diff_SSE2(next - 1, prev - 1),
+                   _mm_mul_ps(diff_SSE2(next, prev), two)),
+        diff_SSE2(next + 1, prev + 1));
+
+    __m128 surfaceScale = _mm_set1_ps(rec.fSurfaceScale);
+    __m128 a = _mm_mul_ps(negate_SSE2(_mm_mul_ps(gx, _mm_set1_ps(rec.fScaleX))),
+                          surfaceScale);
+    __m128 b = _mm_mul_ps(negate_SSE2(_mm_mul_ps(gy, _mm_set1_ps(rec.fScaleY))),
+                          surfaceScale);
+    __m128 scale = invert_length_SSE2(a, b, _mm_set1_ps(1));
+    _mm_storeu_ps(nx, _mm_mul_ps(a, scale));
+    _mm_storeu_ps(ny, _mm_mul_ps(b, scale));
+    _mm_storeu_ps(nz, scale);
+}
+
+void SkLightingNormals_SSE2(const SkLightingRow::NormalsRec& rec,
+                            const float prev[], const float curr[],
+                            const float next[], int width,
+                            float nx[], float ny[], float nz[]) {
+    int x = 1;
+    for (; x + 4 <= width - 1; x += 4) {
+        normals4_SSE2(rec, prev + x, curr + x, next + x,
+                      nx + x, ny + x, nz + x);
+    }
+
+    // Copy the last few pixels and their neighbours out, so the loads
+    // stay inside the rows.
+    int remaining = width - 1 - x;
+    if (remaining > 0) {
+        float p[6] = { 0 }, c[6] = { 0 }, n[6] = { 0 };
+        float tx[4], ty[4], tz[4];
+        memcpy(p, prev + x - 1, (remaining + 2) * sizeof(float));
+        memcpy(c, curr + x - 1, (remaining + 2) * sizeof(float));
+        memcpy(n, next + x - 1, (remaining + 2) * sizeof(float));
+        normals4_SSE2(rec, p + 1, c + 1, n + 1, tx, ty, tz);
+        memcpy(nx + x, tx, remaining * sizeof(float));
+        memcpy(ny + x, ty, remaining * sizeof(float));
+        memcpy(nz + x, tz, remaining * sizeof(float));
+    }
+}
+
+static inline void shade4_SSE2(const SkLightingRow::ShadeRec& rec, int x,
+                               int y, const float alpha[], const float nx[],
+                               const float ny[], const float nz[],
+                               SkPMColor dst[]) {
+    __m128 lx = _mm_set1_ps(rec.fLight[0]);
+    __m128 ly = _mm_set1_ps(rec.fLight[1]);
+    __m128 lz = _mm_set1_ps(rec.fLight[2]);
+    __m128 r = _mm_set1_ps(rec.fColor[0]);
+    __m128 g = _mm_set1_ps(rec.fColor[1]);
+    __m128 b = _mm_set1_ps(rec.fColor[2]);
+    if (SkLightingRow::kDistant_LightType != rec.fLightType) {
+        __m128 xs = _mm_cvtepi32_ps(_mm_add_epi32(_mm_set1_epi32(x),
+                                                  _mm_setr_epi32(0, 1, 2, 3)));
+        lx = _mm_sub_ps(lx, xs);
+        ly = _mm_sub_ps(ly, _mm_set1_ps((float)y));
+        lz = _mm_sub_ps(lz, _mm_mul_ps(_mm_loadu_ps(alpha),
+                                       _mm_set1_ps(rec.fSurfaceScale)));
+        __m128 scale = invert_length_SSE2(lx, ly, lz);
+        lx = _mm_mul_ps(lx, scale);
+        ly = _mm_mul_ps(ly, scale);
+        lz = _mm_mul_ps(lz, scale);
+        if (SkLightingRow::kSpot_LightType == rec.fLightType) {
+            __m128 cosAngle = negate_SSE2(_mm_add_ps(
+                _mm_add_ps(_mm_mul_ps(lx, _mm_set1_ps(rec.fS[0])),
+                           _mm_mul_ps(ly, _mm_set1_ps(rec.fS[1]))),
+                _mm_mul_ps(lz, _mm_set1_ps(rec.fS[2]))));
+            __m128 outer = _mm_set1_ps(rec.fCosOuterConeAngle);
+            __m128 spot = pow_lookup_SSE2(rec.fSpotTable, cosAngle);
+            __m128 edge = _mm_mul_ps(_mm_mul_ps(spot, _mm_sub_ps(cosAngle, outer)),
+                                     _mm_set1_ps(rec.fConeScale));
+            __m128 inEdge = _mm_cmplt_ps(cosAngle,
+                                         _mm_set1_ps(rec.fCosInnerConeAngle));
+            spot = _mm_or_ps(_mm_and_ps(inEdge, edge),
+                             _mm_andnot_ps(inEdge, spot));
+            spot = _mm_and_ps(_mm_cmpge_ps(cosAngle, outer), spot);
+            r = _mm_mul_ps(r, spot);
+            g = _mm_mul_ps(g, spot);
+            b = _mm_mul_ps(b, spot);
+        }
+    }
+
+    __m128 colorScale;
+    if (rec.fSpecular) {
+        if (SkLightingRow::kDistant_LightType != rec.fLightType) {
+            lz = _mm_add_ps(lz, _mm_set1_ps(1));
+            __m128 scale = invert_length_SSE2(lx, ly, lz);
+            lx = _mm_mul_ps(lx, scale);
+            ly = _mm_mul_ps(ly, scale);
+            lz = _mm_mul_ps(lz, scale);
+        }
+        __m128 dot = _mm_add_ps(_mm_add_ps(_mm_mul_ps(_mm_loadu_ps(nx), lx),
+                                           _mm_mul_ps(_mm_loadu_ps(ny), ly)),
+                                _mm_mul_ps(_mm_loadu_ps(nz), lz));
+        colorScale = _mm_mul_ps(_mm_set1_ps(rec.fK),
+                                pow_lookup_SSE2(rec.fShininessTable, dot));
+    } else {
+        __m128 dot = _mm_add_ps(_mm_add_ps(_mm_mul_ps(_mm_loadu_ps(nx), lx),
+                                           _mm_mul_ps(_mm_loadu_ps(ny), ly)),
+                                _mm_mul_ps(_mm_loadu_ps(nz), lz));
+        colorScale = _mm_mul_ps(_mm_set1_ps(rec.fK), dot);
+    }
+    colorScale = clamp_unit_SSE2(colorScale);
+
+    r = _mm_mul_ps(r, colorScale);
+    g = _mm_mul_ps(g, colorScale);
+    b = _mm_mul_ps(b, colorScale);
+    // truncation keeps order, so this is the largest of the truncated colors
+    __m128i ia = rec.fSpecular ?
+                 _mm_cvttps_epi32(_mm_max_ps(_mm_max_ps(r, g), b)) :
+                 _mm_set1_epi32(255);
+    __m128i pixels = _mm_or_si128(
+        _mm_or_si128(_mm_slli_epi32(ia, SK_A32_SHIFT),
+                     _mm_slli_epi32(_mm_cvttps_epi32(r), SK_R32_SHIFT)),
+        _mm_or_si128(_mm_slli_epi32(_mm_cvttps_epi32(g), SK_G32_SHIFT),
+                     _mm_slli_epi32(_mm_cvttps_epi32(b), SK_B32_SHIFT)));
+    _mm_storeu_si128((__m128i*)dst, pixels);
+}
+
+void SkLightingShade_SSE2(const SkLightingRow::ShadeRec& rec, int x, int y,
+                          const float alpha[], const float nx[],
+                          const float ny[], const float nz[],
+                          SkPMColor dst[], int count) {
+    int i = 0;
+    for (; i + 4 <= count; i += 4) {
+        shade4_SSE2(rec, x + i, y, alpha + i, nx + i, ny + i, nz + i, dst + i);
+    }
+
+    int remaining = count - i;
+    if (remaining > 0) {
+        float ta[4] = { 0 }, tx[4] = { 0 }, ty[4] = { 0 }, tz[4] = { 0 };
+        SkPMColor td[4];
+        memcpy(ta, alpha + i, remaining * sizeof(float));
+        memcpy(tx, nx + i, remaining * sizeof(float));
+        memcpy(ty, ny + i, remaining * sizeof(float));
+        memcpy(tz, nz + i, remaining * sizeof(float));
+        shade4_SSE2(rec, x + i, y, ta, tx, ty, tz, td);
+        memcpy(dst + i, td, remaining * sizeof(SkPMColor));
+    }
+}
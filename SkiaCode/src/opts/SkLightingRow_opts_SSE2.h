@@ -0,0 +1,23 @@
+/*
+ * Copyright 2012 Google Inc.
+ *
+ * Use of this source code is governed by a BSD-style license that can be
+ * found in the LICENSE file.
+ */
+
+#ifndef SkLightingRow_opts_SSE2_DEFINED
+#define SkLightingRow_opts_SSE2_DEFINED
+
+#include "SkLightingRow.h"
+
+void SkLightingNormals_SSE2(const SkLightingRow::NormalsRec& rec,
+                            const float prev[], const float curr[],
+                            const float next[], int width,
+                            float nx[], float ny[], float nz[]);
+
+void SkLightingShade_SSE2(const SkLightingRow::ShadeRec& rec, int x, int y,
+                          const float alpha[], const float nx[],
+                          const float ny[], const float nz[],
+                          SkPMColor dst[], int count);
+
+#endif
@@ -0,0 +1,16 @@
+/*
+ * Copyright 2012 Google Inc.
+ *
+ * Use of this source code is governed by a BSD-style license that can be
+ * found in the LICENSE file.
+ */
+
+#include "SkLightingRow.h"
+
+SkLightingRow::NormalsProc SkLightingRow::PlatformNormalsProc() {
+    return NULL;
+}
+
+SkLightingRow::ShadeProc SkLightingRow::PlatformShadeProc() {
+    return NULL;
+}
@@ -11,6 +11,7 @@
 #include "SkBlitRow.h"
 #include "SkBlitRect_opts_SSE2.h"
 #include "SkBlitRow_opts_SSE2.h"
+#include "SkLightingRow_opts_SSE2.h"
 #include "SkUtils_opts_SSE2.h"
 #include "SkUtils.h"
 
@@ -245,4 +246,18 @@ SkBlitRow::ColorRectProc PlatformColorRectProcFactory() {
     }
 }
 
+SkLightingRow::NormalsProc SkLightingRow::PlatformNormalsProc() {
+    if (cachedHasSSE2()) {
+        return SkLightingNormals_SSE2;
+    } else {
+        return NULL;
+    }
+}
 
+SkLightingRow::ShadeProc SkLightingRow::PlatformShadeProc() {
+    if (cachedHasSSE2()) {
+        return SkLightingShade_SSE2;
+    } else {
+        return NULL;
+    }
+}
@@ -14,6 +14,7 @@
  */
 
 #include "SkBlitRow.h"
+#include "SkLightingRow.h"
 #include "SkUtils.h"
 
 #include "SkUtilsArm.h"
@@ -64,3 +65,10 @@ SkBlitRow::ColorRectProc PlatformColorRectProcFactory() {
     return NULL;
 }
 
+SkLightingRow::NormalsProc SkLightingRow::PlatformNormalsProc() {
+    return NULL;
+}
+
+SkLightingRow::ShadeProc SkLightingRow::PlatformShadeProc() {
+    return NULL;
+}
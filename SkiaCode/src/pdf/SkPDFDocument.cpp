@@ -14,6 +14,7 @@
 #include "SkPDFPage.h"
 #include "SkPDFTypes.h"
 #include "SkStream.h"
+#include "SkTrace.h"
 
 // Add the resources, starting at firstIndex to the catalog, removing any dupes.
 // A hash table would be really nice here.
@@ -78,6 +79,7 @@ SkPDFDocument::~SkPDFDocument() {
 }
 
 bool SkPDFDocument::emitPDF(SkWStream* stream) {
+    SK_TRACE_SCOPE("skia.pdf", "SkPDFDocument::emitPDF");
     if (fPages.isEmpty()) {
         return false;
     }
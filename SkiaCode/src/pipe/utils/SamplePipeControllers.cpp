@@ -8,9 +8,12 @@
 #include "SamplePipeControllers.h"
 
 #include "SkCanvas.h"
+#include "SkCondVar.h"
 #include "SkDevice.h"
 #include "SkGPipe.h"
 #include "SkMatrix.h"
+#include "SkThread.h"
+#include "SkThreadUtils.h"
 
 PipeController::PipeController(SkCanvas* target)
 :fReader(target) {
@@ -113,3 +116,184 @@ void ThreadSafePipeController::playback(SkCanvas* target) {
         reader.playback(fBlock, fBytesWritten);
     }
 }
+
+////////////////////////////////////////////////////////////////////////////////
+
+// sk_atomic_add is a full barrier, so adding zero is an ordered load of a
+// counter written by the other thread.
+static inline int32_t atomic_load(int32_t* value) {
+    return sk_atomic_add(value, 0);
+}
+
+ThreadedPipeController::ThreadedPipeController(SkCanvas* target, int blockCount)
+: fReader(target)
+, fBlocks(blockCount)
+, fBlockCount(blockCount)
+, fCurrBlock(NULL)
+, fWaitFence(0)
+, fReadBlock(0)
+, fReadOffset(0)
+, fBlocksRequested(0)
+, fBlocksReleased(0)
+, fBytesWritten(0)
+, fBytesRead(0)
+, fQuit(0)
+, fReaderWaiting(0)
+, fWriterWaiting(0)
+, fCondVar(SkNEW(SkCondVar))
+, fThread(SkNEW_ARGS(SkThread, (ReaderThreadProc, this))) {
+    SkASSERT(blockCount > 0);
+    for (int i = 0; i < fBlockCount; ++i) {
+        fBlocks[i].fData = NULL;
+        fBlocks[i].fSize = 0;
+    }
+    if (!fThread.get()->start()) {
+        SkDEBUGFAIL("could not start the pipe reader thread");
+    }
+}
+
+ThreadedPipeController::~ThreadedPipeController() {
+    // the reader plays back whatever is left before it sees fQuit
+    sk_atomic_inc(&fQuit);
+    this->wake(&fReaderWaiting);
+    fThread.get()->join();
+    for (int i = 0; i < fBlockCount; ++i) {
+        sk_free(fBlocks[i].fData);
+    }
+}
+
+void* ThreadedPipeController::requestBlock(size_t minRequest, size_t* actual) {
+    if (NULL != fCurrBlock) {
+        sk_atomic_inc(&fCurrBlock->fClosed);
+        this->wake(&fReaderWaiting);
+    }
+
+    // backpressure: wait for the reader to hand a block back
+    this->waitUntil(&fWriterWaiting, &ThreadedPipeController::hasFreeBlock);
+
+    Block* block = &fBlocks[fBlocksRequested % fBlockCount];
+    if (block->fSize < minRequest) {
+        block->fSize = SkMax32(minRequest, kMinBlockSize);
+        // the previous contents have been played back, so don't copy them
+        sk_free(block->fData);
+        block->fData = sk_malloc_throw(block->fSize);
+    }
+    block->fWritten = 0;
+    block->fClosed = 0;
+    fCurrBlock = block;
+    // publishes the block to the reader
+    sk_atomic_inc(&fBlocksRequested);
+
+    *actual = block->fSize;
+    return block->fData;
+}
+
+void ThreadedPipeController::notifyWritten(size_t bytes) {
+    SkASSERT(NULL != fCurrBlock);
+    sk_atomic_add(&fCurrBlock->fWritten, bytes);
+    sk_atomic_add(&fBytesWritten, bytes);
+    this->wake(&fReaderWaiting);
+}
+
+ThreadedPipeController::Fence ThreadedPipeController::insertFence() const {
+    // only the writer thread changes fBytesWritten
+    return fBytesWritten;
+}
+
+bool ThreadedPipeController::hasPassed(Fence fence) const {
+    // the difference is taken so that the byte counts may wrap
+    int32_t* bytesRead = const_cast<int32_t*>(&fBytesRead);
+    return (int32_t)((uint32_t)atomic_load(bytesRead) - (uint32_t)fence) >= 0;
+}
+
+void ThreadedPipeController::waitForFence(Fence fence) {
+    fWaitFence = fence;
+    this->waitUntil(&fWriterWaiting, &ThreadedPipeController::hasPassedWaitFence);
+}
+
+bool ThreadedPipeController::readerCanProgress() const {
+    ThreadedPipeController* self = const_cast<ThreadedPipeController*>(this);
+    if (fReadBlock != atomic_load(&self->fBlocksRequested)) {
+        Block* block = &self->fBlocks[fReadBlock % fBlockCount];
+        if (atomic_load(&block->fWritten) != fReadOffset ||
+            atomic_load(&block->fClosed)) {
+            return true;
+        }
+    }
+    return 0 != atomic_load(&self->fQuit);
+}
+
+bool ThreadedPipeController::hasFreeBlock() const {
+    ThreadedPipeController* self = const_cast<ThreadedPipeController*>(this);
+    return fBlocksRequested - atomic_load(&self->fBlocksReleased) < fBlockCount;
+}
+
+bool ThreadedPipeController::hasPassedWaitFence() const {
+    return this->hasPassed(fWaitFence);
+}
+
+void ThreadedPipeController::waitUntil(int32_t* waiterCount,
+                                       WaitCondition condition) {
+    if ((this->*condition)()) {
+        return;
+    }
+    fCondVar.get()->lock();
+    // Announce the waiter before checking the condition. Whoever changes the
+    // condition does so before checking for waiters, so either we see the
+    // change or they see us (and then can't signal until we are waiting).
+    sk_atomic_inc(waiterCount);
+    while (!(this->*condition)()) {
+        fCondVar.get()->wait();
+    }
+    sk_atomic_dec(waiterCount);
+    fCondVar.get()->unlock();
+}
+
+void ThreadedPipeController::wake(int32_t* waiterCount) {
+    if (atomic_load(waiterCount)) {
+        fCondVar.get()->lock();
+        fCondVar.get()->broadcast();
+        fCondVar.get()->unlock();
+    }
+}
+
+void ThreadedPipeController::ReaderThreadProc(void* controller) {
+    static_cast<ThreadedPipeController*>(controller)->readerLoop();
+}
+
+void ThreadedPipeController::readerLoop() {
+    for (;;) {
+        // everything is written before fQuit is set, so check it before
+        // looking for data
+        bool quit = 0 != atomic_load(&fQuit);
+        if (fReadBlock != atomic_load(&fBlocksRequested)) {
+            Block* block = &fBlocks[fReadBlock % fBlockCount];
+            // read fClosed first: once it is set no more bytes will be
+            // written to the block
+            bool closed = 0 != atomic_load(&block->fClosed);
+            int32_t written = atomic_load(&block->fWritten);
+            if (written != fReadOffset) {
+                SkDEBUGCODE(SkGPipeReader::Status status =)
+                fReader.playback((const char*)block->fData + fReadOffset,
+                                 written - fReadOffset);
+                SkASSERT(SkGPipeReader::kError_Status != status);
+                sk_atomic_add(&fBytesRead, written - fReadOffset);
+                fReadOffset = written;
+                this->wake(&fWriterWaiting);
+                continue;
+            }
+            if (closed) {
+                fReadBlock += 1;
+                fReadOffset = 0;
+                sk_atomic_inc(&fBlocksReleased);
+                this->wake(&fWriterWaiting);
+                continue;
+            }
+        }
+        if (quit) {
+            break;
+        }
+        this->waitUntil(&fReaderWaiting,
+                        &ThreadedPipeController::readerCanProgress);
+    }
+}
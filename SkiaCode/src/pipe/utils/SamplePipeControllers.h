@@ -9,9 +9,12 @@
 #include "SkChunkAlloc.h"
 #include "SkGPipe.h"
 #include "SkTDArray.h"
+#include "SkTemplates.h"
 
 class SkCanvas;
+class SkCondVar;
 class SkMatrix;
+class SkThread;
 
 class PipeController : public SkGPipeController {
 public:
@@ -83,3 +86,114 @@ private:
     SkTDArray<PipeBlock> fBlockList;
     int fNumberOfReaders;
 };
+
+////////////////////////////////////////////////////////////////////////////////
+
+/**
+ * Plays the pipe back on a dedicated reader thread, so that the thread
+ * recording into the SkGPipeWriter can run ahead of the one rasterizing.
+ *
+ * The writer's blocks come from a fixed ring. The reader consumes each block
+ * as the writer notifies it of new data, and returns it to the ring once the
+ * writer has moved on to the next block. When all of the blocks are in use,
+ * requestBlock() waits for the reader to free one, which bounds how far ahead
+ * the writer can get. The counters shared by the two threads are updated with
+ * atomics; a thread only takes a lock when it has to sleep or wake the other.
+ *
+ * Fences let the writer find out when the reader is done with a frame, e.g.
+ *
+ *     canvas->drawXXX(...);                   // record frame N
+ *     Fence frameN = controller.insertFence();
+ *     canvas->drawXXX(...);                   // record frame N+1 while
+ *     controller.waitForFence(frameN);        // frame N is drawn
+ *
+ * Since the reader runs at the same time as the writer, record with
+ * SkGPipeWriter::kCrossProcess_Flag so that bitmaps are copied into the
+ * stream instead of being shared through the writer's bitmap heap.
+ */
+class ThreadedPipeController : public SkGPipeController {
+public:
+    ThreadedPipeController(SkCanvas* target, int blockCount = kDefaultBlockCount);
+
+    /**
+     * Waits for the reader to play back everything written so far.
+     */
+    virtual ~ThreadedPipeController();
+
+    virtual void* requestBlock(size_t minRequest, size_t* actual) SK_OVERRIDE;
+    virtual void notifyWritten(size_t bytes) SK_OVERRIDE;
+
+    typedef int32_t Fence;
+
+    /**
+     * Returns a fence that is passed once the reader has played back every
+     * command written to the controller so far.
+     */
+    Fence insertFence() const;
+
+    /**
+     * Returns true if the reader has passed the fence.
+     */
+    bool hasPassed(Fence) const;
+
+    /**
+     * Blocks the calling (writer) thread until the reader has passed the fence.
+     */
+    void waitForFence(Fence);
+
+    /**
+     * Blocks the calling thread until everything written has been played back.
+     */
+    void drain() { this->waitForFence(this->insertFence()); }
+
+private:
+    enum {
+        kDefaultBlockCount  = 8,
+        kMinBlockSize       = 32 * 1024,
+    };
+
+    struct Block {
+        void*           fData;
+        size_t          fSize;
+        // bytes the writer has made available to the reader
+        int32_t         fWritten;
+        // set once the writer has moved on to the next block
+        int32_t         fClosed;
+    };
+
+    static void ReaderThreadProc(void* controller);
+    void readerLoop();
+
+    // wait conditions
+    bool readerCanProgress() const;
+    bool hasFreeBlock() const;
+    bool hasPassedWaitFence() const;
+
+    typedef bool (ThreadedPipeController::*WaitCondition)() const;
+    void waitUntil(int32_t* waiterCount, WaitCondition);
+    void wake(int32_t* waiterCount);
+
+    SkGPipeReader           fReader;
+    SkAutoTMalloc<Block>    fBlocks;
+    const int               fBlockCount;
+
+    // writer thread only
+    Block*                  fCurrBlock;
+    Fence                   fWaitFence;
+
+    // reader thread only
+    int32_t                 fReadBlock;
+    int32_t                 fReadOffset;
+
+    // shared between the threads, only accessed atomically
+    int32_t                 fBlocksRequested;
+    int32_t                 fBlocksReleased;
+    int32_t                 fBytesWritten;
+    int32_t                 fBytesRead;
+    int32_t                 fQuit;
+    int32_t                 fReaderWaiting;
+    int32_t                 fWriterWaiting;
+
+    SkAutoTDelete<SkCondVar> fCondVar;
+    SkAutoTDelete<SkThread>  fThread;
+};
@@ -78,9 +78,10 @@ static bool isLCD(const SkScalerContext::Rec& rec) {
 
 struct SkFaceRec;
 
+// Each scaler context has its own FT_Library and FT_Face, so glyphs are
+// generated without locking. gFTMutex only guards creating a library and the
+// shared font data in gFaceRecHead.
 SK_DECLARE_STATIC_MUTEX(gFTMutex);
-static int          gFTCount;
-static FT_Library   gFTLibrary;
 static SkFaceRec*   gFaceRecHead;
 static bool         gLCDSupportValid;  // true iff |gLCDSupport| has been set.
 static bool         gLCDSupport;  // true iff LCD is supported by the runtime.
@@ -97,16 +98,19 @@ typedef FT_Error (*FT_Library_SetLcdFilterWeightsProc)(FT_Library, unsigned char
 
 /////////////////////////////////////////////////////////////////////////
 
-static bool InitFreetype() {
-    FT_Error err = FT_Init_FreeType(&gFTLibrary);
+// Returns a new library, with the LCD filter set up, or NULL on failure.
+// The caller must hold gFTMutex.
+static FT_Library NewFreetypeLibrary() {
+    FT_Library library;
+    FT_Error err = FT_Init_FreeType(&library);
     if (err) {
-        return false;
+        return NULL;
     }
 
     // Setup LCD filtering. This reduces color fringes for LCD smoothed glyphs.
 #ifdef FT_LCD_FILTER_H
     //Use light as default, as FT_LCD_FILTER_DEFAULT adds up to 0x110.
-    err = FT_Library_SetLcdFilter(gFTLibrary, FT_LCD_FILTER_LIGHT);
+    err = FT_Library_SetLcdFilter(library, FT_LCD_FILTER_LIGHT);
     if (0 == err) {
         gLCDSupport = true;
         gLCDExtra = 2; //Using a filter adds one full pixel to each side.
@@ -116,7 +120,7 @@ static bool InitFreetype() {
 
 #if defined(SK_FONTHOST_FREETYPE_RUNTIME_VERSION) && \
             SK_FONTHOST_FREETYPE_RUNTIME_VERSION > 0x020400
-        err = FT_Library_SetLcdFilterWeights(gFTLibrary, gaussianLikeWeights);
+        err = FT_Library_SetLcdFilterWeights(library, gaussianLikeWeights);
 #elif defined(SK_CAN_USE_DLOPEN) && SK_CAN_USE_DLOPEN == 1
         //The FreeType library is already loaded, so symbols are available in process.
         void* self = dlopen(NULL, RTLD_LAZY);
@@ -127,7 +131,7 @@ static bool InitFreetype() {
             dlclose(self);
 
             if (NULL != setLcdFilterWeights) {
-                err = setLcdFilterWeights(gFTLibrary, gaussianLikeWeights);
+                err = setLcdFilterWeights(library, gaussianLikeWeights);
             }
         }
 #endif
@@ -137,7 +141,7 @@ static bool InitFreetype() {
 #endif
     gLCDSupportValid = true;
 
-    return true;
+    return library;
 }
 
 class SkScalerContext_FreeType : public SkScalerContext_FreeType_Base {
@@ -163,8 +167,9 @@ protected:
     virtual SkUnichar generateGlyphToChar(uint16_t glyph);
 
 private:
-    SkFaceRec*  fFaceRec;
-    FT_Face     fFace;              // reference to shared face in gFaceRecHead
+    FT_Library  fLibrary;           // our own copy
+    SkFaceRec*  fFaceRec;           // reference to shared data in gFaceRecHead
+    FT_Face     fFace;              // our own copy, opened from fFaceRec
     FT_Size     fFTSize;            // our own copy
     SkFixed     fScaleX, fScaleY;
     FT_Matrix   fMatrix22;
@@ -184,11 +189,17 @@ private:
 
 #include "SkStream.h"
 
+/*  The font data for one fontID, shared by all the FT_Faces opened on it.
+    FT_Faces in different libraries may read it concurrently, so it is always
+    in memory: either the stream's memory base, or a copy of the stream.
+*/
 struct SkFaceRec {
     SkFaceRec*      fNext;
-    FT_Face         fFace;
-    FT_StreamRec    fFTStream;
     SkStream*       fSkStream;
+    SkAutoMalloc    fStorage;       // holds the copy, if one was needed
+    const FT_Byte*  fData;
+    size_t          fLength;
+    int             fFaceIndex;
     uint32_t        fRefCnt;
     uint32_t        fFontID;
 
@@ -234,19 +245,26 @@ SkFaceRec::SkFaceRec(SkStream* strm, uint32_t fontID)
         : fNext(NULL), fSkStream(strm), fRefCnt(1), fFontID(fontID) {
 //    SkDEBUGF(("SkFaceRec: opening %s (%p)\n", key.c_str(), strm));
 
-    sk_bzero(&fFTStream, sizeof(fFTStream));
-    fFTStream.size = fSkStream->getLength();
-    fFTStream.descriptor.pointer = fSkStream;
-    fFTStream.read  = sk_stream_read;
-    fFTStream.close = sk_stream_close;
+    fLength = strm->getLength();
+    fData = (const FT_Byte*)strm->getMemoryBase();
+    if (NULL == fData) {
+        void* storage = fStorage.reset(fLength);
+        if (!strm->rewind() || strm->read(storage, fLength) != fLength) {
+            fLength = 0;
+        }
+        fData = (const FT_Byte*)storage;
+    }
+
+    int face_index;
+    int length = SkFontHost::GetFileName(fontID, NULL, 0, &face_index);
+    fFaceIndex = length ? face_index : 0;
 }
 
-// Will return 0 on failure
-static SkFaceRec* ref_ft_face(uint32_t fontID) {
+// Will return 0 on failure. The caller must hold gFTMutex.
+static SkFaceRec* ref_face_rec(uint32_t fontID) {
     SkFaceRec* rec = gFaceRecHead;
     while (rec) {
         if (rec->fFontID == fontID) {
-            SkASSERT(rec->fFace);
             rec->fRefCnt += 1;
             return rec;
         }
@@ -261,53 +279,24 @@ static SkFaceRec* ref_ft_face(uint32_t fontID) {
 
     // this passes ownership of strm to the rec
     rec = SkNEW_ARGS(SkFaceRec, (strm, fontID));
-
-    FT_Open_Args    args;
-    memset(&args, 0, sizeof(args));
-    const void* memoryBase = strm->getMemoryBase();
-
-    if (NULL != memoryBase) {
-//printf("mmap(%s)\n", keyString.c_str());
-        args.flags = FT_OPEN_MEMORY;
-        args.memory_base = (const FT_Byte*)memoryBase;
-        args.memory_size = strm->getLength();
-    } else {
-//printf("fopen(%s)\n", keyString.c_str());
-        args.flags = FT_OPEN_STREAM;
-        args.stream = &rec->fFTStream;
-    }
-
-    int face_index;
-    int length = SkFontHost::GetFileName(fontID, NULL, 0, &face_index);
-    FT_Error err = FT_Open_Face(gFTLibrary, &args, length ? face_index : 0,
-                                &rec->fFace);
-
-    if (err) {    // bad filename, try the default font
-        fprintf(stderr, "ERROR: unable to open font '%x'\n", fontID);
-        SkDELETE(rec);
-        return 0;
-    } else {
-        SkASSERT(rec->fFace);
-        //fprintf(stderr, "Opened font '%s'\n", filename.c_str());
-        rec->fNext = gFaceRecHead;
-        gFaceRecHead = rec;
-        return rec;
-    }
+    rec->fNext = gFaceRecHead;
+    gFaceRecHead = rec;
+    return rec;
 }
 
-static void unref_ft_face(FT_Face face) {
+// The caller must hold gFTMutex.
+static void unref_face_rec(SkFaceRec* target) {
     SkFaceRec*  rec = gFaceRecHead;
     SkFaceRec*  prev = NULL;
     while (rec) {
         SkFaceRec* next = rec->fNext;
-        if (rec->fFace == face) {
+        if (rec == target) {
             if (--rec->fRefCnt == 0) {
                 if (prev) {
                     prev->fNext = next;
                 } else {
                     gFaceRecHead = next;
                 }
-                FT_Done_Face(face);
                 SkDELETE(rec);
             }
             return;
@@ -318,6 +307,25 @@ static void unref_ft_face(FT_Face face) {
     SkDEBUGFAIL("shouldn't get here, face not in list");
 }
 
+// Will return NULL on failure. The face belongs to library, and is released
+// by FT_Done_Face or when the library is.
+static FT_Face open_ft_face(FT_Library library, const SkFaceRec* rec) {
+    FT_Open_Args    args;
+    memset(&args, 0, sizeof(args));
+    args.flags = FT_OPEN_MEMORY;
+    args.memory_base = rec->fData;
+    args.memory_size = rec->fLength;
+
+    FT_Face face;
+    FT_Error err = FT_Open_Face(library, &args, rec->fFaceIndex, &face);
+    if (err) {    // bad filename, try the default font
+        fprintf(stderr, "ERROR: unable to open font '%x'\n", rec->fFontID);
+        return NULL;
+    }
+    //fprintf(stderr, "Opened font '%s'\n", filename.c_str());
+    return face;
+}
+
 ///////////////////////////////////////////////////////////////////////////
 
 // Work around for old versions of freetype.
@@ -438,17 +446,18 @@ SkAdvancedTypefaceMetrics* SkFontHost::GetAdvancedTypefaceMetrics(
     return NULL;
 #else
     SkAutoMutexAcquire ac(gFTMutex);
-    FT_Library libInit = NULL;
-    if (gFTCount == 0) {
-        if (!InitFreetype())
-            sk_throw();
-        libInit = gFTLibrary;
-    }
-    SkAutoTCallIProc<struct FT_LibraryRec_, FT_Done_FreeType> ftLib(libInit);
-    SkFaceRec* rec = ref_ft_face(fontID);
+    FT_Library library = NewFreetypeLibrary();
+    if (NULL == library)
+        sk_throw();
+    SkAutoTCallIProc<struct FT_LibraryRec_, FT_Done_FreeType> ftLib(library);
+    SkFaceRec* rec = ref_face_rec(fontID);
     if (NULL == rec)
         return NULL;
-    FT_Face face = rec->fFace;
+    FT_Face face = open_ft_face(library, rec);
+    if (NULL == face) {
+        unref_face_rec(rec);
+        return NULL;
+    }
 
     SkAdvancedTypefaceMetrics* info = new SkAdvancedTypefaceMetrics;
     info->fFontName.set(FT_Get_Postscript_Name(face));
@@ -613,7 +622,8 @@ SkAdvancedTypefaceMetrics* SkFontHost::GetAdvancedTypefaceMetrics(
     if (!canEmbed(face))
         info->fType = SkAdvancedTypefaceMetrics::kNotEmbeddable_Font;
 
-    unref_ft_face(face);
+    FT_Done_Face(face);
+    unref_face_rec(rec);
     return info;
 #endif
 }
@@ -643,8 +653,11 @@ void SkFontHost::FilterRec(SkScalerContext::Rec* rec) {
     }
 
     if (!gLCDSupportValid) {
-        InitFreetype();
-        FT_Done_FreeType(gFTLibrary);
+        SkAutoMutexAcquire ac(gFTMutex);
+        FT_Library library = NewFreetypeLibrary();
+        if (library) {
+            FT_Done_FreeType(library);
+        }
     }
 
     if (!gLCDSupport && isLCD(*rec)) {
@@ -682,12 +695,21 @@ void SkFontHost::FilterRec(SkScalerContext::Rec* rec) {
 #ifdef SK_BUILD_FOR_ANDROID
 uint32_t SkFontHost::GetUnitsPerEm(SkFontID fontID) {
     SkAutoMutexAcquire ac(gFTMutex);
-    SkFaceRec *rec = ref_ft_face(fontID);
+    FT_Library library = NewFreetypeLibrary();
+    if (NULL == library) {
+        return 0;
+    }
+    SkAutoTCallIProc<struct FT_LibraryRec_, FT_Done_FreeType> ftLib(library);
+    SkFaceRec *rec = ref_face_rec(fontID);
     uint16_t unitsPerEm = 0;
 
-    if (rec != NULL && rec->fFace != NULL) {
-        unitsPerEm = rec->fFace->units_per_EM;
-        unref_ft_face(rec->fFace);
+    if (rec != NULL) {
+        FT_Face face = open_ft_face(library, rec);
+        if (face != NULL) {
+            unitsPerEm = face->units_per_EM;
+            FT_Done_Face(face);
+        }
+        unref_face_rec(rec);
     }
 
     return (uint32_t)unitsPerEm;
@@ -696,23 +718,26 @@ uint32_t SkFontHost::GetUnitsPerEm(SkFontID fontID) {
 
 SkScalerContext_FreeType::SkScalerContext_FreeType(const SkDescriptor* desc)
         : SkScalerContext_FreeType_Base(desc) {
-    SkAutoMutexAcquire  ac(gFTMutex);
+    fFTSize = NULL;
+    fFace = NULL;
+    {
+        SkAutoMutexAcquire  ac(gFTMutex);
 
-    if (gFTCount == 0) {
-        if (!InitFreetype()) {
+        fLibrary = NewFreetypeLibrary();
+        if (NULL == fLibrary) {
             sk_throw();
         }
+        fFaceRec = ref_face_rec(fRec.fFontID);
     }
-    ++gFTCount;
 
     // load the font file
-    fFTSize = NULL;
-    fFace = NULL;
-    fFaceRec = ref_ft_face(fRec.fFontID);
     if (NULL == fFaceRec) {
         return;
     }
-    fFace = fFaceRec->fFace;
+    fFace = open_ft_face(fLibrary, fFaceRec);
+    if (NULL == fFace) {
+        return;
+    }
 
     // compute our factors from the record
 
@@ -856,20 +881,17 @@ SkScalerContext_FreeType::~SkScalerContext_FreeType() {
         FT_Done_Size(fFTSize);
     }
 
-    SkAutoMutexAcquire  ac(gFTMutex);
+    // this also releases fFace, and any size we lost track of
+    FT_Done_FreeType(fLibrary);
 
-    if (fFace != NULL) {
-        unref_ft_face(fFace);
-    }
-    if (--gFTCount == 0) {
-//        SkDEBUGF(("FT_Done_FreeType\n"));
-        FT_Done_FreeType(gFTLibrary);
-        SkDEBUGCODE(gFTLibrary = NULL;)
+    if (fFaceRec != NULL) {
+        SkAutoMutexAcquire  ac(gFTMutex);
+        unref_face_rec(fFaceRec);
     }
 }
 
-/*  We call this before each use of the fFace, since we may be sharing
-    this face with other context (at different sizes).
+/*  We call this before each use of the fFace, since generateMetrics may have
+    left a different transform on it.
 */
 FT_Error SkScalerContext_FreeType::setupSize() {
     FT_Error    err = FT_Activate_Size(fFTSize);
@@ -879,8 +901,6 @@ FT_Error SkScalerContext_FreeType::setupSize() {
                     fFaceRec->fFontID, fScaleX, fScaleY, err));
         fFTSize = NULL;
     } else {
-        // seems we need to reset this every time (not sure why, but without it
-        // I get random italics from some other fFTSize)
         FT_Set_Transform( fFace, &fMatrix22, NULL);
     }
     return err;
@@ -915,8 +935,6 @@ void SkScalerContext_FreeType::generateAdvance(SkGlyph* glyph) {
     * which are very cheap to compute with some font formats...
     */
     if (fDoLinearMetrics) {
-        SkAutoMutexAcquire  ac(gFTMutex);
-
         if (this->setupSize()) {
             glyph->zeroMetrics();
             return;
@@ -989,8 +1007,6 @@ void SkScalerContext_FreeType::updateGlyphPosIfLCD(SkGlyph* glyph) {
 }
 
 void SkScalerContext_FreeType::generateMetrics(SkGlyph* glyph) {
-    SkAutoMutexAcquire  ac(gFTMutex);
-
     glyph->fRsbDelta = 0;
     glyph->fLsbDelta = 0;
 
@@ -1047,7 +1063,7 @@ void SkScalerContext_FreeType::generateMetrics(SkGlyph* glyph) {
       case FT_GLYPH_FORMAT_BITMAP:
         if (fRec.fFlags & kEmbolden_Flag) {
             FT_GlyphSlot_Own_Bitmap(fFace->glyph);
-            FT_Bitmap_Embolden(gFTLibrary, &fFace->glyph->bitmap, kBitmapEmboldenStrength, 0);
+            FT_Bitmap_Embolden(fLibrary, &fFace->glyph->bitmap, kBitmapEmboldenStrength, 0);
         }
         glyph->fWidth   = SkToU16(fFace->glyph->bitmap.width);
         glyph->fHeight  = SkToU16(fFace->glyph->bitmap.rows);
@@ -1137,8 +1153,6 @@ void SkScalerContext_FreeType::generateMetrics(SkGlyph* glyph) {
 
 
 void SkScalerContext_FreeType::generateImage(const SkGlyph& glyph, SkMaskGamma::PreBlend* maskPreBlend) {
-    SkAutoMutexAcquire  ac(gFTMutex);
-
     FT_Error    err;
 
     if (this->setupSize()) {
@@ -1160,8 +1174,6 @@ void SkScalerContext_FreeType::generateImage(const SkGlyph& glyph, SkMaskGamma::
 
 void SkScalerContext_FreeType::generatePath(const SkGlyph& glyph,
                                             SkPath* path) {
-    SkAutoMutexAcquire  ac(gFTMutex);
-
     SkASSERT(&glyph && path);
 
     if (this->setupSize()) {
@@ -1191,8 +1203,6 @@ void SkScalerContext_FreeType::generateFontMetrics(SkPaint::FontMetrics* mx,
         return;
     }
 
-    SkAutoMutexAcquire  ac(gFTMutex);
-
     if (this->setupSize()) {
         ERROR:
         if (mx) {
@@ -16,8 +16,12 @@
 #include "SkString.h"
 #include "SkStream.h"
 #include "SkThread.h"
+#include "SkTArray.h"
 #include "SkTSearch.h"
 
+#include <sys/stat.h>
+#include <unistd.h>
+
 #ifndef SK_FONT_FILE_PREFIX
     #define SK_FONT_FILE_PREFIX      "/usr/share/fonts/truetype/msttcorefonts/"
 #endif
@@ -377,6 +381,305 @@ static bool get_name_and_style(const char path[], SkString* name,
     return false;
 }
 
+///////////////////////////////////////////////////////////////////////////////
+
+/*  Finding the family name and style of each system font means opening and
+    parsing it with FreeType, which is slow when there are many fonts. So we
+    keep what we learned in an index file, and reuse it for as long as the
+    font directory's mtime (and each font file's mtime and size) is unchanged.
+
+    The index is a FontIndexHeader, followed by fCount FontIndexEntry records,
+    followed by fStringsSize bytes of nul-terminated strings. Strings are
+    referenced by their offset from the start of the strings.
+ */
+
+#ifndef SK_FONT_INDEX_FILE
+    // if not set, the index lives in $HOME/.cache
+    #define SK_FONT_INDEX_FILE      NULL
+#endif
+
+static const uint32_t kFontIndexMagic = SkSetFourByteTag('s', 'k', 'f', 'i');
+static const uint32_t kFontIndexVersion = 1;
+
+struct FontIndexHeader {
+    uint32_t    fMagic;
+    uint32_t    fVersion;
+    int64_t     fDirMTime;      // mtime of SK_FONT_FILE_PREFIX when indexed
+    uint32_t    fCount;         // number of entries
+    uint32_t    fStringsSize;   // size of the strings, in bytes
+    uint32_t    fPrefix;        // the SK_FONT_FILE_PREFIX that was indexed
+    uint32_t    fReserved;
+};
+
+struct FontIndexEntry {
+    enum Flags {
+        kFixedWidth_Flag    = 0x01,
+        kUnusable_Flag      = 0x02,     // FreeType couldn't load it
+    };
+
+    int64_t     fMTime;
+    int64_t     fSize;
+    uint32_t    fFileName;      // relative to SK_FONT_FILE_PREFIX
+    uint32_t    fFamilyName;
+    int32_t     fFaceIndex;
+    uint8_t     fStyle;
+    uint8_t     fFlags;
+    uint16_t    fReserved;
+};
+
+// What we know about one font file, either from the index or by parsing it.
+struct FontFileInfo {
+    SkString            fFileName;
+    SkString            fFamilyName;
+    int64_t             fMTime;
+    int64_t             fSize;
+    int32_t             fFaceIndex;
+    SkTypeface::Style   fStyle;
+    bool                fIsFixedWidth;
+    bool                fIsUsable;
+};
+
+static bool get_file_times(const char path[], int64_t* mtime, int64_t* size) {
+    struct stat st;
+    if (stat(path, &st) != 0) {
+        return false;
+    }
+    *mtime = (int64_t)st.st_mtim.tv_sec * 1000000000 + st.st_mtim.tv_nsec;
+    *size = st.st_size;
+    return true;
+}
+
+static bool get_font_index_path(SkString* path) {
+    const char* indexFile = SK_FONT_INDEX_FILE;
+    if (NULL != indexFile) {
+        path->set(indexFile);
+        return true;
+    }
+    const char* home = getenv("HOME");
+    if (NULL == home || 0 == *home) {
+        return false;
+    }
+    path->set(home);
+    path->append("/.cache");
+    mkdir(path->c_str(), 0700);
+    path->append("/skia_fontindex");
+    return true;
+}
+
+static const char* index_string(const char* strings, uint32_t stringsSize,
+                                uint32_t offset) {
+    if (offset >= stringsSize ||
+            NULL == memchr(strings + offset, 0, stringsSize - offset)) {
+        return NULL;
+    }
+    return strings + offset;
+}
+
+/*  Reads the index at path into infos. Returns false if there is no index,
+    or it is invalid, or it isn't for SK_FONT_FILE_PREFIX.
+ */
+static bool read_font_index(const char path[], int64_t* dirMTime,
+                            SkTArray<FontFileInfo>* infos) {
+    SkMMAPStream stream(path);
+    const char* data = (const char*)stream.getMemoryBase();
+    size_t length = stream.getLength();
+    if (NULL == data || length < sizeof(FontIndexHeader)) {
+        return false;
+    }
+
+    const FontIndexHeader* header = (const FontIndexHeader*)data;
+    if (header->fMagic != kFontIndexMagic ||
+            header->fVersion != kFontIndexVersion ||
+            header->fCount > (length - sizeof(FontIndexHeader)) / sizeof(FontIndexEntry)) {
+        return false;
+    }
+    size_t entriesSize = header->fCount * sizeof(FontIndexEntry);
+    if (header->fStringsSize != length - sizeof(FontIndexHeader) - entriesSize) {
+        return false;
+    }
+    const FontIndexEntry* entries = (const FontIndexEntry*)(header + 1);
+    const char* strings = (const char*)(entries + header->fCount);
+    uint32_t stringsSize = header->fStringsSize;
+
+    const char* prefix = index_string(strings, stringsSize, header->fPrefix);
+    if (NULL == prefix || strcmp(prefix, SK_FONT_FILE_PREFIX)) {
+        return false;
+    }
+
+    infos->reset();
+    for (uint32_t i = 0; i < header->fCount; ++i) {
+        const FontIndexEntry& entry = entries[i];
+        const char* fileName = index_string(strings, stringsSize, entry.fFileName);
+        const char* familyName = index_string(strings, stringsSize, entry.fFamilyName);
+        if (NULL == fileName || NULL == familyName ||
+                entry.fStyle > SkTypeface::kBoldItalic) {
+            infos->reset();
+            return false;
+        }
+
+        FontFileInfo& info = infos->push_back();
+        info.fFileName.set(fileName);
+        info.fFamilyName.set(familyName);
+        info.fMTime = entry.fMTime;
+        info.fSize = entry.fSize;
+        info.fFaceIndex = entry.fFaceIndex;
+        info.fStyle = (SkTypeface::Style)entry.fStyle;
+        info.fIsFixedWidth = SkToBool(entry.fFlags & FontIndexEntry::kFixedWidth_Flag);
+        info.fIsUsable = !(entry.fFlags & FontIndexEntry::kUnusable_Flag);
+    }
+    *dirMTime = header->fDirMTime;
+    return true;
+}
+
+static uint32_t append_index_string(SkTDArray<char>* strings, const SkString& str) {
+    uint32_t offset = strings->count();
+    memcpy(strings->append(str.size() + 1), str.c_str(), str.size() + 1);
+    return offset;
+}
+
+/*  Writes infos to the index at path. The index is written to a temporary file
+    and renamed into place, so other processes never see it half written.
+ */
+static void write_font_index(const char path[], int64_t dirMTime,
+                             const SkTArray<FontFileInfo>& infos) {
+    SkTDArray<FontIndexEntry> entries;
+    SkTDArray<char> strings;
+
+    FontIndexHeader header;
+    memset(&header, 0, sizeof(header));
+    header.fMagic = kFontIndexMagic;
+    header.fVersion = kFontIndexVersion;
+    header.fDirMTime = dirMTime;
+    header.fCount = infos.count();
+    header.fPrefix = append_index_string(&strings, SkString(SK_FONT_FILE_PREFIX));
+
+    for (int i = 0; i < infos.count(); ++i) {
+        const FontFileInfo& info = infos[i];
+        FontIndexEntry* entry = entries.append();
+        memset(entry, 0, sizeof(*entry));
+        entry->fMTime = info.fMTime;
+        entry->fSize = info.fSize;
+        entry->fFileName = append_index_string(&strings, info.fFileName);
+        entry->fFamilyName = append_index_string(&strings, info.fFamilyName);
+        entry->fFaceIndex = info.fFaceIndex;
+        entry->fStyle = info.fStyle;
+        entry->fFlags = (info.fIsFixedWidth ? FontIndexEntry::kFixedWidth_Flag : 0) |
+                        (info.fIsUsable ? 0 : FontIndexEntry::kUnusable_Flag);
+    }
+    header.fStringsSize = strings.count();
+
+    SkString tmpPath;
+    tmpPath.printf("%s.%d", path, (int)getpid());
+    bool success;
+    {
+        SkFILEWStream stream(tmpPath.c_str());
+        success = stream.isValid() &&
+                  stream.write(&header, sizeof(header)) &&
+                  stream.write(entries.begin(), entries.count() * sizeof(FontIndexEntry)) &&
+                  stream.write(strings.begin(), strings.count());
+    }
+    if (!success || rename(tmpPath.c_str(), path) != 0) {
+        unlink(tmpPath.c_str());
+    }
+}
+
+// Fills out info for the font file name (in SK_FONT_FILE_PREFIX) by parsing it.
+static void parse_font_file(const char name[], int64_t mtime, int64_t size,
+                            FontFileInfo* info) {
+    SkString filename;
+    GetFullPathForSysFonts(&filename, name);
+
+    info->fFileName.set(name);
+    info->fMTime = mtime;
+    info->fSize = size;
+    info->fFaceIndex = 0;
+    info->fStyle = SkTypeface::kNormal; // avoid uninitialized warning
+    info->fIsUsable = get_name_and_style(filename.c_str(), &info->fFamilyName,
+                                         &info->fStyle, &info->fIsFixedWidth);
+    if (!info->fIsUsable) {
+        SkDebugf("------ can't load <%s> as a font\n", filename.c_str());
+        info->fFamilyName.reset();
+        info->fIsFixedWidth = false;
+    }
+}
+
+// Returns the index of the info for the file name, or -1. Starts looking at
+// *hint, since a directory is usually listed in the same order as last time.
+static int find_font_file(const SkTArray<FontFileInfo>& infos, const char name[],
+                          int* hint) {
+    const int count = infos.count();
+    for (int i = 0; i < count; ++i) {
+        int index = (*hint + i) % count;
+        if (infos[index].fFileName.equals(name)) {
+            *hint = index + 1;
+            return index;
+        }
+    }
+    return -1;
+}
+
+/*  Fills infos with every font file in SK_FONT_FILE_PREFIX, in directory
+    order. Only the files that are new or have changed since they were indexed
+    are parsed, and the index is rewritten if any were.
+ */
+static void find_system_fonts(SkTArray<FontFileInfo>* infos) {
+    int64_t dirMTime = 0, dirSize;
+    bool haveDir = get_file_times(SK_FONT_FILE_PREFIX, &dirMTime, &dirSize);
+
+    SkString indexPath;
+    bool haveIndexPath = haveDir && get_font_index_path(&indexPath);
+
+    SkTArray<FontFileInfo> indexed;
+    int64_t indexedDirMTime = 0;
+    if (!haveIndexPath ||
+            !read_font_index(indexPath.c_str(), &indexedDirMTime, &indexed)) {
+        indexed.reset();
+    }
+
+    bool changed = indexedDirMTime != dirMTime;
+    if (!changed) {
+        // no files were added or removed, but they may have been replaced
+        for (int i = 0; i < indexed.count(); ++i) {
+            FontFileInfo& info = infos->push_back(indexed[i]);
+            SkString filename;
+            GetFullPathForSysFonts(&filename, info.fFileName.c_str());
+            int64_t mtime, size;
+            if (!get_file_times(filename.c_str(), &mtime, &size)) {
+                changed = true;     // it's gone after all
+                infos->pop_back();
+            } else if (mtime != info.fMTime || size != info.fSize) {
+                changed = true;
+                parse_font_file(indexed[i].fFileName.c_str(), mtime, size, &info);
+            }
+        }
+    } else {
+        SkOSFile::Iter  iter(SK_FONT_FILE_PREFIX, ".ttf");
+        SkString        name;
+        int             hint = 0;
+
+        while (iter.next(&name, false)) {
+            SkString filename;
+            GetFullPathForSysFonts(&filename, name.c_str());
+            int64_t mtime, size;
+            if (!get_file_times(filename.c_str(), &mtime, &size)) {
+                continue;
+            }
+
+            int index = find_font_file(indexed, name.c_str(), &hint);
+            if (index >= 0 && indexed[index].fMTime == mtime &&
+                    indexed[index].fSize == size) {
+                infos->push_back(indexed[index]);
+            } else {
+                parse_font_file(name.c_str(), mtime, size, &infos->push_back());
+            }
+        }
+    }
+
+    if (changed && haveIndexPath) {
+        write_font_index(indexPath.c_str(), dirMTime, *infos);
+    }
+}
+
 // these globals are assigned (once) by load_system_fonts()
 static SkTypeface* gFallBackTypeface;
 static FamilyRec* gDefaultFamily;
@@ -389,23 +692,22 @@ static void load_system_fonts() {
         return;
     }
 
-    SkOSFile::Iter  iter(SK_FONT_FILE_PREFIX, ".ttf");
-    SkString        name;
-    int             count = 0;
-
-    while (iter.next(&name, false)) {
-        SkString filename;
-        GetFullPathForSysFonts(&filename, name.c_str());
-
-        bool isFixedWidth;
-        SkString realname;
-        SkTypeface::Style style = SkTypeface::kNormal; // avoid uninitialized warning
+    SkTArray<FontFileInfo> infos;
+    find_system_fonts(&infos);
+    int count = 0;
 
-        if (!get_name_and_style(filename.c_str(), &realname, &style, &isFixedWidth)) {
-            SkDebugf("------ can't load <%s> as a font\n", filename.c_str());
+    for (int i = 0; i < infos.count(); ++i) {
+        const FontFileInfo& info = infos[i];
+        if (!info.fIsUsable) {
             continue;
         }
 
+        SkString filename;
+        GetFullPathForSysFonts(&filename, info.fFileName.c_str());
+
+        const SkString& realname = info.fFamilyName;
+        SkTypeface::Style style = info.fStyle;
+
 //        SkDebugf("font: <%s> %d <%s>\n", realname.c_str(), style, filename.c_str());
 
         FamilyRec* family = find_familyrec(realname.c_str());
@@ -421,7 +723,7 @@ static void load_system_fonts() {
                                          true,  // system-font (cannot delete)
                                          family, // what family to join
                                          filename.c_str(),
-                                         isFixedWidth) // filename
+                                         info.fIsFixedWidth) // filename
                                         );
 
         if (NULL == family) {
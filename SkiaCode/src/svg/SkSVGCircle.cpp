@@ -10,6 +10,7 @@
 #include "SkSVGCircle.h"
 #include "SkSVGParser.h"
 #include "SkParse.h"
+#include "SkPath.h"
 #include <stdio.h>
 
 const SkSVGAttribute SkSVGCircle::gAttributes[] = {
@@ -20,6 +21,15 @@ const SkSVGAttribute SkSVGCircle::gAttributes[] = {
 
 DEFINE_SVG_INFO(Circle)
 
+bool SkSVGCircle::getPath(SkPath* path) {
+    SkScalar r = SkSVGParser::ParseScalar(f_r.c_str());
+    if (r <= 0)
+        return false;
+    path->addCircle(SkSVGParser::ParseScalar(f_cx.c_str()),
+                    SkSVGParser::ParseScalar(f_cy.c_str()), r);
+    return true;
+}
+
 void SkSVGCircle::translate(SkSVGParser& parser, bool defState) {
     parser._startElement("oval");
     INHERITED::translate(parser, defState);
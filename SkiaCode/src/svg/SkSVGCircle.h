@@ -14,6 +14,7 @@
 
 class SkSVGCircle : public SkSVGElement {
     DECLARE_SVG_INFO(Circle);
+    virtual bool getPath(SkPath* path);
 private:
     SkString f_cx;
     SkString f_cy;
@@ -31,6 +31,10 @@ SkSVGElement* SkSVGElement::getGradient() {
     return NULL;
 }
 
+bool SkSVGElement::getPath(SkPath* ) {
+    return false;
+}
+
 bool SkSVGElement::isGroupParent() {
     SkSVGElement* parent = fParent;
     while (parent) {
@@ -14,6 +14,7 @@
 #include "SkSVGTypes.h"
 #include "SkTDArray.h"
 
+class SkPath;
 class SkSVGParser;
 
 #define DECLARE_SVG_INFO(_type) \
@@ -49,6 +50,8 @@ public:
     SkSVGElement();
     virtual ~SkSVGElement();
     virtual SkSVGElement* getGradient();
+    // Set path to the element's geometry, or return false if it has none.
+    virtual bool getPath(SkPath* path);
     virtual SkSVGTypes getType() const  = 0;
     virtual bool isDef();
     virtual bool isFlushable();
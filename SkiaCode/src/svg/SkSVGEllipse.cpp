@@ -10,6 +10,7 @@
 #include "SkSVGEllipse.h"
 #include "SkSVGParser.h"
 #include "SkParse.h"
+#include "SkPath.h"
 #include <stdio.h>
 
 const SkSVGAttribute SkSVGEllipse::gAttributes[] = {
@@ -21,6 +22,19 @@ const SkSVGAttribute SkSVGEllipse::gAttributes[] = {
 
 DEFINE_SVG_INFO(Ellipse)
 
+bool SkSVGEllipse::getPath(SkPath* path) {
+    SkScalar cx = SkSVGParser::ParseScalar(f_cx.c_str());
+    SkScalar cy = SkSVGParser::ParseScalar(f_cy.c_str());
+    SkScalar rx = SkSVGParser::ParseScalar(f_rx.c_str());
+    SkScalar ry = SkSVGParser::ParseScalar(f_ry.c_str());
+    if (rx <= 0 || ry <= 0)
+        return false;
+    SkRect oval;
+    oval.set(cx - rx, cy - ry, cx + rx, cy + ry);
+    path->addOval(oval);
+    return true;
+}
+
 void SkSVGEllipse::translate(SkSVGParser& parser, bool defState) {
     parser._startElement("oval");
     INHERITED::translate(parser, defState);
@@ -14,6 +14,7 @@
 
 class SkSVGEllipse : public SkSVGElement {
     DECLARE_SVG_INFO(Ellipse);
+    virtual bool getPath(SkPath* path);
 private:
     SkString f_cx;
     SkString f_cy;
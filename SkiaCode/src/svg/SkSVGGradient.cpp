@@ -10,14 +10,72 @@
 #include "SkSVGGradient.h"
 #include "SkSVGParser.h"
 #include "SkSVGStop.h"
+#include "SkMatrix.h"
+#include "SkShader.h"
 
 SkSVGGradient::SkSVGGradient() {
 }
 
+SkShader* SkSVGGradient::createShader(SkSVGParser& , const SkRect& ) {
+    return NULL;
+}
+
+const char* SkSVGGradient::getHref() {
+    return "";
+}
+
 SkSVGElement* SkSVGGradient::getGradient() {
     return this;
 }
 
+// Finds the stops, which may belong to the gradient named by href, and returns
+// how many there are. Offsets are pinned so that they never go backwards.
+int SkSVGGradient::getStops(SkSVGParser& parser, const SkString& href,
+        SkTDArray<SkColor>* colors, SkTDArray<SkScalar>* offsets) {
+    SkSVGElement* owner = this;
+    const char* link = href.c_str();
+    for (int depth = 0; owner->fChildren.count() == 0 && depth < 8; depth++) {
+        if (link[0] != '#' || parser.getIDs().find(link + 1, &owner) == false ||
+                owner->getGradient() == NULL)
+            return 0;
+        link = ((SkSVGGradient*) owner)->getHref();
+    }
+    SkScalar last = 0;
+    for (SkSVGElement** ptr = owner->fChildren.begin(); ptr < owner->fChildren.end(); ptr++) {
+        if ((*ptr)->getType() != SkSVGType_Stop)
+            continue;
+        SkSVGStop* stop = (SkSVGStop*) *ptr;
+        SkScalar offset = SkSVGParser::ParseScalar(stop->f_offset.c_str());
+        last = SkScalarPin(offset, last, SK_Scalar1);
+        *offsets->append() = last;
+        SkColor color = SK_ColorBLACK;
+        SkSVGPaint& paint = stop->fPaintState;
+        if (paint.f_stopColor.size() > 0)
+            SkSVGParser::ParseColor(paint.f_stopColor.c_str(), &color);
+        if (paint.f_stopOpacity.size() > 0) {
+            SkScalar opacity = SkScalarPin(SkSVGParser::ParseScalar(
+                paint.f_stopOpacity.c_str()), 0, SK_Scalar1);
+            color = SkColorSetA(color,
+                SkScalarRound(SkScalarMul(opacity, SkIntToScalar(255))));
+        }
+        *colors->append() = color;
+    }
+    return colors->count();
+}
+
+// Gradient coordinates are fractions of the bounds unless the units are
+// userSpaceOnUse; in both cases the gradientTransform applies first.
+void SkSVGGradient::getShaderMatrix(const SkString& units,
+        const SkString& transform, const SkRect& bounds, SkMatrix* matrix) {
+    SkSVGParser::ParseTransform(transform.c_str(), matrix);
+    if (units.equals("userSpaceOnUse") == false) {
+        SkMatrix boxMatrix;
+        boxMatrix.setScale(bounds.width(), bounds.height());
+        boxMatrix.postTranslate(bounds.fLeft, bounds.fTop);
+        matrix->postConcat(boxMatrix);
+    }
+}
+
 bool SkSVGGradient::isDef() {
     return true;
 }
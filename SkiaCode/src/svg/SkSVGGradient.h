@@ -11,15 +11,28 @@
 #define SkSVGGradient_DEFINED
 
 #include "SkSVGElements.h"
+#include "SkColor.h"
+
+class SkMatrix;
+class SkShader;
+struct SkRect;
 
 class SkSVGGradient : public SkSVGElement {
 public:
     SkSVGGradient();
+    // Return a new shader for the gradient when it fills bounds, or NULL.
+    virtual SkShader* createShader(SkSVGParser& , const SkRect& bounds);
     virtual SkSVGElement* getGradient();
+    // Return the xlink:href of the gradient whose stops are shared, if any.
+    virtual const char* getHref();
     virtual bool isDef();
     virtual bool isNotDef();
     virtual void write(SkSVGParser& , SkString& color);
 protected:
+    int getStops(SkSVGParser& , const SkString& href,
+                 SkTDArray<SkColor>* colors, SkTDArray<SkScalar>* offsets);
+    void getShaderMatrix(const SkString& units, const SkString& transform,
+                         const SkRect& bounds, SkMatrix* matrix);
     void translate(SkSVGParser& , bool defState);
     void translateGradientUnits(SkString& units);
 private:
@@ -9,6 +9,7 @@
 
 #include "SkSVGLine.h"
 #include "SkSVGParser.h"
+#include "SkPath.h"
 
 const SkSVGAttribute SkSVGLine::gAttributes[] = {
     SVG_ATTRIBUTE(x1),
@@ -19,6 +20,14 @@ const SkSVGAttribute SkSVGLine::gAttributes[] = {
 
 DEFINE_SVG_INFO(Line)
 
+bool SkSVGLine::getPath(SkPath* path) {
+    path->moveTo(SkSVGParser::ParseScalar(f_x1.c_str()),
+                 SkSVGParser::ParseScalar(f_y1.c_str()));
+    path->lineTo(SkSVGParser::ParseScalar(f_x2.c_str()),
+                 SkSVGParser::ParseScalar(f_y2.c_str()));
+    return true;
+}
+
 void SkSVGLine::translate(SkSVGParser& parser, bool defState) {
     parser._startElement("line");
     INHERITED::translate(parser, defState);
@@ -9,18 +9,49 @@
 
 #include "SkSVGLinearGradient.h"
 #include "SkSVGParser.h"
+#include "SkGradientShader.h"
 
 const SkSVGAttribute SkSVGLinearGradient::gAttributes[] = {
     SVG_ATTRIBUTE(gradientTransform),
     SVG_ATTRIBUTE(gradientUnits),
     SVG_ATTRIBUTE(x1),
     SVG_ATTRIBUTE(x2),
+    SVG_LITERAL_ATTRIBUTE(xlink:href, f_xlink_href),
     SVG_ATTRIBUTE(y1),
     SVG_ATTRIBUTE(y2)
 };
 
 DEFINE_SVG_INFO(LinearGradient)
 
+SkShader* SkSVGLinearGradient::createShader(SkSVGParser& parser,
+        const SkRect& bounds) {
+    SkTDArray<SkColor> colors;
+    SkTDArray<SkScalar> offsets;
+    int count = getStops(parser, f_xlink_href, &colors, &offsets);
+    if (count == 0)
+        return NULL;
+    if (count == 1) {
+        *colors.append() = colors[0];
+        *offsets.append() = SK_Scalar1;
+        count = 2;
+    }
+    SkPoint pts[2];
+    pts[0].set(SkSVGParser::ParseScalar(f_x1.c_str()),
+               SkSVGParser::ParseScalar(f_y1.c_str()));
+    pts[1].set(f_x2.size() > 0 ? SkSVGParser::ParseScalar(f_x2.c_str()) : SK_Scalar1,
+               SkSVGParser::ParseScalar(f_y2.c_str()));
+    SkShader* shader = SkGradientShader::CreateLinear(pts, colors.begin(),
+        offsets.begin(), count, SkShader::kClamp_TileMode);
+    SkMatrix matrix;
+    getShaderMatrix(f_gradientUnits, f_gradientTransform, bounds, &matrix);
+    shader->setLocalMatrix(matrix);
+    return shader;
+}
+
+const char* SkSVGLinearGradient::getHref() {
+    return f_xlink_href.c_str();
+}
+
 void SkSVGLinearGradient::translate(SkSVGParser& parser, bool defState) {
     if (fMatrixID.size() == 0)
         parser.translateMatrix(f_gradientTransform, &fMatrixID);
@@ -14,11 +14,14 @@
 
 class SkSVGLinearGradient : public SkSVGGradient {
     DECLARE_SVG_INFO(LinearGradient);
+    virtual SkShader* createShader(SkSVGParser& , const SkRect& bounds);
+    virtual const char* getHref();
 private:
     SkString f_gradientTransform;
     SkString f_gradientUnits;
     SkString f_x1;
     SkString f_x2;
+    SkString f_xlink_href;
     SkString f_y1;
     SkString f_y2;
     SkString fMatrixID;
@@ -17,6 +17,7 @@ SkSVGAttribute SkSVGPaint::gAttributes[] = {
     SVG_LITERAL_ATTRIBUTE(clip-rule, f_clipRule),
     SVG_LITERAL_ATTRIBUTE(enable-background, f_enableBackground),
     SVG_ATTRIBUTE(fill),
+    SVG_LITERAL_ATTRIBUTE(fill-opacity, f_fillOpacity),
     SVG_LITERAL_ATTRIBUTE(fill-rule, f_fillRule),
     SVG_ATTRIBUTE(filter),
     SVG_LITERAL_ATTRIBUTE(font-family, f_fontFamily),
@@ -31,6 +32,7 @@ SkSVGAttribute SkSVGPaint::gAttributes[] = {
     SVG_LITERAL_ATTRIBUTE(stroke-linecap, f_strokeLinecap),
     SVG_LITERAL_ATTRIBUTE(stroke-linejoin, f_strokeLinejoin),
     SVG_LITERAL_ATTRIBUTE(stroke-miterlimit, f_strokeMiterlimit),
+    SVG_LITERAL_ATTRIBUTE(stroke-opacity, f_strokeOpacity),
     SVG_LITERAL_ATTRIBUTE(stroke-width, f_strokeWidth),
     SVG_ATTRIBUTE(style),
     SVG_ATTRIBUTE(transform)
@@ -49,6 +51,18 @@ SkString* SkSVGPaint::operator[](int index) {
     return result;
 }
 
+static const char* trim_start(const char* start, const char* end) {
+    while (start < end && *start > 0 && *start <= ' ')
+        start++;
+    return start;
+}
+
+static const char* trim_end(const char* start, const char* end) {
+    while (end > start && end[-1] > 0 && end[-1] <= ' ')
+        end--;
+    return end;
+}
+
 void SkSVGPaint::addAttribute(SkSVGParser& parser, int attrIndex,
         const char* attrValue, size_t attrLength) {
     SkString* attr = (*this)[attrIndex];
@@ -57,6 +71,7 @@ void SkSVGPaint::addAttribute(SkSVGParser& parser, int attrIndex,
         case kClipRule:
         case kEnableBackground:
         case kFill:
+        case kFillOpacity:
         case kFillRule:
         case kFilter:
         case kFontFamily:
@@ -71,26 +86,30 @@ void SkSVGPaint::addAttribute(SkSVGParser& parser, int attrIndex,
         case kStroke_Linecap:
         case kStroke_Linejoin:
         case kStroke_Miterlimit:
+        case kStroke_Opacity:
         case kStroke_Width:
         case kTransform:
             attr->set(attrValue, attrLength);
             return;
         case kStyle: {
-            // iterate through colon / semi-colon delimited pairs
-            int pairs = SkParse::Count(attrValue, ';');
+            // iterate through colon / semi-colon delimited pairs, skipping
+            // properties we don't know
             const char* attrEnd = attrValue + attrLength;
-            do {
-                const char* end = strchr(attrValue, ';');
+            while (attrValue < attrEnd) {
+                const char* end = (const char*) memchr(attrValue, ';', attrEnd - attrValue);
                 if (end == NULL)
                     end = attrEnd;
-                const char* delimiter = strchr(attrValue, ':');
-                SkASSERT(delimiter != 0 && delimiter < end);
-                int index = parser.findAttribute(this, attrValue, (int) (delimiter - attrValue), true);
-                SkASSERT(index >= 0);
-                delimiter++;
-                addAttribute(parser, index, delimiter, (int) (end - delimiter));
+                const char* delimiter = (const char*) memchr(attrValue, ':', end - attrValue);
+                if (delimiter != NULL) {
+                    const char* name = trim_start(attrValue, delimiter);
+                    int index = parser.findAttribute(this, name,
+                        (int) (trim_end(name, delimiter) - name), true);
+                    const char* value = trim_start(delimiter + 1, end);
+                    if (index >= 0 && index != kStyle)
+                        addAttribute(parser, index, value, (int) (trim_end(value, end) - value));
+                }
                 attrValue = end + 1;
-            } while (--pairs);
+            }
             return;
             }
         default:
@@ -138,7 +157,8 @@ bool SkSVGPaint::flush(SkSVGParser& parser, bool isFlushable, bool isDef) {
         memset(changed, 0, sizeof(changed));
         for (index = kInitial + 1; index < kTerminal; index++) {
             if (index == kTransform || index == kClipPath || index == kStopColor || index == kStopOpacity ||
-                    index == kClipRule || index == kFillRule)
+                    index == kClipRule || index == kFillRule || index == kFillOpacity ||
+                    index == kStroke_Opacity)
                 continue;
             SkString* lastAttr = lastState[index];
             SkString* currentAttr = current[index];
@@ -288,6 +308,7 @@ bool SkSVGPaint::writeChangedAttributes(SkSVGParser& parser,
                 if (topAttr->equals("none") == false && lastAttr->equals("none") == true)
                     parser._addAttribute("stroke", "false");
                 goto fillStrokeAttrCommon;
+            case kFillOpacity:
             case kFillRule:
             case kFilter:
             case kFontFamily:
@@ -337,6 +358,8 @@ fillStrokeAttrCommon:
             case kStroke_Miterlimit:
                 parser._addAttributeLen("strokeMiter", attrValue, attrLength);
                 break;
+            case kStroke_Opacity:
+                break;
             case kStroke_Width:
                 parser._addAttributeLen("strokeWidth", attrValue, attrLength);
             case kStyle:
@@ -370,6 +393,7 @@ bool SkSVGPaint::writeChangedElements(SkSVGParser& parser,
                 break;
             case kFill:
                 goto addColor;
+            case kFillOpacity:
             case kFillRule:
             case kFilter:
                 break;
@@ -431,6 +455,7 @@ addColor:
             case kStroke_Linecap:
             case kStroke_Linejoin:
             case kStroke_Miterlimit:
+            case kStroke_Opacity:
             case kStroke_Width:
             case kStyle:
             case kTransform:
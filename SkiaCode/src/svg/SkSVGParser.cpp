@@ -30,6 +30,7 @@
 #include "SkSVGSymbol.h"
 #include "SkSVGText.h"
 #include "SkSVGUse.h"
+#include "SkParse.h"
 #include "SkTSearch.h"
 #include <stdio.h>
 
@@ -38,7 +39,8 @@ static int gGeneratedMatrixID = 0;
 SkSVGParser::SkSVGParser(SkXMLParserError* errHandler) :
     SkXMLParser(errHandler),
     fHead(&fEmptyPaint), fIDs(256),
-        fXMLWriter(&fStream), fCurrElement(NULL), fInSVG(false), fSuppressPaint(false) {
+        fXMLWriter(&fStream), fCurrElement(NULL), fIgnoreDepth(0), fInSVG(false),
+        fSuppressPaint(false) {
     fLastTransform.reset();
     fEmptyPaint.f_fill.set("black");
     fEmptyPaint.f_stroke.set("none");
@@ -55,6 +57,7 @@ SkSVGParser::SkSVGParser(SkXMLParserError* errHandler) :
 }
 
 SkSVGParser::~SkSVGParser() {
+    Delete(fChildren);
 }
 
 void SkSVGParser::Delete(SkTDArray<SkSVGElement*>& fChildren) {
@@ -151,9 +154,7 @@ bool SkSVGParser::onAddAttribute(const char name[], const char value[]) {
 
 bool SkSVGParser::onAddAttributeLen(const char name[], const char value[], size_t len) {
     if (fCurrElement == NULL)    // this signals we should ignore attributes for this element
-        return true;
-    if (fCurrElement->fIsDef == false && fCurrElement->fIsNotDef == false)
-        return false; // also an ignored element
+        return false;
     size_t nameLen = strlen(name);
     int attrIndex = findAttribute(fCurrElement, name, nameLen, false);
     if (attrIndex == -1) {
@@ -166,15 +167,18 @@ bool SkSVGParser::onAddAttributeLen(const char name[], const char value[], size_
             fCurrElement->f_id.set(value, len);
             return false;
         }
-        if (strchr(name, ':') != 0) // part of a different namespace
-            return false;
+        // ignore attributes we don't know, including other namespaces'
+        return false;
     }
-    SkASSERT(attrIndex >= 0);
     fCurrElement->addAttribute(*this, attrIndex, value, len);
     return false;
 }
 
 bool SkSVGParser::onEndElement(const char elem[]) {
+    if (fIgnoreDepth > 0) {
+        fIgnoreDepth--;
+        return false;
+    }
     int parentIndex = fParents.count() - 1;
     if (parentIndex >= 0) {
         SkSVGElement* element = fParents[parentIndex];
@@ -193,9 +197,13 @@ bool SkSVGParser::onStartElementLen(const char name[], size_t len) {
         fInSVG = true;
     } else if (fInSVG == false)
         return false;
+    // skip elements in other namespaces, along with everything inside them
     const char* nextColon = strchr(name, ':');
-    if (nextColon && (size_t)(nextColon - name) < len)
+    if (fIgnoreDepth > 0 || (nextColon && (size_t)(nextColon - name) < len)) {
+        fIgnoreDepth++;
+        fCurrElement = NULL;
         return false;
+    }
     SkSVGTypes type = GetType(name, len);
 //    SkASSERT(type >= 0);
     if (type < 0) {
@@ -217,7 +225,7 @@ bool SkSVGParser::onStartElementLen(const char name[], size_t len) {
 }
 
 bool SkSVGParser::onText(const char text[], int len) {
-    if (fInSVG == false)
+    if (fInSVG == false || fCurrElement == NULL)
         return false;
     SkSVGTypes type = fCurrElement->getType();
     if (type != SkSVGType_Text && type != SkSVGType_Tspan)
@@ -353,6 +361,97 @@ undoLastComma:
         valCh[index] = ' ';
 }
 
+SkScalar SkSVGParser::ParseScalar(const char str[]) {
+    SkScalar value = 0;
+    const char* end = SkParse::FindScalar(str, &value);
+    if (end && *end == '%')
+        value = SkScalarDiv(value, SkIntToScalar(100));
+    return value;
+}
+
+bool SkSVGParser::ParseColor(const char str[], SkColor* color) {
+    while (is_whitespace(*str))
+        str++;
+    if (strncmp(str, "rgb(", 4) == 0) {
+        str += 4;
+        unsigned rgb[3];
+        for (int index = 0; index < 3; index++) {
+            SkScalar value;
+            while (is_whitespace(*str) || *str == ',')
+                str++;
+            str = SkParse::FindScalar(str, &value);
+            if (str == NULL)
+                return false;
+            if (*str == '%')
+                value = SkScalarMulDiv(value, SkIntToScalar(255), SkIntToScalar(100));
+            rgb[index] = SkScalarRound(SkScalarPin(value, 0, SkIntToScalar(255)));
+        }
+        *color = SkColorSetRGB(rgb[0], rgb[1], rgb[2]);
+        return true;
+    }
+    *color = SK_ColorBLACK;
+    return SkParse::FindColor(str, color) != NULL;
+}
+
+void SkSVGParser::ParseTransform(const char str[], SkMatrix* matrix) {
+    matrix->reset();
+    for (;;) {
+        while (is_whitespace(*str) || *str == ',')
+            str++;
+        const char* name = str;
+        while (*str && *str != '(')
+            str++;
+        if (*str == '\0')
+            return;
+        size_t nameLen = str - name;
+        while (nameLen > 0 && is_whitespace(name[nameLen - 1]))
+            nameLen--;
+        str++;  // skip '('
+        SkScalar v[6];
+        int count = 0;
+        for (;;) {
+            while (is_whitespace(*str) || *str == ',')
+                str++;
+            const char* end = count < 6 ? SkParse::FindScalar(str, &v[count]) : NULL;
+            if (end == NULL)
+                break;
+            str = end;
+            count++;
+        }
+        while (*str && *str != ')')
+            str++;
+        if (*str == ')')
+            str++;
+
+        SkMatrix m;
+        if (nameLen == 6 && strncmp(name, "matrix", 6) == 0 && count == 6) {
+            m.setAll(v[0], v[2], v[4], v[1], v[3], v[5],
+                     0, 0, SkScalarToPersp(SK_Scalar1));
+        } else if (nameLen == 9 && strncmp(name, "translate", 9) == 0 && count >= 1) {
+            m.setTranslate(v[0], count > 1 ? v[1] : 0);
+        } else if (nameLen == 5 && strncmp(name, "scale", 5) == 0 && count >= 1) {
+            m.setScale(v[0], count > 1 ? v[1] : v[0]);
+        } else if (nameLen == 6 && strncmp(name, "rotate", 6) == 0 && count >= 1) {
+            if (count >= 3)
+                m.setRotate(v[0], v[1], v[2]);
+            else
+                m.setRotate(v[0]);
+        } else if (nameLen == 5 && (strncmp(name, "skewX", 5) == 0 ||
+                strncmp(name, "skewY", 5) == 0) && count >= 1) {
+            SkScalar cos;
+            SkScalar sin = SkScalarSinCos(SkDegreesToRadians(v[0]), &cos);
+            SkScalar tan = SkScalarDiv(sin, cos);
+            if (name[4] == 'X')
+                m.setSkew(tan, 0);
+            else
+                m.setSkew(0, tan);
+        } else {
+            continue;   // ignore what we don't understand
+        }
+        matrix->preConcat(m);
+    }
+}
+
 #define CASE_NEW(type) case SkSVGType_##type : created = new SkSVG##type(); break
 
 SkSVGElement* SkSVGParser::CreateElement(SkSVGTypes type, SkSVGElement* parent) {
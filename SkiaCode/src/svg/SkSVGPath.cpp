@@ -9,6 +9,7 @@
 
 #include "SkSVGPath.h"
 #include "SkSVGParser.h"
+#include "SkParsePath.h"
 
 const SkSVGAttribute SkSVGPath::gAttributes[] = {
     SVG_ATTRIBUTE(d)
@@ -16,6 +17,10 @@ const SkSVGAttribute SkSVGPath::gAttributes[] = {
 
 DEFINE_SVG_INFO(Path)
 
+bool SkSVGPath::getPath(SkPath* path) {
+    return SkParsePath::FromSVGString(f_d.c_str(), path);
+}
+
 void SkSVGPath::translate(SkSVGParser& parser, bool defState) {
     parser._startElement("path");
     INHERITED::translate(parser, defState);
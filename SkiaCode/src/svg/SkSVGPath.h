@@ -14,6 +14,7 @@
 
 class SkSVGPath : public SkSVGElement {
     DECLARE_SVG_INFO(Path);
+    virtual bool getPath(SkPath* path);
 private:
     SkString f_d;
     typedef SkSVGElement INHERITED;
@@ -0,0 +1,473 @@
+/*
+ * Copyright 2012 Google Inc.
+ *
+ * Use of this source code is governed by a BSD-style license that can be
+ * found in the LICENSE file.
+ */
+
+#include "SkSVGPicture.h"
+#include "SkCanvas.h"
+#include "SkDashPathEffect.h"
+#include "SkParse.h"
+#include "SkPicture.h"
+#include "SkSVGGradient.h"
+#include "SkSVGParser.h"
+#include "SkSVGSVG.h"
+#include "SkSVGText.h"
+#include "SkSVGUse.h"
+#include "SkShader.h"
+#include "SkStream.h"
+#include "SkTArray.h"
+
+// Size used when the document gives neither width and height nor a viewBox.
+#define DEFAULT_SIZE    100
+// Limit on nested <use> references, which may otherwise loop.
+#define MAX_USE_DEPTH   16
+
+static bool is_ws(char ch) {
+    return ch > 0 && ch <= ' ';
+}
+
+static SkScalar parse_opacity(const SkString& value) {
+    if (value.size() == 0)
+        return SK_Scalar1;
+    return SkScalarPin(SkSVGParser::ParseScalar(value.c_str()), 0, SK_Scalar1);
+}
+
+static bool parse_transform(const SkString& value, SkMatrix* matrix) {
+    if (value.size() == 0)
+        return false;
+    SkSVGParser::ParseTransform(value.c_str(), matrix);
+    return true;
+}
+
+// The walk is a friend of the parser and of the elements it needs to look
+// inside, so it is a class rather than a set of static functions.
+class SkSVGPictureBuilder {
+public:
+    SkSVGPictureBuilder(SkSVGParser& parser) : fParser(parser), fUseDepth(0) {}
+
+    bool getSize(int* width, int* height, SkMatrix* viewMatrix);
+    void draw(SkCanvas* canvas);
+
+private:
+    void clip(SkCanvas* , const SkString& clipPath);
+    void drawChildren(SkCanvas* , SkSVGElement* );
+    void drawElement(SkCanvas* , SkSVGElement* );
+    void drawShape(SkCanvas* , SkSVGElement* , SkScalar opacity);
+    void drawText(SkCanvas* , SkSVGText* , SkScalar opacity);
+    void drawUse(SkCanvas* , SkSVGUse* );
+    SkSVGElement* find(const char ref[]);
+    const SkString* inherited(SkSVGPaint::Field );
+    bool setupPaint(SkPaint* , bool stroke, const SkRect& bounds,
+                    SkScalar opacity);
+
+    SkSVGParser& fParser;
+    SkTDArray<SkSVGPaint*> fPaints;     // paint states of the elements being drawn
+    int fUseDepth;
+};
+
+bool SkSVGPictureBuilder::getSize(int* width, int* height, SkMatrix* viewMatrix) {
+    viewMatrix->reset();
+    *width = *height = DEFAULT_SIZE;
+    if (fParser.fChildren.count() == 0)
+        return false;
+    SkSVGElement* root = fParser.fChildren[0];
+    if (root->getType() != SkSVGType_SVG)
+        return true;
+    SkSVGSVG* svg = (SkSVGSVG*) root;
+    SkScalar box[4];
+    bool hasBox = svg->f_viewBox.size() > 0 &&
+        SkParse::FindScalars(svg->f_viewBox.c_str(), box, 4) != NULL &&
+        box[2] > 0 && box[3] > 0;
+    SkScalar w = hasBox ? box[2] : SkIntToScalar(DEFAULT_SIZE);
+    SkScalar h = hasBox ? box[3] : SkIntToScalar(DEFAULT_SIZE);
+    // percentages are of a viewport we don't have, so treat them as missing
+    if (svg->f_width.size() > 0 && strchr(svg->f_width.c_str(), '%') == NULL)
+        w = SkSVGParser::ParseScalar(svg->f_width.c_str());
+    if (svg->f_height.size() > 0 && strchr(svg->f_height.c_str(), '%') == NULL)
+        h = SkSVGParser::ParseScalar(svg->f_height.c_str());
+    *width = SkScalarCeil(w);
+    *height = SkScalarCeil(h);
+    if (*width <= 0 || *height <= 0)
+        return false;
+    if (hasBox) {
+        // preserveAspectRatio="xMidYMid meet"
+        SkScalar scale = SkMinScalar(SkScalarDiv(w, box[2]), SkScalarDiv(h, box[3]));
+        viewMatrix->setTranslate(-box[0], -box[1]);
+        viewMatrix->postScale(scale, scale);
+        viewMatrix->postTranslate(SkScalarHalf(w - SkScalarMul(box[2], scale)),
+                                  SkScalarHalf(h - SkScalarMul(box[3], scale)));
+    }
+    return true;
+}
+
+void SkSVGPictureBuilder::draw(SkCanvas* canvas) {
+    // the root <svg> is never a parent, so its children follow it in the list
+    for (SkSVGElement** ptr = fParser.fChildren.begin(); ptr < fParser.fChildren.end(); ptr++) {
+        if ((*ptr)->getType() == SkSVGType_SVG) {
+            if (fPaints.count() == 0)
+                *fPaints.append() = &(*ptr)->fPaintState;
+            continue;
+        }
+        this->drawElement(canvas, *ptr);
+    }
+    fPaints.reset();
+}
+
+// Paths of differing fill types can't share one path, and there is no path
+// op to union them, so the children are unioned as regions scaled up by this,
+// and the outline of the union is clipped to.
+#define CLIP_REGION_SCALE   16
+// Limit on the scaled coordinates, well within what the scan converter takes.
+#define MAX_CLIP_REGION_COORD   (1 << 14)
+
+static void union_clip_paths(const SkTArray<SkPath>& paths, SkPath* result) {
+    SkRect bounds;
+    bounds.setEmpty();
+    for (int index = 0; index < paths.count(); index++)
+        bounds.join(paths[index].getBounds());
+    result->reset();
+    if (bounds.isEmpty())
+        return;
+    SkScalar extent = SkMaxScalar(SkMaxScalar(SkScalarAbs(bounds.fLeft),
+                                              SkScalarAbs(bounds.fRight)),
+                                  SkMaxScalar(SkScalarAbs(bounds.fTop),
+                                              SkScalarAbs(bounds.fBottom)));
+    SkScalar scale = SkIntToScalar(CLIP_REGION_SCALE);
+    if (SkScalarMul(extent, scale) > SkIntToScalar(MAX_CLIP_REGION_COORD))
+        scale = SkScalarDiv(SkIntToScalar(MAX_CLIP_REGION_COORD), extent);
+    SkMatrix matrix;
+    matrix.setScale(scale, scale);
+    SkRect scaledBounds;
+    matrix.mapRect(&scaledBounds, bounds);
+    SkIRect area;
+    scaledBounds.roundOut(&area);
+    area.outset(1, 1);
+    SkRegion areaRgn(area);
+    SkRegion rgn;
+    for (int index = 0; index < paths.count(); index++) {
+        SkPath scaled;
+        paths[index].transform(matrix, &scaled);
+        SkRegion childRgn;
+        childRgn.setPath(scaled, areaRgn);
+        rgn.op(childRgn, SkRegion::kUnion_Op);
+    }
+    rgn.getBoundaryPath(result);
+    matrix.setScale(SkScalarInvert(scale), SkScalarInvert(scale));
+    result->transform(matrix);
+}
+
+// Intersects the clip with the union of the children of the <clipPath>
+// referenced by url(#id), each filled with its own clip-rule.
+void SkSVGPictureBuilder::clip(SkCanvas* canvas, const SkString& clipPath) {
+    SkSVGElement* clipElement = this->find(clipPath.c_str());
+    if (clipElement == NULL || clipElement->getType() != SkSVGType_ClipPath)
+        return;
+    SkTArray<SkPath> paths;
+    bool allWinding = true;
+    SkSVGElement** end = clipElement->fChildren.end();
+    for (SkSVGElement** ptr = clipElement->fChildren.begin(); ptr < end; ptr++) {
+        SkSVGElement* child = *ptr;
+        SkMatrix matrix;
+        if (parse_transform(child->fPaintState.f_transform, &matrix) == false)
+            matrix.reset();
+        if (child->getType() == SkSVGType_Use) {
+            SkSVGUse* use = (SkSVGUse*) child;
+            matrix.preTranslate(SkSVGParser::ParseScalar(use->f_x.c_str()),
+                                SkSVGParser::ParseScalar(use->f_y.c_str()));
+            child = this->find(use->f_xlink_href.c_str());
+            if (child == NULL)
+                continue;
+            SkMatrix childMatrix;
+            if (parse_transform(child->fPaintState.f_transform, &childMatrix))
+                matrix.preConcat(childMatrix);
+        }
+        SkPath path;
+        if (child->getPath(&path) == false)
+            continue;
+        if ((*ptr)->fPaintState.f_clipRule.equals("evenodd") ||
+                child->fPaintState.f_clipRule.equals("evenodd")) {
+            path.setFillType(SkPath::kEvenOdd_FillType);
+            allWinding = false;
+        }
+        path.transform(matrix);
+        paths.push_back(path);
+    }
+    SkPath clip;
+    if (paths.count() == 1) {
+        clip = paths[0];
+    } else if (allWinding) {
+        // wind every child the same way, so that where they overlap they
+        // add up rather than cancel
+        for (int index = 0; index < paths.count(); index++) {
+            if (paths[index].cheapIsDirection(SkPath::kCCW_Direction))
+                clip.reverseAddPath(paths[index]);
+            else
+                clip.addPath(paths[index]);
+        }
+    } else {
+        union_clip_paths(paths, &clip);
+    }
+    canvas->clipPath(clip, SkRegion::kIntersect_Op, true);
+}
+
+void SkSVGPictureBuilder::drawChildren(SkCanvas* canvas, SkSVGElement* element) {
+    for (SkSVGElement** ptr = element->fChildren.begin(); ptr < element->fChildren.end(); ptr++)
+        this->drawElement(canvas, *ptr);
+}
+
+void SkSVGPictureBuilder::drawElement(SkCanvas* canvas, SkSVGElement* element) {
+    SkSVGTypes type = element->getType();
+    switch (type) {
+        // definitions, drawn only when referenced, and what isn't supported
+        case SkSVGType_ClipPath:
+        case SkSVGType_Defs:
+        case SkSVGType_FeColorMatrix:
+        case SkSVGType_Filter:
+        case SkSVGType_Image:
+        case SkSVGType_LinearGradient:
+        case SkSVGType_Mask:
+        case SkSVGType_Metadata:
+        case SkSVGType_RadialGradient:
+        case SkSVGType_Stop:
+        case SkSVGType_SVG:
+        case SkSVGType_Symbol:
+            return;
+        default:
+            break;
+    }
+    SkSVGPaint& paintState = element->fPaintState;
+    *fPaints.append() = &paintState;
+    int saveCount = canvas->save();
+    SkMatrix matrix;
+    if (parse_transform(paintState.f_transform, &matrix))
+        canvas->concat(matrix);
+    if (paintState.f_clipPath.size() > 0)
+        this->clip(canvas, paintState.f_clipPath);
+    SkScalar opacity = parse_opacity(paintState.f_opacity);
+    if (element->isGroup() || type == SkSVGType_Use) {
+        // group opacity applies to the children as a whole
+        if (opacity < SK_Scalar1)
+            canvas->saveLayerAlpha(NULL,
+                SkScalarRound(SkScalarMul(opacity, SkIntToScalar(255))));
+        if (type == SkSVGType_Use)
+            this->drawUse(canvas, (SkSVGUse*) element);
+        else
+            this->drawChildren(canvas, element);
+    } else if (type == SkSVGType_Text || type == SkSVGType_Tspan) {
+        this->drawText(canvas, (SkSVGText*) element, opacity);
+    } else {
+        this->drawShape(canvas, element, opacity);
+    }
+    canvas->restoreToCount(saveCount);
+    fPaints.pop();
+}
+
+void SkSVGPictureBuilder::drawShape(SkCanvas* canvas, SkSVGElement* element,
+                                    SkScalar opacity) {
+    SkPath path;
+    if (element->getPath(&path) == false)
+        return;
+    SkSVGTypes type = element->getType();
+    // polylines and polygons have a fill-rule of their own
+    const SkString* fillRule = this->inherited(SkSVGPaint::kFillRule);
+    if (fillRule && fillRule->equals("evenodd") &&
+            type != SkSVGType_Polyline && type != SkSVGType_Polygon)
+        path.setFillType(SkPath::kEvenOdd_FillType);
+    SkPaint paint;
+    if (this->setupPaint(&paint, false, path.getBounds(), opacity))
+        canvas->drawPath(path, paint);
+    if (this->setupPaint(&paint, true, path.getBounds(), opacity))
+        canvas->drawPath(path, paint);
+}
+
+void SkSVGPictureBuilder::drawText(SkCanvas* canvas, SkSVGText* text,
+                                   SkScalar opacity) {
+    SkScalar x = SkSVGParser::ParseScalar(text->f_x.c_str());
+    SkScalar y = SkSVGParser::ParseScalar(text->f_y.c_str());
+    if (text->getType() == SkSVGType_Tspan && text->fParent &&
+            text->fParent->getType() == SkSVGType_Text) {
+        SkSVGText* parent = (SkSVGText*) text->fParent;
+        if (text->f_x.size() == 0)
+            x = SkSVGParser::ParseScalar(parent->f_x.c_str());
+        if (text->f_y.size() == 0)
+            y = SkSVGParser::ParseScalar(parent->f_y.c_str());
+    }
+    const SkString* fontSize = this->inherited(SkSVGPaint::kFontSize);
+    SkScalar textSize = fontSize ? SkSVGParser::ParseScalar(fontSize->c_str())
+                                 : SkIntToScalar(16);
+    const char* str = text->f_text.c_str();
+    size_t len = text->f_text.size();
+    while (len > 0 && is_ws(*str)) {
+        str++;
+        len--;
+    }
+    while (len > 0 && is_ws(str[len - 1]))
+        len--;
+    if (len > 0 && textSize > 0) {
+        SkPaint paint;
+        paint.setTextSize(textSize);
+        SkRect bounds;
+        paint.measureText(str, len, &bounds);
+        bounds.offset(x, y);
+        for (int stroke = 0; stroke < 2; stroke++) {
+            if (this->setupPaint(&paint, stroke != 0, bounds, opacity)) {
+                paint.setTextSize(textSize);
+                canvas->drawText(str, len, x, y, paint);
+            }
+        }
+    }
+    this->drawChildren(canvas, text);
+}
+
+void SkSVGPictureBuilder::drawUse(SkCanvas* canvas, SkSVGUse* use) {
+    SkSVGElement* ref = this->find(use->f_xlink_href.c_str());
+    if (ref == NULL || fUseDepth >= MAX_USE_DEPTH)
+        return;
+    fUseDepth++;
+    canvas->translate(SkSVGParser::ParseScalar(use->f_x.c_str()),
+                      SkSVGParser::ParseScalar(use->f_y.c_str()));
+    if (ref->getType() == SkSVGType_Symbol) {
+        *fPaints.append() = &ref->fPaintState;
+        this->drawChildren(canvas, ref);
+        fPaints.pop();
+    } else {
+        this->drawElement(canvas, ref);
+    }
+    fUseDepth--;
+}
+
+// Looks up "#id" or "url(#id)".
+SkSVGElement* SkSVGPictureBuilder::find(const char ref[]) {
+    const char* start = strchr(ref, '#');
+    if (start == NULL)
+        return NULL;
+    start++;
+    const char* end = start;
+    while (*end && *end != ')' && *end != '\'' && *end != '"' && !is_ws(*end))
+        end++;
+    SkSVGElement* element;
+    if (fParser.getIDs().find(start, end - start, &element) == false)
+        return NULL;
+    return element;
+}
+
+const SkString* SkSVGPictureBuilder::inherited(SkSVGPaint::Field field) {
+    for (int index = fPaints.count() - 1; index >= 0; index--) {
+        const SkString* value = (*fPaints[index])[field];
+        if (value->size() > 0 && value->equals("inherit") == false)
+            return value;
+    }
+    return NULL;
+}
+
+bool SkSVGPictureBuilder::setupPaint(SkPaint* paint, bool stroke,
+                                     const SkRect& bounds, SkScalar opacity) {
+    paint->reset();
+    paint->setAntiAlias(true);
+    SkColor color = SK_ColorBLACK;
+    const SkString* value = this->inherited(stroke ? SkSVGPaint::kStroke :
+                                                     SkSVGPaint::kFill);
+    if (value == NULL) {
+        if (stroke)     // stroke defaults to none, fill to black
+            return false;
+    } else if (value->equals("none")) {
+        return false;
+    } else if (value->startsWith("url(")) {
+        SkSVGElement* ref = this->find(value->c_str());
+        SkSVGElement* gradient = ref ? ref->getGradient() : NULL;
+        if (gradient == NULL)
+            return false;
+        SkShader* shader = ((SkSVGGradient*) gradient)->createShader(fParser, bounds);
+        if (shader == NULL)
+            return false;
+        paint->setShader(shader)->unref();
+    } else if (SkSVGParser::ParseColor(value->c_str(), &color) == false) {
+        return false;
+    }
+    value = this->inherited(stroke ? SkSVGPaint::kStroke_Opacity :
+                                     SkSVGPaint::kFillOpacity);
+    if (value)
+        opacity = SkScalarMul(opacity, parse_opacity(*value));
+    paint->setColor(color);
+    paint->setAlpha(SkScalarRound(SkScalarMul(SkIntToScalar(SkColorGetA(color)),
+                                              opacity)));
+    if (stroke == false)
+        return true;
+
+    paint->setStyle(SkPaint::kStroke_Style);
+    value = this->inherited(SkSVGPaint::kStroke_Width);
+    SkScalar width = value ? SkSVGParser::ParseScalar(value->c_str()) : SK_Scalar1;
+    if (width <= 0)
+        return false;
+    paint->setStrokeWidth(width);
+    value = this->inherited(SkSVGPaint::kStroke_Linecap);
+    if (value && value->equals("round"))
+        paint->setStrokeCap(SkPaint::kRound_Cap);
+    else if (value && value->equals("square"))
+        paint->setStrokeCap(SkPaint::kSquare_Cap);
+    value = this->inherited(SkSVGPaint::kStroke_Linejoin);
+    if (value && value->equals("round"))
+        paint->setStrokeJoin(SkPaint::kRound_Join);
+    else if (value && value->equals("bevel"))
+        paint->setStrokeJoin(SkPaint::kBevel_Join);
+    value = this->inherited(SkSVGPaint::kStroke_Miterlimit);
+    paint->setStrokeMiter(value ? SkSVGParser::ParseScalar(value->c_str())
+                                : SkIntToScalar(4));
+    value = this->inherited(SkSVGPaint::kStroke_Dasharray);
+    if (value && value->equals("none") == false) {
+        int count = SkParse::Count(value->c_str());
+        if (count > 0) {
+            // an odd list is repeated to make it even
+            SkAutoTMalloc<SkScalar> intervals(count * 2);
+            if (SkParse::FindScalars(value->c_str(), intervals.get(), count)) {
+                SkScalar sum = 0;
+                for (int index = 0; index < count; index++) {
+                    intervals[count + index] = intervals[index];
+                    sum += intervals[index];
+                }
+                if (sum > 0)
+                    paint->setPathEffect(SkNEW_ARGS(SkDashPathEffect,
+                        (intervals.get(), count & 1 ? count * 2 : count, 0)))->unref();
+            }
+        }
+    }
+    return true;
+}
+
+///////////////////////////////////////////////////////////////////////////////
+
+bool SkSVGPicture::Record(SkSVGParser& parser, SkPicture* picture) {
+    SkSVGPictureBuilder builder(parser);
+    int width, height;
+    SkMatrix viewMatrix;
+    if (builder.getSize(&width, &height, &viewMatrix) == false)
+        return false;
+    SkCanvas* canvas = picture->beginRecording(width, height);
+    canvas->concat(viewMatrix);
+    builder.draw(canvas);
+    picture->endRecording();
+    return true;
+}
+
+bool SkSVGPicture::DecodeMemory(const void* data, size_t length, SkPicture* picture) {
+    SkSVGParser parser;
+    if (parser.parse((const char*) data, length) == false)
+        return false;
+    return Record(parser, picture);
+}
+
+bool SkSVGPicture::DecodeStream(SkStream* stream, SkPicture* picture) {
+    SkSVGParser parser;
+    if (parser.parse(*stream) == false)
+        return false;
+    return Record(parser, picture);
+}
+
+bool SkSVGPicture::DecodeFile(const char path[], SkPicture* picture) {
+    SkFILEStream stream(path);
+    if (stream.isValid() == false)
+        return false;
+    return DecodeStream(&stream, picture);
+}
@@ -9,6 +9,8 @@
 
 #include "SkSVGPolyline.h"
 #include "SkSVGParser.h"
+#include "SkParse.h"
+#include "SkPath.h"
 
 enum {
     kCliipRule,
@@ -33,6 +35,34 @@ void SkSVGPolyline::addAttribute(SkSVGParser& , int attrIndex,
     SkSVGParser::ConvertToArray(f_points);
 }
 
+bool SkSVGPolyline::getPath(SkPath* path) {
+    // f_points was converted to "[x,y,x,y...]" by addAttribute
+    const char* str = f_points.c_str();
+    int count = 0;
+    for (;;) {
+        while (*str == '[' || *str == ',' || (*str > 0 && *str <= ' '))
+            str++;
+        SkPoint pt;
+        if ((str = SkParse::FindScalar(str, &pt.fX)) == NULL)
+            break;
+        while (*str == ',' || (*str > 0 && *str <= ' '))
+            str++;
+        if ((str = SkParse::FindScalar(str, &pt.fY)) == NULL)
+            break;
+        if (count++ == 0)
+            path->moveTo(pt);
+        else
+            path->lineTo(pt);
+    }
+    if (count < 2)
+        return false;
+    if (getType() == SkSVGType_Polygon)
+        path->close();
+    if (f_fillRule.equals("evenodd"))
+        path->setFillType(SkPath::kEvenOdd_FillType);
+    return true;
+}
+
 void SkSVGPolyline::translate(SkSVGParser& parser, bool defState) {
     parser._startElement("polyline");
     INHERITED::translate(parser, defState);
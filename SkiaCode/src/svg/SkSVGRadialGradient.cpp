@@ -9,6 +9,7 @@
 
 #include "SkSVGRadialGradient.h"
 #include "SkSVGParser.h"
+#include "SkGradientShader.h"
 
 const SkSVGAttribute SkSVGRadialGradient::gAttributes[] = {
     SVG_ATTRIBUTE(cx),
@@ -17,11 +18,54 @@ const SkSVGAttribute SkSVGRadialGradient::gAttributes[] = {
     SVG_ATTRIBUTE(fy),
     SVG_ATTRIBUTE(gradientTransform),
     SVG_ATTRIBUTE(gradientUnits),
-    SVG_ATTRIBUTE(r)
+    SVG_ATTRIBUTE(r),
+    SVG_LITERAL_ATTRIBUTE(xlink:href, f_xlink_href)
 };
 
 DEFINE_SVG_INFO(RadialGradient)
 
+static SkScalar parse_or_default(const SkString& value, SkScalar defaultValue) {
+    return value.size() > 0 ? SkSVGParser::ParseScalar(value.c_str()) : defaultValue;
+}
+
+SkShader* SkSVGRadialGradient::createShader(SkSVGParser& parser,
+        const SkRect& bounds) {
+    SkTDArray<SkColor> colors;
+    SkTDArray<SkScalar> offsets;
+    int count = getStops(parser, f_xlink_href, &colors, &offsets);
+    if (count == 0)
+        return NULL;
+    if (count == 1) {
+        *colors.append() = colors[0];
+        *offsets.append() = SK_Scalar1;
+        count = 2;
+    }
+    SkPoint center, focus;
+    center.set(parse_or_default(f_cx, SK_ScalarHalf),
+               parse_or_default(f_cy, SK_ScalarHalf));
+    focus.set(parse_or_default(f_fx, center.fX),
+              parse_or_default(f_fy, center.fY));
+    SkScalar radius = parse_or_default(f_r, SK_ScalarHalf);
+    if (radius <= 0)
+        return NULL;
+    SkShader* shader;
+    if (focus == center)
+        shader = SkGradientShader::CreateRadial(center, radius, colors.begin(),
+            offsets.begin(), count, SkShader::kClamp_TileMode);
+    else
+        shader = SkGradientShader::CreateTwoPointConical(focus, 0, center,
+            radius, colors.begin(), offsets.begin(), count,
+            SkShader::kClamp_TileMode);
+    SkMatrix matrix;
+    getShaderMatrix(f_gradientUnits, f_gradientTransform, bounds, &matrix);
+    shader->setLocalMatrix(matrix);
+    return shader;
+}
+
+const char* SkSVGRadialGradient::getHref() {
+    return f_xlink_href.c_str();
+}
+
 void SkSVGRadialGradient::translate(SkSVGParser& parser, bool defState) {
     if (fMatrixID.size() == 0)
         parser.translateMatrix(f_gradientTransform, &fMatrixID);
@@ -14,6 +14,8 @@
 
 class SkSVGRadialGradient : public SkSVGGradient {
     DECLARE_SVG_INFO(RadialGradient);
+    virtual SkShader* createShader(SkSVGParser& , const SkRect& bounds);
+    virtual const char* getHref();
 protected:
     SkString f_cx;
     SkString f_cy;
@@ -22,6 +24,7 @@ protected:
     SkString f_gradientTransform;
     SkString f_gradientUnits;
     SkString f_r;
+    SkString f_xlink_href;
     SkString fMatrixID;
 private:
     typedef SkSVGGradient INHERITED;
@@ -9,9 +9,12 @@
 
 #include "SkSVGRect.h"
 #include "SkSVGParser.h"
+#include "SkPath.h"
 
 const SkSVGAttribute SkSVGRect::gAttributes[] = {
     SVG_ATTRIBUTE(height),
+    SVG_ATTRIBUTE(rx),
+    SVG_ATTRIBUTE(ry),
     SVG_ATTRIBUTE(width),
     SVG_ATTRIBUTE(x),
     SVG_ATTRIBUTE(y)
@@ -24,6 +27,29 @@ SkSVGRect::SkSVGRect() {
     f_y.set("0");
 }
 
+bool SkSVGRect::getPath(SkPath* path) {
+    SkScalar x = SkSVGParser::ParseScalar(f_x.c_str());
+    SkScalar y = SkSVGParser::ParseScalar(f_y.c_str());
+    SkRect rect;
+    rect.set(x, y, x + SkSVGParser::ParseScalar(f_width.c_str()),
+             y + SkSVGParser::ParseScalar(f_height.c_str()));
+    if (rect.isEmpty())
+        return false;
+    SkScalar rx = SkSVGParser::ParseScalar(f_rx.c_str());
+    SkScalar ry = SkSVGParser::ParseScalar(f_ry.c_str());
+    if (f_rx.size() == 0)
+        rx = ry;
+    else if (f_ry.size() == 0)
+        ry = rx;
+    rx = SkMinScalar(rx, SkScalarHalf(rect.width()));
+    ry = SkMinScalar(ry, SkScalarHalf(rect.height()));
+    if (rx > 0 && ry > 0)
+        path->addRoundRect(rect, rx, ry);
+    else
+        path->addRect(rect);
+    return true;
+}
+
 void SkSVGRect::translate(SkSVGParser& parser, bool defState) {
     parser._startElement("rect");
     INHERITED::translate(parser, defState);
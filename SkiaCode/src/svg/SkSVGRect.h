@@ -14,9 +14,12 @@
 
 class SkSVGRect : public SkSVGElement {
     DECLARE_SVG_INFO(Rect);
+    virtual bool getPath(SkPath* path);
     SkSVGRect();
 private:
     SkString f_height;
+    SkString f_rx;
+    SkString f_ry;
     SkString f_width;
     SkString f_x;
     SkString f_y;
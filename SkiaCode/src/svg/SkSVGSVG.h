@@ -29,6 +29,7 @@ private:
     SkString f_y;
 
     typedef SkSVGElement INHERITED;
+    friend class SkSVGPictureBuilder;
 };
 
 #endif // SkSVGSVG_DEFINED
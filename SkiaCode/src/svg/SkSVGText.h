@@ -21,6 +21,7 @@ protected:
 private:
     typedef SkSVGElement INHERITED;
     friend class SkSVGParser;
+    friend class SkSVGPictureBuilder;
 };
 
 class SkSVGTspan : public SkSVGText {
@@ -23,6 +23,7 @@ protected:
 private:
     typedef SkSVGElement INHERITED;
     friend class SkSVGClipPath;
+    friend class SkSVGPictureBuilder;
 };
 
 #endif // SkSVGUse_DEFINED
@@ -0,0 +1,42 @@
+/*
+ * Copyright 2012 Google Inc.
+ *
+ * Use of this source code is governed by a BSD-style license that can be
+ * found in the LICENSE file.
+ */
+
+#include "SkParallelFor.h"
+#include "SkThreadUtils.h"
+
+namespace {
+
+struct ParallelForRec {
+    int32_t     fNext;
+    int         fCount;
+    void        (*fProc)(void*, int);
+    void*       fContext;
+};
+
+void parallel_for_worker(void* data) {
+    ParallelForRec* rec = static_cast<ParallelForRec*>(data);
+    int i;
+    while ((i = sk_atomic_inc(&rec->fNext)) < rec->fCount) {
+        rec->fProc(rec->fContext, i);
+    }
+}
+
+}
+
+void SkThreadedFor(int count, void (*proc)(void* context, int i), void* context) {
+    ParallelForRec rec = { 0, count, proc, context };
+    SkThread* threads[3];
+    for (size_t i = 0; i < SK_ARRAY_COUNT(threads); ++i) {
+        threads[i] = SkNEW_ARGS(SkThread, (parallel_for_worker, &rec));
+        threads[i]->start();
+    }
+    parallel_for_worker(&rec);
+    for (size_t i = 0; i < SK_ARRAY_COUNT(threads); ++i) {
+        threads[i]->join();
+        SkDELETE(threads[i]);
+    }
+}
@@ -0,0 +1,21 @@
+/*
+ * Copyright 2012 Google Inc.
+ *
+ * Use of this source code is governed by a BSD-style license that can be
+ * found in the LICENSE file.
+ */
+
+#ifndef SkParallelFor_DEFINED
+#define SkParallelFor_DEFINED
+
+#include "SkThread.h"
+
+/**
+ *  An SkParallelForProc that shares the calls between the calling thread and
+ *  three SkThreads, which it starts and joins on every call. Starting threads
+ *  each time is too slow for production use, but is enough for tests, benches
+ *  and tools to drive the APIs that take an SkParallelForProc.
+ */
+void SkThreadedFor(int count, void (*proc)(void* context, int i), void* context);
+
+#endif
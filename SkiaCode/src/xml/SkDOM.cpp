@@ -201,11 +201,13 @@ static char* dupstr(SkChunkAlloc* chunk, const char src[])
 class SkDOMParser : public SkXMLParser {
     bool fNeedToFlush;
 public:
-    SkDOMParser(SkChunkAlloc* chunk) : SkXMLParser(&fParserError), fAlloc(chunk)
+    // if copyStrings is false, the names and values passed in must outlive the DOM
+    SkDOMParser(SkChunkAlloc* chunk, bool copyStrings = true) : SkXMLParser(&fParserError), fAlloc(chunk)
     {
         fRoot = NULL;
         fLevel = 0;
         fNeedToFlush = true;
+        fCopyStrings = copyStrings;
     }
     SkDOM::Node* getRoot() const { return fRoot; }
     SkXMLParserError fParserError;
@@ -245,15 +247,15 @@ protected:
         if (fLevel > 0 && fNeedToFlush)
             this->flushAttributes();
         fNeedToFlush = true;
-        fElemName = dupstr(fAlloc, elem);
+        fElemName = fCopyStrings ? dupstr(fAlloc, elem) : elem;
         ++fLevel;
         return false;
     }
     virtual bool onAddAttribute(const char name[], const char value[])
     {
         SkDOM::Attr* attr = fAttrs.append();
-        attr->fName = dupstr(fAlloc, name);
-        attr->fValue = dupstr(fAlloc, value);
+        attr->fName = fCopyStrings ? dupstr(fAlloc, name) : name;
+        attr->fValue = fCopyStrings ? dupstr(fAlloc, value) : value;
         return false;
     }
     virtual bool onEndElement(const char elem[])
@@ -283,10 +285,11 @@ private:
     SkTDArray<SkDOM::Node*> fParentStack;
     SkChunkAlloc*   fAlloc;
     SkDOM::Node*    fRoot;
+    bool            fCopyStrings;
 
     // state needed for flushAttributes()
     SkTDArray<SkDOM::Attr>  fAttrs;
-    char*                   fElemName;
+    const char*             fElemName;
     int                     fLevel;
 };
 
@@ -307,6 +310,314 @@ const SkDOM::Node* SkDOM::build(const char doc[], size_t len)
 
 ///////////////////////////////////////////////////////////////////////////
 
+#include "SkData.h"
+#include "SkUtils.h"
+
+static bool is_space(char c)
+{
+    return c == ' ' || c == '\t' || c == '\n' || c == '\r';
+}
+
+static char* skip_space(char* p)
+{
+    while (is_space(*p))
+        p += 1;
+    return p;
+}
+
+static char* skip_name(char* p)
+{
+    while (*p && !is_space(*p) && !strchr("/>=<'\"", *p))
+        p += 1;
+    return p;
+}
+
+static bool skip_past(char** pp, const char end[])
+{
+    char* p = strstr(*pp, end);
+    if (p == NULL)
+        return false;
+    *pp = p + strlen(end);
+    return true;
+}
+
+static bool starts_with(const char* p, const char prefix[])
+{
+    return !strncmp(p, prefix, strlen(prefix));
+}
+
+// skips a declaration such as <!DOCTYPE ...>, including any internal subset
+static bool skip_declaration(char** pp)
+{
+    char*   p = *pp;
+    int     depth = 0;
+    for (;;)
+    {
+        switch (*p++) {
+            case 0:
+                return false;
+            case '"':
+            case '\'':
+                p = strchr(p, p[-1]);
+                if (p == NULL)
+                    return false;
+                p += 1;
+                break;
+            case '[':
+                depth += 1;
+                break;
+            case ']':
+                depth -= 1;
+                break;
+            case '>':
+                if (depth <= 0)
+                {
+                    *pp = p;
+                    return true;
+                }
+                break;
+        }
+    }
+}
+
+// replaces the reference at *src with the character it stands for, written at *dst.
+// The replacement is never longer than the reference, so dst never passes src.
+static bool decode_reference(char** src, char** dst)
+{
+    char* p = *src + 1;
+    char* end = strchr(p, ';');
+    if (end == NULL)
+        return false;
+
+    static const struct {
+        const char* fName;
+        char        fChar;
+    } gEntities[] = {
+        { "lt;",    '<' },
+        { "gt;",    '>' },
+        { "amp;",   '&' },
+        { "quot;",  '"' },
+        { "apos;",  '\'' }
+    };
+    for (size_t i = 0; i < SK_ARRAY_COUNT(gEntities); i++)
+    {
+        if (starts_with(p, gEntities[i].fName))
+        {
+            *(*dst)++ = gEntities[i].fChar;
+            *src = end + 1;
+            return true;
+        }
+    }
+    if (*p++ != '#')
+        return false;
+
+    int base = 10;
+    if (*p == 'x')
+    {
+        base = 16;
+        p += 1;
+    }
+    if (p == end)
+        return false;
+    SkUnichar uni = 0;
+    for (; p < end; p++)
+    {
+        int digit;
+        if (*p >= '0' && *p <= '9')
+            digit = *p - '0';
+        else if (base == 16 && (*p | 0x20) >= 'a' && (*p | 0x20) <= 'f')
+            digit = (*p | 0x20) - 'a' + 10;
+        else
+            return false;
+        uni = uni * base + digit;
+        if (uni > 0x10FFFF)
+            return false;
+    }
+    if (uni == 0 || (uni >= 0xD800 && uni <= 0xDFFF))
+        return false;
+    *dst += SkUTF8_FromUnichar(uni, *dst);
+    *src = end + 1;
+    return true;
+}
+
+// parses the attribute value starting at the opening quote, decoding references and
+// normalizing white space in place, as expat does, and terminating it
+static bool parse_value(char** pp, char** value)
+{
+    char*   p = *pp;
+    char    quote = *p++;
+    if (quote != '"' && quote != '\'')
+        return false;
+
+    char*   dst = p;
+    *value = p;
+    while (*p != quote)
+    {
+        if (*p == 0 || *p == '<')
+            return false;
+        if (*p == '&')
+        {
+            if (!decode_reference(&p, &dst))
+                return false;
+        }
+        else
+        {
+            if (p[0] == '\r' && p[1] == '\n')
+                p += 1;
+            *dst++ = is_space(*p) ? ' ' : *p;
+            p += 1;
+        }
+    }
+    *dst = 0;
+    *pp = p + 1;
+    return true;
+}
+
+/*  Parses the elements and attributes of doc, which must be zero terminated, calling
+    parser for each of them with names and values that point into doc. Text, comments,
+    CDATA sections, processing instructions and declarations are skipped.
+*/
+static bool parse_in_place(char doc[], SkXMLParser* parser)
+{
+    SkTDArray<const char*>  elems;  // open elements
+    SkTDArray<char*>        attrs;  // name, value pairs of the current element
+    bool                    sawRoot = false;
+    char*                   p = doc;
+
+    if (starts_with(p, "\xEF\xBB\xBF"))   // UTF-8 byte order mark
+        p += 3;
+    for (;;)
+    {
+        // text between tags is ignored, but only white space may surround the root
+        char* text = p;
+        p = strchr(p, '<');
+        if (elems.count() == 0)
+        {
+            char* stop = p ? p : text + strlen(text);
+            if (skip_space(text) < stop)
+                return false;
+        }
+        if (p == NULL)
+            return sawRoot && elems.count() == 0;
+        p += 1;
+
+        if (starts_with(p, "!--"))
+        {
+            if (!skip_past(&p, "-->"))
+                return false;
+        }
+        else if (starts_with(p, "![CDATA["))
+        {
+            if (elems.count() == 0 || !skip_past(&p, "]]>"))
+                return false;
+        }
+        else if (*p == '!')
+        {
+            if (!skip_declaration(&p))
+                return false;
+        }
+        else if (*p == '?')
+        {
+            if (!skip_past(&p, "?>"))
+                return false;
+        }
+        else if (*p == '/')
+        {
+            char* name = p + 1;
+            char* nameStop = skip_name(name);
+            p = skip_space(nameStop);
+            if (*p != '>' || elems.count() == 0)
+                return false;
+            p += 1;
+            *nameStop = 0;
+            const char* elem;
+            elems.pop(&elem);
+            if (strcmp(elem, name) || parser->endElement(elem))
+                return false;
+        }
+        else
+        {
+            if (sawRoot && elems.count() == 0)
+                return false;
+            sawRoot = true;
+
+            char* name = p;
+            char* nameStop = skip_name(name);
+            if (nameStop == name)
+                return false;
+            p = nameStop;
+            attrs.reset();
+            for (;;)
+            {
+                char* attrStart = p;
+                p = skip_space(p);
+                if (*p == '/' || *p == '>')
+                    break;
+                if (p == attrStart)   // attributes must be separated by white space
+                    return false;
+                char* attrName = p;
+                char* attrStop = skip_name(attrName);
+                p = skip_space(attrStop);
+                if (attrStop == attrName || *p != '=')
+                    return false;
+                p = skip_space(p + 1);
+                *attrStop = 0;
+                *attrs.append() = attrName;
+                if (!parse_value(&p, attrs.append()))
+                    return false;
+            }
+            bool empty = *p == '/';
+            if (empty)
+            {
+                if (p[1] != '>')
+                    return false;
+                p += 1;
+            }
+            p += 1;
+            // the name can only be terminated once the character after it has been read
+            *nameStop = 0;
+
+            if (parser->startElement(name))
+                return false;
+            for (int i = 0; i < attrs.count(); i += 2)
+            {
+                if (parser->addAttribute(attrs[i], attrs[i + 1]))
+                    return false;
+            }
+            if (empty)
+            {
+                if (parser->endElement(name))
+                    return false;
+            }
+            else
+                *elems.append() = name;
+        }
+    }
+}
+
+const SkDOM::Node* SkDOM::build(SkData* doc)
+{
+    fAlloc.reset();
+    // names and values point into this copy of the document, so it lives as long as the nodes
+    size_t  len = doc->size();
+    char*   text = (char*)fAlloc.alloc(len + 1, SkChunkAlloc::kThrow_AllocFailType);
+    memcpy(text, doc->data(), len);
+    text[len] = 0;
+
+    SkDOMParser parser(&fAlloc, false);
+    if (!parse_in_place(text, &parser))
+    {
+        SkDEBUGCODE(SkDebugf("xml parse error\n");)
+        fRoot = NULL;
+        fAlloc.reset();
+        return NULL;
+    }
+    fRoot = parser.getRoot();
+    return fRoot;
+}
+
+///////////////////////////////////////////////////////////////////////////
+
 static void walk_dom(const SkDOM& dom, const SkDOM::Node* node, SkXMLParser* parser)
 {
     const char* elem = dom.getName(node);
@@ -317,6 +317,7 @@ static void test_path_with_hole(skiatest::Reporter* reporter) {
 }
 
 #include "SkRasterClip.h"
+#include "SkAAClipCache.h"
 
 static void copyToMask(const SkRasterClip& rc, SkMask* mask) {
     if (rc.isAA()) {
@@ -394,6 +395,132 @@ static void test_regressions(skiatest::Reporter* reporter) {
     }
 }
 
+// Expands clip into a size x size A8 grid whose origin is 0,0
+static void expand_to_grid(const SkAAClip& clip, uint8_t grid[], int size) {
+    sk_bzero(grid, size * size);
+    if (clip.isEmpty()) {
+        return;
+    }
+    SkMask mask;
+    clip.copyToMask(&mask);
+    SkAutoMaskFreeImage freeM(mask.fImage);
+    for (int y = mask.fBounds.fTop; y < mask.fBounds.fBottom; ++y) {
+        for (int x = mask.fBounds.fLeft; x < mask.fBounds.fRight; ++x) {
+            SkASSERT(x >= 0 && x < size && y >= 0 && y < size);
+            grid[y * size + x] = *mask.getAddr8(x, y);
+        }
+    }
+}
+
+static void make_rand_aaclip(SkAAClip* clip, SkRandom& rand, const SkRect& r) {
+    SkPath path;
+    SkScalar rad = rand.nextUScalar1() * r.width() / 2;
+    path.addRoundRect(r, rad, rad);
+    if (rand.nextBool()) {
+        // punch a hole, so some rows are not opaque in the middle
+        SkRect hole = r;
+        hole.inset(r.width() / 3, r.height() * rand.nextUScalar1() / 3);
+        path.addOval(hole, SkPath::kCCW_Direction);
+    }
+    clip->setPath(path, NULL, true);
+}
+
+// Intersecting copies the rows of a clip the other one is opaque across,
+// rather than rebuilding them. The result must still be the product of the
+// two clips at every pixel.
+static void test_intersect_rows(skiatest::Reporter* reporter) {
+    static const int kSize = 64;
+    uint8_t gridA[kSize * kSize];
+    uint8_t gridB[kSize * kSize];
+    uint8_t gridR[kSize * kSize];
+
+    SkRandom rand;
+    for (int i = 0; i < 200; ++i) {
+        // B is wider than A, so the result spans exactly A's width
+        SkRect rb = SkRect::MakeLTRB(SkIntToScalar(2), rand.nextUScalar1() * 20,
+                                     SkIntToScalar(kSize - 2),
+                                     SkIntToScalar(kSize - 2) - rand.nextUScalar1() * 20);
+        SkRect ra = SkRect::MakeLTRB(SkIntToScalar(10) + rand.nextUScalar1() * 10,
+                                     SkIntToScalar(4) + rand.nextUScalar1() * 10,
+                                     SkIntToScalar(kSize - 10) - rand.nextUScalar1() * 10,
+                                     SkIntToScalar(kSize - 4) - rand.nextUScalar1() * 10);
+
+        SkAAClip a, b;
+        make_rand_aaclip(&a, rand, ra);
+        make_rand_aaclip(&b, rand, rb);
+        if (i & 1) {
+            SkTSwap(a, b);
+        }
+
+        SkAAClip result;
+        result.op(a, b, SkRegion::kIntersect_Op);
+
+        expand_to_grid(a, gridA, kSize);
+        expand_to_grid(b, gridB, kSize);
+        expand_to_grid(result, gridR, kSize);
+        bool same = true;
+        for (int j = 0; j < kSize * kSize; ++j) {
+            if (gridR[j] != SkMulDiv255Round(gridA[j], gridB[j])) {
+                same = false;
+            }
+        }
+        REPORTER_ASSERT(reporter, same);
+    }
+}
+
+// Building the same clips through SkRasterClip with the clip cache on must
+// give the same clips as with it off.
+static void test_clip_cache(skiatest::Reporter* reporter) {
+    const SkIRect bounds = SkIRect::MakeWH(100, 100);
+    SkPath outer, inner;
+    outer.addRoundRect(SkRect::MakeLTRB(SkFloatToScalar(4.5f),
+                                        SkFloatToScalar(5.25f),
+                                        SkFloatToScalar(95.5f),
+                                        SkFloatToScalar(90.75f)),
+                       SkIntToScalar(8), SkIntToScalar(8));
+    inner.addCircle(SkIntToScalar(50), SkIntToScalar(48), SkFloatToScalar(30.3f));
+
+    const int limit = SkAAClipCache::SetCountLimit(0);
+
+    SkRasterClip expected;
+    expected.setPath(outer, bounds, true);
+    {
+        SkRasterClip clip;
+        clip.setPath(inner, bounds, true);
+        expected.op(clip, SkRegion::kIntersect_Op);
+    }
+
+    SkAAClipCache::SetCountLimit(SkAAClipCache::kDefaultCountLimit);
+    SkAAClipCache::ResetStats();
+
+    for (int i = 0; i < 4; ++i) {
+        SkRasterClip actual;
+        actual.setPath(outer, bounds, true);
+        SkRasterClip clip;
+        clip.setPath(inner, bounds, true);
+        actual.op(clip, SkRegion::kIntersect_Op);
+
+        REPORTER_ASSERT(reporter, expected == actual);
+    }
+
+    // each of the three clips is added the second time around, and then hit
+    SkAAClipCache::Stats stats;
+    SkAAClipCache::GetStats(&stats);
+    REPORTER_ASSERT(reporter, stats.fAdds >= 3);
+    REPORTER_ASSERT(reporter, stats.fHits >= 3);
+    REPORTER_ASSERT(reporter, stats.fBytesUsed > 0);
+    REPORTER_ASSERT(reporter, stats.fBytesUsed <= SkAAClipCache::GetByteLimit());
+
+    // a byte limit smaller than any clip evicts them all
+    const size_t byteLimit = SkAAClipCache::SetByteLimit(1);
+    SkAAClipCache::GetStats(&stats);
+    REPORTER_ASSERT(reporter, 0 == stats.fCount);
+    REPORTER_ASSERT(reporter, 0 == stats.fBytesUsed);
+    SkAAClipCache::SetByteLimit(byteLimit);
+
+    SkAAClipCache::SetCountLimit(limit);
+}
+
 static void TestAAClip(skiatest::Reporter* reporter) {
     test_empty(reporter);
     test_path_bounds(reporter);
@@ -402,6 +529,8 @@ static void TestAAClip(skiatest::Reporter* reporter) {
     test_path_with_hole(reporter);
     test_regressions(reporter);
     test_nearly_integral(reporter);
+    test_intersect_rows(reporter);
+    test_clip_cache(reporter);
 }
 
 #include "TestClassDef.h"
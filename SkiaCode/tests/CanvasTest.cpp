@@ -46,6 +46,7 @@
  */
 #include "SkBitmap.h"
 #include "SkCanvas.h"
+#include "SkData.h"
 #include "SkDeferredCanvas.h"
 #include "SkDevice.h"
 #include "SkMatrix.h"
@@ -183,6 +184,10 @@ private:
 const SkRect kTestRect =
     SkRect::MakeXYWH(SkIntToScalar(0), SkIntToScalar(0),
                      SkIntToScalar(2), SkIntToScalar(1));
+// -0 must survive a compact op stream, which only packs whole numbers
+const SkRect kNegativeZeroRect =
+    SkRect::MakeLTRB(-SkIntToScalar(0), SkIntToScalar(0),
+                     SkIntToScalar(2), SkIntToScalar(1));
 static SkMatrix testMatrix() {
     SkMatrix matrix;
     matrix.reset();
@@ -290,6 +295,8 @@ SIMPLE_TEST_STEP(DrawPointsLiness, drawPoints(SkCanvas::kLines_PointMode,
 SIMPLE_TEST_STEP(DrawPointsPolygon, drawPoints(SkCanvas::kPolygon_PointMode,
     kTestPointCount, kTestPoints, kTestPaint));
 SIMPLE_TEST_STEP(DrawRect, drawRect(kTestRect, kTestPaint));
+SIMPLE_TEST_STEP(DrawRectNegativeZero, drawRect(kNegativeZeroRect,
+    kTestPaint));
 SIMPLE_TEST_STEP(DrawPath, drawPath(kTestPath, kTestPaint));
 SIMPLE_TEST_STEP(DrawBitmap, drawBitmap(kTestBitmap, 0, 0));
 SIMPLE_TEST_STEP(DrawBitmapPaint, drawBitmap(kTestBitmap, 0, 0, &kTestPaint));
@@ -729,6 +736,51 @@ public:
         AssertFlattenedObjectsEqual(referenceRecord, testRecord,
             reporter, testStep);
     }
+
+    // Plays picture back into a fresh recording, and returns its op stream
+    static SkData* PlaybackOps(SkPicture* picture) {
+        SkPicture playbackPicture;
+        SkCanvas* canvas = playbackPicture.beginRecording(kWidth, kHeight);
+        picture->draw(canvas);
+        SkPictureRecord* record = static_cast<SkPictureRecord*>(canvas);
+        record->endRecording();
+        size_t size = record->writeStream().size();
+        void* ops = sk_malloc_throw(size);
+        record->writeStream().flatten(ops);
+        return SkData::NewFromMalloc(ops, size);
+    }
+
+    static void TestPictureCompactPlayback(skiatest::Reporter* reporter,
+                                           CanvasTestStep* testStep) {
+        // A compact picture must play back exactly the same calls as a
+        // regular one, both as recorded and after serialization.
+        testStep->setAssertMessageFormat(kPictureDrawAssertMessageFormat);
+        SkPicture referencePicture;
+        testStep->draw(referencePicture.beginRecording(kWidth, kHeight),
+                       reporter);
+        referencePicture.endRecording();
+        SkPicture compactPicture;
+        testStep->draw(compactPicture.beginRecording(kWidth, kHeight,
+            SkPicture::kCompactOpStream_RecordingFlag), reporter);
+        compactPicture.endRecording();
+
+        SkDynamicMemoryWStream stream;
+        compactPicture.serialize(&stream);
+        SkAutoDataUnref data(stream.copyToData());
+        SkMemoryStream readStream(data->data(), data->size());
+        SkPicture deserializedPicture(&readStream);
+
+        testStep->setAssertMessageFormat(kPicturePlaybackAssertMessageFormat);
+        SkAutoDataUnref referenceOps(PlaybackOps(&referencePicture));
+        SkAutoDataUnref compactOps(PlaybackOps(&compactPicture));
+        SkAutoDataUnref deserializedOps(PlaybackOps(&deserializedPicture));
+        REPORTER_ASSERT_MESSAGE(reporter,
+            referenceOps->equals(compactOps.get()),
+            testStep->assertMessage());
+        REPORTER_ASSERT_MESSAGE(reporter,
+            referenceOps->equals(deserializedOps.get()),
+            testStep->assertMessage());
+    }
 };
 
 // The following class groups static functions that need to access
@@ -868,6 +920,33 @@ static void TestOverrideStateConsistency(skiatest::Reporter* reporter,
     }
 }
 
+static size_t serialized_size(uint32_t recordingFlags) {
+    static const int kSize = 100;
+    SkPicture picture;
+    SkCanvas* canvas = picture.beginRecording(kSize, kSize, recordingFlags);
+    SkPaint paint;
+    const char text[] = "Hamburgefons";
+    for (int y = 0; y < kSize; y += 2) {
+        for (int x = 0; x < kSize; x += 4) {
+            canvas->drawRect(SkRect::MakeXYWH(SkIntToScalar(x), SkIntToScalar(y),
+                                              SkIntToScalar(3), SkIntToScalar(1)),
+                             paint);
+        }
+        canvas->drawText(text, sizeof(text) - 1, 0, SkIntToScalar(y), paint);
+    }
+    picture.endRecording();
+    SkDynamicMemoryWStream stream;
+    picture.serialize(&stream);
+    return stream.getOffset();
+}
+
+// The compact op stream is only worth having if it is smaller.
+static void TestPictureCompactSize(skiatest::Reporter* reporter) {
+    size_t regularSize = serialized_size(0);
+    size_t compactSize = serialized_size(SkPicture::kCompactOpStream_RecordingFlag);
+    REPORTER_ASSERT(reporter, compactSize < regularSize);
+}
+
 static void TestCanvas(skiatest::Reporter* reporter) {
     // Init global here because bitmap pixels cannot be alocated during
     // static initialization
@@ -877,8 +956,12 @@ static void TestCanvas(skiatest::Reporter* reporter) {
         TestOverrideStateConsistency(reporter, testStepArray()[testStep]);
         SkPictureTester::TestPictureFlattenedObjectReuse(reporter,
             testStepArray()[testStep], 0);
+        SkPictureTester::TestPictureCompactPlayback(reporter,
+            testStepArray()[testStep]);
     }
 
+    TestPictureCompactSize(reporter);
+
     // Explicitly call reset(), so we don't leak the pixels (since kTestBitmap is a global)
     kTestBitmap.reset();
 }
@@ -0,0 +1,116 @@
+/*
+ * Copyright 2012 Google Inc.
+ *
+ * Use of this source code is governed by a BSD-style license that can be
+ * found in the LICENSE file.
+ */
+#include "Test.h"
+#include "SkData.h"
+#include "SkDOM.h"
+
+static const SkDOM::Node* build(SkDOM* dom, const char doc[]) {
+    SkAutoTUnref<SkData> data(SkData::NewWithCString(doc));
+    // parse the document without its terminating zero
+    SkAutoTUnref<SkData> text(SkData::NewSubset(data, 0, strlen(doc)));
+    return dom->build(text);
+}
+
+static void test_tree(skiatest::Reporter* reporter) {
+    static const char gDoc[] =
+        "\xEF\xBB\xBF<?xml version='1.0' encoding='UTF-8'?>\n"
+        "<!DOCTYPE root [ <!ELEMENT root ANY> ]>\n"
+        "<!-- <notAnElement/> -->\n"
+        "<root a='1' b=\"2\">"
+            "<elem1 c='3' />"
+            "text is skipped"
+            "<elem2 d = '4'/>"
+            "<elem3 e='5'>"
+                "<![CDATA[<notAnElement/>]]>"
+                "<subelem1/>"
+                "<subelem2 f='6' g='7'></subelem2>"
+            "</elem3 >"
+            "<elem4 h='8'/>"
+        "</root>\n";
+
+    SkDOM dom;
+    const SkDOM::Node* root = build(&dom, gDoc);
+    REPORTER_ASSERT(reporter, root && dom.getRootNode() == root);
+    if (NULL == root) {
+        return;
+    }
+    REPORTER_ASSERT(reporter, !strcmp(dom.getName(root), "root"));
+    REPORTER_ASSERT(reporter, dom.hasAttr(root, "a", "1"));
+    REPORTER_ASSERT(reporter, dom.hasAttr(root, "b", "2"));
+    REPORTER_ASSERT(reporter, NULL == dom.findAttr(root, "c"));
+    REPORTER_ASSERT(reporter, dom.countChildren(root) == 4);
+
+    static const char* gChildren[] = { "elem1", "elem2", "elem3", "elem4" };
+    const SkDOM::Node* child = dom.getFirstChild(root);
+    for (size_t i = 0; i < SK_ARRAY_COUNT(gChildren); ++i) {
+        REPORTER_ASSERT(reporter, child && !strcmp(dom.getName(child), gChildren[i]));
+        child = child ? dom.getNextSibling(child) : NULL;
+    }
+    REPORTER_ASSERT(reporter, dom.hasS32(dom.getFirstChild(root, "elem2"), "d", 4));
+
+    const SkDOM::Node* elem3 = dom.getFirstChild(root, "elem3");
+    REPORTER_ASSERT(reporter, elem3 && dom.countChildren(elem3) == 2);
+    if (elem3) {
+        const SkDOM::Node* subelem2 = dom.getFirstChild(elem3, "subelem2");
+        REPORTER_ASSERT(reporter, subelem2 && dom.hasAttr(subelem2, "g", "7"));
+        REPORTER_ASSERT(reporter, NULL == dom.getFirstChild(elem3, "notAnElement"));
+    }
+}
+
+static void test_values(skiatest::Reporter* reporter) {
+    SkDOM dom;
+    const SkDOM::Node* root = build(&dom,
+        "<root refs='&lt;&amp;&gt;&quot;&apos;' chars='&#65;&#x42;&#xe9;&#x20AC;'"
+        " space='a\tb\r\nc' quotes=\"it's\"/>");
+    REPORTER_ASSERT(reporter, root);
+    if (NULL == root) {
+        return;
+    }
+    REPORTER_ASSERT(reporter, dom.hasAttr(root, "refs", "<&>\"'"));
+    REPORTER_ASSERT(reporter, dom.hasAttr(root, "chars", "AB\xC3\xA9\xE2\x82\xAC"));
+    REPORTER_ASSERT(reporter, dom.hasAttr(root, "space", "a b c"));
+    REPORTER_ASSERT(reporter, dom.hasAttr(root, "quotes", "it's"));
+    REPORTER_ASSERT(reporter, NULL == dom.getFirstChild(root));
+}
+
+static void test_errors(skiatest::Reporter* reporter) {
+    static const char* gBadDocs[] = {
+        "",
+        "   ",
+        "<root>",
+        "<root></other>",
+        "<root/><root/>",
+        "text<root/>",
+        "<root a='1/>",
+        "<root a=1/>",
+        "<root a='1'b='2'/>",
+        "<root a='&unknown;'/>",
+        "<root a='&#0;'/>",
+        "<root a='<'/>",
+        "<root><!-- unterminated </root>",
+        "< root/>",
+        "<root/",
+    };
+
+    SkDOM dom;
+    for (size_t i = 0; i < SK_ARRAY_COUNT(gBadDocs); ++i) {
+        REPORTER_ASSERT(reporter, NULL == build(&dom, gBadDocs[i]));
+        REPORTER_ASSERT(reporter, NULL == dom.getRootNode());
+    }
+
+    // a failed build leaves the DOM usable
+    REPORTER_ASSERT(reporter, build(&dom, "<root/>"));
+}
+
+static void TestDOM(skiatest::Reporter* reporter) {
+    test_tree(reporter);
+    test_values(reporter);
+    test_errors(reporter);
+}
+
+#include "TestClassDef.h"
+DEFINE_TESTCLASS("DOM", DOMTestClass, TestDOM)
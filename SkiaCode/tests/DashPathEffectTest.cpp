@@ -0,0 +1,183 @@
+
+/*
+ * Copyright 2012 Google Inc.
+ *
+ * Use of this source code is governed by a BSD-style license that can be
+ * found in the LICENSE file.
+ */
+
+#include "Test.h"
+#include "SkBitmap.h"
+#include "SkCanvas.h"
+#include "SkDashPathEffect.h"
+#include "SkPaint.h"
+#include "SkPath.h"
+
+static const int kSize = 100;
+
+static void erase(SkBitmap* bm) {
+    bm->setConfig(SkBitmap::kARGB_8888_Config, kSize, kSize);
+    bm->allocPixels();
+    bm->eraseColor(SK_ColorWHITE);
+}
+
+// Draws path with paint's dashing, as SkDraw does (possibly culled, or as
+// rects), and again by filling the whole dashed and stroked path.
+static void draw_both(SkBitmap* actual, SkBitmap* expected, const SkPath& path,
+                      const SkPaint& paint, const SkMatrix& matrix) {
+    erase(actual);
+    SkCanvas canvas(*actual);
+    canvas.concat(matrix);
+    canvas.drawPath(path, paint);
+
+    SkPath fillPath;
+    paint.getFillPath(path, &fillPath);
+    SkPaint fillPaint(paint);
+    fillPaint.setPathEffect(NULL);
+    fillPaint.setStyle(SkPaint::kFill_Style);
+
+    erase(expected);
+    SkCanvas expectedCanvas(*expected);
+    expectedCanvas.concat(matrix);
+    expectedCanvas.drawPath(fillPath, fillPaint);
+}
+
+static int max_component_diff(const SkBitmap& a, const SkBitmap& b) {
+    SkAutoLockPixels alpa(a);
+    SkAutoLockPixels alpb(b);
+    int maxDiff = 0;
+    for (int y = 0; y < a.height(); ++y) {
+        for (int x = 0; x < a.width(); ++x) {
+            SkPMColor ca = *a.getAddr32(x, y);
+            SkPMColor cb = *b.getAddr32(x, y);
+            for (int shift = 0; shift < 32; shift += 8) {
+                int diff = SkAbs32((int)((ca >> shift) & 0xFF) -
+                                   (int)((cb >> shift) & 0xFF));
+                maxDiff = SkMax32(maxDiff, diff);
+            }
+        }
+    }
+    return maxDiff;
+}
+
+// A dashed line that is mostly offscreen should only be dashed where it can
+// be seen.
+static void test_culled_line(skiatest::Reporter* reporter) {
+    const SkScalar intervals[] = { SkIntToScalar(10), SkIntToScalar(10) };
+    SkDashPathEffect dash(intervals, 2, 0);
+
+    SkPath path;
+    path.moveTo(SkIntToScalar(-20000), SkIntToScalar(50));
+    path.lineTo(SkIntToScalar(20000), SkIntToScalar(50));
+    const SkRect cull = SkRect::MakeWH(SkIntToScalar(kSize),
+                                       SkIntToScalar(kSize));
+
+    SkPaint paint;
+    paint.setStyle(SkPaint::kStroke_Style);
+    paint.setStrokeWidth(SkIntToScalar(3));
+
+    SkPath all, culled;
+    SkStrokeRec rec(paint);
+    REPORTER_ASSERT(reporter, dash.filterPath(&all, path, &rec));
+    SkStrokeRec culledRec(paint);
+    REPORTER_ASSERT(reporter, dash.filterPathInRect(&culled, path, &culledRec,
+                                                    cull));
+    REPORTER_ASSERT(reporter, all.countPoints() > 4000);
+    REPORTER_ASSERT(reporter, culled.countPoints() < 50);
+
+    // a line that misses the cull rect produces nothing
+    path.offset(0, SkIntToScalar(1000));
+    culled.reset();
+    SkStrokeRec missedRec(paint);
+    REPORTER_ASSERT(reporter, dash.filterPathInRect(&culled, path, &missedRec,
+                                                    cull));
+    REPORTER_ASSERT(reporter, culled.isEmpty());
+
+    // a rotated line is culled too, and draws the same as before
+    path.reset();
+    path.moveTo(SkIntToScalar(-3000), SkIntToScalar(-2990));
+    path.lineTo(SkIntToScalar(3000), SkIntToScalar(3010));
+    paint.setAntiAlias(true);
+    paint.setPathEffect(&dash);
+    SkBitmap actual, expected;
+    draw_both(&actual, &expected, path, paint, SkMatrix::I());
+    REPORTER_ASSERT(reporter, 0 == max_component_diff(actual, expected));
+    paint.setPathEffect(NULL);
+}
+
+// AntiFillRect computes exact coverage, while the path scan converter samples
+// four rows per pixel, so an antialiased edge may be off by up to 1/4 of the
+// (0xC0) color.
+static const int kAATolerance = 0xC0 / 4;
+
+// Dashed horizontal and vertical lines and rects are drawn as rects.
+static void test_dash_rects(skiatest::Reporter* reporter, const SkPath& path,
+                            SkScalar phase) {
+    const SkScalar intervals[] = { SkIntToScalar(7), SkIntToScalar(4),
+                                   SkIntToScalar(2), SkIntToScalar(5) };
+    SkAutoTUnref<SkDashPathEffect> dash(SkNEW_ARGS(SkDashPathEffect,
+            (intervals, SK_ARRAY_COUNT(intervals), phase)));
+
+    SkPaint paint;
+    paint.setStyle(SkPaint::kStroke_Style);
+    paint.setStrokeWidth(SkIntToScalar(3));
+    paint.setColor(0xC0204080);
+    paint.setPathEffect(dash);
+
+    SkTDArray<SkRect> rects;
+    SkPath fillPath;
+    const SkRect cull = SkRect::MakeWH(SkIntToScalar(kSize),
+                                       SkIntToScalar(kSize));
+    REPORTER_ASSERT(reporter, dash->asRects(&rects, &fillPath, path,
+                                            SkStrokeRec(paint), cull));
+    REPORTER_ASSERT(reporter, rects.count() > 0);
+
+    SkMatrix matrix;
+    matrix.setScale(SkFloatToScalar(1.25f), SkFloatToScalar(0.75f));
+    matrix.postTranslate(SkFloatToScalar(0.3f), SkFloatToScalar(5.6f));
+
+    for (int aa = 0; aa <= 1; ++aa) {
+        paint.setAntiAlias(SkToBool(aa));
+        const int tolerance = aa ? kAATolerance : 0;
+        SkBitmap actual, expected;
+        draw_both(&actual, &expected, path, paint, SkMatrix::I());
+        REPORTER_ASSERT(reporter, max_component_diff(actual, expected) <= tolerance);
+        draw_both(&actual, &expected, path, paint, matrix);
+        REPORTER_ASSERT(reporter, max_component_diff(actual, expected) <= tolerance);
+    }
+
+    // gaps narrower than the stroke would make the rects overlap
+    paint.setStrokeWidth(SkIntToScalar(5));
+    rects.reset();
+    REPORTER_ASSERT(reporter, !dash->asRects(&rects, &fillPath, path,
+                                             SkStrokeRec(paint), cull));
+}
+
+static void TestDashPathEffect(skiatest::Reporter* reporter) {
+    test_culled_line(reporter);
+
+    SkPath path;
+    path.moveTo(SkFloatToScalar(3.25f), SkIntToScalar(20));
+    path.lineTo(SkFloatToScalar(96.25f), SkIntToScalar(20));
+    test_dash_rects(reporter, path, 0);
+
+    path.reset();
+    path.moveTo(SkIntToScalar(40), SkIntToScalar(120));
+    path.lineTo(SkIntToScalar(40), SkIntToScalar(-10));
+    test_dash_rects(reporter, path, SkIntToScalar(3));
+
+    // try phases that make dashes start on, stop on and wrap around corners
+    const SkRect r = { SkFloatToScalar(10.25f), SkFloatToScalar(10.6f),
+                       SkFloatToScalar(72.3f), SkFloatToScalar(61.1f) };
+    for (int phase = 0; phase < 18; phase += 1) {
+        path.reset();
+        path.addRect(r);
+        test_dash_rects(reporter, path, SkIntToScalar(phase));
+        path.reset();
+        path.addRect(r, SkPath::kCCW_Direction);
+        test_dash_rects(reporter, path, SkIntToScalar(phase));
+    }
+}
+
+#include "TestClassDef.h"
+DEFINE_TESTCLASS("DashPathEffect", DashPathEffectClass, TestDashPathEffect)
@@ -6,6 +6,11 @@
  */
 
 #include "Test.h"
+#include "SkBitmap.h"
+#include "SkMatrix.h"
+#include "SkPaint.h"
+#include "SkRandom.h"
+#include "SkRasterClip.h"
 #include "SkRegion.h"
 #include "SkPath.h"
 #include "SkScan.h"
@@ -48,5 +53,84 @@ static void TestFillPathInverse(skiatest::Reporter* reporter) {
   REPORTER_ASSERT(reporter, blitter.m_blitCount == expected_lines);
 }
 
+static void make_random_path(SkPath* path, SkRandom* rand, int verbs) {
+    // some points fall outside of the clip
+    const SkScalar size = SkIntToScalar(120);
+    path->moveTo(rand->nextUScalar1() * size, rand->nextUScalar1() * size);
+    for (int i = 0; i < verbs; ++i) {
+        SkPoint pts[2];
+        for (int j = 0; j < 2; ++j) {
+            pts[j].set(rand->nextUScalar1() * size, rand->nextUScalar1() * size);
+        }
+        switch (rand->nextU() % 8) {
+            case 0:
+                path->quadTo(pts[0], pts[1]);
+                break;
+            case 1:
+                path->addCircle(pts[0].fX, pts[0].fY, rand->nextUScalar1() * 30);
+                path->moveTo(pts[1]);
+                break;
+            default:
+                path->lineTo(pts[0]);
+                break;
+        }
+    }
+    path->close();
+}
+
+static void draw_with_walker(SkBitmap* bm, const SkPath& path, const SkPaint& paint,
+                             SkScan::EdgeWalker walker) {
+    bm->setConfig(SkBitmap::kARGB_8888_Config, 100, 100);
+    bm->allocPixels();
+    bm->eraseColor(SK_ColorWHITE);
+
+    SkAutoLockPixels alp(*bm);
+    SkAutoTDelete<SkBlitter> blitter(SkBlitter::Choose(*bm, SkMatrix::I(), paint));
+    SkRasterClip clip(SkIRect::MakeLTRB(3, 5, 97, 90));
+    if (paint.isAntiAlias()) {
+        SkScan::AntiFillPath(path, clip, blitter.get(), walker);
+    } else {
+        SkScan::FillPath(path, clip, blitter.get(), walker);
+    }
+}
+
+static bool same_pixels(const SkBitmap& a, const SkBitmap& b) {
+    SkAutoLockPixels alpa(a);
+    SkAutoLockPixels alpb(b);
+    return 0 == memcmp(a.getPixels(), b.getPixels(), a.getSize());
+}
+
+// The linked list and array edge walkers must draw exactly the same pixels.
+static void TestEdgeWalkers(skiatest::Reporter* reporter) {
+    static const SkPath::FillType gFillTypes[] = {
+        SkPath::kWinding_FillType,
+        SkPath::kEvenOdd_FillType,
+        SkPath::kInverseWinding_FillType,
+        SkPath::kInverseEvenOdd_FillType,
+    };
+
+    SkRandom rand;
+    for (int i = 0; i < 40; ++i) {
+        SkPath path;
+        make_random_path(&path, &rand, 2 + i * 5);
+        path.setFillType(gFillTypes[i % SK_ARRAY_COUNT(gFillTypes)]);
+
+        SkPaint paint;
+        paint.setColor(0xC0204080);
+        for (int aa = 0; aa <= 1; ++aa) {
+            paint.setAntiAlias(SkToBool(aa));
+            SkBitmap list, arrays;
+            draw_with_walker(&list, path, paint, SkScan::kList_EdgeWalker);
+            draw_with_walker(&arrays, path, paint, SkScan::kArray_EdgeWalker);
+            REPORTER_ASSERT(reporter, same_pixels(list, arrays));
+        }
+    }
+}
+
+static void TestFillPath(skiatest::Reporter* reporter) {
+    TestFillPathInverse(reporter);
+    TestEdgeWalkers(reporter);
+}
+
 #include "TestClassDef.h"
-DEFINE_TESTCLASS("FillPath", FillPathTestClass, TestFillPathInverse)
+DEFINE_TESTCLASS("FillPath", FillPathTestClass, TestFillPath)
@@ -0,0 +1,130 @@
+
+/*
+ * Copyright 2012 Google Inc.
+ *
+ * Use of this source code is governed by a BSD-style license that can be
+ * found in the LICENSE file.
+ */
+
+#include "Test.h"
+// This is a GPU-backend specific test
+#if SK_SUPPORT_GPU
+#include "GrBufferAllocPool.h"
+#include "GrContext.h"
+#include "GrGpu.h"
+#include "GrInOrderDrawBuffer.h"
+#include "GrTexture.h"
+#include "SkNullGLContext.h"
+
+static const GrColor kColorA = 0xff0000ff;
+static const GrColor kColorB = 0xff00ff00;
+
+// Records 'count' rects alternating between two colors (and so between two
+// draw states). The rects are either spread out or all on top of each other.
+static void record_rects(GrInOrderDrawBuffer* buffer, int count, bool overlap) {
+    for (int i = 0; i < count; ++i) {
+        buffer->drawState()->setColor((i & 1) ? kColorB : kColorA);
+        GrScalar x = overlap ? 0 : SkIntToScalar(12 * i);
+        GrRect rect = GrRect::MakeXYWH(x, 0, SkIntToScalar(10),
+                                       SkIntToScalar(10));
+        buffer->drawRect(rect, NULL, NULL, NULL);
+    }
+}
+
+static void test_draw_batching(skiatest::Reporter* reporter,
+                               GrContext* context) {
+    GrGpu* gpu = context->getGpu();
+
+    GrTextureDesc desc;
+    desc.fFlags     = kRenderTarget_GrTextureFlagBit;
+    desc.fConfig    = kSkia8888_PM_GrPixelConfig;
+    desc.fWidth     = 256;
+    desc.fHeight    = 256;
+    GrTexture* texture = context->createUncachedTexture(desc, NULL, 0);
+    REPORTER_ASSERT(reporter, NULL != texture);
+    if (NULL == texture) {
+        return;
+    }
+    GrAutoUnref au(texture);
+
+    GrVertexBufferAllocPool vertexPool(gpu, false, 1 << 15, 4);
+    GrIndexBufferAllocPool indexPool(gpu, false, 1 << 11, 4);
+    {
+        GrInOrderDrawBuffer buffer(gpu, &vertexPool, &indexPool);
+        buffer.setQuadIndexBuffer(gpu->getQuadIndexBuffer());
+        buffer.drawState()->setRenderTarget(texture->asRenderTarget());
+
+        // interleaved states, nothing overlaps: each state is issued once
+        buffer.resetDrawStats();
+        record_rects(&buffer, 8, false);
+        buffer.flushTo(gpu);
+        const GrInOrderDrawBuffer::DrawStats& stats = buffer.getDrawStats();
+        REPORTER_ASSERT(reporter, 8 == stats.fRecordedDraws);
+        REPORTER_ASSERT(reporter, 2 == stats.fIssuedDraws);
+        REPORTER_ASSERT(reporter, 3 == stats.fReorderedDraws);
+
+        // every rect covers the previous one, so painter's order must be kept
+        buffer.resetDrawStats();
+        record_rects(&buffer, 8, true);
+        buffer.flushTo(gpu);
+        REPORTER_ASSERT(reporter, 8 == stats.fRecordedDraws);
+        REPORTER_ASSERT(reporter, 8 == stats.fIssuedDraws);
+        REPORTER_ASSERT(reporter, 0 == stats.fReorderedDraws);
+
+        // draws are not moved past a clear
+        buffer.resetDrawStats();
+        record_rects(&buffer, 2, false);
+        buffer.clear(NULL, 0);
+        buffer.drawState()->setColor(kColorA);
+        buffer.drawRect(GrRect::MakeXYWH(SkIntToScalar(100), 0,
+                                         SkIntToScalar(10), SkIntToScalar(10)),
+                        NULL, NULL, NULL);
+        buffer.flushTo(gpu);
+        REPORTER_ASSERT(reporter, 3 == stats.fRecordedDraws);
+        REPORTER_ASSERT(reporter, 3 == stats.fIssuedDraws);
+
+        // consecutive rects with the same state are still joined as they
+        // are recorded
+        buffer.resetDrawStats();
+        for (int i = 0; i < 4; ++i) {
+            buffer.drawState()->setColor(kColorA);
+            buffer.drawRect(GrRect::MakeXYWH(SkIntToScalar(12 * i), 0,
+                                             SkIntToScalar(10),
+                                             SkIntToScalar(10)),
+                            NULL, NULL, NULL);
+        }
+        buffer.flushTo(gpu);
+        REPORTER_ASSERT(reporter, 4 == stats.fRecordedDraws);
+        REPORTER_ASSERT(reporter, 1 == stats.fIssuedDraws);
+
+        // without reordering the interleaved draws are issued as recorded
+        buffer.setDrawReordering(false);
+        buffer.resetDrawStats();
+        record_rects(&buffer, 8, false);
+        buffer.flushTo(gpu);
+        REPORTER_ASSERT(reporter, 8 == stats.fRecordedDraws);
+        REPORTER_ASSERT(reporter, 8 == stats.fIssuedDraws);
+        REPORTER_ASSERT(reporter, 0 == stats.fReorderedDraws);
+    }
+}
+
+static void TestGrInOrderDrawBuffer(skiatest::Reporter* reporter) {
+    SkAutoTUnref<SkGLContext> glContext(SkNEW(SkNullGLContext));
+    if (!glContext.get()->init(32, 32)) {
+        return;
+    }
+    GrPlatform3DContext ctx =
+        reinterpret_cast<GrPlatform3DContext>(glContext.get()->gl());
+    SkAutoTUnref<GrContext> context(GrContext::Create(kOpenGL_Shaders_GrEngine,
+                                                      ctx));
+    REPORTER_ASSERT(reporter, NULL != context.get());
+    if (NULL != context.get()) {
+        test_draw_batching(reporter, context.get());
+    }
+}
+
+#include "TestClassDef.h"
+DEFINE_TESTCLASS("GrInOrderDrawBuffer", GrInOrderDrawBufferClass,
+                 TestGrInOrderDrawBuffer)
+
+#endif
@@ -0,0 +1,79 @@
+
+/*
+ * Copyright 2012 Google Inc.
+ *
+ * Use of this source code is governed by a BSD-style license that can be
+ * found in the LICENSE file.
+ */
+
+#include "Test.h"
+// This is a GPU-backend specific test
+#if SK_SUPPORT_GPU
+#include "GrRectanizer.h"
+#include "SkRandom.h"
+#include "SkRect.h"
+#include "SkTDArray.h"
+
+static const int kWidth = 256;
+static const int kHeight = 256;
+
+static void test_rectanizer(skiatest::Reporter* reporter,
+                            GrRectanizer::Type type) {
+    GrRectanizer* rects = GrRectanizer::Factory(kWidth, kHeight, type);
+    REPORTER_ASSERT(reporter, 0 == rects->percentFull());
+
+    // too big never fits
+    GrIPoint16 loc;
+    REPORTER_ASSERT(reporter, !rects->addRect(kWidth + 1, 1, &loc));
+    REPORTER_ASSERT(reporter, !rects->addRect(1, kHeight + 1, &loc));
+
+    SkRandom rand;
+    SkTDArray<SkIRect> placed;
+    int32_t area = 0;
+    for (int i = 0; i < 1000; ++i) {
+        int w = rand.nextRangeU(1, 24);
+        int h = rand.nextRangeU(1, 24);
+        if (!rects->addRect(w, h, &loc)) {
+            continue;
+        }
+        SkIRect r = SkIRect::MakeXYWH(loc.fX, loc.fY, w, h);
+        REPORTER_ASSERT(reporter, r.fLeft >= 0 && r.fTop >= 0);
+        REPORTER_ASSERT(reporter, r.fRight <= kWidth && r.fBottom <= kHeight);
+        for (int j = 0; j < placed.count(); ++j) {
+            REPORTER_ASSERT(reporter, !SkIRect::Intersects(placed[j], r));
+        }
+        *placed.append() = r;
+        area += w * h;
+    }
+
+    REPORTER_ASSERT(reporter, placed.count() > 0);
+    float expected = area / ((float)kWidth * kHeight);
+    REPORTER_ASSERT(reporter, rects->percentFull() == expected);
+
+    delete rects;
+}
+
+static void test_skyline_fill(skiatest::Reporter* reporter) {
+    // uniform squares must tile the skyline rectanizer completely
+    GrRectanizer* rects = GrRectanizer::Factory(kWidth, kHeight,
+                                                GrRectanizer::kSkyline_Type);
+    GrIPoint16 loc;
+    int count = 0;
+    while (rects->addRect(16, 16, &loc)) {
+        ++count;
+    }
+    REPORTER_ASSERT(reporter, (kWidth / 16) * (kHeight / 16) == count);
+    REPORTER_ASSERT(reporter, 1 == rects->percentFull());
+    delete rects;
+}
+
+static void TestGrRectanizer(skiatest::Reporter* reporter) {
+    test_rectanizer(reporter, GrRectanizer::kPow2_Type);
+    test_rectanizer(reporter, GrRectanizer::kSkyline_Type);
+    test_skyline_fill(reporter);
+}
+
+#include "TestClassDef.h"
+DEFINE_TESTCLASS("GrRectanizer", GrRectanizerClass, TestGrRectanizer)
+
+#endif
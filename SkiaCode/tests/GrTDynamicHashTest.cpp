@@ -0,0 +1,144 @@
+
+/*
+ * Copyright 2012 Google Inc.
+ *
+ * Use of this source code is governed by a BSD-style license that can be
+ * found in the LICENSE file.
+ */
+
+#include "Test.h"
+// This is a GPU-backend specific test
+#if SK_SUPPORT_GPU
+#include "GrTDynamicHash.h"
+#include "SkRandom.h"
+#include "SkTDArray.h"
+
+namespace {
+
+struct Entry {
+    uint32_t fKey;
+    int      fValue;
+};
+
+class EntryKey {
+public:
+    EntryKey(uint32_t key) : fKey(key) {}
+
+    // deliberately poor hash so that probe chains get long
+    uint32_t getHash() const { return fKey & 0xFF; }
+
+    static bool EQ(const Entry& entry, const EntryKey& key) {
+        return entry.fKey == key.fKey;
+    }
+    static uint32_t GetHash(const Entry& entry) {
+        return entry.fKey & 0xFF;
+    }
+
+private:
+    uint32_t fKey;
+};
+
+typedef GrTDynamicHash<Entry, EntryKey> EntryHash;
+
+}
+
+static void test_dynamic_hash(skiatest::Reporter* reporter) {
+    enum {
+        kCount = 2000,
+    };
+    Entry entries[kCount];
+    EntryHash hash;
+
+    REPORTER_ASSERT(reporter, NULL == hash.find(EntryKey(0)));
+
+    for (int i = 0; i < kCount; ++i) {
+        entries[i].fKey = i;
+        entries[i].fValue = i * 3;
+        hash.insert(EntryKey(i), &entries[i]);
+    }
+    REPORTER_ASSERT(reporter, kCount == hash.count());
+    // the table grows and keeps itself at most 3/4 full
+    REPORTER_ASSERT(reporter, 4 * hash.count() <= 3 * hash.capacity());
+#if GR_DEBUG
+    hash.validate();
+#endif
+
+    for (int i = 0; i < kCount; ++i) {
+        Entry* found = hash.find(EntryKey(i));
+        REPORTER_ASSERT(reporter, found == &entries[i]);
+    }
+    REPORTER_ASSERT(reporter, NULL == hash.find(EntryKey(kCount)));
+
+    // remove a random half and check the rest is still reachable through
+    // the tombstones
+    SkRandom rand;
+    bool removed[kCount];
+    int removedCount = 0;
+    for (int i = 0; i < kCount; ++i) {
+        removed[i] = rand.nextBool();
+        if (removed[i]) {
+            hash.remove(EntryKey(i), &entries[i]);
+            ++removedCount;
+        }
+    }
+    REPORTER_ASSERT(reporter, kCount - removedCount == hash.count());
+#if GR_DEBUG
+    hash.validate();
+#endif
+    for (int i = 0; i < kCount; ++i) {
+        Entry* found = hash.find(EntryKey(i));
+        REPORTER_ASSERT(reporter, found == (removed[i] ? NULL : &entries[i]));
+    }
+
+    // churn: repeated insert/remove must not fill the table with tombstones
+    int capacity = hash.capacity();
+    for (int round = 0; round < 20; ++round) {
+        for (int i = 0; i < kCount; ++i) {
+            if (removed[i]) {
+                hash.insert(EntryKey(i), &entries[i]);
+            }
+        }
+        for (int i = 0; i < kCount; ++i) {
+            if (removed[i]) {
+                hash.remove(EntryKey(i), &entries[i]);
+            }
+        }
+    }
+    REPORTER_ASSERT(reporter, hash.capacity() == capacity);
+#if GR_DEBUG
+    hash.validate();
+#endif
+
+    hash.removeAll();
+    REPORTER_ASSERT(reporter, 0 == hash.count());
+    REPORTER_ASSERT(reporter, NULL == hash.find(EntryKey(1)));
+}
+
+static void test_duplicates(skiatest::Reporter* reporter) {
+    Entry a = { 7, 1 };
+    Entry b = { 7, 2 };
+    EntryHash hash;
+
+    hash.insert(EntryKey(7), &a);
+    hash.insert(EntryKey(7), &b);
+    REPORTER_ASSERT(reporter, 2 == hash.count());
+
+    Entry* found = hash.find(EntryKey(7));
+    REPORTER_ASSERT(reporter, found == &a || found == &b);
+
+    // removing a specific duplicate leaves the other one
+    hash.remove(EntryKey(7), &a);
+    REPORTER_ASSERT(reporter, hash.find(EntryKey(7)) == &b);
+    hash.remove(EntryKey(7), &b);
+    REPORTER_ASSERT(reporter, NULL == hash.find(EntryKey(7)));
+}
+
+static void TestGrTDynamicHash(skiatest::Reporter* reporter) {
+    test_dynamic_hash(reporter);
+    test_duplicates(reporter);
+}
+
+#include "TestClassDef.h"
+DEFINE_TESTCLASS("GrTDynamicHash", GrTDynamicHashClass, TestGrTDynamicHash)
+
+#endif
@@ -0,0 +1,125 @@
+
+/*
+ * Copyright 2012 Google Inc.
+ *
+ * Use of this source code is governed by a BSD-style license that can be
+ * found in the LICENSE file.
+ */
+
+#include "Test.h"
+#include "SkBitmap.h"
+#include "SkBlurImageFilter.h"
+#include "SkCanvas.h"
+#include "SkColorFilterImageFilter.h"
+#include "SkColorMatrixFilter.h"
+#include "SkLightingImageFilter.h"
+#include "SkMorphologyImageFilter.h"
+#include "SkParallelFor.h"
+#include "SkRandom.h"
+
+static void serial_for(int count, void (*proc)(void*, int), void* context) {
+    // run backwards, so nothing depends on the tiles being done in order
+    for (int i = count - 1; i >= 0; --i) {
+        proc(context, i);
+    }
+}
+
+// Random blobs of color, so every filter has edges to work on.
+static void make_src(SkBitmap* bm, int width, int height) {
+    bm->setConfig(SkBitmap::kARGB_8888_Config, width, height);
+    bm->allocPixels();
+    bm->eraseColor(0);
+
+    SkCanvas canvas(*bm);
+    SkRandom rand;
+    SkPaint paint;
+    paint.setAntiAlias(true);
+    for (int i = 0; i < 40; ++i) {
+        paint.setColor(rand.nextU() | 0x40000000);
+        canvas.drawCircle(rand.nextUScalar1() * width,
+                          rand.nextUScalar1() * height,
+                          rand.nextUScalar1() * 40 + 2, paint);
+    }
+}
+
+static void draw_filtered(const SkBitmap& src, SkImageFilter* filter,
+                          SkBitmap* dst) {
+    dst->setConfig(SkBitmap::kARGB_8888_Config, src.width(), src.height());
+    dst->allocPixels();
+    dst->eraseColor(0);
+
+    SkCanvas canvas(*dst);
+    SkPaint paint;
+    paint.setImageFilter(filter);
+    canvas.drawSprite(src, 0, 0, &paint);
+}
+
+static bool equal_pixels(const SkBitmap& a, const SkBitmap& b) {
+    SkAutoLockPixels alpA(a);
+    SkAutoLockPixels alpB(b);
+    for (int y = 0; y < a.height(); ++y) {
+        if (memcmp(a.getAddr32(0, y), b.getAddr32(0, y), a.width() << 2)) {
+            return false;
+        }
+    }
+    return true;
+}
+
+// Filtering in tiles must give exactly the result of filtering in one pass.
+static void TestImageFilter(skiatest::Reporter* reporter) {
+    SkBitmap src;
+    make_src(&src, 301, 203);
+
+    SkScalar matrix[20];
+    memset(matrix, 0, sizeof(matrix));
+    matrix[2] = matrix[6] = matrix[10] = matrix[18] = SK_Scalar1;
+    SkAutoTUnref<SkColorFilter> cf(SkNEW_ARGS(SkColorMatrixFilter, (matrix)));
+
+    SkPoint3 direction(SK_Scalar1, -SK_Scalar1, SkIntToScalar(2));
+    SkPoint3 location(SkIntToScalar(150), SkIntToScalar(100), SkIntToScalar(20));
+
+    SkAutoTUnref<SkImageFilter> dilate(SkNEW_ARGS(SkDilateImageFilter, (2, 3)));
+    SkImageFilter* filters[] = {
+        SkNEW_ARGS(SkBlurImageFilter, (SkIntToScalar(3), SkIntToScalar(5))),
+        SkNEW_ARGS(SkBlurImageFilter, (SkIntToScalar(2), 0, dilate)),
+        SkNEW_ARGS(SkDilateImageFilter, (4, 1)),
+        SkNEW_ARGS(SkErodeImageFilter, (1, 6)),
+        SkNEW_ARGS(SkColorFilterImageFilter, (cf)),
+        SkLightingImageFilter::CreateDistantLitDiffuse(direction, SK_ColorWHITE,
+                                                       SK_Scalar1, SK_Scalar1),
+        SkLightingImageFilter::CreateDistantLitSpecular(direction, SK_ColorWHITE,
+                                                        SK_Scalar1, SK_Scalar1,
+                                                        SkIntToScalar(4)),
+        // not tiled, but must still come out the same
+        SkLightingImageFilter::CreatePointLitDiffuse(location, SK_ColorWHITE,
+                                                     SK_Scalar1, SK_Scalar1),
+    };
+
+    SkMatrix identity;
+    identity.reset();
+    SkISize margin;
+    REPORTER_ASSERT(reporter, filters[1]->filterMargin(identity, &margin));
+    REPORTER_ASSERT(reporter, margin.width() > 2 && 3 == margin.height());
+    REPORTER_ASSERT(reporter, !filters[7]->filterMargin(identity, &margin));
+
+    for (size_t i = 0; i < SK_ARRAY_COUNT(filters); ++i) {
+        SkImageFilter::SetParallelFor(NULL);
+        SkBitmap expected;
+        draw_filtered(src, filters[i], &expected);
+
+        SkBitmap actual;
+        SkImageFilter::SetParallelFor(serial_for, 64);
+        draw_filtered(src, filters[i], &actual);
+        REPORTER_ASSERT(reporter, equal_pixels(expected, actual));
+
+        SkImageFilter::SetParallelFor(SkThreadedFor, 50);
+        draw_filtered(src, filters[i], &actual);
+        REPORTER_ASSERT(reporter, equal_pixels(expected, actual));
+
+        filters[i]->unref();
+    }
+    SkImageFilter::SetParallelFor(NULL);
+}
+
+#include "TestClassDef.h"
+DEFINE_TESTCLASS("ImageFilter", ImageFilterTestClass, TestImageFilter)
@@ -0,0 +1,142 @@
+/*
+ * Copyright 2012 Google Inc.
+ *
+ * Use of this source code is governed by a BSD-style license that can be
+ * found in the LICENSE file.
+ */
+
+#include "Test.h"
+#include "SkBitmap.h"
+#include "SkCanvas.h"
+#include "SkData.h"
+#include "SkImageEncoder.h"
+#include "SkImageRef.h"
+#include "SkImageRef_GlobalPool.h"
+#include "SkParallelFor.h"
+#include "SkRandom.h"
+#include "SkStream.h"
+
+// SkImageRef is abstract, since it can't be flattened.
+class PlainImageRef : public SkImageRef {
+public:
+    PlainImageRef(SkStream* stream)
+        : INHERITED(stream, SkBitmap::kARGB_8888_Config) {}
+    SK_DECLARE_UNFLATTENABLE_OBJECT()
+
+private:
+    typedef SkImageRef INHERITED;
+};
+
+static const int kWidth = 64;
+static const int kHeight = 48;
+static const int kImageCount = 12;
+
+// Opaque, so the png round trip gives back exactly the same pixels.
+static void make_bitmap(SkBitmap* bm, SkRandom* rand) {
+    bm->setConfig(SkBitmap::kARGB_8888_Config, kWidth, kHeight);
+    bm->allocPixels();
+    bm->eraseColor(rand->nextU() | 0xFF000000);
+
+    SkCanvas canvas(*bm);
+    SkPaint paint;
+    for (int i = 0; i < 5; ++i) {
+        paint.setColor(rand->nextU() | 0xFF000000);
+        canvas.drawCircle(rand->nextUScalar1() * kWidth,
+                          rand->nextUScalar1() * kHeight,
+                          rand->nextUScalar1() * 20 + 2, paint);
+    }
+}
+
+static SkStream* encode_png(const SkBitmap& bm) {
+    SkDynamicMemoryWStream wstream;
+    if (!SkImageEncoder::EncodeStream(&wstream, bm,
+                                      SkImageEncoder::kPNG_Type, 100)) {
+        return NULL;
+    }
+    SkAutoTUnref<SkData> data(wstream.copyToData());
+    return SkNEW_ARGS(SkMemoryStream, (data->data(), data->size(), true));
+}
+
+static bool equal_pixels(const SkBitmap& a, const SkBitmap& b) {
+    SkAutoLockPixels alpA(a);
+    SkAutoLockPixels alpB(b);
+    if (NULL == a.getPixels() || NULL == b.getPixels()) {
+        return false;
+    }
+    for (int y = 0; y < a.height(); ++y) {
+        if (memcmp(a.getAddr32(0, y), b.getAddr32(0, y), a.width() << 2)) {
+            return false;
+        }
+    }
+    return true;
+}
+
+static bool check_ref(SkImageRef* ref, const SkBitmap& expected) {
+    SkBitmap bm;
+    if (!ref->getInfo(&bm)) {
+        return false;
+    }
+    bm.setPixelRef(ref);
+    return equal_pixels(expected, bm);
+}
+
+static void TestImageRef(skiatest::Reporter* reporter) {
+    SkRandom rand;
+    SkBitmap expected[kImageCount];
+    SkImageRef* refs[kImageCount];
+    SkImageRef* poolRefs[kImageCount];
+
+    for (int i = 0; i < kImageCount; ++i) {
+        make_bitmap(&expected[i], &rand);
+        SkAutoTUnref<SkStream> stream(encode_png(expected[i]));
+        if (NULL == stream.get()) {
+            // no png encoder in this build
+            return;
+        }
+        refs[i] = SkNEW_ARGS(PlainImageRef, (stream));
+        poolRefs[i] = SkNEW_ARGS(SkImageRef_GlobalPool,
+                                 (stream, SkBitmap::kARGB_8888_Config));
+    }
+
+    // Decoding on several threads at once must give each image its own
+    // pixels.
+    SkImageRef::Prefetch(refs, kImageCount, SkThreadedFor);
+    for (int i = 0; i < kImageCount; ++i) {
+        REPORTER_ASSERT(reporter, check_ref(refs[i], expected[i]));
+    }
+
+    // Pooled imagerefs decode concurrently too, and the pool keeps its
+    // budget.
+    size_t imageSize = expected[0].getSize();
+    size_t oldBudget = SkImageRef_GlobalPool::GetRAMBudget();
+    size_t oldUsed = SkImageRef_GlobalPool::GetRAMUsed();
+
+    SkImageRef_GlobalPool::SetRAMBudget(0);
+    SkImageRef::Prefetch(poolRefs, kImageCount, SkThreadedFor);
+    REPORTER_ASSERT(reporter, SkImageRef_GlobalPool::GetRAMUsed() ==
+                              oldUsed + kImageCount * imageSize);
+
+    SkImageRef_GlobalPool::SetRAMBudget(oldUsed + 3 * imageSize);
+    REPORTER_ASSERT(reporter, SkImageRef_GlobalPool::GetRAMUsed() <=
+                              oldUsed + 3 * imageSize);
+    SkImageRef::Prefetch(poolRefs, kImageCount, SkThreadedFor);
+    REPORTER_ASSERT(reporter, SkImageRef_GlobalPool::GetRAMUsed() <=
+                              oldUsed + 3 * imageSize);
+
+    // purged images decode again when they are locked
+    for (int i = 0; i < kImageCount; ++i) {
+        REPORTER_ASSERT(reporter, check_ref(poolRefs[i], expected[i]));
+    }
+    REPORTER_ASSERT(reporter, SkImageRef_GlobalPool::GetRAMUsed() <=
+                              oldUsed + 3 * imageSize);
+
+    for (int i = 0; i < kImageCount; ++i) {
+        refs[i]->unref();
+        poolRefs[i]->unref();
+    }
+    REPORTER_ASSERT(reporter, SkImageRef_GlobalPool::GetRAMUsed() == oldUsed);
+    SkImageRef_GlobalPool::SetRAMBudget(oldBudget);
+}
+
+#include "TestClassDef.h"
+DEFINE_TESTCLASS("ImageRef", ImageRefTestClass, TestImageRef)
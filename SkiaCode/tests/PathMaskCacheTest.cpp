@@ -0,0 +1,134 @@
+
+/*
+ * Copyright 2012 Google Inc.
+ *
+ * Use of this source code is governed by a BSD-style license that can be
+ * found in the LICENSE file.
+ */
+
+#include "Test.h"
+#include "SkBitmap.h"
+#include "SkCanvas.h"
+#include "SkGraphics.h"
+#include "SkPaint.h"
+#include "SkPath.h"
+#include "SkPathMaskCache.h"
+
+static void make_star(SkPath* path) {
+    path->moveTo(SkIntToScalar(20), 0);
+    path->lineTo(SkIntToScalar(32), SkIntToScalar(38));
+    path->lineTo(0, SkIntToScalar(14));
+    path->lineTo(SkIntToScalar(40), SkIntToScalar(14));
+    path->lineTo(SkIntToScalar(8), SkIntToScalar(38));
+    path->close();
+}
+
+// Draws path a few times, at fractional positions that differ by whole
+// pixels, so the later draws can reuse the first one's mask.
+static void draw_path(SkBitmap* bm, const SkPath& path, const SkPaint& paint) {
+    bm->setConfig(SkBitmap::kARGB_8888_Config, 200, 100);
+    bm->allocPixels();
+    bm->eraseColor(SK_ColorWHITE);
+
+    SkCanvas canvas(*bm);
+    canvas.clipRect(SkRect::MakeXYWH(SkIntToScalar(5), SkIntToScalar(5),
+                                     SkIntToScalar(150), SkIntToScalar(80)));
+    for (int i = 0; i < 4; ++i) {
+        canvas.save();
+        canvas.translate(SkFloatToScalar(10.25f) + SkIntToScalar(45 * i),
+                         SkFloatToScalar(20.5f) - SkIntToScalar(7 * i));
+        canvas.drawPath(path, paint);
+        canvas.restore();
+    }
+}
+
+// blitMask and the scan converter's blitAntiH round differently, so the
+// cached draws may be off by one.
+static const int kTolerance = 1;
+
+static int max_component_diff(const SkBitmap& a, const SkBitmap& b) {
+    SkAutoLockPixels alpa(a);
+    SkAutoLockPixels alpb(b);
+    int maxDiff = 0;
+    for (int y = 0; y < a.height(); ++y) {
+        for (int x = 0; x < a.width(); ++x) {
+            SkPMColor ca = *a.getAddr32(x, y);
+            SkPMColor cb = *b.getAddr32(x, y);
+            for (int shift = 0; shift < 32; shift += 8) {
+                int diff = SkAbs32((int)((ca >> shift) & 0xFF) -
+                                   (int)((cb >> shift) & 0xFF));
+                maxDiff = SkMax32(maxDiff, diff);
+            }
+        }
+    }
+    return maxDiff;
+}
+
+static void test_cache(skiatest::Reporter* reporter, const SkPaint& paint) {
+    SkPath path;
+    make_star(&path);
+
+    size_t prevLimit = SkGraphics::SetPathMaskCacheLimit(0);
+    SkBitmap expected;
+    draw_path(&expected, path, paint);
+
+    SkGraphics::SetPathMaskCacheLimit(SkPathMaskCache::kSuggestedByteLimit);
+    SkPathMaskCache::ResetStats();
+    SkBitmap actual;
+    draw_path(&actual, path, paint);
+
+    SkPathMaskCache::Stats stats;
+    SkPathMaskCache::GetStats(&stats);
+    // the first draw is only noted, the second one is cached
+    REPORTER_ASSERT(reporter, 1 == stats.fAdds);
+    REPORTER_ASSERT(reporter, 2 == stats.fHits);
+    REPORTER_ASSERT(reporter, 2 == stats.fMisses);
+    REPORTER_ASSERT(reporter, stats.fBytesUsed > 0);
+    REPORTER_ASSERT(reporter, max_component_diff(expected, actual) <= kTolerance);
+
+    // editing the path must not reuse the old mask
+    SkPathMaskCache::ResetStats();
+    path.lineTo(SkIntToScalar(60), SkIntToScalar(60));
+    SkGraphics::SetPathMaskCacheLimit(0);
+    draw_path(&expected, path, paint);
+    SkGraphics::SetPathMaskCacheLimit(SkPathMaskCache::kSuggestedByteLimit);
+    draw_path(&actual, path, paint);
+    SkPathMaskCache::GetStats(&stats);
+    REPORTER_ASSERT(reporter, 2 == stats.fHits);
+    REPORTER_ASSERT(reporter, max_component_diff(expected, actual) <= kTolerance);
+
+    SkGraphics::PurgePathMaskCache();
+    REPORTER_ASSERT(reporter, 0 == SkGraphics::GetPathMaskCacheUsed());
+    SkGraphics::SetPathMaskCacheLimit(prevLimit);
+}
+
+static void TestPathMaskCache(skiatest::Reporter* reporter) {
+    // off unless asked for, so that draws don't depend on what came before
+    REPORTER_ASSERT(reporter, 0 == SkGraphics::GetPathMaskCacheLimit());
+
+    SkPaint paint;
+    paint.setAntiAlias(true);
+    paint.setColor(0x80FF4020);
+    test_cache(reporter, paint);
+
+    paint.setStyle(SkPaint::kStroke_Style);
+    paint.setStrokeWidth(SkIntToScalar(3));
+    paint.setStrokeJoin(SkPaint::kRound_Join);
+    test_cache(reporter, paint);
+
+    // hairlines are never cached
+    paint.setStrokeWidth(0);
+    SkPath path;
+    make_star(&path);
+    size_t prevLimit = SkGraphics::SetPathMaskCacheLimit(SkPathMaskCache::kSuggestedByteLimit);
+    SkPathMaskCache::ResetStats();
+    SkBitmap bm;
+    draw_path(&bm, path, paint);
+    SkPathMaskCache::Stats stats;
+    SkPathMaskCache::GetStats(&stats);
+    REPORTER_ASSERT(reporter, 0 == stats.fAdds && 0 == stats.fMisses);
+    SkGraphics::SetPathMaskCacheLimit(prevLimit);
+}
+
+#include "TestClassDef.h"
+DEFINE_TESTCLASS("PathMaskCache", PathMaskCacheClass, TestPathMaskCache)
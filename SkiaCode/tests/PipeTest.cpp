@@ -43,7 +43,58 @@ static void testDrawingAfterEndRecording(SkCanvas* canvas) {
     pipeCanvas->drawBitmap(bm, 0, 0);
 }
 
-static void test_pipeTests(skiatest::Reporter*) {
+static void drawRects(SkCanvas* canvas, int start, int count) {
+    SkPaint paint;
+    for (int i = start; i < start + count; ++i) {
+        paint.setColor(SkColorSetARGB(0xFF, (i * 37) & 0xFF, (i * 59) & 0xFF,
+                                     (i * 101) & 0xFF));
+        SkRect r = SkRect::MakeXYWH(SkIntToScalar(i % 61), SkIntToScalar(i % 53),
+                                    SkIntToScalar(1 + i % 7), SkIntToScalar(1 + i % 5));
+        canvas->drawRect(r, paint);
+    }
+}
+
+// Plays enough commands through a ThreadedPipeController with a small ring that
+// the writer has to wait for blocks, and checks the result matches drawing
+// directly.
+static void testThreadedPipe(skiatest::Reporter* reporter) {
+    static const int kRectCount = 4000;
+
+    SkBitmap expected;
+    expected.setConfig(SkBitmap::kARGB_8888_Config, 64, 64);
+    expected.allocPixels();
+    expected.eraseColor(0);
+    SkCanvas expectedCanvas(expected);
+    drawRects(&expectedCanvas, 0, kRectCount);
+
+    SkBitmap actual;
+    actual.setConfig(SkBitmap::kARGB_8888_Config, 64, 64);
+    actual.allocPixels();
+    actual.eraseColor(0);
+    SkCanvas actualCanvas(actual);
+    {
+        ThreadedPipeController controller(&actualCanvas, 2);
+        SkGPipeWriter writer;
+        SkCanvas* pipeCanvas = writer.startRecording(&controller,
+                                                     SkGPipeWriter::kCrossProcess_Flag);
+        drawRects(pipeCanvas, 0, kRectCount / 2);
+        ThreadedPipeController::Fence fence = controller.insertFence();
+        drawRects(pipeCanvas, kRectCount / 2, kRectCount / 2);
+        controller.waitForFence(fence);
+        REPORTER_ASSERT(reporter, controller.hasPassed(fence));
+
+        writer.endRecording();
+        controller.drain();
+        REPORTER_ASSERT(reporter, controller.hasPassed(controller.insertFence()));
+    }
+
+    SkAutoLockPixels alpExpected(expected);
+    SkAutoLockPixels alpActual(actual);
+    REPORTER_ASSERT(reporter, 0 == memcmp(expected.getPixels(), actual.getPixels(),
+                                          expected.getSize()));
+}
+
+static void test_pipeTests(skiatest::Reporter* reporter) {
     SkBitmap bitmap;
     bitmap.setConfig(SkBitmap::kARGB_8888_Config, 64, 64);
     SkCanvas canvas(bitmap);
@@ -55,6 +106,8 @@ static void test_pipeTests(skiatest::Reporter*) {
     writer.endRecording();
 
     testDrawingAfterEndRecording(&canvas);
+
+    testThreadedPipe(reporter);
 }
 
 #include "TestClassDef.h"
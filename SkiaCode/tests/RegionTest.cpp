@@ -155,6 +155,66 @@ static bool test_rects(const SkIRect rect[], int count) {
     return true;
 }
 
+// The batched ops must match applying op() to each input in turn.
+static void test_batched_ops(skiatest::Reporter* reporter) {
+    static const SkRegion::Op gOps[] = {
+        SkRegion::kUnion_Op,
+        SkRegion::kIntersect_Op,
+        SkRegion::kXOR_Op,
+    };
+
+    SkRandom rand;
+    SkRegion::Scratch scratch;
+    for (int i = 0; i < 500; ++i) {
+        const int N = 1 + rand.nextU() % 12;
+        SkIRect rects[12];
+        SkRegion rgns[12];
+        const SkRegion* rgnPtrs[12];
+        for (int j = 0; j < N; ++j) {
+            rand_rect(&rects[j], rand);
+            // a mix of empty, rect and complex regions
+            randRgn(rand, &rgns[j], rand.nextU() % 4);
+            if (0 == j % 3) {
+                rgns[j].op(SkIRect::MakeXYWH(W / 4, H / 4, W / 2, H / 2),
+                           SkRegion::kUnion_Op);
+            }
+            rgnPtrs[j] = &rgns[j];
+        }
+
+        for (size_t k = 0; k < SK_ARRAY_COUNT(gOps); ++k) {
+            const SkRegion::Op op = gOps[k];
+
+            SkRegion expected(rects[0]);
+            for (int j = 1; j < N; ++j) {
+                expected.op(rects[j], op);
+            }
+            SkRegion actual;
+            bool nonEmpty = actual.op(rects, N, op, &scratch);
+            REPORTER_ASSERT(reporter, expected == actual);
+            REPORTER_ASSERT(reporter, nonEmpty == !actual.isEmpty());
+
+            expected = rgns[0];
+            for (int j = 1; j < N; ++j) {
+                expected.op(rgns[j], op);
+            }
+            nonEmpty = actual.op(rgnPtrs, N, op, &scratch);
+            REPORTER_ASSERT(reporter, expected == actual);
+            REPORTER_ASSERT(reporter, nonEmpty == !actual.isEmpty());
+
+            // the result may also be one of the inputs
+            SkRegion first(rgns[0]);
+            rgnPtrs[0] = &first;
+            first.op(rgnPtrs, N, op);
+            rgnPtrs[0] = &rgns[0];
+            REPORTER_ASSERT(reporter, expected == first);
+        }
+    }
+
+    SkRegion rgn(SkIRect::MakeWH(10, 10));
+    REPORTER_ASSERT(reporter, !rgn.op((const SkIRect*)NULL, 0, SkRegion::kUnion_Op));
+    REPORTER_ASSERT(reporter, rgn.isEmpty());
+}
+
 static void TestRegion(skiatest::Reporter* reporter) {
     const SkIRect r2[] = {
         { 0, 0, 1, 1 },
@@ -185,6 +245,7 @@ static void TestRegion(skiatest::Reporter* reporter) {
     test_proc(reporter, contains_proc);
     test_proc(reporter, intersects_proc);
     test_empties(reporter);
+    test_batched_ops(reporter);
 }
 
 #include "TestClassDef.h"
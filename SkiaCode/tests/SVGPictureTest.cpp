@@ -0,0 +1,67 @@
+/*
+ * Copyright 2012 Google Inc.
+ *
+ * Use of this source code is governed by a BSD-style license that can be
+ * found in the LICENSE file.
+ */
+#include "Test.h"
+#include "SkBitmap.h"
+#include "SkCanvas.h"
+#include "SkPicture.h"
+#include "SkSVGParser.h"
+#include "SkSVGPicture.h"
+
+// The default Linux build links the empty XML parser, so the document is
+// handed to the SVG parser element by element.
+static void add_rect(SkSVGParser* parser, const char x[], const char y[],
+                     const char size[], const char name[] = NULL,
+                     const char value[] = NULL) {
+    parser->startElement("rect");
+    parser->addAttribute("x", x);
+    parser->addAttribute("y", y);
+    parser->addAttribute("width", size);
+    parser->addAttribute("height", size);
+    if (name) {
+        parser->addAttribute(name, value);
+    }
+    parser->endElement("rect");
+}
+
+// A clip path's children are unioned, each filled with its own clip-rule, so
+// where a nonzero and an evenodd child overlap, the clip is still open.
+static void test_clip_rules(skiatest::Reporter* reporter) {
+    SkSVGParser parser;
+    parser.startElement("svg");
+    parser.addAttribute("width", "20");
+    parser.addAttribute("height", "20");
+    parser.startElement("clipPath");
+    parser.addAttribute("id", "clip");
+    add_rect(&parser, "2", "2", "10");
+    add_rect(&parser, "8", "8", "10", "clip-rule", "evenodd");
+    parser.endElement("clipPath");
+    add_rect(&parser, "0", "0", "20", "clip-path", "url(#clip)");
+    parser.endElement("svg");
+
+    SkPicture picture;
+    REPORTER_ASSERT(reporter, SkSVGPicture::Record(parser, &picture));
+
+    SkBitmap bitmap;
+    bitmap.setConfig(SkBitmap::kARGB_8888_Config, 20, 20);
+    bitmap.allocPixels();
+    bitmap.eraseColor(0);
+    SkCanvas canvas(bitmap);
+    canvas.drawPicture(picture);
+
+    REPORTER_ASSERT(reporter, SK_ColorBLACK == bitmap.getColor(5, 5));
+    REPORTER_ASSERT(reporter, SK_ColorBLACK == bitmap.getColor(10, 10));
+    REPORTER_ASSERT(reporter, SK_ColorBLACK == bitmap.getColor(15, 15));
+    REPORTER_ASSERT(reporter, 0 == bitmap.getColor(15, 4));
+    REPORTER_ASSERT(reporter, 0 == bitmap.getColor(4, 15));
+}
+
+static void TestSVGPicture(skiatest::Reporter* reporter) {
+    test_clip_rules(reporter);
+}
+
+#include "TestClassDef.h"
+DEFINE_TESTCLASS("SVGPicture", SVGPictureTestClass, TestSVGPicture)
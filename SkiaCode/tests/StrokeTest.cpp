@@ -0,0 +1,135 @@
+
+/*
+ * Copyright 2012 Google Inc.
+ *
+ * Use of this source code is governed by a BSD-style license that can be
+ * found in the LICENSE file.
+ */
+
+#include "Test.h"
+#include "SkBitmap.h"
+#include "SkCanvas.h"
+#include "SkGraphics.h"
+#include "SkPaint.h"
+#include "SkParallelFor.h"
+#include "SkPath.h"
+#include "SkRandom.h"
+#include "SkStroke.h"
+
+static void serial_for(int count, void (*proc)(void*, int), void* context) {
+    // run backwards, so nothing depends on the chunks being done in order
+    for (int i = count - 1; i >= 0; --i) {
+        proc(context, i);
+    }
+}
+
+static int gCountingForCalls;
+
+static void counting_for(int count, void (*proc)(void*, int), void* context) {
+    gCountingForCalls += 1;
+    serial_for(count, proc, context);
+}
+
+// A random walk, with some repeated points (which the stroker skips), and
+// optionally a curve partway through.
+static void make_polyline(SkPath* path, SkRandom* rand, int count, bool withCurve) {
+    SkScalar x = 0;
+    SkScalar y = 0;
+    path->moveTo(x, y);
+    for (int i = 1; i < count; ++i) {
+        if (withCurve && i == count / 2) {
+            path->quadTo(x + SkIntToScalar(20), y, x + SkIntToScalar(20),
+                         y + SkIntToScalar(20));
+            x += SkIntToScalar(20);
+            y += SkIntToScalar(20);
+            continue;
+        }
+        if (rand->nextU() % 8) {
+            x += rand->nextSScalar1() * 10;
+            y += rand->nextSScalar1() * 10;
+        }
+        path->lineTo(x, y);
+    }
+}
+
+static void test_chunked_stroke(skiatest::Reporter* reporter, const SkPath& path,
+                                const SkPaint& paint) {
+    SkStroke stroke(paint);
+    SkPath expected;
+    stroke.strokePath(path, &expected);
+
+    static const int gSegmentsPerChunk[] = { 1, 2, 7, 50 };
+    for (size_t i = 0; i < SK_ARRAY_COUNT(gSegmentsPerChunk); ++i) {
+        SkPath actual;
+        stroke.setParallelFor(serial_for, gSegmentsPerChunk[i]);
+        stroke.strokePath(path, &actual);
+        REPORTER_ASSERT(reporter, expected == actual);
+
+        actual.reset();
+        stroke.setParallelFor(SkThreadedFor, gSegmentsPerChunk[i]);
+        stroke.strokePath(path, &actual);
+        REPORTER_ASSERT(reporter, expected == actual);
+    }
+}
+
+static void draw_path(SkBitmap* bm, const SkPath& path, const SkPaint& paint) {
+    bm->setConfig(SkBitmap::kARGB_8888_Config, 400, 400);
+    bm->allocPixels();
+    bm->eraseColor(SK_ColorWHITE);
+    SkCanvas canvas(*bm);
+    canvas.translate(SkIntToScalar(200), SkIntToScalar(200));
+    canvas.drawPath(path, paint);
+}
+
+// The process-wide parallel-for reaches the strokes that canvas draws build.
+static void test_process_wide(skiatest::Reporter* reporter, const SkPath& path,
+                              const SkPaint& paint) {
+    SkBitmap expected;
+    draw_path(&expected, path, paint);
+
+    gCountingForCalls = 0;
+    SkGraphics::SetStrokeParallelFor(counting_for, 7);
+    SkBitmap actual;
+    draw_path(&actual, path, paint);
+    SkGraphics::SetStrokeParallelFor(NULL);
+
+    REPORTER_ASSERT(reporter, gCountingForCalls > 0);
+    SkAutoLockPixels alpe(expected);
+    SkAutoLockPixels alpa(actual);
+    REPORTER_ASSERT(reporter, 0 == memcmp(expected.getPixels(), actual.getPixels(),
+                                          expected.getSize()));
+}
+
+// Stroking long runs of lines in chunks must build exactly the same path as
+// stroking them in one pass.
+static void TestStroke(skiatest::Reporter* reporter) {
+    SkRandom rand;
+    SkPaint paint;
+    paint.setStyle(SkPaint::kStroke_Style);
+    paint.setStrokeWidth(SkIntToScalar(3));
+
+    for (int join = 0; join < SkPaint::kJoinCount; ++join) {
+        for (int cap = 0; cap < SkPaint::kCapCount; ++cap) {
+            paint.setStrokeJoin(static_cast<SkPaint::Join>(join));
+            paint.setStrokeCap(static_cast<SkPaint::Cap>(cap));
+            for (int type = 0; type < 4; ++type) {
+                SkPath path;
+                make_polyline(&path, &rand, 300, SkToBool(type & 1));
+                if (type & 2) {
+                    path.close();
+                    // and start another contour
+                    make_polyline(&path, &rand, 120, false);
+                }
+                test_chunked_stroke(reporter, path, paint);
+            }
+        }
+    }
+
+    SkPath path;
+    make_polyline(&path, &rand, 300, false);
+    paint.setAntiAlias(true);
+    test_process_wide(reporter, path, paint);
+}
+
+#include "TestClassDef.h"
+DEFINE_TESTCLASS("Stroke", StrokeTestClass, TestStroke)
@@ -0,0 +1,69 @@
+/*
+ * Copyright 2012 Google Inc.
+ *
+ * Use of this source code is governed by a BSD-style license that can be
+ * found in the LICENSE file.
+ */
+#include "Test.h"
+#include "SkData.h"
+#include "SkStream.h"
+#include "SkString.h"
+#include "SkTraceEvent.h"
+
+static void write_events(SkString* json) {
+    SkDynamicMemoryWStream stream;
+    SkTraceEvent::WriteJSON(&stream);
+    SkAutoTUnref<SkData> data(stream.copyToData());
+    json->set((const char*) data->data(), data->size());
+}
+
+static void TestTraceEvent(skiatest::Reporter* reporter) {
+    {
+        SkAutoTraceEvent event("test", "notRecording");
+    }
+
+    SkTraceEvent::StartRecording();
+    REPORTER_ASSERT(reporter, SkTraceEvent::IsRecording());
+    {
+        SkAutoTraceEvent outer("test", "outer");
+        SkAutoTraceEvent inner("test", "inner");
+    }
+    SkTraceEvent::StopRecording();
+    REPORTER_ASSERT(reporter, !SkTraceEvent::IsRecording());
+    {
+        SkAutoTraceEvent event("test", "stopped");
+    }
+
+    SkString json;
+    write_events(&json);
+    REPORTER_ASSERT(reporter, json.startsWith("{\"traceEvents\":["));
+    REPORTER_ASSERT(reporter, json.endsWith("}\n"));
+    REPORTER_ASSERT(reporter, NULL != strstr(json.c_str(),
+                    "{\"cat\":\"test\",\"name\":\"outer\",\"ph\":\"X\",\"pid\":1,\"tid\":"));
+    REPORTER_ASSERT(reporter, NULL != strstr(json.c_str(), "\"name\":\"inner\""));
+    REPORTER_ASSERT(reporter, NULL == strstr(json.c_str(), "notRecording"));
+    REPORTER_ASSERT(reporter, NULL == strstr(json.c_str(), "stopped"));
+
+    // starting again discards the earlier events
+    SkTraceEvent::StartRecording();
+    SkTraceEvent::StopRecording();
+    write_events(&json);
+    REPORTER_ASSERT(reporter, NULL == strstr(json.c_str(), "outer"));
+
+    // a thread's events past the limit are dropped
+    SkTraceEvent::StartRecording();
+    for (int i = 0; i <= SkTraceEvent::kMaxEventsPerThread; ++i) {
+        SkAutoTraceEvent event("test", "many");
+    }
+    SkTraceEvent::StopRecording();
+    write_events(&json);
+    int count = 0;
+    for (const char* found = strstr(json.c_str(), "\"many\"");
+         found; found = strstr(found + 1, "\"many\"")) {
+        count += 1;
+    }
+    REPORTER_ASSERT(reporter, SkTraceEvent::kMaxEventsPerThread == count);
+}
+
+#include "TestClassDef.h"
+DEFINE_TESTCLASS("TraceEvent", TraceEventTestClass, TestTraceEvent)
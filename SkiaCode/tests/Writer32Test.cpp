@@ -169,6 +169,38 @@ static void testWritePad(skiatest::Reporter* reporter, SkWriter32* writer) {
     }
 }
 
+static void testPacked(skiatest::Reporter* reporter, SkWriter32* writer) {
+    // packed values share words, but any other write realigns the stream
+    static const uint32_t gValues[] = { 0, 1, 127, 128, 300, 0x3FFF, 0x4000,
+                                        0xFFFFFFFF };
+    for (size_t i = 0; i < SK_ARRAY_COUNT(gValues); ++i) {
+        writer->writePackedUInt(gValues[i]);
+        writer->writePackedInt(-(int32_t)i);
+        if (i & 1) {
+            writer->writeInt(i);
+        }
+    }
+    writer->writePackedInt(SK_MaxS32);
+    writer->writePackedInt(SK_MinS32);
+    REPORTER_ASSERT(reporter, SkIsAlign4(writer->size()));
+
+    uint32_t totalBytes = writer->size();
+    SkAutoMalloc readStorage(totalBytes);
+    writer->flatten(readStorage.get());
+
+    SkReader32 reader(readStorage.get(), totalBytes);
+    for (size_t i = 0; i < SK_ARRAY_COUNT(gValues); ++i) {
+        REPORTER_ASSERT(reporter, gValues[i] == reader.readPackedUInt());
+        REPORTER_ASSERT(reporter, -(int32_t)i == reader.readPackedInt());
+        if (i & 1) {
+            REPORTER_ASSERT(reporter, (int32_t)i == reader.readInt());
+        }
+    }
+    REPORTER_ASSERT(reporter, SK_MaxS32 == reader.readPackedInt());
+    REPORTER_ASSERT(reporter, (int32_t)SK_MinS32 == reader.readPackedInt());
+    REPORTER_ASSERT(reporter, reader.eof());
+}
+
 static void Tests(skiatest::Reporter* reporter) {
     // dynamic allocator
     {
@@ -181,6 +213,9 @@ static void Tests(skiatest::Reporter* reporter) {
 
         writer.reset();
         testWritePad(reporter, &writer);
+
+        writer.reset();
+        testPacked(reporter, &writer);
     }
 
     // single-block
@@ -57,6 +57,9 @@ void PictureBenchmark::run(SkPicture* pict) {
     renderer->resetState();
 
     BenchTimer* timer = this->setupTimer();
+    if (fCounters && !timer->enableCounters()) {
+        this->logProgress("Hardware counters are not available, only timing.\n");
+    }
     bool usingGpu = false;
 #if SK_SUPPORT_GPU
     usingGpu = renderer->isUsingGpuDevice();
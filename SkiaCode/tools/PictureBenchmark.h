@@ -22,6 +22,7 @@ class PictureBenchmark : public SkRefCnt {
 public:
     PictureBenchmark()
     : fRepeats(1)
+    , fCounters(false)
     , fLogger(NULL) {}
 
     void run(SkPicture* pict);
@@ -30,6 +31,14 @@ public:
         fRepeats = repeats;
     }
 
+    /**
+     * Also count hardware events (cycles, instructions, cache and branch misses) while
+     * rendering, if the system allows it.
+     */
+    void setCounters(bool counters) {
+        fCounters = counters;
+    }
+
     void setDeviceType(PictureRenderer::SkDeviceTypes deviceType) {
         sk_tools::PictureRenderer* renderer = getRenderer();
 
@@ -42,6 +51,7 @@ public:
 
 private:
     int            fRepeats;
+    bool           fCounters;
     SkBenchLogger* fLogger;
 
     void logProgress(const char msg[]);
@@ -0,0 +1,202 @@
+/*
+ * Copyright 2012 Google Inc.
+ *
+ * Use of this source code is governed by a BSD-style license that can be
+ * found in the LICENSE file.
+ */
+
+#include "BenchTimer.h"
+#include "SkAnimator.h"
+#include "SkBitmap.h"
+#include "SkCanvas.h"
+#include "SkEvent.h"
+#include "SkGraphics.h"
+#include "SkStream.h"
+#include "SkString.h"
+#include "SkTArray.h"
+
+const int DEFAULT_FRAMES = 120;
+const int DEFAULT_SHAPES = 400;
+const int DEFAULT_FORMULAS = 0;
+const int WIDTH = 640;
+const int HEIGHT = 480;
+const SkMSec FRAME_INTERVAL = 16;
+
+// The animator posts events, but this tool never services the event queue.
+void SkEvent::SignalNonEmptyQueue() {}
+void SkEvent::SignalQueueTimer(SkMSec) {}
+
+static void usage(const char* argv0) {
+    SkDebugf("Animator drawing benchmark\n");
+    SkDebugf("\n"
+"Usage: \n"
+"     %s [input]... [--frames count] [--shapes count] [--formulas count]\n", argv0);
+    SkDebugf("\n\n");
+    SkDebugf(
+"     input:     A list of animator XML files. If none are given, a mostly\n"
+"                static animation is generated: a grid of shapes with one\n"
+"                small rectangle moving across it.\n\n");
+    SkDebugf(
+"     --frames count: Number of frames drawn. Default is %i.\n", DEFAULT_FRAMES);
+    SkDebugf(
+"     --shapes count: Number of static shapes in the generated animation.\n"
+"                     Default is %i.\n", DEFAULT_SHAPES);
+    SkDebugf(
+"     --formulas count: Number of squares in the generated animation that are\n"
+"                       moved by a script formula instead of by interpolation.\n"
+"                       Default is %i.\n", DEFAULT_FORMULAS);
+}
+
+// Frames are timed with a clock that only moves when told to, so that both
+// animators see the same times.
+class BenchTimeline : public SkAnimator::Timeline {
+public:
+    BenchTimeline() : fTime(0) {}
+    virtual SkMSec getMSecs() const { return fTime; }
+    SkMSec fTime;
+};
+
+static void make_document(int shapes, int formulas, SkString* doc) {
+    doc->set("<screenplay>\n<event kind=\"onLoad\">\n");
+    const int columns = 32;
+    const SkScalar size = SkIntToScalar(WIDTH) / columns;
+    for (int i = 0; i < shapes; ++i) {
+        if (i % 16 == 0) {
+            doc->appendf("<paint antiAlias=\"true\"><color color=\"#%06x\"/></paint>\n",
+                         (i * 0x2468AC) & 0xFFFFFF);
+        }
+        SkScalar x = SkIntToScalar(i % columns) * size;
+        SkScalar y = SkIntToScalar(i / columns % (HEIGHT / (int) size)) * size;
+        doc->appendf("<oval left=\"%g\" top=\"%g\" right=\"%g\" bottom=\"%g\"/>\n",
+                     SkScalarToFloat(x + 1), SkScalarToFloat(y + 1),
+                     SkScalarToFloat(x + size - 1), SkScalarToFloat(y + size - 1));
+    }
+    doc->append("<paint antiAlias=\"true\"><color color=\"red\"/></paint>\n"
+                "<apply>\n"
+                "  <rect left=\"0\" top=\"100\" right=\"24\" bottom=\"124\"/>\n"
+                "  <animate field=\"left\" from=\"0\" to=\"600\" dur=\"4\"/>\n"
+                "  <animate field=\"right\" from=\"24\" to=\"624\" dur=\"4\"/>\n"
+                "</apply>\n");
+    // the formulas are evaluated every frame, so these stress the script engine
+    for (int i = 0; i < formulas; ++i) {
+        int y = i * 8 % (HEIGHT - 8);
+        doc->appendf("<apply id=\"f%d\">\n"
+                     "  <rect left=\"0\" top=\"%d\" right=\"8\" bottom=\"%d\"/>\n", i, y, y + 8);
+        doc->appendf("  <animate field=\"left\" dur=\"4\"\n"
+                     "    formula=\"Math.sin(f%d.time * 2 + %d) * 300 + 310\"/>\n", i, i % 7);
+        doc->appendf("  <animate field=\"right\" dur=\"4\"\n"
+                     "    formula=\"Math.sin(f%d.time * 2 + %d) * 300 + 318\"/>\n", i, i % 7);
+        doc->append("</apply>\n");
+    }
+    doc->append("</event>\n</screenplay>\n");
+}
+
+static bool load(SkAnimator* animator, const BenchTimeline& timeline,
+                 const SkString& path, const SkString& doc) {
+    animator->setTimeline(timeline);
+    if (path.isEmpty()) {
+        return animator->decodeMemory(doc.c_str(), doc.size());
+    }
+    SkFILEStream stream(path.c_str());
+    return stream.isValid() && animator->decodeStream(&stream);
+}
+
+// Times drawing every frame with draw() against drawing it with
+// drawRetained(), which redraws only what changed since the last frame.
+static void bench_animation(const SkString& path, const SkString& doc, int frames) {
+    const char* name = path.isEmpty() ? "generated" : path.c_str();
+    BenchTimeline timeline;
+    SkAnimator full;
+    SkAnimator retained;
+    if (!load(&full, timeline, path, doc) || !load(&retained, timeline, path, doc)) {
+        SkDebugf("Could not decode %s\n", name);
+        return;
+    }
+
+    SkBitmap bitmap;
+    bitmap.setConfig(SkBitmap::kARGB_8888_Config, WIDTH, HEIGHT);
+    bitmap.allocPixels();
+    SkCanvas canvas(bitmap);
+
+    BenchTimer timer;
+    timer.start();
+    for (int i = 0; i < frames; ++i) {
+        timeline.fTime = i * FRAME_INTERVAL;
+        bitmap.eraseColor(0);
+        full.draw(&canvas, timeline.fTime);
+    }
+    timer.end();
+    double fullMs = timer.fWall / frames;
+
+    double redrawn = 0;
+    timer.start();
+    for (int i = 0; i < frames; ++i) {
+        timeline.fTime = i * FRAME_INTERVAL;
+        retained.drawRetained(WIDTH, HEIGHT, timeline.fTime);
+        SkRect inval;
+        retained.getInvalBounds(&inval);
+        redrawn += SkScalarToFloat(inval.width()) * SkScalarToFloat(inval.height());
+    }
+    timer.end();
+    double retainedMs = timer.fWall / frames;
+
+    // the last frame drawn both ways should match
+    const SkBitmap& result = retained.getRetainedBitmap();
+    SkAutoLockPixels lockBitmap(bitmap);
+    SkAutoLockPixels lockResult(result);
+    int mismatches = 0;
+    for (int y = 0; y < HEIGHT; ++y) {
+        if (memcmp(bitmap.getAddr32(0, y), result.getAddr32(0, y), WIDTH << 2)) {
+            ++mismatches;
+        }
+    }
+
+    SkDebugf("%s: draw = %.3f ms, drawRetained = %.3f ms, %.1f%% redrawn%s\n",
+             name, fullMs, retainedMs, 100 * redrawn / ((double) WIDTH * HEIGHT * frames),
+             mismatches ? " (last frames differ)" : "");
+}
+
+int main(int argc, char* const argv[]) {
+    SkAutoGraphics ag;
+    SkTArray<SkString> inputs;
+    int frames = DEFAULT_FRAMES;
+    int shapes = DEFAULT_SHAPES;
+    int formulas = DEFAULT_FORMULAS;
+
+    for (int i = 1; i < argc; ++i) {
+        if (0 == strcmp(argv[i], "--frames")) {
+            if (++i >= argc || (frames = atoi(argv[i])) <= 0) {
+                SkDebugf("--frames must be given a value > 0\n");
+                usage(argv[0]);
+                return -1;
+            }
+        } else if (0 == strcmp(argv[i], "--shapes")) {
+            if (++i >= argc || (shapes = atoi(argv[i])) < 0) {
+                SkDebugf("--shapes must be given a value >= 0\n");
+                usage(argv[0]);
+                return -1;
+            }
+        } else if (0 == strcmp(argv[i], "--formulas")) {
+            if (++i >= argc || (formulas = atoi(argv[i])) < 0) {
+                SkDebugf("--formulas must be given a value >= 0\n");
+                usage(argv[0]);
+                return -1;
+            }
+        } else if (0 == strcmp(argv[i], "--help") || 0 == strcmp(argv[i], "-h")) {
+            usage(argv[0]);
+            return 0;
+        } else {
+            inputs.push_back(SkString(argv[i]));
+        }
+    }
+
+    SkString doc;
+    if (inputs.count() == 0) {
+        make_document(shapes, formulas, &doc);
+        bench_animation(SkString(), doc, frames);
+    }
+    for (int i = 0; i < inputs.count(); ++i) {
+        bench_animation(inputs[i], doc, frames);
+    }
+    return 0;
+}
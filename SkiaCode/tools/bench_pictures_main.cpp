@@ -28,6 +28,7 @@ static void usage(const char* argv0) {
 "     [--mode pow2tile minWidth height[] (multi) | record | simple\n"
 "             | tile width[] height[] (multi) | playbackCreation]\n"
 "     [--pipe]\n"
+"     [--counters]\n"
 "     [--device bitmap"
 #if SK_SUPPORT_GPU
 " | gpu"
@@ -84,6 +85,9 @@ static void usage(const char* argv0) {
 #endif
     SkDebugf("\n");
     SkDebugf(
+"     --counters: Also count CPU cycles, instructions, cache misses and branch\n"
+"                 misses per repeat, where the system allows it.\n");
+    SkDebugf(
 "     --repeat:  "
 "Set the number of times to repeat each test."
 " Default is %i.\n", DEFAULT_REPEATS);
@@ -134,6 +138,7 @@ static void parse_commandline(int argc, char* const argv[], SkTArray<SkString>*
     commandLine.append("\n");
 
     bool usePipe = false;
+    bool counters = false;
     bool multiThreaded = false;
     bool useTiles = false;
     const char* widthString = NULL;
@@ -158,6 +163,8 @@ static void parse_commandline(int argc, char* const argv[], SkTArray<SkString>*
             }
         } else if (0 == strcmp(*argv, "--pipe")) {
             usePipe = true;
+        } else if (0 == strcmp(*argv, "--counters")) {
+            counters = true;
         } else if (0 == strcmp(*argv, "--logFile")) {
             argv++;
             if (argv < stop) {
@@ -323,6 +330,7 @@ static void parse_commandline(int argc, char* const argv[], SkTArray<SkString>*
     }
 
     benchmark->setRepeats(repeats);
+    benchmark->setCounters(counters);
     benchmark->setDeviceType(deviceType);
     benchmark->setLogger(&gLogger);
     // Report current settings:
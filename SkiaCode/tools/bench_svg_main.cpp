@@ -0,0 +1,129 @@
+/*
+ * Copyright 2012 Google Inc.
+ *
+ * Use of this source code is governed by a BSD-style license that can be
+ * found in the LICENSE file.
+ */
+
+#include "BenchTimer.h"
+#include "SkGraphics.h"
+#include "SkOSFile.h"
+#include "SkPicture.h"
+#include "SkSVGParser.h"
+#include "SkSVGPicture.h"
+#include "SkStream.h"
+#include "SkString.h"
+#include "SkTArray.h"
+#include "SkTemplates.h"
+#include "picture_utils.h"
+
+const int DEFAULT_REPEATS = 20;
+
+static void usage(const char* argv0) {
+    SkDebugf("SVG loading benchmark\n");
+    SkDebugf("\n"
+"Usage: \n"
+"     %s <input>... [--repeat count]\n", argv0);
+    SkDebugf("\n\n");
+    SkDebugf(
+"     input:     A list of directories and files to use as input. Files are\n"
+"                expected to have the .svg extension.\n\n");
+    SkDebugf(
+"     --repeat count: Number of times each file is loaded. Default is %i.\n",
+        DEFAULT_REPEATS);
+}
+
+static bool read_file(const SkString& path, SkAutoMalloc* data, size_t* length) {
+    SkFILEStream stream(path.c_str());
+    if (!stream.isValid()) {
+        return false;
+    }
+    *length = stream.getLength();
+    return stream.read(data->reset(*length), *length) == *length;
+}
+
+// Times parsing the document into SVG elements, and then parsing it and
+// recording it into a picture; the difference is the cost of the walk.
+static void bench_file(const SkString& path, int repeats) {
+    SkAutoMalloc data;
+    size_t length = 0;
+    if (!read_file(path, &data, &length)) {
+        SkDebugf("Could not read %s\n", path.c_str());
+        return;
+    }
+    const char* doc = static_cast<const char*>(data.get());
+
+    // also warms up the caches before anything is timed
+    SkPicture picture;
+    if (!SkSVGPicture::DecodeMemory(doc, length, &picture)) {
+        SkDebugf("Could not decode %s\n", path.c_str());
+        return;
+    }
+
+    BenchTimer timer;
+    timer.start();
+    for (int i = 0; i < repeats; ++i) {
+        SkSVGParser parser;
+        parser.parse(doc, length);
+    }
+    timer.end();
+    double parseMs = timer.fWall / repeats;
+
+    timer.start();
+    for (int i = 0; i < repeats; ++i) {
+        SkPicture scratch;
+        SkSVGPicture::DecodeMemory(doc, length, &scratch);
+    }
+    timer.end();
+    double loadMs = timer.fWall / repeats;
+
+    SkString name;
+    sk_tools::get_basename(&name, path);
+    SkDebugf("%s %dx%d: parse = %.3f ms, parse + record = %.3f ms\n",
+             name.c_str(), picture.width(), picture.height(), parseMs, loadMs);
+}
+
+static void process_input(const SkString& input, int repeats) {
+    SkOSFile::Iter iter(input.c_str(), "svg");
+    SkString inputFilename;
+
+    if (iter.next(&inputFilename)) {
+        do {
+            SkString inputPath;
+            sk_tools::make_filepath(&inputPath, input, inputFilename);
+            bench_file(inputPath, repeats);
+        } while (iter.next(&inputFilename));
+    } else {
+        bench_file(input, repeats);
+    }
+}
+
+int main(int argc, char* const argv[]) {
+    SkAutoGraphics ag;
+    SkTArray<SkString> inputs;
+    int repeats = DEFAULT_REPEATS;
+
+    for (int i = 1; i < argc; ++i) {
+        if (0 == strcmp(argv[i], "--repeat")) {
+            if (++i >= argc || (repeats = atoi(argv[i])) <= 0) {
+                SkDebugf("--repeat must be given a value > 0\n");
+                usage(argv[0]);
+                return -1;
+            }
+        } else if (0 == strcmp(argv[i], "--help") || 0 == strcmp(argv[i], "-h")) {
+            usage(argv[0]);
+            return 0;
+        } else {
+            inputs.push_back(SkString(argv[i]));
+        }
+    }
+    if (inputs.count() < 1) {
+        usage(argv[0]);
+        return -1;
+    }
+
+    for (int i = 0; i < inputs.count(); ++i) {
+        process_input(inputs[i], repeats);
+    }
+    return 0;
+}
@@ -14,6 +14,7 @@
 #include "SkStream.h"
 #include "SkString.h"
 #include "SkTArray.h"
+#include "SkTraceEvent.h"
 #include "PictureRenderer.h"
 #include "picture_utils.h"
 
@@ -28,7 +29,8 @@ static void usage(const char* argv0) {
 #if SK_SUPPORT_GPU
 " | gpu"
 #endif
-"]"
+"]\n"
+"     [--trace filename]"
 , argv0);
     SkDebugf("\n\n");
     SkDebugf(
@@ -69,6 +71,11 @@ static void usage(const char* argv0) {
     SkDebugf(
 "                     gpu, Render to the GPU.\n");
 #endif
+    SkDebugf("\n");
+    SkDebugf(
+"     --trace filename: Write where rendering spent its time to filename, as\n"
+"                       Chrome trace-event JSON for chrome://tracing. Needs\n"
+"                       Skia built with SK_ENABLE_TRACE_EVENTS.\n");
 }
 
 static void make_output_filepath(SkString* path, const SkString& dir,
@@ -131,7 +138,7 @@ static void process_input(const SkString& input, const SkString& outputDir,
 }
 
 static void parse_commandline(int argc, char* const argv[], SkTArray<SkString>* inputs,
-                              sk_tools::PictureRenderer*& renderer){
+                              sk_tools::PictureRenderer*& renderer, SkString* tracePath){
     const char* argv0 = argv[0];
     char* const* stop = argv + argc;
 
@@ -251,6 +258,19 @@ static void parse_commandline(int argc, char* const argv[], SkTArray<SkString>*
                 exit(-1);
             }
 
+        } else if (0 == strcmp(*argv, "--trace")) {
+            ++argv;
+            if (argv >= stop) {
+                SkDELETE(renderer);
+                SkDebugf("Missing filename for --trace\n");
+                usage(argv0);
+                exit(-1);
+            }
+            tracePath->set(*argv);
+#ifndef SK_ENABLE_TRACE_EVENTS
+            SkDebugf("Skia was built without SK_ENABLE_TRACE_EVENTS,"
+                     " so no events will be traced.\n");
+#endif
         } else if ((0 == strcmp(*argv, "-h")) || (0 == strcmp(*argv, "--help"))) {
             SkDELETE(renderer);
             usage(argv0);
@@ -276,14 +296,25 @@ static void parse_commandline(int argc, char* const argv[], SkTArray<SkString>*
 int main(int argc, char* const argv[]) {
     SkTArray<SkString> inputs;
     sk_tools::PictureRenderer* renderer = NULL;
+    SkString tracePath;
 
-    parse_commandline(argc, argv, &inputs, renderer);
+    parse_commandline(argc, argv, &inputs, renderer, &tracePath);
     SkString outputDir = inputs[inputs.count() - 1];
     SkASSERT(renderer);
 
+    if (!tracePath.isEmpty()) {
+        SkTraceEvent::StartRecording();
+    }
     for (int i = 0; i < inputs.count() - 1; i ++) {
         process_input(inputs[i], outputDir, *renderer);
     }
+    if (!tracePath.isEmpty()) {
+        SkTraceEvent::StopRecording();
+        SkFILEWStream stream(tracePath.c_str());
+        if (!stream.isValid() || !SkTraceEvent::WriteJSON(&stream)) {
+            SkDebugf("Could not write to file %s\n", tracePath.c_str());
+        }
+    }
 
     SkDELETE(renderer);
 }
@@ -15,6 +15,8 @@
 #include "SkTemplates.h"
 #include "SkTime.h"
 #include "SkTSearch.h"
+#include "SkThread.h"
+#include "SkThreadUtils.h"
 #include "SkTypes.h"
 
 /**
@@ -542,6 +544,139 @@ static inline bool colors_match_thresholded(SkPMColor c0, SkPMColor c1,
             (SkAbs32(db) <= threshold));
 }
 
+/// Differences accumulated over one row of pixels.
+struct DiffRowStats {
+    DiffRowStats()
+        : fMismatchedPixels(0)
+        , fTotalMismatchR(0)
+        , fTotalMismatchG(0)
+        , fTotalMismatchB(0)
+        , fTotalValue(0)
+        , fMaxMismatchR(0)
+        , fMaxMismatchG(0)
+        , fMaxMismatchB(0) { };
+
+    int fMismatchedPixels;
+    uint32_t fTotalMismatchR;
+    uint32_t fTotalMismatchG;
+    uint32_t fTotalMismatchB;
+    /// Sum of the largest channel difference of each pixel.
+    uint32_t fTotalValue;
+    uint32_t fMaxMismatchR;
+    uint32_t fMaxMismatchG;
+    uint32_t fMaxMismatchB;
+};
+
+/// Compares count pixels, writing the difference and white images and
+/// adding to *stats.
+static void diff_row(const SkPMColor base[], const SkPMColor comparison[],
+                     SkPMColor difference[], SkPMColor white[], int count,
+                     DiffMetricProc diffFunction, const int colorThreshold,
+                     DiffRowStats* stats) {
+    for (int x = 0; x < count; x++) {
+        SkPMColor c0 = base[x];
+        SkPMColor c1 = comparison[x];
+        SkPMColor trueDifference = compute_diff_pmcolor(c0, c1);
+        uint32_t thisR = SkGetPackedR32(trueDifference);
+        uint32_t thisG = SkGetPackedG32(trueDifference);
+        uint32_t thisB = SkGetPackedB32(trueDifference);
+        stats->fTotalMismatchR += thisR;
+        stats->fTotalMismatchG += thisG;
+        stats->fTotalMismatchB += thisB;
+        // In HSV, value is defined as max RGB component.
+        stats->fTotalValue += MAX3(thisR, thisG, thisB);
+        if (thisR > stats->fMaxMismatchR) {
+            stats->fMaxMismatchR = thisR;
+        }
+        if (thisG > stats->fMaxMismatchG) {
+            stats->fMaxMismatchG = thisG;
+        }
+        if (thisB > stats->fMaxMismatchB) {
+            stats->fMaxMismatchB = thisB;
+        }
+        if (!colors_match_thresholded(c0, c1, colorThreshold)) {
+            stats->fMismatchedPixels++;
+            difference[x] = diffFunction(c0, c1);
+            white[x] = PMCOLOR_WHITE;
+        } else {
+            difference[x] = 0;
+            white[x] = PMCOLOR_BLACK;
+        }
+    }
+}
+
+#if SK_CPU_SSE_LEVEL >= SK_CPU_SSE_LEVEL_SSE2
+#include <emmintrin.h>
+
+static inline uint32_t sum_halves(__m128i sums) {
+    return _mm_cvtsi128_si32(sums) + _mm_cvtsi128_si32(_mm_srli_si128(sums, 8));
+}
+
+/// diff_row for compute_diff_pmcolor and a threshold in [0, 255], four pixels
+/// at a time. Returns the number of pixels compared, which is count rounded
+/// down to a multiple of four.
+static int diff_row_SSE2(const SkPMColor base[], const SkPMColor comparison[],
+                         SkPMColor difference[], SkPMColor white[], int count,
+                         const int colorThreshold, DiffRowStats* stats) {
+    const __m128i zero = _mm_setzero_si128();
+    const __m128i byteMask = _mm_set1_epi32(0xFF);
+    const __m128i alphaMask = _mm_set1_epi32(SK_A32_MASK << SK_A32_SHIFT);
+    const __m128i threshold = _mm_set1_epi8((char) colorThreshold);
+    const __m128i whiteColor = _mm_set1_epi32(PMCOLOR_WHITE);
+    const __m128i blackColor = _mm_set1_epi32(PMCOLOR_BLACK);
+
+    __m128i maxes = zero;
+    __m128i sumR = zero;
+    __m128i sumG = zero;
+    __m128i sumB = zero;
+    __m128i sumValue = zero;
+    __m128i mismatches = zero;
+    int x = 0;
+    for (; x + 4 <= count; x += 4) {
+        __m128i c0 = _mm_loadu_si128(reinterpret_cast<const __m128i*>(base + x));
+        __m128i c1 = _mm_loadu_si128(reinterpret_cast<const __m128i*>(comparison + x));
+        // absolute difference of every channel, alpha included
+        __m128i diff = _mm_or_si128(_mm_subs_epu8(c0, c1), _mm_subs_epu8(c1, c0));
+        maxes = _mm_max_epu8(maxes, diff);
+
+        __m128i r = _mm_and_si128(_mm_srli_epi32(diff, SK_R32_SHIFT), byteMask);
+        __m128i g = _mm_and_si128(_mm_srli_epi32(diff, SK_G32_SHIFT), byteMask);
+        __m128i b = _mm_and_si128(_mm_srli_epi32(diff, SK_B32_SHIFT), byteMask);
+        sumR = _mm_add_epi64(sumR, _mm_sad_epu8(r, zero));
+        sumG = _mm_add_epi64(sumG, _mm_sad_epu8(g, zero));
+        sumB = _mm_add_epi64(sumB, _mm_sad_epu8(b, zero));
+        __m128i value = _mm_max_epu8(r, _mm_max_epu8(g, b));
+        sumValue = _mm_add_epi64(sumValue, _mm_sad_epu8(value, zero));
+
+        // all ones for the pixels whose channels all match within the threshold
+        __m128i match = _mm_cmpeq_epi32(_mm_subs_epu8(diff, threshold), zero);
+        mismatches = _mm_sub_epi32(mismatches, _mm_cmpeq_epi32(match, zero));
+
+        __m128i diffColor = _mm_andnot_si128(match, _mm_or_si128(diff, alphaMask));
+        __m128i whiteOrBlack = _mm_or_si128(_mm_and_si128(match, blackColor),
+                                            _mm_andnot_si128(match, whiteColor));
+        _mm_storeu_si128(reinterpret_cast<__m128i*>(difference + x), diffColor);
+        _mm_storeu_si128(reinterpret_cast<__m128i*>(white + x), whiteOrBlack);
+    }
+
+    stats->fTotalMismatchR += sum_halves(sumR);
+    stats->fTotalMismatchG += sum_halves(sumG);
+    stats->fTotalMismatchB += sum_halves(sumB);
+    stats->fTotalValue += sum_halves(sumValue);
+
+    uint32_t lanes[4];
+    _mm_storeu_si128(reinterpret_cast<__m128i*>(lanes), mismatches);
+    stats->fMismatchedPixels += lanes[0] + lanes[1] + lanes[2] + lanes[3];
+    _mm_storeu_si128(reinterpret_cast<__m128i*>(lanes), maxes);
+    for (int i = 0; i < 4; i++) {
+        stats->fMaxMismatchR = SkMax32(stats->fMaxMismatchR, SkGetPackedR32(lanes[i]));
+        stats->fMaxMismatchG = SkMax32(stats->fMaxMismatchG, SkGetPackedG32(lanes[i]));
+        stats->fMaxMismatchB = SkMax32(stats->fMaxMismatchB, SkGetPackedB32(lanes[i]));
+    }
+    return x;
+}
+#endif
+
 // based on gm
 // Postcondition: when we exit this method, dr->fResult should have some value
 // other than kUnknown.
@@ -562,42 +697,38 @@ static void compute_diff(DiffRecord* dr,
         dr->fResult = kDifferentSizes;
         return;
     }
+#if SK_CPU_SSE_LEVEL >= SK_CPU_SSE_LEVEL_SSE2
+    // Thresholds above 255 let every pixel match, as 255 does.
+    const bool useSSE2 = compute_diff_pmcolor == diffFunction && colorThreshold >= 0;
+    const int clampedThreshold = SkMin32(colorThreshold, 255);
+#endif
     // Accumulate fractionally different pixels, then divide out
     // # of pixels at the end.
     dr->fWeightedFraction = 0;
     for (int y = 0; y < h; y++) {
-        for (int x = 0; x < w; x++) {
-            SkPMColor c0 = *dr->fBaseBitmap->getAddr32(x, y);
-            SkPMColor c1 = *dr->fComparisonBitmap->getAddr32(x, y);
-            SkPMColor trueDifference = compute_diff_pmcolor(c0, c1);
-            SkPMColor outputDifference = diffFunction(c0, c1);
-            uint32_t thisR = SkGetPackedR32(trueDifference);
-            uint32_t thisG = SkGetPackedG32(trueDifference);
-            uint32_t thisB = SkGetPackedB32(trueDifference);
-            totalMismatchR += thisR;
-            totalMismatchG += thisG;
-            totalMismatchB += thisB;
-            // In HSV, value is defined as max RGB component.
-            int value = MAX3(thisR, thisG, thisB);
-            dr->fWeightedFraction += ((float) value) / 255;
-            if (thisR > dr->fMaxMismatchR) {
-                dr->fMaxMismatchR = thisR;
-            }
-            if (thisG > dr->fMaxMismatchG) {
-                dr->fMaxMismatchG = thisG;
-            }
-            if (thisB > dr->fMaxMismatchB) {
-                dr->fMaxMismatchB = thisB;
-            }
-            if (!colors_match_thresholded(c0, c1, colorThreshold)) {
-                mismatchedPixels++;
-                *dr->fDifferenceBitmap->getAddr32(x, y) = outputDifference;
-                *dr->fWhiteBitmap->getAddr32(x, y) = PMCOLOR_WHITE;
-            } else {
-                *dr->fDifferenceBitmap->getAddr32(x, y) = 0;
-                *dr->fWhiteBitmap->getAddr32(x, y) = PMCOLOR_BLACK;
-            }
+        const SkPMColor* base = dr->fBaseBitmap->getAddr32(0, y);
+        const SkPMColor* comparison = dr->fComparisonBitmap->getAddr32(0, y);
+        SkPMColor* difference = dr->fDifferenceBitmap->getAddr32(0, y);
+        SkPMColor* white = dr->fWhiteBitmap->getAddr32(0, y);
+        DiffRowStats stats;
+        int x = 0;
+#if SK_CPU_SSE_LEVEL >= SK_CPU_SSE_LEVEL_SSE2
+        if (useSSE2) {
+            x = diff_row_SSE2(base, comparison, difference, white, w,
+                              clampedThreshold, &stats);
         }
+#endif
+        diff_row(base + x, comparison + x, difference + x, white + x, w - x,
+                 diffFunction, colorThreshold, &stats);
+
+        mismatchedPixels += stats.fMismatchedPixels;
+        totalMismatchR += stats.fTotalMismatchR;
+        totalMismatchG += stats.fTotalMismatchG;
+        totalMismatchB += stats.fTotalMismatchB;
+        dr->fWeightedFraction += ((float) stats.fTotalValue) / 255;
+        dr->fMaxMismatchR = SkMax32(dr->fMaxMismatchR, stats.fMaxMismatchR);
+        dr->fMaxMismatchG = SkMax32(dr->fMaxMismatchG, stats.fMaxMismatchG);
+        dr->fMaxMismatchB = SkMax32(dr->fMaxMismatchB, stats.fMaxMismatchB);
     }
     if (0 == mismatchedPixels) {
         dr->fResult = kEqualPixels;
@@ -786,8 +917,71 @@ static int compare_file_name_metrics(SkString **lhs, SkString **rhs) {
     return strcmp((*lhs)->c_str(), (*rhs)->c_str());
 }
 
+/// Reads, decodes and compares the base and comparison files of drp,
+/// setting drp->fResult. Files with identical bits are not decoded.
+/// If outputDir.isEmpty(), don't write out diff files.
+static void compare_file_pair(DiffRecord* drp,
+                              DiffMetricProc dmp,
+                              const int colorThreshold,
+                              const SkString& outputDir) {
+    SkASSERT(kUnknown == drp->fResult);
+
+    SkData* baseFileBits = NULL;
+    SkData* comparisonFileBits = NULL;
+    if (NULL == (baseFileBits = read_file(drp->fBasePath.c_str()))) {
+        SkDebugf("WARNING: couldn't read base file <%s>\n",
+                 drp->fBasePath.c_str());
+        drp->fResult = kBaseMissing;
+    } else if (NULL == (comparisonFileBits = read_file(drp->fComparisonPath.c_str()))) {
+        SkDebugf("WARNING: couldn't read comparison file <%s>\n",
+                 drp->fComparisonPath.c_str());
+        drp->fResult = kComparisonMissing;
+    } else {
+        if (are_buffers_equal(baseFileBits, comparisonFileBits)) {
+            drp->fResult = kEqualBits;
+        } else if (get_bitmaps(baseFileBits, comparisonFileBits, drp)) {
+            create_and_write_diff_image(drp, dmp, colorThreshold,
+                                        outputDir, drp->fFilename);
+        } else {
+            drp->fResult = kDifferentOther;
+        }
+    }
+    if (baseFileBits) {
+        baseFileBits->unref();
+    }
+    if (comparisonFileBits) {
+        comparisonFileBits->unref();
+    }
+    // Free whatever was decoded, so that pixels are only held for the pairs
+    // being compared.
+    release_bitmaps(drp);
+}
+
+/// File pairs shared by the threads comparing them. Each thread claims the
+/// next pair by incrementing fNextPair.
+struct DiffQueue {
+    RecordArray fPairs;
+    int32_t fNextPair;
+    DiffMetricProc fDiffProc;
+    int fColorThreshold;
+    const SkString* fOutputDir;
+};
+
+static void compare_queued_pairs(void* data) {
+    DiffQueue* queue = static_cast<DiffQueue*>(data);
+    for (;;) {
+        int32_t index = sk_atomic_inc(&queue->fNextPair);
+        if (index >= queue->fPairs.count()) {
+            break;
+        }
+        compare_file_pair(queue->fPairs[index], queue->fDiffProc,
+                          queue->fColorThreshold, *queue->fOutputDir);
+    }
+}
+
 /// Creates difference images, returns the number that have a 0 metric.
 /// If outputDir.isEmpty(), don't write out diff files.
+/// File pairs are compared on threadCount threads.
 static void create_diff_images (DiffMetricProc dmp,
                                 const int colorThreshold,
                                 RecordArray* differences,
@@ -797,6 +991,7 @@ static void create_diff_images (DiffMetricProc dmp,
                                 const StringArray& matchSubstrings,
                                 const StringArray& nomatchSubstrings,
                                 bool recurseIntoSubdirs,
+                                int threadCount,
                                 DiffSummary* summary) {
     SkASSERT(!baseDir.isEmpty());
     SkASSERT(!comparisonDir.isEmpty());
@@ -817,6 +1012,13 @@ static void create_diff_images (DiffMetricProc dmp,
               sizeof(SkString*), SkCastForQSort(compare_file_name_metrics));
     }
 
+    DiffQueue queue;
+    queue.fNextPair = 0;
+    queue.fDiffProc = dmp;
+    queue.fColorThreshold = colorThreshold;
+    queue.fOutputDir = &outputDir;
+
+    int firstRecord = differences->count();
     int i = 0;
     int j = 0;
 
@@ -844,41 +1046,13 @@ static void create_diff_images (DiffMetricProc dmp,
             ++j;
         } else {
             // Found the same filename in both baseDir and comparisonDir.
+            // It is compared below, with all the other pairs.
             drp = new DiffRecord(*baseFiles[i], basePath, comparisonPath);
-            SkASSERT(kUnknown == drp->fResult);
-
-            SkData* baseFileBits = NULL;
-            SkData* comparisonFileBits = NULL;
-            if (NULL == (baseFileBits = read_file(basePath.c_str()))) {
-                SkDebugf("WARNING: couldn't read base file <%s>\n",
-                         basePath.c_str());
-                drp->fResult = kBaseMissing;
-            } else if (NULL == (comparisonFileBits = read_file(comparisonPath.c_str()))) {
-                SkDebugf("WARNING: couldn't read comparison file <%s>\n",
-                         comparisonPath.c_str());
-                drp->fResult = kComparisonMissing;
-            } else {
-                if (are_buffers_equal(baseFileBits, comparisonFileBits)) {
-                    drp->fResult = kEqualBits;
-                } else if (get_bitmaps(baseFileBits, comparisonFileBits, drp)) {
-                    create_and_write_diff_image(drp, dmp, colorThreshold,
-                                                outputDir, *baseFiles[i]);
-                } else {
-                    drp->fResult = kDifferentOther;
-                }
-            }
-            if (baseFileBits) {
-                baseFileBits->unref();
-            }
-            if (comparisonFileBits) {
-                comparisonFileBits->unref();
-            }
+            *queue.fPairs.append() = drp;
             ++i;
             ++j;
         }
-        SkASSERT(kUnknown != drp->fResult);
         differences->push(drp);
-        summary->add(drp);
     }
 
     for (; i < baseFiles.count(); ++i) {
@@ -889,7 +1063,6 @@ static void create_diff_images (DiffMetricProc dmp,
         DiffRecord *drp = new DiffRecord(*baseFiles[i], basePath,
                                          comparisonPath, kComparisonMissing);
         differences->push(drp);
-        summary->add(drp);
     }
 
     for (; j < comparisonFiles.count(); ++j) {
@@ -900,7 +1073,35 @@ static void create_diff_images (DiffMetricProc dmp,
         DiffRecord *drp = new DiffRecord(*comparisonFiles[j], basePath,
                                          comparisonPath, kBaseMissing);
         differences->push(drp);
-        summary->add(drp);
+    }
+
+    if (threadCount > queue.fPairs.count()) {
+        threadCount = queue.fPairs.count();
+    }
+    if (threadCount <= 1) {
+        compare_queued_pairs(&queue);
+    } else {
+        SkTDArray<SkThread*> threads;
+        for (int t = 0; t < threadCount; ++t) {
+            SkThread* thread = SkNEW_ARGS(SkThread, (&compare_queued_pairs, &queue));
+            if (!thread->start()) {
+                SkDebugf("WARNING: could not start comparison thread %d\n", t);
+            }
+            *threads.append() = thread;
+        }
+        // a thread that did not start joins immediately; this thread then
+        // compares whatever pairs are left
+        for (int t = 0; t < threads.count(); ++t) {
+            threads[t]->join();
+            SkDELETE(threads[t]);
+        }
+        compare_queued_pairs(&queue);
+    }
+
+    // summarize in file name order, however the comparisons were scheduled
+    for (int k = firstRecord; k < differences->count(); ++k) {
+        SkASSERT(kUnknown != (*differences)[k]->fResult);
+        summary->add((*differences)[k]);
     }
 
     release_file_list(&baseFiles);
@@ -1255,6 +1456,7 @@ static void usage (char * argv0) {
 "\n    --sortbymaxmismatch: sort by worst color channel mismatch;"
 "\n                         break ties with -sortbymismatch"
 "\n    --sortbymismatch: sort by average color channel mismatch"
+"\n    --threads <n>: compare n file pairs at a time [default 1]"
 "\n    --threshold <n>: only report differences > n (per color channel) [default 0]"
 "\n    --weighted: sort by # pixels different weighted by color difference"
 "\n"
@@ -1277,6 +1479,7 @@ int main (int argc, char ** argv) {
     // Maximum error tolerated in any one color channel in any one pixel before
     // a difference is reported.
     int colorThreshold = 0;
+    int threadCount = 1;
     SkString baseDir;
     SkString comparisonDir;
     SkString outputDir;
@@ -1341,6 +1544,14 @@ int main (int argc, char ** argv) {
             sortProc = compare<CompareDiffMeanMismatches>;
             continue;
         }
+        if (!strcmp(argv[i], "--threads")) {
+            if (++i >= argc || (threadCount = atoi(argv[i])) < 1) {
+                SkDebugf("--threads must be given a value >= 1\n");
+                usage(argv[0]);
+                return kGenericError;
+            }
+            continue;
+        }
         if (!strcmp(argv[i], "--threshold")) {
             colorThreshold = atoi(argv[++i]);
             continue;
@@ -1415,7 +1626,8 @@ int main (int argc, char ** argv) {
 
     create_diff_images(diffProc, colorThreshold, &differences,
                        baseDir, comparisonDir, outputDir,
-                       matchSubstrings, nomatchSubstrings, recurseIntoSubdirs, &summary);
+                       matchSubstrings, nomatchSubstrings, recurseIntoSubdirs, threadCount,
+                       &summary);
     summary.print(listFilenames, failOnResultType);
 
     if (differences.count()) {